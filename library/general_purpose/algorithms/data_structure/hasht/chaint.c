@@ -0,0 +1,427 @@
+#include "chaint.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ 链地址法与树化
+ （1）结构与 uthash 相同：桶数组 + 每个桶一条链表，哈希值取低位选桶；扩容条件、理想链长与 noexpand 的计算也照搬 uthash：
+      扩容后理想链长 ideal = ceil(n / 桶数)，统计落在超过理想链长的桶中的元素数 nonideal，
+      超过一半时记一次无效扩容，连续两次无效就不再扩容；同时给过长的桶提高 expand_mult，推迟它下一次触发扩容
+ （2）不再扩容之后，uthash 的链表会无限变长：构造的碰撞键（哈希值完全相同）全部落在同一个桶里，
+      每次查找（以及 "先查找、不存在再插入"）都要遍历整条链，n 个键的插入总共 O(n^2)
+ （3）树化：链表超过 8 个元素时，把桶内节点排序后建成平衡的 AVL 树；之后在该桶中插入、删除都按 AVL 维护平衡，
+      删除到 6 个以下时转回链表。树按 (哈希值, 键长, memcmp) 排序，即使哈希值全部相同也能按键的字节比较，查找 O(log n)。
+      节点的两个指针在链表中用作 next，在树中用作左右子树，树化不需要额外的节点内存
+ （4）扩容时把树摊平成链表再分配到新桶，分配完后重新树化仍然过长的桶
+*/
+
+// 初始桶数与扩容阈值，与 uthash 的 HASH_INITIAL_NUM_BUCKETS、HASH_BKT_CAPACITY_THRESH 相同
+#define CHAINT_INITIAL_BUCKETS 32u
+#define CHAINT_BKT_CAPACITY_THRESH 10u
+
+typedef struct {
+    ChainTNode* head;           // 链表头或树根
+    uint32_t count;
+    uint16_t expand_mult;       // 该桶触发扩容的链长为 10 * (expand_mult + 1)
+    uint16_t tree;              // 是否已树化
+} ChainTBucket;
+
+struct ChainT {
+    ChainTBucket* buckets;
+    uint32_t num_buckets;       // 2 的幂
+    size_t count;
+    size_t tree_buckets;
+    uint32_t ineff_expands;     // 连续无效扩容的次数
+    int noexpand;
+    hash32_fn hash;
+    uint32_t seed;
+    int treeify;
+};
+
+// 树中的顺序：哈希值、键长、键的字节
+static inline int key_cmp(uint32_t hashv, const void* key, uint32_t len, const ChainTNode* n) {
+    if (hashv != n->hashv) {
+        return hashv < n->hashv ? -1 : 1;
+    }
+    if (len != n->key_len) {
+        return len < n->key_len ? -1 : 1;
+    }
+    return memcmp(key, n->key, len);
+}
+
+static int node_qsort_cmp(const void* a, const void* b) {
+    const ChainTNode* x = *(const ChainTNode* const*)a;
+    const ChainTNode* y = *(const ChainTNode* const*)b;
+    return key_cmp(x->hashv, x->key, x->key_len, y);
+}
+
+/*
+ AVL 树：每个节点左右子树高度差不超过 1，高度不超过 1.44 log2(n)
+*/
+static inline int32_t height(const ChainTNode* n) {
+    return n != NULL ? n->height : 0;
+}
+
+static inline void update_height(ChainTNode* n) {
+    int32_t l = height(n->left);
+    int32_t r = height(n->right);
+    n->height = (l > r ? l : r) + 1;
+}
+
+static ChainTNode* rotate_right(ChainTNode* n) {
+    ChainTNode* l = n->left;
+    n->left = l->right;
+    l->right = n;
+    update_height(n);
+    update_height(l);
+    return l;
+}
+
+static ChainTNode* rotate_left(ChainTNode* n) {
+    ChainTNode* r = n->right;
+    n->right = r->left;
+    r->left = n;
+    update_height(n);
+    update_height(r);
+    return r;
+}
+
+// 子树高度差为 2 时旋转，返回新的子树根
+static ChainTNode* rebalance(ChainTNode* n) {
+    update_height(n);
+    int32_t diff = height(n->left) - height(n->right);
+    if (diff > 1) {
+        if (height(n->left->left) < height(n->left->right)) {
+            n->left = rotate_left(n->left);
+        }
+        return rotate_right(n);
+    }
+    if (diff < -1) {
+        if (height(n->right->right) < height(n->right->left)) {
+            n->right = rotate_right(n->right);
+        }
+        return rotate_left(n);
+    }
+    return n;
+}
+
+// 插入（调用前已确认键不在树中）
+static ChainTNode* avl_insert(ChainTNode* root, ChainTNode* node) {
+    if (root == NULL) {
+        node->left = NULL;
+        node->right = NULL;
+        node->height = 1;
+        return node;
+    }
+    if (key_cmp(node->hashv, node->key, node->key_len, root) < 0) {
+        root->left = avl_insert(root->left, node);
+    } else {
+        root->right = avl_insert(root->right, node);
+    }
+    return rebalance(root);
+}
+
+static ChainTNode* avl_remove_min(ChainTNode* root, ChainTNode** min) {
+    if (root->left == NULL) {
+        *min = root;
+        return root->right;
+    }
+    root->left = avl_remove_min(root->left, min);
+    return rebalance(root);
+}
+
+static ChainTNode* avl_remove(ChainTNode* root, uint32_t hashv, const void* key, uint32_t len, ChainTNode** out) {
+    if (root == NULL) {
+        return NULL;
+    }
+    int c = key_cmp(hashv, key, len, root);
+    if (c < 0) {
+        root->left = avl_remove(root->left, hashv, key, len, out);
+    } else if (c > 0) {
+        root->right = avl_remove(root->right, hashv, key, len, out);
+    } else {
+        *out = root;
+        if (root->left == NULL) {
+            return root->right;
+        }
+        if (root->right == NULL) {
+            return root->left;
+        }
+        // 用右子树的最小节点顶替被删除的节点
+        ChainTNode* min;
+        ChainTNode* right = avl_remove_min(root->right, &min);
+        min->left = root->left;
+        min->right = right;
+        return rebalance(min);
+    }
+    return rebalance(root);
+}
+
+// 有序节点数组 [lo, hi) 建成平衡树
+static ChainTNode* build_balanced(ChainTNode** nodes, size_t lo, size_t hi) {
+    if (lo >= hi) {
+        return NULL;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    ChainTNode* n = nodes[mid];
+    n->left = build_balanced(nodes, lo, mid);
+    n->right = build_balanced(nodes, mid + 1, hi);
+    update_height(n);
+    return n;
+}
+
+// 把子树的节点逐个压到链表 list 的头部，返回新的链表头
+static ChainTNode* tree_to_list(ChainTNode* root, ChainTNode* list) {
+    while (root != NULL) {
+        ChainTNode* left = root->left;
+        list = tree_to_list(root->right, list);
+        root->left = list;
+        root->right = NULL;
+        list = root;
+        root = left;
+    }
+    return list;
+}
+
+// 链表转为平衡树；内存不足时保持链表
+static void treeify_bucket(ChainT* t, ChainTBucket* b) {
+    ChainTNode** nodes = (ChainTNode**)malloc(b->count * sizeof(ChainTNode*));
+    if (nodes == NULL) {
+        return;
+    }
+    size_t n = 0;
+    for (ChainTNode* p = b->head; p != NULL; p = p->left) {
+        nodes[n++] = p;
+    }
+    qsort(nodes, n, sizeof(ChainTNode*), node_qsort_cmp);
+    b->head = build_balanced(nodes, 0, n);
+    b->tree = 1;
+    t->tree_buckets++;
+    free(nodes);
+}
+
+static void untreeify_bucket(ChainT* t, ChainTBucket* b) {
+    b->head = tree_to_list(b->head, NULL);
+    b->tree = 0;
+    t->tree_buckets--;
+}
+
+static ChainTNode* find_in_bucket(const ChainTBucket* b, uint32_t hashv, const void* key, uint32_t len) {
+    ChainTNode* n = b->head;
+    if (b->tree) {
+        while (n != NULL) {
+            int c = key_cmp(hashv, key, len, n);
+            if (c == 0) {
+                return n;
+            }
+            n = c < 0 ? n->left : n->right;
+        }
+        return NULL;
+    }
+    for (; n != NULL; n = n->left) {
+        if (n->hashv == hashv && n->key_len == len && memcmp(n->key, key, len) == 0) {
+            return n;
+        }
+    }
+    return NULL;
+}
+
+// 桶数加倍（uthash 的 HASH_EXPAND_BUCKETS），内存不足返回 -1，表不变
+static int expand(ChainT* t) {
+    uint32_t new_num = t->num_buckets * 2;
+    ChainTBucket* nb = (ChainTBucket*)calloc(new_num, sizeof(ChainTBucket));
+    if (nb == NULL) {
+        return -1;
+    }
+    size_t ideal = t->count / new_num + (t->count % new_num != 0);
+    size_t nonideal = 0;
+    for (uint32_t i = 0; i < t->num_buckets; i++) {
+        ChainTBucket* ob = &t->buckets[i];
+        ChainTNode* n = ob->tree ? tree_to_list(ob->head, NULL) : ob->head;
+        while (n != NULL) {
+            ChainTNode* next = n->left;
+            ChainTBucket* b = &nb[n->hashv & (new_num - 1)];
+            if (++b->count > ideal) {
+                nonideal++;
+                if (b->count > b->expand_mult * ideal) {
+                    b->expand_mult++;
+                }
+            }
+            n->left = b->head;
+            n->right = NULL;
+            b->head = n;
+            n = next;
+        }
+    }
+    free(t->buckets);
+    t->buckets = nb;
+    t->num_buckets = new_num;
+    t->tree_buckets = 0;
+    t->ineff_expands = nonideal > t->count / 2 ? t->ineff_expands + 1 : 0;
+    if (t->ineff_expands > 1) {
+        t->noexpand = 1;
+    }
+    if (t->treeify) {
+        for (uint32_t i = 0; i < new_num; i++) {
+            if (nb[i].count > CHAINT_TREEIFY_THRESHOLD) {
+                treeify_bucket(t, &nb[i]);
+            }
+        }
+    }
+    return 0;
+}
+
+// 创建、销毁
+ChainT* chaint_create(const ChainTConfig* cfg) {
+    if (cfg == NULL) {
+        return NULL;
+    }
+    ChainT* t = (ChainT*)calloc(1, sizeof(ChainT));
+    if (t == NULL) {
+        return NULL;
+    }
+    t->buckets = (ChainTBucket*)calloc(CHAINT_INITIAL_BUCKETS, sizeof(ChainTBucket));
+    if (t->buckets == NULL) {
+        free(t);
+        return NULL;
+    }
+    t->num_buckets = CHAINT_INITIAL_BUCKETS;
+    t->hash = cfg->hash != NULL ? cfg->hash : murmurHash3_32;
+    t->seed = cfg->seed;
+    t->treeify = cfg->treeify;
+    return t;
+}
+
+void chaint_free(ChainT* table) {
+    if (table == NULL) {
+        return;
+    }
+    free(table->buckets);
+    free(table);
+}
+
+// 增、删、查
+int chaint_add(ChainT* table, ChainTNode* node, const void* key, size_t key_len) {
+    if (key_len > UINT32_MAX) {
+        return -1;
+    }
+    uint32_t len = (uint32_t)key_len;
+    uint32_t hashv = table->hash(key, key_len, table->seed);
+    ChainTBucket* b = &table->buckets[hashv & (table->num_buckets - 1)];
+    if (find_in_bucket(b, hashv, key, len) != NULL) {
+        return 1;
+    }
+    node->key = key;
+    node->key_len = len;
+    node->hashv = hashv;
+    if (b->tree) {
+        b->head = avl_insert(b->head, node);
+    } else {
+        node->left = b->head;
+        node->right = NULL;
+        b->head = node;
+    }
+    b->count++;
+    table->count++;
+
+    if (b->count >= (b->expand_mult + 1u) * CHAINT_BKT_CAPACITY_THRESH && !table->noexpand && expand(table) == 0) {
+        return 0;
+    }
+    if (table->treeify && !b->tree && b->count > CHAINT_TREEIFY_THRESHOLD) {
+        treeify_bucket(table, b);
+    }
+    return 0;
+}
+
+ChainTNode* chaint_find(const ChainT* table, const void* key, size_t key_len) {
+    if (key_len > UINT32_MAX) {
+        return NULL;
+    }
+    uint32_t hashv = table->hash(key, key_len, table->seed);
+    return find_in_bucket(&table->buckets[hashv & (table->num_buckets - 1)], hashv, key, (uint32_t)key_len);
+}
+
+ChainTNode* chaint_remove(ChainT* table, const void* key, size_t key_len) {
+    if (key_len > UINT32_MAX) {
+        return NULL;
+    }
+    uint32_t len = (uint32_t)key_len;
+    uint32_t hashv = table->hash(key, key_len, table->seed);
+    ChainTBucket* b = &table->buckets[hashv & (table->num_buckets - 1)];
+    ChainTNode* out = NULL;
+    if (b->tree) {
+        b->head = avl_remove(b->head, hashv, key, len, &out);
+    } else {
+        for (ChainTNode** pp = &b->head; *pp != NULL; pp = &(*pp)->left) {
+            ChainTNode* n = *pp;
+            if (n->hashv == hashv && n->key_len == len && memcmp(n->key, key, len) == 0) {
+                *pp = n->left;
+                out = n;
+                break;
+            }
+        }
+    }
+    if (out == NULL) {
+        return NULL;
+    }
+    b->count--;
+    table->count--;
+    if (b->tree && b->count <= CHAINT_UNTREEIFY_THRESHOLD) {
+        untreeify_bucket(table, b);
+    }
+    return out;
+}
+
+// 中序遍历：访问节点之前先取出左右子树，fn 释放节点也不影响遍历
+static void foreach_tree(ChainTNode* n, void (*fn)(ChainTNode* node, void* arg), void* arg) {
+    while (n != NULL) {
+        ChainTNode* left = n->left;
+        ChainTNode* right = n->right;
+        foreach_tree(left, fn, arg);
+        fn(n, arg);
+        n = right;
+    }
+}
+
+void chaint_foreach(const ChainT* table, void (*fn)(ChainTNode* node, void* arg), void* arg) {
+    for (uint32_t i = 0; i < table->num_buckets; i++) {
+        const ChainTBucket* b = &table->buckets[i];
+        if (b->tree) {
+            foreach_tree(b->head, fn, arg);
+            continue;
+        }
+        for (ChainTNode* n = b->head; n != NULL;) {
+            ChainTNode* next = n->left;
+            fn(n, arg);
+            n = next;
+        }
+    }
+}
+
+size_t chaint_count(const ChainT* table) {
+    return table->count;
+}
+
+size_t chaint_bucket_count(const ChainT* table) {
+    return table->num_buckets;
+}
+
+size_t chaint_tree_buckets(const ChainT* table) {
+    return table->tree_buckets;
+}
+
+size_t chaint_max_depth(const ChainT* table) {
+    size_t depth = 0;
+    for (uint32_t i = 0; i < table->num_buckets; i++) {
+        const ChainTBucket* b = &table->buckets[i];
+        size_t d = b->tree ? (size_t)b->head->height : b->count;
+        if (d > depth) {
+            depth = d;
+        }
+    }
+    return depth;
+}
+
+int chaint_noexpand(const ChainT* table) {
+    return table->noexpand;
+}
@@ -0,0 +1,97 @@
+#ifndef CHAINT_H
+#define CHAINT_H
+
+#include "hashalg.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ 链地址法哈希表（与 uthash 相同的结构与扩容策略），可选树化
+ （1）侵入式：节点 ChainTNode 嵌在用户结构体中，表只保存节点指针，不分配、不释放元素；用 CHAINT_ENTRY 取回外层结构体
+ （2）桶数为 2 的幂，初始 32；某个桶的元素数达到 10 *（expand_mult + 1）时桶数加倍；
+      连续两次扩容后仍有超过一半的元素在过长的桶里（哈希函数对这批键无效），停止扩容（noexpand）
+ （3）树化（treeify 不为 0）：参考 Java 8 的 HashMap，桶内元素超过 CHAINT_TREEIFY_THRESHOLD 个时由链表转为 AVL 树
+      （按 哈希值、键长、键的字节序 排序），删除到 CHAINT_UNTREEIFY_THRESHOLD 个以下时转回链表。
+      大量键的哈希值完全相同（构造的碰撞攻击）时，扩容无效，链表的查找是 O(n)，树化后为 O(log n)
+*/
+
+// 链表长度超过此值时树化
+#define CHAINT_TREEIFY_THRESHOLD 8
+// 树的元素数不超过此值时转回链表（与树化阈值错开，避免在阈值附近反复转换）
+#define CHAINT_UNTREEIFY_THRESHOLD 6
+
+typedef struct ChainTNode {
+    struct ChainTNode* left;    // 链表桶中为下一个节点；树化的桶中为左子树
+    struct ChainTNode* right;   // 树化的桶中为右子树
+    const void* key;            // 键的地址（通常指向外层结构体中的字段），节点在表中时不能修改
+    uint32_t key_len;
+    uint32_t hashv;
+    int32_t height;             // 树化的桶中为子树高度
+} ChainTNode;
+
+// 由节点地址取回外层结构体
+#define CHAINT_ENTRY(node, type, member) ((type*)((char*)(node) - offsetof(type, member)))
+
+typedef struct {
+    hash32_fn hash;             // 为NULL时使用 murmurHash3_32
+    uint32_t seed;
+    int treeify;                // 非 0 时开启树化
+} ChainTConfig;
+
+typedef struct ChainT ChainT;
+
+/**
+* @brief             创建哈希表
+* @return            成功返回哈希表，cfg 为NULL或内存不足返回NULL
+*/
+ChainT* chaint_create(const ChainTConfig* cfg);
+
+/**
+* @brief             销毁哈希表（只释放桶数组，不释放节点），table 为NULL时不做任何事
+*/
+void chaint_free(ChainT* table);
+
+/**
+* @brief             加入节点
+* @param node        未在任何表中的节点，key 在节点留在表中期间必须有效
+* @param key_len     键长，不超过 UINT32_MAX
+* @return            加入返回0，键已存在（节点未加入）返回 1，键过长返回 -1
+* @note              扩容或树化时内存不足不影响加入，只是桶继续保持原样
+*/
+int chaint_add(ChainT* table, ChainTNode* node, const void* key, size_t key_len);
+
+/**
+* @brief             查找
+* @return            键对应的节点，不存在返回NULL
+*/
+ChainTNode* chaint_find(const ChainT* table, const void* key, size_t key_len);
+
+/**
+* @brief             删除键对应的节点
+* @return            被删除的节点（由调用者释放），不存在返回NULL
+*/
+ChainTNode* chaint_remove(ChainT* table, const void* key, size_t key_len);
+
+/**
+* @brief             访问每个节点，顺序不确定；fn 可以释放节点（如销毁全部元素），之后不能再使用表
+*/
+void chaint_foreach(const ChainT* table, void (*fn)(ChainTNode* node, void* arg), void* arg);
+
+size_t chaint_count(const ChainT* table);
+size_t chaint_bucket_count(const ChainT* table);
+// 当前为树的桶数
+size_t chaint_tree_buckets(const ChainT* table);
+// 最坏查找的比较次数：最长链表的长度与最高树的高度中的较大者
+size_t chaint_max_depth(const ChainT* table);
+// 是否已经因为扩容无效而停止扩容
+int chaint_noexpand(const ChainT* table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CHAINT_H
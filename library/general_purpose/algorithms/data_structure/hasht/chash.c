@@ -0,0 +1,331 @@
+#include "chash.h"
+#include "hashalg.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ 一致性哈希（Consistent Hashing）
+ 取模分片 node = hash(key) % n 在 n 变化时几乎所有键都要换节点；一致性哈希让 n -> n±1 时只有约 1/n 的键移动
+ （1）Ketama 环：把节点和键都映射到 [0, 2^32) 的环上，键归属于顺时针方向遇到的第一个节点。
+      每个节点只放一个点时各节点的弧长差异很大，所以每个节点放置上百个虚拟节点，弧长之和趋于均匀；
+      Memcached 客户端（libketama）每个节点 160 个虚拟节点，每个 MD5 摘要切成 4 个 32 位位置。
+      这里用 MurmurHash3 x64_128 代替 MD5（同样每次得到 4 个位置），不追求与 libketama 的位置逐位一致
+ （2）跳跃一致性哈希：桶数从 j 增加到 j+1 时，键以 1/(j+1) 的概率跳到新桶；
+      用键播种的伪随机数直接算出下一次跳跃的位置，循环次数期望为 ln(n)
+ （3）Rendezvous 哈希：每个 (键, 节点) 对算一个伪随机分数，键归属于分数最高的节点；
+      删除节点只影响原本选中它的键，其余键的最高分不变
+*/
+
+typedef struct {
+    char* name;             // NULL 表示该编号的节点已删除
+    uint32_t weight;
+} ChashNode;
+
+struct ChashRing {
+    uint32_t vnodes;        // 每单位权重的虚拟节点数
+    uint32_t count;         // 虚拟节点总数
+    uint32_t cap;
+    uint32_t* points;       // 虚拟节点位置，升序
+    int32_t* owners;        // owners[i] 为 points[i] 所属的节点编号
+
+    ChashNode* nodes;       // 按编号存放，删除的节点保留空位，编号不复用
+    uint32_t node_used;     // 已分配的编号数
+    uint32_t node_cap;
+    uint32_t node_alive;    // 当前节点数
+};
+
+ChashRing* chash_ring_create(uint32_t vnodes) {
+    ChashRing* ring = (ChashRing*)calloc(1, sizeof(ChashRing));
+    if (ring == NULL) {
+        return NULL;
+    }
+    ring->vnodes = vnodes != 0 ? vnodes : CHASH_DEFAULT_VNODES;
+    return ring;
+}
+
+void chash_ring_free(ChashRing* ring) {
+    if (ring == NULL) {
+        return;
+    }
+    for (uint32_t i = 0; i < ring->node_used; i++) {
+        free(ring->nodes[i].name);
+    }
+    free(ring->nodes);
+    free(ring->points);
+    free(ring->owners);
+    free(ring);
+}
+
+static int find_node(const ChashRing* ring, const char* name) {
+    for (uint32_t i = 0; i < ring->node_used; i++) {
+        if (ring->nodes[i].name != NULL && strcmp(ring->nodes[i].name, name) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/*
+ 虚拟节点的全序：先按位置，位置相同（概率约 P^2 / 2^33）时按节点名，
+ 保证排序结果只取决于节点集合，与加入顺序和编号无关
+*/
+static int point_less(const ChashRing* ring, uint32_t pa, int32_t oa, uint32_t pb, int32_t ob) {
+    if (pa != pb) {
+        return pa < pb;
+    }
+    return oa != ob && strcmp(ring->nodes[oa].name, ring->nodes[ob].name) < 0;
+}
+
+typedef struct {
+    uint32_t point;
+    int32_t owner;
+} ChashPoint;
+
+static int cmp_point(const void* a, const void* b) {
+    const ChashPoint* x = (const ChashPoint*)a;
+    const ChashPoint* y = (const ChashPoint*)b;
+    if (x->point != y->point) {
+        return x->point < y->point ? -1 : 1;
+    }
+    return 0;   // 只对同一节点的虚拟节点排序，位置相同时先后无所谓
+}
+
+int chash_ring_add(ChashRing* ring, const char* name, uint32_t weight) {
+    if (ring == NULL || name == NULL || weight == 0 || find_node(ring, name) >= 0) {
+        return -1;
+    }
+    // owners 存 int32_t 下标，虚拟节点总数上限取 INT32_MAX；在 64 位里算好目标再进扩容循环
+    uint64_t add64 = (uint64_t)ring->vnodes * weight;
+    if (add64 > (uint64_t)INT32_MAX - ring->count) {
+        return -1;
+    }
+    uint32_t add = (uint32_t)add64;
+    size_t target = (size_t)ring->count + add;
+
+    if (ring->node_used == ring->node_cap) {
+        uint32_t cap = ring->node_cap != 0 ? ring->node_cap * 2 : 8;
+        ChashNode* nodes = (ChashNode*)realloc(ring->nodes, cap * sizeof(ChashNode));
+        if (nodes == NULL) {
+            return -1;
+        }
+        ring->nodes = nodes;
+        ring->node_cap = cap;
+    }
+    size_t name_len = strlen(name);
+    char* copy = (char*)malloc(name_len + 1);
+    ChashPoint* fresh = (ChashPoint*)malloc(add * sizeof(ChashPoint));
+    size_t new_cap = ring->cap;
+    while (new_cap < target) {
+        new_cap = new_cap != 0 ? new_cap * 2 : 1024;
+    }
+    if (new_cap > INT32_MAX) {
+        new_cap = target;
+    }
+    if (new_cap > SIZE_MAX / sizeof(uint32_t)) {
+        free(copy);
+        free(fresh);
+        return -1;
+    }
+    uint32_t* points = (uint32_t*)malloc(new_cap * sizeof(uint32_t));
+    int32_t* owners = (int32_t*)malloc(new_cap * sizeof(int32_t));
+    if (copy == NULL || fresh == NULL || points == NULL || owners == NULL) {
+        free(copy);
+        free(fresh);
+        free(points);
+        free(owners);
+        return -1;
+    }
+    memcpy(copy, name, name_len + 1);
+
+    int32_t id = (int32_t)ring->node_used;
+    ring->nodes[id].name = copy;
+    ring->nodes[id].weight = weight;
+    ring->node_used++;
+    ring->node_alive++;
+
+    // 第 i 组 4 个虚拟节点取 MurmurHash3_x64_128(name, seed = i) 的 4 个 32 位分量
+    uint64_t out[2] = { 0, 0 };
+    for (uint32_t i = 0; i < add; i++) {
+        if ((i & 3) == 0) {
+            murmurHash3_x64_128(name, name_len, i / 4, out);
+        }
+        fresh[i].point = (uint32_t)(out[(i & 3) >> 1] >> (32 * (i & 1)));
+        fresh[i].owner = id;
+    }
+    qsort(fresh, add, sizeof(ChashPoint), cmp_point);
+
+    // 与原有的有序数组归并
+    uint32_t i = 0, j = 0, k = 0;
+    while (i < ring->count && j < add) {
+        if (point_less(ring, fresh[j].point, fresh[j].owner, ring->points[i], ring->owners[i])) {
+            points[k] = fresh[j].point;
+            owners[k++] = fresh[j++].owner;
+        } else {
+            points[k] = ring->points[i];
+            owners[k++] = ring->owners[i++];
+        }
+    }
+    for (; i < ring->count; i++, k++) {
+        points[k] = ring->points[i];
+        owners[k] = ring->owners[i];
+    }
+    for (; j < add; j++, k++) {
+        points[k] = fresh[j].point;
+        owners[k] = fresh[j].owner;
+    }
+
+    free(fresh);
+    free(ring->points);
+    free(ring->owners);
+    ring->points = points;
+    ring->owners = owners;
+    ring->count = k;
+    ring->cap = (uint32_t)new_cap;
+    return id;
+}
+
+int chash_ring_remove(ChashRing* ring, const char* name) {
+    if (ring == NULL || name == NULL) {
+        return -1;
+    }
+    int id = find_node(ring, name);
+    if (id < 0) {
+        return -1;
+    }
+
+    // 原地过滤，剩余虚拟节点的相对顺序不变
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < ring->count; i++) {
+        if (ring->owners[i] != id) {
+            ring->points[k] = ring->points[i];
+            ring->owners[k++] = ring->owners[i];
+        }
+    }
+    ring->count = k;
+
+    free(ring->nodes[id].name);
+    ring->nodes[id].name = NULL;
+    ring->nodes[id].weight = 0;
+    ring->node_alive--;
+    return 0;
+}
+
+/**
+* @brief             无分支二分查找：第一个 >= hash 的位置的下标，全部小于 hash 时返回 count
+* @note              每轮把区间减半，比较结果只用于选择下一轮的起点（编译为 cmov），不产生条件跳转；
+*                    键的哈希值随机，普通二分查找每轮约有一半的概率预测失败，虚拟节点数上千时分支预测失败是主要开销。
+*                    循环次数只取决于 count，所有查找走完全相同的指令序列。
+*                    比较写成乘法而不是三目运算：gcc 对三目运算生成的是条件跳转。
+*                    下一轮要访问的位置只有两种可能，提前预取两者，虚拟节点数组超出 L1 时隐藏一部分访存延迟
+*/
+static uint32_t lower_bound_u32(const uint32_t* points, uint32_t count, uint32_t hash) {
+    const uint32_t* base = points;
+    uint32_t n = count;
+    while (n > 1) {
+        uint32_t half = n / 2;
+        __builtin_prefetch(base + half / 2);
+        __builtin_prefetch(base + half + half / 2);
+        base += (base[half - 1] < hash) * half;
+        n -= half;
+    }
+    return (uint32_t)(base - points) + (*base < hash);
+}
+
+int chash_ring_lookup_hash(const ChashRing* ring, uint32_t hash) {
+    if (ring == NULL || ring->count == 0) {
+        return -1;
+    }
+    uint32_t idx = lower_bound_u32(ring->points, ring->count, hash);
+    idx = idx == ring->count ? 0 : idx;     // 超过最后一个虚拟节点时回绕
+    return ring->owners[idx];
+}
+
+int chash_ring_lookup(const ChashRing* ring, const void* key, size_t len) {
+    return chash_ring_lookup_hash(ring, murmurHash3_32(key, len, 0));
+}
+
+const char* chash_ring_node_name(const ChashRing* ring, int node) {
+    if (ring == NULL || node < 0 || (uint32_t)node >= ring->node_used) {
+        return NULL;
+    }
+    return ring->nodes[node].name;
+}
+
+uint32_t chash_ring_node_count(const ChashRing* ring) {
+    return ring != NULL ? ring->node_alive : 0;
+}
+
+uint32_t chash_ring_point_count(const ChashRing* ring) {
+    return ring != NULL ? ring->count : 0;
+}
+
+/**
+* @brief             跳跃一致性哈希
+* @note              b 为当前所在的桶，j 为下一次跳到的桶：以键为种子的线性同余序列产生 (0,1] 的随机数 r，
+*                    j = (b + 1) / r，即 "从 b+1 到 j-1 的每个桶都不跳" 的概率恰为 (b+1)/j。
+*                    与论文中的参考实现逐位一致
+*/
+int32_t jump_consistent_hash(uint64_t key, int32_t num_buckets) {
+    int64_t b = -1;
+    int64_t j = 0;
+    while (j < num_buckets) {
+        b = j;
+        key = key * 2862933555777941757ULL + 1;
+        j = (int64_t)((double)(b + 1) * ((double)(1LL << 31) / (double)((key >> 33) + 1)));
+    }
+    return (int32_t)b;
+}
+
+// MurmurHash3 的 64 位终混合，把 (键, 节点) 组合成均匀分布的分数
+static inline uint64_t score_mix(uint64_t key_hash, uint64_t node_hash) {
+    uint64_t x = key_hash ^ node_hash;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+int32_t rendezvous_hash(uint64_t key_hash, const uint64_t node_hashes[], int32_t n) {
+    int32_t best = -1;
+    uint64_t best_score = 0;
+    uint64_t best_node = 0;
+    for (int32_t i = 0; i < n; i++) {
+        uint64_t s = score_mix(key_hash, node_hashes[i]);
+        // 分数相同时比较节点哈希，结果与数组顺序无关
+        if (best < 0 || s > best_score || (s == best_score && node_hashes[i] > best_node)) {
+            best = i;
+            best_score = s;
+            best_node = node_hashes[i];
+        }
+    }
+    return best;
+}
+
+/**
+* @brief             带权重的 Rendezvous 哈希
+* @note              u 在 (0,1) 上均匀分布时 -ln(u) / w 服从参数为 w 的指数分布，
+*                    n 个独立指数分布中第 i 个最小的概率为 w_i / Σw，取 -w / ln(u) 的最大值与之等价
+*/
+int32_t rendezvous_hash_weighted(uint64_t key_hash, const uint64_t node_hashes[],
+                                 const double weights[], int32_t n) {
+    int32_t best = -1;
+    double best_score = 0.0;
+    uint64_t best_node = 0;
+    for (int32_t i = 0; i < n; i++) {
+        if (!(weights[i] > 0.0)) {
+            continue;
+        }
+        // 取高 53 位映射到 (0,1)，不会取到 0 或 1
+        double u = ((double)(score_mix(key_hash, node_hashes[i]) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+        double s = -weights[i] / log(u);
+        if (best < 0 || s > best_score || (s == best_score && node_hashes[i] > best_node)) {
+            best = i;
+            best_score = s;
+            best_node = node_hashes[i];
+        }
+    }
+    return best;
+}
@@ -0,0 +1,113 @@
+#ifndef CHASH_H
+#define CHASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ 一致性哈希：把键分配到 n 个节点上，节点增删时只迁移约 1/n 的键（取模分片几乎迁移全部键）
+ （1）Ketama 环：每个节点按权重在 32 位环上放置若干虚拟节点，键顺时针找到的第一个虚拟节点即所属节点；
+      支持任意节点增删与权重，查找 O(log P)（P 为虚拟节点总数）
+ （2）跳跃一致性哈希（Jump Consistent Hash）：不占内存、查找 O(ln n)，
+      但节点只能是 0 ~ n-1 的编号，只能在末尾增删，适合副本编号固定的分片
+ （3）Rendezvous 哈希（最高随机权重，HRW）：每个节点对键打分取最高者，查找 O(n)，
+      节点可以任意增删，不需要预先构建数据结构，适合节点数较少的场景
+*/
+
+/*
+ Ketama 环
+ 虚拟节点的位置存放在按位置排序的连续数组中（位置与所属节点分两个数组存放，二分查找只访问位置数组），
+ 查找使用无分支二分查找；增删节点时把该节点的虚拟节点归并进有序数组或从中过滤，不做整体重排序
+ 虚拟节点的位置与加入顺序无关：同一组节点以任意顺序加入，每个键映射到同名节点
+*/
+typedef struct ChashRing ChashRing;
+
+// 每单位权重的虚拟节点数，Ketama 默认每个节点 160 个
+#define CHASH_DEFAULT_VNODES 160
+
+/**
+* @brief             创建空的 Ketama 环
+* @param vnodes      每单位权重的虚拟节点数，为 0 时使用 CHASH_DEFAULT_VNODES
+* @return            成功返回环，内存不足返回NULL
+*/
+ChashRing* chash_ring_create(uint32_t vnodes);
+
+/**
+* @brief             销毁环，ring 为NULL时不做任何事
+*/
+void chash_ring_free(ChashRing* ring);
+
+/**
+* @brief             加入节点
+* @param name        节点名（如 "10.0.0.1:11211"），虚拟节点位置由节点名决定，环内拷贝一份
+* @param weight      权重，虚拟节点数为 vnodes * weight
+* @return            成功返回节点编号（>= 0，节点删除后编号不复用）；
+*                    节点名已存在、weight 为 0、虚拟节点总数超过 INT32_MAX 或内存不足返回 -1
+*/
+int chash_ring_add(ChashRing* ring, const char* name, uint32_t weight);
+
+/**
+* @brief             删除节点，原属该节点的键顺时针移交给相邻的虚拟节点
+* @return            成功返回0，节点不存在返回 -1
+*/
+int chash_ring_remove(ChashRing* ring, const char* name);
+
+/**
+* @brief             查找键所属的节点
+* @param key         任意二进制键，使用 murmurHash3_32 映射到环上
+* @return            节点编号，环为空时返回 -1
+*/
+int chash_ring_lookup(const ChashRing* ring, const void* key, size_t len);
+
+/**
+* @brief             按环上的位置查找节点，键已有 32 位哈希值时使用
+* @return            位置之后（含）第一个虚拟节点所属的节点编号，超过最后一个时回绕到第一个；环为空时返回 -1
+*/
+int chash_ring_lookup_hash(const ChashRing* ring, uint32_t hash);
+
+/**
+* @brief             按编号取节点名
+* @return            节点名，编号无效或节点已删除返回NULL
+*/
+const char* chash_ring_node_name(const ChashRing* ring, int node);
+
+// 当前节点数与虚拟节点总数
+uint32_t chash_ring_node_count(const ChashRing* ring);
+uint32_t chash_ring_point_count(const ChashRing* ring);
+
+/**
+* @brief             跳跃一致性哈希（Lamping & Veach, 2014）
+* @param key         键的 64 位哈希值（如 xxHash64 的结果）；直接传入连续整数时分布也是均匀的
+* @param num_buckets 桶数
+* @return            [0, num_buckets) 中的桶编号；num_buckets <= 0 时返回 -1
+* @note              num_buckets 由 n 增加到 n+1 时，只有约 1/(n+1) 的键移动，且都移到新桶 n
+*/
+int32_t jump_consistent_hash(uint64_t key, int32_t num_buckets);
+
+/**
+* @brief             Rendezvous 哈希：对每个节点计算 mix(key_hash, node_hashes[i])，取分数最高的节点
+* @param key_hash    键的 64 位哈希值
+* @param node_hashes 节点标识的 64 位哈希值（如节点名的 xxHash64），各不相同
+* @param n           节点数
+* @return            选中节点在数组中的下标，n <= 0 时返回 -1
+* @note              结果只取决于节点集合，与数组顺序无关；删除节点时只有原属该节点的键移动
+*/
+int32_t rendezvous_hash(uint64_t key_hash, const uint64_t node_hashes[], int32_t n);
+
+/**
+* @brief             带权重的 Rendezvous 哈希，分数为 -weight / ln(u)（u 为映射到 (0,1) 的打分）
+* @param weights     各节点权重（> 0），每个节点分到的键的比例与权重成正比
+* @return            同 rendezvous_hash，权重全部不大于 0 时返回 -1
+*/
+int32_t rendezvous_hash_weighted(uint64_t key_hash, const uint64_t node_hashes[],
+                                 const double weights[], int32_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CHASH_H
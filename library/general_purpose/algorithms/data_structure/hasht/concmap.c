@@ -0,0 +1,637 @@
+#include "concmap.h"
+#include "hasht_group.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ 实现要点
+ （1）段内的表与 hasht.c 相同：控制字节 + 三角数探测、空组停止探测、组满时删除留墓碑；
+      槽位为 序号 + 键 + 值，键值直接存在槽位里（不为每个元素单独分配），读与 hasht 一样只访问控制字节与一个槽位
+ （2）写者（持有段锁）与无锁读者之间用槽位序号同步（顺序锁 seqlock）：
+      - 写者修改槽位（插入、更新值、删除）前把序号加 1 成为奇数，改完（含控制字节）再加 1 成为偶数
+      - 读者在控制字节匹配的槽位上：读序号（奇数则等待）→ 比较键、拷贝值、读控制字节 → 再读序号，
+        两次序号相同说明读到的是一次完整写入之后的状态，否则重读这个槽位
+      - 读到的控制字节不再等于 h2 说明槽位已被删除，当作不匹配；读者对比较结果只在序号校验通过后才采信，
+        所以用户的 eq 可能在写了一半的键上被调用，但结果会被丢弃
+      读者用 SSE2 一次读 16 个控制字节，写者逐字节原子写；x86 上对齐的加载不会读到撕裂的单个字节
+ （3）扩容：在锁内建新表，再原子地替换段的表指针；旧表之后不再被修改，读者可以继续读完，其他段不受影响
+ （4）被替换的旧表不能立即释放（可能有读者正在访问），用纪元回收（epoch-based reclamation）：
+      - 全局纪元 epoch；读者进入时把 (epoch << 1) | 1 写到自己的线程记录，离开时清零
+      - 写者在解锁之后把旧表挂到本线程的待回收链表 limbo[epoch % 3]，记下当时的纪元
+      - 推进纪元：所有正在读的线程都已进入当前纪元时，纪元加 1；
+        纪元为 e 时，e - 2 及以前退休的表已经没有读者能访问（之后进入的读者只能看到新表），可以释放
+      - 有待回收的表时，写者每 CONCMAP_ADVANCE_INTERVAL 次写操作尝试推进一次纪元并回收
+      - detach 时尚未到期的表连同各自的退休纪元移到全局的孤儿链表，由之后任一线程的 retire/after_write 到期释放
+*/
+
+#define CONCMAP_CACHE_LINE 64
+#define CONCMAP_MIN_CAPACITY HASHT_GROUP_WIDTH
+
+// 有待回收的表时，每这么多次写操作尝试推进一次纪元
+#define CONCMAP_ADVANCE_INTERVAL 64
+
+// 读者连续这么多次遇到正在写的槽位后让出 CPU（写者可能被调度出去了）
+#define CONCMAP_SPIN_LIMIT 64
+
+// 段内的表：发布后只有持有段锁的写者修改，被替换后不再修改
+typedef struct Table {
+    struct Table* next;         // 待回收链表
+    uint64_t retire_epoch;      // 退休时的纪元
+    size_t capacity;            // 槽位数，2 的幂，>= CONCMAP_MIN_CAPACITY
+    size_t group_mask;          // 组数 - 1
+    uint8_t* ctrl;              // capacity 个控制字节，16 字节对齐
+    uint8_t* slots;             // capacity 个槽位：uint32_t 序号 + 键 + 值（按对齐补齐）
+} Table;
+
+typedef struct {
+    _Alignas(CONCMAP_CACHE_LINE) pthread_mutex_t lock;
+    Table* table;               // 读者 acquire 读取，写者在锁内 release 发布
+    size_t size;                // 以下由段锁保护；size 允许无锁读取近似值
+    size_t tombstones;
+    size_t growth_left;
+} Segment;
+
+struct ConcMapThread {
+    _Alignas(CONCMAP_CACHE_LINE) uint64_t epoch;   // 读者所在纪元：(纪元 << 1) | 1，不在读时为 0
+    int in_use;
+    ConcMap* map;
+    Table* limbo[3];            // 按退休时的纪元 % 3 分组的待回收表
+    uint64_t limbo_epoch[3];
+    size_t write_count;
+};
+
+struct ConcMap {
+    Segment* segs;
+    size_t seg_count;
+    unsigned seg_bits;          // 段号为哈希值的高 seg_bits 位
+
+    size_t key_size;
+    size_t value_size;
+    size_t key_offset;          // 键在槽位中的偏移（序号之后）
+    size_t value_offset;        // 值在槽位中的偏移
+    size_t slot_size;
+    hash64_fn hash;
+    hasht_eq_fn eq;             // NULL 表示按字节比较
+    uint64_t seed;
+    double max_load;
+
+    _Alignas(CONCMAP_CACHE_LINE) uint64_t epoch;
+    size_t thread_hwm;          // 曾经使用过的线程记录数，推进纪元时只扫描这些记录
+    size_t pending;             // 已退休未释放的表数
+
+    pthread_mutex_t orphan_lock;
+    Table* orphans;             // detach 时尚未到期的表，到期后由其他线程释放，无锁读取只用于判空
+
+    ConcMapThread threads[CONCMAP_MAX_THREADS];
+};
+
+static inline int keys_equal(const ConcMap* m, const void* a, const void* b) {
+    if (m->eq != NULL) {
+        return m->eq(a, b, m->key_size) == 0;
+    }
+    switch (m->key_size) {
+    case 4: {
+        uint32_t x, y;
+        memcpy(&x, a, 4);
+        memcpy(&y, b, 4);
+        return x == y;
+    }
+    case 8: {
+        uint64_t x, y;
+        memcpy(&x, a, 8);
+        memcpy(&y, b, 8);
+        return x == y;
+    }
+    default:
+        return memcmp(a, b, m->key_size) == 0;
+    }
+}
+
+static inline Segment* segment_of(const ConcMap* m, uint64_t h) {
+    return &m->segs[m->seg_bits != 0 ? (size_t)(h >> (64 - m->seg_bits)) : 0];
+}
+
+static inline uint8_t* slot_at(const ConcMap* m, const Table* tb, size_t i) {
+    return tb->slots + i * m->slot_size;
+}
+
+static inline uint32_t* slot_seq(uint8_t* slot) {
+    return (uint32_t*)slot;
+}
+
+static inline size_t max_occupied(size_t capacity, double max_load) {
+    size_t n = (size_t)((double)capacity * max_load);
+    // 至少留一个空槽位，保证未命中的查找能停止
+    return n >= capacity ? capacity - 1 : (n == 0 ? 1 : n);
+}
+
+static size_t capacity_for(size_t n, double max_load) {
+    size_t cap = CONCMAP_MIN_CAPACITY;
+    while (max_occupied(cap, max_load) < n) {
+        cap *= 2;
+    }
+    return cap;
+}
+
+static inline size_t value_align(size_t size) {
+    return size >= 8 ? 8 : (size >= 4 ? 4 : (size >= 2 ? 2 : 1));
+}
+
+static inline size_t round_up(size_t x, size_t a) {
+    return (x + a - 1) / a * a;
+}
+
+static Table* table_alloc(const ConcMap* m, size_t capacity) {
+    Table* tb = (Table*)malloc(sizeof(Table));
+    if (tb == NULL) {
+        return NULL;
+    }
+    tb->next = NULL;
+    tb->capacity = capacity;
+    tb->group_mask = capacity / HASHT_GROUP_WIDTH - 1;
+    tb->ctrl = (uint8_t*)aligned_alloc(HASHT_GROUP_WIDTH, capacity);
+    // 序号从 0 开始
+    tb->slots = (uint8_t*)calloc(capacity, m->slot_size);
+    if (tb->ctrl == NULL || tb->slots == NULL) {
+        free(tb->ctrl);
+        free(tb->slots);
+        free(tb);
+        return NULL;
+    }
+    memset(tb->ctrl, HASHT_EMPTY, capacity);
+    return tb;
+}
+
+static void free_tables(Table* tb) {
+    while (tb != NULL) {
+        Table* next = tb->next;
+        free(tb->ctrl);
+        free(tb->slots);
+        free(tb);
+        tb = next;
+    }
+}
+
+/*
+ 纪元
+*/
+static inline void epoch_enter(ConcMapThread* th) {
+    uint64_t e = __atomic_load_n(&th->map->epoch, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&th->epoch, (e << 1) | 1, __ATOMIC_RELAXED);
+    // 之后读表之前，推进纪元的线程一定能看到本线程已经进入纪元 e
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void epoch_exit(ConcMapThread* th) {
+    __atomic_store_n(&th->epoch, 0, __ATOMIC_RELEASE);
+}
+
+// 所有正在读的线程都已进入当前纪元时把纪元加 1（其他线程同时推进时 CAS 失败，无妨）
+static void epoch_try_advance(ConcMap* m) {
+    uint64_t e = __atomic_load_n(&m->epoch, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    size_t n = __atomic_load_n(&m->thread_hwm, __ATOMIC_ACQUIRE);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t s = __atomic_load_n(&m->threads[i].epoch, __ATOMIC_ACQUIRE);
+        if ((s & 1) != 0 && (s >> 1) != e) {
+            return;
+        }
+    }
+    __atomic_compare_exchange_n(&m->epoch, &e, e + 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+static inline int has_limbo(const ConcMapThread* th) {
+    return th->limbo[0] != NULL || th->limbo[1] != NULL || th->limbo[2] != NULL;
+}
+
+// 释放本线程在纪元 e - 2 及以前退休的表
+static void reclaim(ConcMapThread* th, uint64_t e) {
+    for (int i = 0; i < 3; i++) {
+        if (th->limbo[i] != NULL && th->limbo_epoch[i] + 2 <= e) {
+            size_t freed = 0;
+            for (Table* tb = th->limbo[i]; tb != NULL; tb = tb->next) {
+                freed++;
+            }
+            free_tables(th->limbo[i]);
+            th->limbo[i] = NULL;
+            __atomic_fetch_sub(&th->map->pending, freed, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static inline int has_orphans(const ConcMap* m) {
+    return __atomic_load_n(&m->orphans, __ATOMIC_ACQUIRE) != NULL;
+}
+
+// 释放孤儿链表中在纪元 e - 2 及以前退休的表
+static void reclaim_orphans(ConcMap* m, uint64_t e) {
+    if (!has_orphans(m)) {
+        return;
+    }
+    pthread_mutex_lock(&m->orphan_lock);
+    Table* kept = NULL;
+    size_t freed = 0;
+    for (Table* tb = m->orphans; tb != NULL;) {
+        Table* next = tb->next;
+        if (tb->retire_epoch + 2 <= e) {
+            tb->next = NULL;
+            free_tables(tb);
+            freed++;
+        } else {
+            tb->next = kept;
+            kept = tb;
+        }
+        tb = next;
+    }
+    __atomic_store_n(&m->orphans, kept, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&m->orphan_lock);
+    __atomic_fetch_sub(&m->pending, freed, __ATOMIC_RELAXED);
+}
+
+// 退休被替换的旧表
+static void retire(ConcMapThread* th, Table* tb) {
+    ConcMap* m = th->map;
+    epoch_try_advance(m);
+    uint64_t e = __atomic_load_n(&m->epoch, __ATOMIC_ACQUIRE);
+    reclaim(th, e);
+    reclaim_orphans(m, e);
+    // reclaim 之后 limbo[e % 3] 要么为空，要么就是纪元 e 的链表（更早的同余纪元 <= e - 3，已经释放）
+    size_t i = (size_t)(e % 3);
+    tb->next = th->limbo[i];
+    th->limbo[i] = tb;
+    th->limbo_epoch[i] = e;
+    tb->retire_epoch = e;
+    __atomic_fetch_add(&m->pending, 1, __ATOMIC_RELAXED);
+}
+
+// 写操作之后：有待回收的表（本线程的或孤儿）时定期推进纪元并回收
+static inline void after_write(ConcMapThread* th) {
+    ConcMap* m = th->map;
+    if (++th->write_count % CONCMAP_ADVANCE_INTERVAL == 0 && (has_limbo(th) || has_orphans(m))) {
+        epoch_try_advance(m);
+        uint64_t e = __atomic_load_n(&m->epoch, __ATOMIC_ACQUIRE);
+        reclaim(th, e);
+        reclaim_orphans(m, e);
+    }
+}
+
+/*
+ 写者修改槽位：begin 之后序号为奇数，end 之后为偶数
+*/
+static inline void write_begin(uint8_t* slot) {
+    uint32_t* seq = slot_seq(slot);
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void write_end(uint8_t* slot) {
+    uint32_t* seq = slot_seq(slot);
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ 段内的表
+*/
+
+// 写者（持有段锁）查找键所在的槽位，不存在返回 (size_t)-1
+static size_t find_slot(const ConcMap* m, const Table* tb, const void* key, uint64_t h) {
+    uint8_t h2 = hash_h2(h);
+    size_t g = hash_h1(h) & tb->group_mask;
+    for (size_t step = 0; step <= tb->group_mask; step++) {
+        const uint8_t* group = tb->ctrl + g * HASHT_GROUP_WIDTH;
+        uint32_t mt = group_match(group, h2);
+        while (mt != 0) {
+            size_t i = g * HASHT_GROUP_WIDTH + (size_t)__builtin_ctz(mt);
+            if (keys_equal(m, slot_at(m, tb, i) + m->key_offset, key)) {
+                return i;
+            }
+            mt &= mt - 1;
+        }
+        if (group_match_empty(group) != 0) {
+            break;
+        }
+        g = (g + step + 1) & tb->group_mask;
+    }
+    return (size_t)-1;
+}
+
+// 读者读取槽位 i：键匹配返回 1 并拷贝出值（value_out 不为NULL时），不匹配返回0
+static int read_slot(const ConcMap* m, const Table* tb, size_t i, const void* key, uint8_t h2, void* value_out) {
+    uint8_t* slot = slot_at(m, tb, i);
+    uint32_t* seq = slot_seq(slot);
+    for (int spins = 0;; spins++) {
+        uint32_t s1 = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+        if ((s1 & 1) == 0) {
+            int eq = keys_equal(m, slot + m->key_offset, key);
+            if (eq && value_out != NULL && m->value_size != 0) {
+                memcpy(value_out, slot + m->value_offset, m->value_size);
+            }
+            uint8_t c = __atomic_load_n(&tb->ctrl[i], __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(seq, __ATOMIC_RELAXED) == s1) {
+                return eq && c == h2;
+            }
+        }
+        if (spins >= CONCMAP_SPIN_LIMIT) {
+            sched_yield();
+        }
+    }
+}
+
+// 读者查找：找到返回0
+static int lookup(const ConcMap* m, const Table* tb, const void* key, uint64_t h, void* value_out) {
+    uint8_t h2 = hash_h2(h);
+    size_t g = hash_h1(h) & tb->group_mask;
+    for (size_t step = 0; step <= tb->group_mask; step++) {
+        const uint8_t* group = tb->ctrl + g * HASHT_GROUP_WIDTH;
+        uint32_t mt = group_match(group, h2);
+        while (mt != 0) {
+            if (read_slot(m, tb, g * HASHT_GROUP_WIDTH + (size_t)__builtin_ctz(mt), key, h2, value_out)) {
+                return 0;
+            }
+            mt &= mt - 1;
+        }
+        if (group_match_empty(group) != 0) {
+            break;
+        }
+        g = (g + step + 1) & tb->group_mask;
+    }
+    return -1;
+}
+
+// 沿探测序列找到第一个空或墓碑槽位（表中至少有一个空槽位）
+static size_t find_free_slot(const Table* tb, uint64_t h) {
+    size_t g = hash_h1(h) & tb->group_mask;
+    for (size_t step = 0;; step++) {
+        uint32_t mt = group_match_free(tb->ctrl + g * HASHT_GROUP_WIDTH);
+        if (mt != 0) {
+            return g * HASHT_GROUP_WIDTH + (size_t)__builtin_ctz(mt);
+        }
+        g = (g + step + 1) & tb->group_mask;
+    }
+}
+
+/*
+ 重建段的表（持有段锁）：墓碑较多时按原容量，否则容量加倍；建好后发布，返回被替换的旧表（由调用者在解锁后退休）
+ 失败返回NULL，段保持不变
+*/
+static Table* rebuild(const ConcMap* m, Segment* s) {
+    Table* old = s->table;
+    size_t limit = max_occupied(old->capacity, m->max_load);
+    size_t cap = s->size + 1 <= limit / 2 ? old->capacity : old->capacity * 2;
+    // 负载因子很小时容量加倍后可能仍放不下已有元素与这次插入
+    size_t min_cap = capacity_for(s->size + 1, m->max_load);
+    if (cap < min_cap) {
+        cap = min_cap;
+    }
+    Table* tb = table_alloc(m, cap);
+    if (tb == NULL) {
+        return NULL;
+    }
+    // 新表还没有发布，直接写
+    for (size_t i = 0; i < old->capacity; i++) {
+        if (old->ctrl[i] & 0x80) {
+            continue;
+        }
+        const uint8_t* src = slot_at(m, old, i);
+        uint64_t h = m->hash(src + m->key_offset, m->key_size, m->seed);
+        size_t j = find_free_slot(tb, h);
+        tb->ctrl[j] = hash_h2(h);
+        memcpy(slot_at(m, tb, j) + m->key_offset, src + m->key_offset, m->slot_size - m->key_offset);
+    }
+    s->growth_left = max_occupied(cap, m->max_load) - s->size;
+    s->tombstones = 0;
+    __atomic_store_n(&s->table, tb, __ATOMIC_RELEASE);
+    return old;
+}
+
+// 创建、销毁
+ConcMap* concmap_create(const ConcMapConfig* cfg) {
+    if (cfg == NULL || cfg->key_size == 0 || !(cfg->max_load >= 0.0 && cfg->max_load < 1.0)) {
+        return NULL;
+    }
+    ConcMap* m = (ConcMap*)aligned_alloc(CONCMAP_CACHE_LINE, sizeof(ConcMap));
+    if (m == NULL) {
+        return NULL;
+    }
+    memset(m, 0, sizeof(ConcMap));
+    m->key_size = cfg->key_size;
+    m->value_size = cfg->value_size;
+    size_t ka = value_align(cfg->key_size);
+    size_t va = cfg->value_size != 0 ? value_align(cfg->value_size) : 1;
+    size_t align = ka > va ? ka : va;
+    m->key_offset = round_up(sizeof(uint32_t), ka);
+    m->value_offset = round_up(m->key_offset + cfg->key_size, va);
+    m->slot_size = round_up(m->value_offset + cfg->value_size, align > sizeof(uint32_t) ? align : sizeof(uint32_t));
+    m->hash = cfg->hash != NULL ? cfg->hash : xxHash64;
+    m->eq = cfg->eq;
+    m->seed = cfg->seed;
+    m->max_load = cfg->max_load > 0.0 ? cfg->max_load : HASHT_DEFAULT_MAX_LOAD;
+
+    size_t want = cfg->segments != 0 ? cfg->segments : CONCMAP_DEFAULT_SEGMENTS;
+    m->seg_count = 1;
+    while (m->seg_count < want && m->seg_bits < 16) {
+        m->seg_count *= 2;
+        m->seg_bits++;
+    }
+    m->segs = (Segment*)aligned_alloc(CONCMAP_CACHE_LINE, m->seg_count * sizeof(Segment));
+    if (m->segs == NULL) {
+        free(m);
+        return NULL;
+    }
+    memset(m->segs, 0, m->seg_count * sizeof(Segment));
+    pthread_mutex_init(&m->orphan_lock, NULL);
+    size_t per_seg = (cfg->initial_capacity + m->seg_count - 1) / m->seg_count;
+    size_t cap = capacity_for(per_seg, m->max_load);
+    for (size_t i = 0; i < m->seg_count; i++) {
+        Segment* s = &m->segs[i];
+        s->table = table_alloc(m, cap);
+        if (s->table == NULL) {
+            m->seg_count = i;
+            concmap_free(m);
+            return NULL;
+        }
+        pthread_mutex_init(&s->lock, NULL);
+        s->growth_left = max_occupied(cap, m->max_load);
+    }
+    return m;
+}
+
+void concmap_free(ConcMap* map) {
+    if (map == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < map->seg_count; i++) {
+        free_tables(map->segs[i].table);
+        pthread_mutex_destroy(&map->segs[i].lock);
+    }
+    for (size_t i = 0; i < map->thread_hwm; i++) {
+        for (int k = 0; k < 3; k++) {
+            free_tables(map->threads[i].limbo[k]);
+        }
+    }
+    free_tables(map->orphans);
+    pthread_mutex_destroy(&map->orphan_lock);
+    free(map->segs);
+    free(map);
+}
+
+// 线程登记
+ConcMapThread* concmap_attach(ConcMap* map) {
+    for (size_t i = 0; i < CONCMAP_MAX_THREADS; i++) {
+        ConcMapThread* th = &map->threads[i];
+        int expected = 0;
+        if (!__atomic_compare_exchange_n(&th->in_use, &expected, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            continue;
+        }
+        th->map = map;
+        th->epoch = 0;
+        memset(th->limbo, 0, sizeof(th->limbo));
+        th->write_count = 0;
+        size_t hwm = __atomic_load_n(&map->thread_hwm, __ATOMIC_RELAXED);
+        while (hwm < i + 1 &&
+               !__atomic_compare_exchange_n(&map->thread_hwm, &hwm, i + 1, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+        return th;
+    }
+    return NULL;
+}
+
+void concmap_detach(ConcMapThread* th) {
+    ConcMap* m = th->map;
+    epoch_try_advance(m);
+    reclaim(th, __atomic_load_n(&m->epoch, __ATOMIC_ACQUIRE));
+    // 尚未到期的表带着各自的 retire_epoch 移到孤儿链表
+    pthread_mutex_lock(&m->orphan_lock);
+    Table* orphans = m->orphans;
+    for (int i = 0; i < 3; i++) {
+        while (th->limbo[i] != NULL) {
+            Table* tb = th->limbo[i];
+            th->limbo[i] = tb->next;
+            tb->next = orphans;
+            orphans = tb;
+        }
+    }
+    __atomic_store_n(&m->orphans, orphans, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&m->orphan_lock);
+    __atomic_store_n(&th->epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&th->in_use, 0, __ATOMIC_RELEASE);
+}
+
+// 读写
+int concmap_put(ConcMapThread* th, const void* key, const void* value) {
+    ConcMap* m = th->map;
+    uint64_t h = m->hash(key, m->key_size, m->seed);
+    Segment* s = segment_of(m, h);
+    Table* garbage = NULL;
+    int ret;
+    pthread_mutex_lock(&s->lock);
+    Table* tb = s->table;
+    size_t i = find_slot(m, tb, key, h);
+    if (i != (size_t)-1) {
+        uint8_t* slot = slot_at(m, tb, i);
+        write_begin(slot);
+        if (m->value_size != 0) {
+            memcpy(slot + m->value_offset, value, m->value_size);
+        }
+        write_end(slot);
+        ret = 0;
+    } else {
+        i = find_free_slot(tb, h);
+        if (tb->ctrl[i] == HASHT_EMPTY && s->growth_left == 0) {
+            garbage = rebuild(m, s);
+            if (garbage == NULL) {
+                pthread_mutex_unlock(&s->lock);
+                return -1;
+            }
+            tb = s->table;
+            i = find_free_slot(tb, h);
+        }
+        if (tb->ctrl[i] == HASHT_DELETED) {
+            s->tombstones--;
+        } else {
+            s->growth_left--;
+        }
+        uint8_t* slot = slot_at(m, tb, i);
+        write_begin(slot);
+        memcpy(slot + m->key_offset, key, m->key_size);
+        if (m->value_size != 0) {
+            memcpy(slot + m->value_offset, value, m->value_size);
+        }
+        __atomic_store_n(&tb->ctrl[i], hash_h2(h), __ATOMIC_RELAXED);
+        write_end(slot);
+        __atomic_store_n(&s->size, s->size + 1, __ATOMIC_RELAXED);
+        ret = 1;
+    }
+    pthread_mutex_unlock(&s->lock);
+    if (garbage != NULL) {
+        retire(th, garbage);
+    }
+    after_write(th);
+    return ret;
+}
+
+int concmap_get(ConcMapThread* th, const void* key, void* value_out) {
+    ConcMap* m = th->map;
+    uint64_t h = m->hash(key, m->key_size, m->seed);
+    Segment* s = segment_of(m, h);
+    epoch_enter(th);
+    int ret = lookup(m, __atomic_load_n(&s->table, __ATOMIC_ACQUIRE), key, h, value_out);
+    epoch_exit(th);
+    return ret;
+}
+
+int concmap_remove(ConcMapThread* th, const void* key, void* value_out) {
+    ConcMap* m = th->map;
+    uint64_t h = m->hash(key, m->key_size, m->seed);
+    Segment* s = segment_of(m, h);
+    pthread_mutex_lock(&s->lock);
+    Table* tb = s->table;
+    size_t i = find_slot(m, tb, key, h);
+    if (i == (size_t)-1) {
+        pthread_mutex_unlock(&s->lock);
+        return -1;
+    }
+    uint8_t* slot = slot_at(m, tb, i);
+    if (value_out != NULL && m->value_size != 0) {
+        memcpy(value_out, slot + m->value_offset, m->value_size);
+    }
+    // 组内还有空槽位时没有探测路径经过这一组，可以直接置空，否则留墓碑；槽位内容保留，读者靠控制字节判断已删除
+    uint8_t* group = tb->ctrl + (i & ~(size_t)(HASHT_GROUP_WIDTH - 1));
+    write_begin(slot);
+    if (group_match_empty(group) != 0) {
+        __atomic_store_n(&tb->ctrl[i], HASHT_EMPTY, __ATOMIC_RELAXED);
+        s->growth_left++;
+    } else {
+        __atomic_store_n(&tb->ctrl[i], HASHT_DELETED, __ATOMIC_RELAXED);
+        s->tombstones++;
+    }
+    write_end(slot);
+    __atomic_store_n(&s->size, s->size - 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&s->lock);
+    after_write(th);
+    return 0;
+}
+
+// 统计
+size_t concmap_size(const ConcMap* map) {
+    size_t n = 0;
+    for (size_t i = 0; i < map->seg_count; i++) {
+        n += __atomic_load_n(&map->segs[i].size, __ATOMIC_RELAXED);
+    }
+    return n;
+}
+
+size_t concmap_segments(const ConcMap* map) {
+    return map->seg_count;
+}
+
+uint64_t concmap_epoch(const ConcMap* map) {
+    return __atomic_load_n(&map->epoch, __ATOMIC_ACQUIRE);
+}
+
+size_t concmap_pending(const ConcMap* map) {
+    return __atomic_load_n(&map->pending, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,101 @@
+#ifndef CONCMAP_H
+#define CONCMAP_H
+
+#include "hasht.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ 并发哈希表：分段锁 + 无锁读（基于纪元的内存回收），与 hasht.h 使用相同的分组探测结构
+ （1）按哈希值的高位分成若干段（2 的幂），每段是一张独立的分组探测表和一把互斥锁；写操作只锁所在的段，
+      不同段的写互不阻塞
+ （2）读不加锁：键值直接存在槽位里，每个槽位带一个序号，写者修改槽位前后各把序号加 1（顺序锁 seqlock）；
+      读者读槽位前后比较序号，不一致就重读，不会读到写了一半的值
+ （3）扩容只锁本段：在锁内建好新表后原子地替换段的表指针，读者继续使用旧表直到读完，其他段不受影响
+ （4）被替换的旧表不能立即释放（可能有读者正在访问），放入当前线程的待回收链表，
+      等所有线程都离开了当时的纪元后再释放（epoch-based reclamation）
+ 使用方式：每个线程先 concmap_attach 取得线程句柄，之后用句柄调用读写接口，线程结束前 concmap_detach
+*/
+
+typedef struct {
+    size_t key_size;            // 键的字节数，> 0
+    size_t value_size;          // 值的字节数，可以为 0（当作集合使用）
+    hash64_fn hash;             // 为NULL时使用 xxHash64；高位选段，其余位在段内选组
+    hasht_eq_fn eq;             // 为NULL时使用 memcmp
+    uint64_t seed;              // 传给哈希函数的种子
+    size_t segments;            // 段数，向上取整为 2 的幂，为 0 时使用 CONCMAP_DEFAULT_SEGMENTS
+    double max_load;            // 每段的最大负载因子，(0, 1)，为 0 时使用 HASHT_DEFAULT_MAX_LOAD
+    size_t initial_capacity;    // 预计的元素总数，平均分到各段
+} ConcMapConfig;
+
+#define CONCMAP_DEFAULT_SEGMENTS 64
+
+// 可以同时 attach 的线程数上限
+#define CONCMAP_MAX_THREADS 256
+
+typedef struct ConcMap ConcMap;
+typedef struct ConcMapThread ConcMapThread;
+
+/**
+* @brief             创建并发哈希表
+* @param cfg         配置，创建后可以释放
+* @return            成功返回哈希表；key_size 为 0、max_load 不在 [0, 1) 内或内存不足返回NULL
+*/
+ConcMap* concmap_create(const ConcMapConfig* cfg);
+
+/**
+* @brief             销毁哈希表，释放全部元素与待回收的内存，map 为NULL时不做任何事
+* @note              调用时不能再有线程在使用哈希表（句柄不需要先 detach）
+*/
+void concmap_free(ConcMap* map);
+
+/**
+* @brief             当前线程登记为哈希表的使用者
+* @return            线程句柄，只能在本线程使用；登记的线程数达到 CONCMAP_MAX_THREADS 返回NULL
+*/
+ConcMapThread* concmap_attach(ConcMap* map);
+
+/**
+* @brief             注销线程句柄，之后不能再使用；尚未到期的待回收内存转交给哈希表，到期后由其他线程的写操作释放
+*/
+void concmap_detach(ConcMapThread* th);
+
+/**
+* @brief             插入或更新
+* @param value       值，value_size 为 0 时可以为NULL
+* @return            新插入返回 1，键已存在（值被替换）返回0，内存不足返回 -1
+*/
+int concmap_put(ConcMapThread* th, const void* key, const void* value);
+
+/**
+* @brief             查找（不加锁）
+* @param value_out   不为NULL时拷贝出值
+* @return            找到返回0，不存在返回 -1
+* @note              与同一个键的并发写之间，读到写之前或写之后的值；未找到时 value_out 的内容不确定
+*/
+int concmap_get(ConcMapThread* th, const void* key, void* value_out);
+
+/**
+* @brief             删除
+* @param value_out   不为NULL时拷贝出被删除的值
+* @return            删除成功返回0，键不存在返回 -1
+*/
+int concmap_remove(ConcMapThread* th, const void* key, void* value_out);
+
+// 元素数（各段分别统计后相加，有并发写时只是近似值）
+size_t concmap_size(const ConcMap* map);
+size_t concmap_segments(const ConcMap* map);
+// 当前纪元，每推进一次说明所有线程都离开过上一个纪元
+uint64_t concmap_epoch(const ConcMap* map);
+// 扩容后被替换、尚未释放的旧表数
+size_t concmap_pending(const ConcMap* map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONCMAP_H
@@ -0,0 +1,383 @@
+#include "crc.h"
+#include "hashalg_util.h"
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ CRC（循环冗余校验）：把数据看作 GF(2) 上的多项式 M(x)，CRC 是 M(x)·x^n 除以生成多项式 P(x) 的余数
+ 算法特点：
+ - 线性：CRC(A xor B) = CRC(A) xor CRC(B)（不计初值），因此可以分段计算再合并
+ - 检错能力强：能检出所有奇数个位错误、所有长度不超过 n 的突发错误，适合存储与网络传输的完整性校验
+ - 不适合做哈希表的哈希函数：输出是输入的线性函数，雪崩效应差，也不能抵抗人为构造的碰撞
+ 实现方式：
+ （1）逐字节查表：每个字节查一次 256 项的表，每字节都依赖上一字节的结果，约 1 字节/周期以下
+ （2）slicing-by-8：8 张表，每次处理 8 个字节，8 次查表互不依赖，可以并行执行
+ （3）SSE4.2 crc32 指令（仅 CRC-32C 多项式）：每条指令处理 8 字节，延迟 3 周期、吞吐 1 条/周期，
+      单条依赖链只能用到 1/3 的吞吐，所以把缓冲区切成三段并行计算，再用 "移位" 运算合并
+ （4）PCLMULQDQ 折叠（任意多项式）：无进位乘法把 128 位的累加值 "折叠" 到后面 128 位的数据上，
+      最后剩下的 128 位再用查表求余
+ 反射形式：数据低位在前，64 位寄存器的第 i 位对应 x^(63-i)（CRC-32 同理对应 x^(31-i)）
+*/
+
+#define CRC32_IEEE_POLY 0xEDB88320u
+#define CRC32C_POLY     0x82F63B78u
+#define CRC64_XZ_POLY   0xC96C5795D7870F42ULL
+
+// 三路并行的分段长度：长缓冲区每段 4096 字节，剩余部分每段 256 字节
+#define CRC32C_LONG  4096
+#define CRC32C_SHORT 256
+
+static uint32_t g_crc32_ieee_table[8][256];
+static uint32_t g_crc32c_table[8][256];
+static uint64_t g_crc64_table[8][256];
+
+// 把 CRC-32C 寄存器向后 "移位" n 个零字节的线性变换，按字节拆成 4 张表：shift(r) = T[0][r & 0xff] ^ ... ^ T[3][r >> 24]
+static uint32_t g_crc32c_shift_long[2][4][256];     // [0]：CRC32C_LONG 字节，[1]：2 * CRC32C_LONG 字节
+static uint32_t g_crc32c_shift_short[2][4][256];
+
+static uint64_t g_crc64_fold_k[4];                  // x^191, x^127, x^575, x^511 mod P
+
+static pthread_once_t g_crc_once = PTHREAD_ONCE_INIT;
+
+/* ---------- GF(2) 多项式运算（反射形式） ---------- */
+
+// a(x)·b(x) mod P(x)，32 位反射形式
+static uint32_t crc32_multmodp(uint32_t a, uint32_t b, uint32_t poly) {
+    uint32_t m = 1u << 31;
+    uint32_t p = 0;
+    if (a == 0) {
+        return 0;
+    }
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) {
+                break;
+            }
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ poly : b >> 1;
+    }
+    return p;
+}
+
+// x^n mod P(x)，32 位反射形式
+static uint32_t crc32_xnmodp(size_t n, uint32_t poly) {
+    uint32_t p = 1u << 31;              // x^0
+    while (n-- > 0) {
+        p = (p & 1) ? (p >> 1) ^ poly : p >> 1;
+    }
+    return p;
+}
+
+// x^n mod P(x)，64 位反射形式
+static uint64_t crc64_xnmodp(size_t n, uint64_t poly) {
+    uint64_t p = 1ULL << 63;
+    while (n-- > 0) {
+        p = (p & 1) ? (p >> 1) ^ poly : p >> 1;
+    }
+    return p;
+}
+
+// 生成 "寄存器后接 nbytes 个零字节" 的移位表：寄存器 r 移位后等于 r(x)·x^(8·nbytes) mod P
+static void crc32_make_shift_table(uint32_t table[4][256], size_t nbytes, uint32_t poly) {
+    uint32_t k = crc32_xnmodp(8 * nbytes, poly);
+    for (int i = 0; i < 4; i++) {
+        for (uint32_t b = 0; b < 256; b++) {
+            table[i][b] = crc32_multmodp(b << (8 * i), k, poly);
+        }
+    }
+}
+
+static inline uint32_t crc32_shift(const uint32_t table[4][256], uint32_t r) {
+    return table[0][r & 0xff] ^ table[1][(r >> 8) & 0xff] ^ table[2][(r >> 16) & 0xff] ^ table[3][r >> 24];
+}
+
+static void crc32_make_slice8(uint32_t table[8][256], uint32_t poly) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? (c >> 1) ^ poly : c >> 1;
+        }
+        table[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int t = 1; t < 8; t++) {
+            table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xff];
+        }
+    }
+}
+
+static void crc64_make_slice8(uint64_t table[8][256], uint64_t poly) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint64_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? (c >> 1) ^ poly : c >> 1;
+        }
+        table[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int t = 1; t < 8; t++) {
+            table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xff];
+        }
+    }
+}
+
+// 所有表只生成一次，多线程首次调用时由 pthread_once 保证只初始化一次
+static void crc_init_tables(void) {
+    crc32_make_slice8(g_crc32_ieee_table, CRC32_IEEE_POLY);
+    crc32_make_slice8(g_crc32c_table, CRC32C_POLY);
+    crc64_make_slice8(g_crc64_table, CRC64_XZ_POLY);
+    crc32_make_shift_table(g_crc32c_shift_long[0], CRC32C_LONG, CRC32C_POLY);
+    crc32_make_shift_table(g_crc32c_shift_long[1], 2 * CRC32C_LONG, CRC32C_POLY);
+    crc32_make_shift_table(g_crc32c_shift_short[0], CRC32C_SHORT, CRC32C_POLY);
+    crc32_make_shift_table(g_crc32c_shift_short[1], 2 * CRC32C_SHORT, CRC32C_POLY);
+    // 无进位乘法的积比真实的多项式乘积多乘了一个 x，所以折叠 N 位用 x^(N-1) 而不是 x^N
+    g_crc64_fold_k[0] = crc64_xnmodp(128 + 64 - 1, CRC64_XZ_POLY);
+    g_crc64_fold_k[1] = crc64_xnmodp(128 - 1, CRC64_XZ_POLY);
+    g_crc64_fold_k[2] = crc64_xnmodp(512 + 64 - 1, CRC64_XZ_POLY);
+    g_crc64_fold_k[3] = crc64_xnmodp(512 - 1, CRC64_XZ_POLY);
+}
+
+static inline void crc_ensure_tables(void) {
+    pthread_once(&g_crc_once, crc_init_tables);
+}
+
+/* ---------- slicing-by-8 ---------- */
+
+// crc 为不含初值/输出异或的寄存器值
+static uint32_t crc32_slice8(const uint32_t table[8][256], uint32_t crc, const uint8_t* p, size_t len) {
+    while (len >= 8) {
+        uint32_t one = hash_load32(p) ^ crc;
+        uint32_t two = hash_load32(p + 4);
+        crc = table[7][one & 0xff] ^ table[6][(one >> 8) & 0xff] ^
+              table[5][(one >> 16) & 0xff] ^ table[4][one >> 24] ^
+              table[3][two & 0xff] ^ table[2][(two >> 8) & 0xff] ^
+              table[1][(two >> 16) & 0xff] ^ table[0][two >> 24];
+        p += 8;
+        len -= 8;
+    }
+    while (len-- > 0) {
+        crc = (crc >> 8) ^ table[0][(crc ^ *p++) & 0xff];
+    }
+    return crc;
+}
+
+static uint64_t crc64_slice8(uint64_t crc, const uint8_t* p, size_t len) {
+    const uint64_t (*table)[256] = g_crc64_table;
+    while (len >= 8) {
+        uint64_t v = hash_load64(p) ^ crc;
+        crc = table[7][v & 0xff] ^ table[6][(v >> 8) & 0xff] ^
+              table[5][(v >> 16) & 0xff] ^ table[4][(v >> 24) & 0xff] ^
+              table[3][(v >> 32) & 0xff] ^ table[2][(v >> 40) & 0xff] ^
+              table[1][(v >> 48) & 0xff] ^ table[0][v >> 56];
+        p += 8;
+        len -= 8;
+    }
+    while (len-- > 0) {
+        crc = (crc >> 8) ^ table[0][(crc ^ *p++) & 0xff];
+    }
+    return crc;
+}
+
+uint32_t crc32_ieee_update(uint32_t crc, const void* data, size_t len) {
+    crc_ensure_tables();
+    return ~crc32_slice8(g_crc32_ieee_table, ~crc, (const uint8_t*)data, len);
+}
+
+uint32_t crc32_ieee(const void* data, size_t len) {
+    return crc32_ieee_update(0, data, len);
+}
+
+uint32_t crc32c_update_sw(uint32_t crc, const void* data, size_t len) {
+    crc_ensure_tables();
+    return ~crc32_slice8(g_crc32c_table, ~crc, (const uint8_t*)data, len);
+}
+
+uint64_t crc64_update_sw(uint64_t crc, const void* data, size_t len) {
+    crc_ensure_tables();
+    return ~crc64_slice8(~crc, (const uint8_t*)data, len);
+}
+
+/* ---------- 硬件加速 ---------- */
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define CRC_HAVE_X86 1
+#include <immintrin.h>
+
+/**
+* @brief             SSE4.2 计算 CRC-32C，三路并行
+* @param   crc       寄存器值（不含初值/输出异或）
+*
+* @note              三段 A、B、C 各自独立地用 crc32 指令计算（B、C 的寄存器从 0 开始），
+*                    合并时 A 需要 "经过" B、C 两段的长度，B 需要经过 C 的长度：
+*                    crc = shift(2n, a) ^ shift(n, b) ^ c，移位用预先生成的 4 张字节表完成
+*/
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const uint8_t* p, size_t len) {
+    uint64_t a = crc;
+    while (len >= 3 * CRC32C_LONG) {
+        uint64_t b = 0;
+        uint64_t c = 0;
+        for (size_t i = 0; i < CRC32C_LONG; i += 8) {
+            a = _mm_crc32_u64(a, hash_load64(p + i));
+            b = _mm_crc32_u64(b, hash_load64(p + CRC32C_LONG + i));
+            c = _mm_crc32_u64(c, hash_load64(p + 2 * CRC32C_LONG + i));
+        }
+        a = crc32_shift(g_crc32c_shift_long[1], (uint32_t)a) ^
+            crc32_shift(g_crc32c_shift_long[0], (uint32_t)b) ^ (uint32_t)c;
+        p += 3 * CRC32C_LONG;
+        len -= 3 * CRC32C_LONG;
+    }
+    while (len >= 3 * CRC32C_SHORT) {
+        uint64_t b = 0;
+        uint64_t c = 0;
+        for (size_t i = 0; i < CRC32C_SHORT; i += 8) {
+            a = _mm_crc32_u64(a, hash_load64(p + i));
+            b = _mm_crc32_u64(b, hash_load64(p + CRC32C_SHORT + i));
+            c = _mm_crc32_u64(c, hash_load64(p + 2 * CRC32C_SHORT + i));
+        }
+        a = crc32_shift(g_crc32c_shift_short[1], (uint32_t)a) ^
+            crc32_shift(g_crc32c_shift_short[0], (uint32_t)b) ^ (uint32_t)c;
+        p += 3 * CRC32C_SHORT;
+        len -= 3 * CRC32C_SHORT;
+    }
+    while (len >= 8) {
+        a = _mm_crc32_u64(a, hash_load64(p));
+        p += 8;
+        len -= 8;
+    }
+    uint32_t r = (uint32_t)a;
+    while (len-- > 0) {
+        r = _mm_crc32_u8(r, *p++);
+    }
+    return r;
+}
+
+// 128 位累加值向后折叠：acc·x^N ≡ lo·k[0] ^ hi·k[1]（k 为折叠 N 位的一对常数）
+__attribute__((target("pclmul,sse2")))
+static inline __m128i crc64_fold(__m128i acc, __m128i k) {
+    return _mm_xor_si128(_mm_clmulepi64_si128(acc, k, 0x00), _mm_clmulepi64_si128(acc, k, 0x11));
+}
+
+/**
+* @brief             PCLMULQDQ 折叠计算 CRC-64，要求 len >= 64
+* @param   crc       寄存器值（不含初值/输出异或）
+*
+* @note              把数据看作多项式 M(x)，寄存器初值异或到前 8 个字节上之后，CRC = M(x)·x^64 mod P。
+*                    四个 128 位累加器每次吃 64 字节（折叠 512 位），再合并为一个累加器按 16 字节折叠，
+*                    最后剩下的 128 位累加值 A 满足 A ≡ M（不计尾部），A·x^64 mod P 正好是
+*                    "以 0 为初值对 A 的 16 个字节求 CRC"，用查表完成，再接着处理不足 16 字节的尾部
+*/
+__attribute__((target("pclmul,sse2")))
+static uint64_t crc64_pclmul(uint64_t crc, const uint8_t* p, size_t len) {
+    const __m128i k128 = _mm_set_epi64x((long long)g_crc64_fold_k[1], (long long)g_crc64_fold_k[0]);
+    const __m128i k512 = _mm_set_epi64x((long long)g_crc64_fold_k[3], (long long)g_crc64_fold_k[2]);
+
+    __m128i x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)p), _mm_set_epi64x(0, (long long)crc));
+    __m128i x1 = _mm_loadu_si128((const __m128i*)(p + 16));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)(p + 32));
+    __m128i x3 = _mm_loadu_si128((const __m128i*)(p + 48));
+    p += 64;
+    len -= 64;
+
+    while (len >= 64) {
+        x0 = _mm_xor_si128(crc64_fold(x0, k512), _mm_loadu_si128((const __m128i*)p));
+        x1 = _mm_xor_si128(crc64_fold(x1, k512), _mm_loadu_si128((const __m128i*)(p + 16)));
+        x2 = _mm_xor_si128(crc64_fold(x2, k512), _mm_loadu_si128((const __m128i*)(p + 32)));
+        x3 = _mm_xor_si128(crc64_fold(x3, k512), _mm_loadu_si128((const __m128i*)(p + 48)));
+        p += 64;
+        len -= 64;
+    }
+
+    // 四个累加器依次折叠到后一个上
+    x1 = _mm_xor_si128(crc64_fold(x0, k128), x1);
+    x2 = _mm_xor_si128(crc64_fold(x1, k128), x2);
+    x3 = _mm_xor_si128(crc64_fold(x2, k128), x3);
+
+    while (len >= 16) {
+        x3 = _mm_xor_si128(crc64_fold(x3, k128), _mm_loadu_si128((const __m128i*)p));
+        p += 16;
+        len -= 16;
+    }
+
+    uint8_t rest[16];
+    _mm_storeu_si128((__m128i*)rest, x3);
+    crc = crc64_slice8(0, rest, 16);
+    return crc64_slice8(crc, p, len);
+}
+
+static pthread_once_t g_crc_cpu_once = PTHREAD_ONCE_INIT;
+static int g_has_sse42 = 0;
+static int g_has_pclmul = 0;
+
+static void crc_init_cpu(void) {
+    __builtin_cpu_init();
+    g_has_pclmul = __builtin_cpu_supports("pclmul") ? 1 : 0;
+    g_has_sse42 = __builtin_cpu_supports("sse4.2") ? 1 : 0;
+}
+
+// 与查表初始化一样走 pthread_once，多线程并发首次调用时不会对两个标志产生数据竞争
+static inline void crc_detect_cpu(void) {
+    pthread_once(&g_crc_cpu_once, crc_init_cpu);
+}
+#else
+#define CRC_HAVE_X86 0
+#endif
+
+int crc32c_hw_available(void) {
+#if CRC_HAVE_X86
+    crc_detect_cpu();
+    return g_has_sse42;
+#else
+    return 0;
+#endif
+}
+
+int crc64_clmul_available(void) {
+#if CRC_HAVE_X86
+    crc_detect_cpu();
+    return g_has_pclmul;
+#else
+    return 0;
+#endif
+}
+
+uint32_t crc32c_update_hw(uint32_t crc, const void* data, size_t len) {
+#if CRC_HAVE_X86
+    if (crc32c_hw_available()) {
+        crc_ensure_tables();
+        return ~crc32c_sse42(~crc, (const uint8_t*)data, len);
+    }
+#endif
+    return crc32c_update_sw(crc, data, len);
+}
+
+uint64_t crc64_update_clmul(uint64_t crc, const void* data, size_t len) {
+#if CRC_HAVE_X86
+    // 少于 64 字节时折叠的准备与收尾开销大于收益
+    if (len >= 64 && crc64_clmul_available()) {
+        crc_ensure_tables();
+        return ~crc64_pclmul(~crc, (const uint8_t*)data, len);
+    }
+#endif
+    return crc64_update_sw(crc, data, len);
+}
+
+uint32_t crc32c_update(uint32_t crc, const void* data, size_t len) {
+    return crc32c_update_hw(crc, data, len);
+}
+
+uint32_t crc32c(const void* data, size_t len) {
+    return crc32c_update(0, data, len);
+}
+
+uint64_t crc64_update(uint64_t crc, const void* data, size_t len) {
+    return crc64_update_clmul(crc, data, len);
+}
+
+uint64_t crc64(const void* data, size_t len) {
+    return crc64_update(0, data, len);
+}
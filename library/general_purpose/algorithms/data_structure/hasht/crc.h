@@ -0,0 +1,46 @@
+#ifndef CRC_H
+#define CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ CRC 校验（循环冗余校验）
+ （1）三种 CRC：CRC-32（IEEE 802.3，与 zlib 的 crc32 相同）、CRC-32C（Castagnoli，iSCSI/ext4/SSE4.2 使用）、
+      CRC-64/XZ（ECMA-182 多项式，xz/7-Zip 使用），都是反射（低位在前）形式，初值与输出异或值都是全 1
+ （2）流式接口与 zlib 相同：crc = xxx_update(0, buf1, len1); crc = xxx_update(crc, buf2, len2); ...
+      分段计算的结果与一次计算整块数据相同
+ （3）硬件加速：CRC-32C 使用 SSE4.2 的 crc32 指令（三路并行），CRC-64 使用 PCLMULQDQ 折叠，
+      运行时检测 CPU，不支持时使用 slicing-by-8 查表实现；_sw / _hw / _clmul 版本供测试与基准测试直接调用
+*/
+
+// CRC-32（IEEE），与 zlib 的 crc32(crc, buf, len) 结果相同
+uint32_t crc32_ieee_update(uint32_t crc, const void* data, size_t len);
+uint32_t crc32_ieee(const void* data, size_t len);
+
+// CRC-32C（Castagnoli）
+uint32_t crc32c_update(uint32_t crc, const void* data, size_t len);
+uint32_t crc32c(const void* data, size_t len);
+// slicing-by-8 查表版本
+uint32_t crc32c_update_sw(uint32_t crc, const void* data, size_t len);
+// SSE4.2 版本，CPU 不支持时回退到查表版本
+uint32_t crc32c_update_hw(uint32_t crc, const void* data, size_t len);
+int crc32c_hw_available(void);
+
+// CRC-64/XZ
+uint64_t crc64_update(uint64_t crc, const void* data, size_t len);
+uint64_t crc64(const void* data, size_t len);
+uint64_t crc64_update_sw(uint64_t crc, const void* data, size_t len);
+// PCLMULQDQ 折叠版本，CPU 不支持时回退到查表版本
+uint64_t crc64_update_clmul(uint64_t crc, const void* data, size_t len);
+int crc64_clmul_available(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_H
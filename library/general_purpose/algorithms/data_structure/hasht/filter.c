@@ -0,0 +1,501 @@
+#include "filter.h"
+#include "hashalg.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ 分块布隆过滤器（Putze 2007 的 cache-blocked Bloom filter，块内按字分片，类似 Impala / Parquet 的 split block Bloom filter）
+ （1）标准布隆过滤器的 k 个位散落在整个位数组里，查询一个键要访问 k 条缓存行；
+      分块后每个键只访问一个 64 字节的块，一次查询最多一次缓存未命中
+ （2）块内 16 个 32 位字，键在从 start 开始的连续 k 个字（模 16）中各置 1 位：同一个键的 k 个位不会落在同一个字里，
+      不同的键从不同的字开始，k < 16 时也能用满整个块；第 w 个字里的位由 低 32 位 * 常量[w] 的高 5 位决定
+ （3）AVX2：16 个字的位掩码分两个 256 位寄存器，一条 mullo + srli + sllv 算出 8 个字的位，
+      不属于这个键的字用比较生成的掩码清零；查询用 testc 判断 "掩码中的位在块中都为 1"
+ （4）假阳性率：块内的键数近似服从均值 λ = n / 块数 的泊松分布，每个键使某一位为 1 的概率为 k / 512，
+      块内有 i 个键时查询的假阳性率为 (1 - (1 - k/512)^i)^k，按泊松分布加权求和
+
+ 布谷鸟过滤器（Fan 2014）
+ （1）每桶 4 个槽位存指纹（0 表示空槽位，指纹为 0 时改为 1），槽位按指纹位数紧凑存储；
+      键的两个候选桶 i1 = 哈希高 32 位 * 桶数 >> 32、i2 = (t - i1) mod 桶数（t 由指纹的哈希决定），
+      由任一候选桶和指纹就能算出另一个，所以踢出时不需要原来的键；
+      不用异或（要求桶数为 2 的幂），桶数可以按负载精确确定，不会因为向上取整多占将近一倍的内存
+ （2）两个候选桶都满时随机踢出一个指纹，把它移到它的另一个候选桶，最多踢 CUCKOO_FILTER_MAX_KICKS 次
+ （3）查询只比较两个桶的 8 个指纹，假阳性率约为 8 / 2^指纹位数
+*/
+
+static const _Alignas(32) uint32_t kBloomSalt[BLOOM_BLOCK_WORDS] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+    0x9e3779b1U, 0x85ebca77U, 0xc2b2ae3dU, 0x27d4eb2fU, 0x165667b1U, 0xd3a2646dU, 0xfd7046c5U, 0xb55a4f09U,
+};
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define FILTER_HAVE_AVX2 1
+#include <immintrin.h>
+#else
+#define FILTER_HAVE_AVX2 0
+#endif
+
+struct BloomFilter {
+    uint32_t* words;            // nblocks * 16 个字，64 字节对齐
+    size_t nblocks;
+    unsigned k;
+    int use_avx2;
+};
+
+double bloom_fpr(size_t nblocks, unsigned k, size_t n) {
+    if (nblocks == 0 || k == 0 || k > BLOOM_BLOCK_WORDS) {
+        return 1.0;
+    }
+    if (n == 0) {
+        return 0.0;
+    }
+    double lambda = (double)n / (double)nblocks;
+    double q = log1p(-(double)k / (BLOOM_BLOCK_BYTES * 8));
+    // 泊松分布的质量集中在 λ ± 12 sqrt(λ) 之内
+    double spread = 12.0 * sqrt(lambda) + 40.0;
+    size_t lo = lambda > spread ? (size_t)(lambda - spread) : 0;
+    size_t hi = (size_t)(lambda + spread);
+    double fpr = 0.0;
+    for (size_t i = lo; i <= hi; i++) {
+        double p = exp((double)i * log(lambda) - lambda - lgamma((double)i + 1.0));
+        fpr += p * pow(-expm1((double)i * q), (double)k);
+    }
+    return fpr < 1.0 ? fpr : 1.0;
+}
+
+int bloom_params(size_t n, double fpr, size_t* nblocks, unsigned* k) {
+    if (!(fpr > 0.0 && fpr < 1.0) || nblocks == NULL || k == NULL) {
+        return -1;
+    }
+    size_t best = 0;
+    unsigned best_k = 0;
+    for (unsigned kk = 1; kk <= BLOOM_BLOCK_WORDS; kk++) {
+        // 倍增找到上界，再二分找到满足要求的最少块数
+        size_t hi = 1;
+        while (bloom_fpr(hi, kk, n) > fpr) {
+            if (hi > UINT32_MAX / 2) {
+                hi = 0;
+                break;
+            }
+            hi *= 2;
+        }
+        if (hi == 0) {
+            continue;
+        }
+        size_t lo = hi / 2 + 1;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (bloom_fpr(mid, kk, n) <= fpr) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        if (best == 0 || hi < best) {
+            best = hi;
+            best_k = kk;
+        }
+    }
+    if (best == 0) {
+        return -1;
+    }
+    *nblocks = best;
+    *k = best_k;
+    return 0;
+}
+
+BloomFilter* bloom_create_blocks(size_t nblocks, unsigned k) {
+    if (nblocks == 0 || nblocks > UINT32_MAX || k == 0 || k > BLOOM_BLOCK_WORDS) {
+        return NULL;
+    }
+    BloomFilter* f = (BloomFilter*)malloc(sizeof(BloomFilter));
+    if (f == NULL) {
+        return NULL;
+    }
+    f->words = (uint32_t*)aligned_alloc(BLOOM_BLOCK_BYTES, nblocks * BLOOM_BLOCK_BYTES);
+    if (f->words == NULL) {
+        free(f);
+        return NULL;
+    }
+    memset(f->words, 0, nblocks * BLOOM_BLOCK_BYTES);
+    f->nblocks = nblocks;
+    f->k = k;
+    f->use_avx2 = hash_cpu_has_avx2();
+    return f;
+}
+
+BloomFilter* bloom_create(size_t n, double fpr) {
+    size_t nblocks;
+    unsigned k;
+    if (bloom_params(n, fpr, &nblocks, &k) != 0) {
+        return NULL;
+    }
+    return bloom_create_blocks(nblocks, k);
+}
+
+void bloom_free(BloomFilter* filter) {
+    if (filter == NULL) {
+        return;
+    }
+    free(filter->words);
+    free(filter);
+}
+
+void bloom_clear(BloomFilter* filter) {
+    memset(filter->words, 0, filter->nblocks * BLOOM_BLOCK_BYTES);
+}
+
+// 高 32 位：乘法取区间选块（块数不必是 2 的幂），低 4 位选起始字
+static inline uint32_t* bloom_block(const BloomFilter* f, uint64_t h, unsigned* start) {
+    uint32_t hi = (uint32_t)(h >> 32);
+    *start = hi & (BLOOM_BLOCK_WORDS - 1);
+    return f->words + (size_t)(((uint64_t)hi * f->nblocks) >> 32) * BLOOM_BLOCK_WORDS;
+}
+
+static inline uint32_t bloom_bit(uint32_t lo, unsigned w) {
+    return 1u << ((lo * kBloomSalt[w]) >> 27);
+}
+
+void bloom_add_hash_scalar(BloomFilter* filter, uint64_t h) {
+    unsigned start;
+    uint32_t* block = bloom_block(filter, h, &start);
+    for (unsigned j = 0; j < filter->k; j++) {
+        unsigned w = (start + j) & (BLOOM_BLOCK_WORDS - 1);
+        block[w] |= bloom_bit((uint32_t)h, w);
+    }
+}
+
+int bloom_contains_hash_scalar(const BloomFilter* filter, uint64_t h) {
+    unsigned start;
+    const uint32_t* block = bloom_block(filter, h, &start);
+    for (unsigned j = 0; j < filter->k; j++) {
+        unsigned w = (start + j) & (BLOOM_BLOCK_WORDS - 1);
+        uint32_t bit = bloom_bit((uint32_t)h, w);
+        if ((block[w] & bit) == 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+#if FILTER_HAVE_AVX2
+// 16 个字的位掩码：m0 为第 0 ~ 7 个字，m1 为第 8 ~ 15 个字；不属于这个键的字为 0
+__attribute__((target("avx2")))
+static inline void bloom_masks_avx2(uint64_t h, unsigned start, unsigned k, __m256i* m0, __m256i* m1) {
+    __m256i lo = _mm256_set1_epi32((int)(uint32_t)h);
+    __m256i one = _mm256_set1_epi32(1);
+    __m256i b0 = _mm256_sllv_epi32(one, _mm256_srli_epi32(
+        _mm256_mullo_epi32(lo, _mm256_load_si256((const __m256i*)kBloomSalt)), 27));
+    __m256i b1 = _mm256_sllv_epi32(one, _mm256_srli_epi32(
+        _mm256_mullo_epi32(lo, _mm256_load_si256((const __m256i*)(kBloomSalt + 8))), 27));
+    // 字 w 属于这个键当且仅当 (w - start) mod 16 < k
+    __m256i s = _mm256_set1_epi32((int)start);
+    __m256i kv = _mm256_set1_epi32((int)k);
+    __m256i mod = _mm256_set1_epi32(BLOOM_BLOCK_WORDS - 1);
+    __m256i r0 = _mm256_and_si256(_mm256_sub_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), s), mod);
+    __m256i r1 = _mm256_and_si256(_mm256_sub_epi32(_mm256_setr_epi32(8, 9, 10, 11, 12, 13, 14, 15), s), mod);
+    *m0 = _mm256_and_si256(b0, _mm256_cmpgt_epi32(kv, r0));
+    *m1 = _mm256_and_si256(b1, _mm256_cmpgt_epi32(kv, r1));
+}
+
+__attribute__((target("avx2")))
+static void bloom_add_hash_avx2(BloomFilter* filter, uint64_t h) {
+    unsigned start;
+    uint32_t* block = bloom_block(filter, h, &start);
+    __m256i m0, m1;
+    bloom_masks_avx2(h, start, filter->k, &m0, &m1);
+    __m256i* p = (__m256i*)block;
+    _mm256_store_si256(p, _mm256_or_si256(_mm256_load_si256(p), m0));
+    _mm256_store_si256(p + 1, _mm256_or_si256(_mm256_load_si256(p + 1), m1));
+}
+
+__attribute__((target("avx2")))
+static int bloom_contains_hash_avx2(const BloomFilter* filter, uint64_t h) {
+    unsigned start;
+    const uint32_t* block = bloom_block(filter, h, &start);
+    __m256i m0, m1;
+    bloom_masks_avx2(h, start, filter->k, &m0, &m1);
+    const __m256i* p = (const __m256i*)block;
+    // testc(a, b)：(~a & b) 全为 0 时为 1，即掩码中的位在块中都已置位
+    return _mm256_testc_si256(_mm256_load_si256(p), m0) & _mm256_testc_si256(_mm256_load_si256(p + 1), m1);
+}
+#endif
+
+void bloom_add_hash(BloomFilter* filter, uint64_t h) {
+#if FILTER_HAVE_AVX2
+    if (filter->use_avx2) {
+        bloom_add_hash_avx2(filter, h);
+        return;
+    }
+#endif
+    bloom_add_hash_scalar(filter, h);
+}
+
+int bloom_contains_hash(const BloomFilter* filter, uint64_t h) {
+#if FILTER_HAVE_AVX2
+    if (filter->use_avx2) {
+        return bloom_contains_hash_avx2(filter, h);
+    }
+#endif
+    return bloom_contains_hash_scalar(filter, h);
+}
+
+void bloom_add(BloomFilter* filter, const void* key, size_t len) {
+    bloom_add_hash(filter, xxHash64(key, len, 0));
+}
+
+int bloom_contains(const BloomFilter* filter, const void* key, size_t len) {
+    return bloom_contains_hash(filter, xxHash64(key, len, 0));
+}
+
+size_t bloom_blocks(const BloomFilter* filter) {
+    return filter->nblocks;
+}
+
+unsigned bloom_k(const BloomFilter* filter) {
+    return filter->k;
+}
+
+size_t bloom_memory(const BloomFilter* filter) {
+    return filter->nblocks * BLOOM_BLOCK_BYTES;
+}
+
+/*
+ 布谷鸟过滤器
+*/
+
+// 目标负载：超过后插入失败的概率迅速上升
+#define CUCKOO_FILTER_MAX_LOAD 0.95
+
+struct CuckooFilter {
+    uint8_t* buckets;           // nbuckets * 4 个槽位，每个槽位 fp_bits 位，按位紧凑存储；末尾多 8 字节供 64 位读写越过
+    size_t nbuckets;
+    unsigned fp_bits;
+    uint32_t fp_mask;
+    size_t count;
+    uint64_t rng;               // 踢出时的随机选择
+
+    // 踢出次数用尽时最后被踢出的指纹，以及它所在的候选桶之一
+    int has_victim;
+    uint32_t victim_fp;
+    size_t victim_index;
+};
+
+int cuckoo_filter_params(size_t n, double fpr, size_t* nbuckets, unsigned* fp_bits) {
+    if (!(fpr > 0.0 && fpr < 1.0) || nbuckets == NULL || fp_bits == NULL) {
+        return -1;
+    }
+    // 查询比较 2 个桶共 8 个指纹，每个以 1 / 2^f 的概率误匹配
+    double bits = ceil(log2(2.0 * CUCKOO_FILTER_BUCKET_SLOTS / fpr));
+    if (bits > 32.0) {
+        return -1;
+    }
+    *fp_bits = bits < 4.0 ? 4 : (unsigned)bits;
+    size_t need = (size_t)ceil((double)n / (CUCKOO_FILTER_BUCKET_SLOTS * CUCKOO_FILTER_MAX_LOAD));
+    if (need > ((size_t)1 << 32)) {
+        return -1;
+    }
+    *nbuckets = need < 2 ? 2 : need;
+    return 0;
+}
+
+CuckooFilter* cuckoo_filter_create_buckets(size_t nbuckets, unsigned fp_bits) {
+    if (nbuckets == 0 || nbuckets > ((size_t)1 << 32) || fp_bits < 4 || fp_bits > 32) {
+        return NULL;
+    }
+    CuckooFilter* f = (CuckooFilter*)calloc(1, sizeof(CuckooFilter));
+    if (f == NULL) {
+        return NULL;
+    }
+    f->nbuckets = nbuckets < 2 ? 2 : nbuckets;
+    f->fp_bits = fp_bits;
+    f->fp_mask = fp_bits == 32 ? UINT32_MAX : (1u << fp_bits) - 1;
+    f->rng = 0x9e3779b97f4a7c15ULL;
+    f->buckets = (uint8_t*)calloc(cuckoo_filter_memory(f) + sizeof(uint64_t), 1);
+    if (f->buckets == NULL) {
+        free(f);
+        return NULL;
+    }
+    return f;
+}
+
+CuckooFilter* cuckoo_filter_create(size_t n, double fpr) {
+    size_t nbuckets;
+    unsigned fp_bits;
+    if (cuckoo_filter_params(n, fpr, &nbuckets, &fp_bits) != 0) {
+        return NULL;
+    }
+    return cuckoo_filter_create_buckets(nbuckets, fp_bits);
+}
+
+void cuckoo_filter_free(CuckooFilter* filter) {
+    if (filter == NULL) {
+        return;
+    }
+    free(filter->buckets);
+    free(filter);
+}
+
+// 槽位从第 pos 位开始：读出 pos / 8 处的 64 位，右移 pos % 8（<= 7）位后取低 fp_bits（<= 32）位
+static inline uint32_t cf_get(const CuckooFilter* f, size_t b, unsigned s) {
+    size_t pos = (b * CUCKOO_FILTER_BUCKET_SLOTS + s) * f->fp_bits;
+    uint64_t v;
+    memcpy(&v, f->buckets + pos / 8, sizeof(v));
+    return (uint32_t)(v >> (pos % 8)) & f->fp_mask;
+}
+
+static inline void cf_set(CuckooFilter* f, size_t b, unsigned s, uint32_t fp) {
+    size_t pos = (b * CUCKOO_FILTER_BUCKET_SLOTS + s) * f->fp_bits;
+    uint64_t v;
+    memcpy(&v, f->buckets + pos / 8, sizeof(v));
+    v &= ~((uint64_t)f->fp_mask << (pos % 8));
+    v |= (uint64_t)fp << (pos % 8);
+    memcpy(f->buckets + pos / 8, &v, sizeof(v));
+}
+
+static inline uint32_t cf_fingerprint(const CuckooFilter* f, uint64_t h) {
+    uint32_t fp = (uint32_t)h & f->fp_mask;
+    return fp != 0 ? fp : 1;
+}
+
+// 高 32 位乘以桶数取高位，桶数不必是 2 的幂
+static inline size_t cf_index(const CuckooFilter* f, uint64_t h) {
+    return (size_t)(((h >> 32) * f->nbuckets) >> 32);
+}
+
+// 另一个候选桶：(t - i) mod 桶数，t 由指纹决定，对称（alt(alt(i)) == i），只依赖当前桶与指纹
+static inline size_t cf_alt(const CuckooFilter* f, size_t i, uint32_t fp) {
+    size_t t = (size_t)(((uint64_t)(uint32_t)(fp * 0x5bd1e995u) * f->nbuckets) >> 32);
+    return t >= i ? t - i : t + f->nbuckets - i;
+}
+
+static inline int cf_bucket_has(const CuckooFilter* f, size_t b, uint32_t fp) {
+    for (unsigned s = 0; s < CUCKOO_FILTER_BUCKET_SLOTS; s++) {
+        if (cf_get(f, b, s) == fp) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int cf_bucket_insert(CuckooFilter* f, size_t b, uint32_t fp) {
+    for (unsigned s = 0; s < CUCKOO_FILTER_BUCKET_SLOTS; s++) {
+        if (cf_get(f, b, s) == 0) {
+            cf_set(f, b, s, fp);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int cf_bucket_remove(CuckooFilter* f, size_t b, uint32_t fp) {
+    for (unsigned s = 0; s < CUCKOO_FILTER_BUCKET_SLOTS; s++) {
+        if (cf_get(f, b, s) == fp) {
+            cf_set(f, b, s, 0);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static inline uint64_t cf_rand(CuckooFilter* f) {
+    f->rng ^= f->rng << 13;
+    f->rng ^= f->rng >> 7;
+    f->rng ^= f->rng << 17;
+    return f->rng;
+}
+
+// 放入指纹（i 为它的一个候选桶），必要时踢出其他指纹；踢出次数用尽时把手上的指纹存为备用，返回 -1
+static int cf_place(CuckooFilter* f, size_t i, uint32_t fp) {
+    size_t j = cf_alt(f, i, fp);
+    if (cf_bucket_insert(f, i, fp) || cf_bucket_insert(f, j, fp)) {
+        return 0;
+    }
+    size_t b = (cf_rand(f) & 1) ? i : j;
+    for (int kick = 0; kick < CUCKOO_FILTER_MAX_KICKS; kick++) {
+        unsigned s = (unsigned)(cf_rand(f) % CUCKOO_FILTER_BUCKET_SLOTS);
+        uint32_t old = cf_get(f, b, s);
+        cf_set(f, b, s, fp);
+        fp = old;
+        b = cf_alt(f, b, fp);
+        if (cf_bucket_insert(f, b, fp)) {
+            return 0;
+        }
+    }
+    f->has_victim = 1;
+    f->victim_fp = fp;
+    f->victim_index = b;
+    return -1;
+}
+
+int cuckoo_filter_add_hash(CuckooFilter* filter, uint64_t h) {
+    if (filter->has_victim) {
+        return -1;
+    }
+    // 即使踢出次数用尽，这个键的指纹也已放入表中，被挤出的指纹在备用槽位里，加入仍然成功
+    cf_place(filter, cf_index(filter, h), cf_fingerprint(filter, h));
+    filter->count++;
+    return 0;
+}
+
+int cuckoo_filter_contains_hash(const CuckooFilter* filter, uint64_t h) {
+    uint32_t fp = cf_fingerprint(filter, h);
+    size_t i = cf_index(filter, h);
+    size_t j = cf_alt(filter, i, fp);
+    if (cf_bucket_has(filter, i, fp) || cf_bucket_has(filter, j, fp)) {
+        return 1;
+    }
+    return filter->has_victim && filter->victim_fp == fp &&
+           (filter->victim_index == i || filter->victim_index == j);
+}
+
+int cuckoo_filter_remove_hash(CuckooFilter* filter, uint64_t h) {
+    uint32_t fp = cf_fingerprint(filter, h);
+    size_t i = cf_index(filter, h);
+    size_t j = cf_alt(filter, i, fp);
+    if (filter->has_victim && filter->victim_fp == fp &&
+        (filter->victim_index == i || filter->victim_index == j)) {
+        filter->has_victim = 0;
+        filter->count--;
+        return 0;
+    }
+    if (!cf_bucket_remove(filter, i, fp) && !cf_bucket_remove(filter, j, fp)) {
+        return -1;
+    }
+    filter->count--;
+    // 腾出了一个槽位，把备用的指纹放回表中
+    if (filter->has_victim) {
+        filter->has_victim = 0;
+        cf_place(filter, filter->victim_index, filter->victim_fp);
+    }
+    return 0;
+}
+
+int cuckoo_filter_add(CuckooFilter* filter, const void* key, size_t len) {
+    return cuckoo_filter_add_hash(filter, xxHash64(key, len, 0));
+}
+
+int cuckoo_filter_contains(const CuckooFilter* filter, const void* key, size_t len) {
+    return cuckoo_filter_contains_hash(filter, xxHash64(key, len, 0));
+}
+
+int cuckoo_filter_remove(CuckooFilter* filter, const void* key, size_t len) {
+    return cuckoo_filter_remove_hash(filter, xxHash64(key, len, 0));
+}
+
+size_t cuckoo_filter_count(const CuckooFilter* filter) {
+    return filter->count;
+}
+
+size_t cuckoo_filter_capacity(const CuckooFilter* filter) {
+    return filter->nbuckets * CUCKOO_FILTER_BUCKET_SLOTS;
+}
+
+unsigned cuckoo_filter_fp_bits(const CuckooFilter* filter) {
+    return filter->fp_bits;
+}
+
+size_t cuckoo_filter_memory(const CuckooFilter* filter) {
+    return (filter->nbuckets * CUCKOO_FILTER_BUCKET_SLOTS * filter->fp_bits + 7) / 8;
+}
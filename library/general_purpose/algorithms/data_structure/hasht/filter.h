@@ -0,0 +1,143 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ 近似成员查询过滤器：回答 "键一定不在集合中" 或 "键可能在集合中"，没有假阴性，假阳性率可按需求设定
+ （1）分块布隆过滤器（blocked Bloom filter）：位数组分成 64 字节（一条缓存行）的块，每个键只落在一个块里，
+      在块的 16 个 32 位字中连续的 k 个字里各置 1 位；查询只访问一条缓存行，CPU 支持 AVX2 时 16 个字并行计算与比较。
+      代价是块内负载不均，同样的位数下假阳性率比标准布隆过滤器略高（由 bloom_params 计入）
+ （2）布谷鸟过滤器（cuckoo filter）：每个桶 4 个槽位存键的指纹，键可以放在两个候选桶之一（部分键布谷鸟哈希），
+      支持删除；假阳性率约为 8 / 2^指纹位数，负载可达 95%，假阳性率要求在 0.1% 左右或更低时比分块布隆过滤器省内存
+ 与 uthash 的 HASH_BLOOM 相比：HASH_BLOOM 每个键只置 1 位、大小在编译期固定，元素数接近位数时几乎总是返回 "可能存在"，
+ 只能作为哈希表的前置过滤；这里的两种过滤器可以单独使用，按元素数与目标假阳性率确定大小
+*/
+
+// 布隆过滤器每个块的字节数与字数
+#define BLOOM_BLOCK_BYTES 64
+#define BLOOM_BLOCK_WORDS 16
+
+// 布谷鸟过滤器每个桶的槽位数、插入时的最大踢出次数
+#define CUCKOO_FILTER_BUCKET_SLOTS 4
+#define CUCKOO_FILTER_MAX_KICKS 500
+
+typedef struct BloomFilter BloomFilter;
+typedef struct CuckooFilter CuckooFilter;
+
+/**
+* @brief             估计分块布隆过滤器的假阳性率
+* @param nblocks     块数
+* @param k           每个键置位的字数（位数），1 ~ BLOOM_BLOCK_WORDS
+* @param n           已加入的键数
+* @return            假阳性率（按块内键数服从泊松分布计算）；参数无效返回 1
+*/
+double bloom_fpr(size_t nblocks, unsigned k, size_t n);
+
+/**
+* @brief             选择块数与 k，使 n 个键时的假阳性率不超过 fpr 且内存最少
+* @param fpr         目标假阳性率，(0, 1)
+* @return            成功返回0，fpr 无效或所需块数超过 UINT32_MAX 返回 -1
+*/
+int bloom_params(size_t n, double fpr, size_t* nblocks, unsigned* k);
+
+/**
+* @brief             按元素数与目标假阳性率创建（见 bloom_params）
+* @return            成功返回过滤器，参数无效或内存不足返回NULL
+*/
+BloomFilter* bloom_create(size_t n, double fpr);
+
+/**
+* @brief             按块数与 k 创建
+* @param nblocks     块数，1 ~ UINT32_MAX
+* @return            成功返回过滤器，参数无效或内存不足返回NULL
+*/
+BloomFilter* bloom_create_blocks(size_t nblocks, unsigned k);
+
+void bloom_free(BloomFilter* filter);
+// 清空全部位
+void bloom_clear(BloomFilter* filter);
+
+// 加入键（xxHash64，种子为 0）
+void bloom_add(BloomFilter* filter, const void* key, size_t len);
+// 键可能存在返回 1，一定不存在返回0
+int bloom_contains(const BloomFilter* filter, const void* key, size_t len);
+
+/**
+* @brief             按 64 位哈希值加入、查询（调用者自己计算哈希，同一过滤器要用同一个哈希函数）
+* @note              高 32 位选择块与起始字，低 32 位分别乘以 16 个奇数常量后取高 5 位作为各字中的位
+*/
+void bloom_add_hash(BloomFilter* filter, uint64_t h);
+int bloom_contains_hash(const BloomFilter* filter, uint64_t h);
+// 标量版本供测试与基准测试直接调用，结果与默认版本（CPU 支持时为 AVX2）一致
+void bloom_add_hash_scalar(BloomFilter* filter, uint64_t h);
+int bloom_contains_hash_scalar(const BloomFilter* filter, uint64_t h);
+
+size_t bloom_blocks(const BloomFilter* filter);
+unsigned bloom_k(const BloomFilter* filter);
+// 位数组占用的字节数
+size_t bloom_memory(const BloomFilter* filter);
+
+/**
+* @brief             选择桶数与指纹位数，使 n 个键时的假阳性率不超过 fpr
+* @param nbuckets    输出桶数，使负载不超过 95%，至少 2
+* @param fp_bits     输出指纹位数，ceil(log2(8 / fpr))，4 ~ 32
+* @return            成功返回0，fpr 无效、要求的指纹超过 32 位或桶数超过 2^32 返回 -1
+*/
+int cuckoo_filter_params(size_t n, double fpr, size_t* nbuckets, unsigned* fp_bits);
+
+/**
+* @brief             按元素数与目标假阳性率创建（见 cuckoo_filter_params）
+* @return            成功返回过滤器，参数无效或内存不足返回NULL
+*/
+CuckooFilter* cuckoo_filter_create(size_t n, double fpr);
+
+/**
+* @brief             按桶数与指纹位数创建
+* @param nbuckets    桶数，1 ~ 2^32，小于 2 时按 2
+* @param fp_bits     指纹位数，4 ~ 32；槽位按位紧凑存储，每个键约占 fp_bits / 负载 位
+* @return            成功返回过滤器，参数无效或内存不足返回NULL
+*/
+CuckooFilter* cuckoo_filter_create_buckets(size_t nbuckets, unsigned fp_bits);
+
+void cuckoo_filter_free(CuckooFilter* filter);
+
+/**
+* @brief             加入键；同一个键加入多次会占用多个槽位（删除时也要删除同样多次）
+* @return            成功返回0，过滤器已满返回 -1
+* @note              踢出 CUCKOO_FILTER_MAX_KICKS 次仍放不下时，最后被踢出的指纹保存在备用槽位里，这次加入仍然成功、
+*                    不会产生假阴性，但之后的加入都返回 -1，直到删除腾出位置
+*/
+int cuckoo_filter_add(CuckooFilter* filter, const void* key, size_t len);
+int cuckoo_filter_contains(const CuckooFilter* filter, const void* key, size_t len);
+
+/**
+* @brief             删除键的一个指纹
+* @return            删除成功返回0，指纹不存在返回 -1
+* @note              只能删除确实加入过的键，否则可能删掉指纹相同的另一个键，使它产生假阴性
+*/
+int cuckoo_filter_remove(CuckooFilter* filter, const void* key, size_t len);
+
+// 按 64 位哈希值操作：高 32 位选择桶，低位作为指纹
+int cuckoo_filter_add_hash(CuckooFilter* filter, uint64_t h);
+int cuckoo_filter_contains_hash(const CuckooFilter* filter, uint64_t h);
+int cuckoo_filter_remove_hash(CuckooFilter* filter, uint64_t h);
+
+// 已加入的指纹数（含备用槽位）
+size_t cuckoo_filter_count(const CuckooFilter* filter);
+// 槽位总数
+size_t cuckoo_filter_capacity(const CuckooFilter* filter);
+unsigned cuckoo_filter_fp_bits(const CuckooFilter* filter);
+// 桶数组占用的字节数（桶数 * 4 * fp_bits 位）
+size_t cuckoo_filter_memory(const CuckooFilter* filter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FILTER_H
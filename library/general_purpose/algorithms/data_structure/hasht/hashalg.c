@@ -1,6 +1,8 @@
+#include "hashalg.h"
+#include "hashalg_util.h"
+#include <assert.h>
 #include <stddef.h>
 #include <stdint.h>
-#include <stdio.h>
 #include <string.h>
 /*
 一、哈希函数的作用：
@@ -65,21 +67,35 @@
 */
 /**
 * @brief             times33 hash 算法
-* @param   key       接收一个字符串或char数组或char指针
+* @param   key       任意二进制数据（字符串不含结尾的 '\0'）
+* @param   len       数据长度（字节）
+* @param   seed      初始哈希值，传 0 即经典 times33
 * @return            返回生成的 hash 值
 *
-* @note              Revision History
-*/
-unsigned int times33Hash(const char* key) {
-    // 初始哈希值为0
-    unsigned int hashv = 0;
-    // 遍历字符串直到空字符'\0'
-    while(*key){
-        // hashv += hashv * 33 + (unsigned char)(*key);
+* @note              原版本按 '\0' 结尾遍历字符串，改为按长度遍历后可以哈希包含 '\0' 的二进制数据
+*/
+uint32_t times33Hash(const void* key, size_t len, uint32_t seed) {
+    const uint8_t* bytes = (const uint8_t*)key;
+    // 初始哈希值为种子
+    uint32_t hashv = seed;
+    // 遍历每个字节
+    for (size_t i = 0; i < len; i++) {
+        // hashv = hashv * 33 + bytes[i]
         // 优化：使用 hash = (hash << 5) + hash 代替乘法
-        hashv += (hashv << 5) + hashv + (unsigned char)(*key);
-        // 移动指针到下一个字符
-        key++;
+        hashv = (hashv << 5) + hashv + bytes[i];
+    }
+    return hashv;
+}
+
+/**
+* @brief             times33 hash 算法 64 位版本
+* @note              与 32 位版本步骤相同，状态扩展为 64 位，长字符串的高位不会过早溢出丢失
+*/
+uint64_t times33Hash64(const void* key, size_t len, uint64_t seed) {
+    const uint8_t* bytes = (const uint8_t*)key;
+    uint64_t hashv = seed;
+    for (size_t i = 0; i < len; i++) {
+        hashv = (hashv << 5) + hashv + bytes[i];
     }
     return hashv;
 }
@@ -116,10 +132,14 @@ unsigned int times33Hash(const char* key) {
  （3）种子选择：若需避免哈希碰撞攻击，种子应随机化（如使用随机数生成器）
 */
 /**
-* @brief             MurmurHash3 32位哈希算法
-* @return  uint32_t  Return Description
+* @brief             MurmurHash3 32位哈希算法（x86_32）
+* @param   key       任意二进制数据
+* @param   len       数据长度（字节）
+* @param   seed      种子
+* @return  uint32_t  32 位哈希值
 *
-* @note              Revision History
+* @note              4 字节块用 hash_load32 读取（memcpy + 小端序转换），解决了上面注意事项中的字节序与对齐问题；
+*                    块混合为 k = rotl(k * c1, 15) * c2，结果与参考实现及 mmh3 等常用库逐位一致
 */
 uint32_t murmurHash3_32(const void *key, size_t len, uint32_t seed) {
     // 初始化与常量定义: 设计目的：通过乘法、位移和异或操作，确保输入数据的每一位都能影响最终哈希值
@@ -138,46 +158,46 @@ uint32_t murmurHash3_32(const void *key, size_t len, uint32_t seed) {
     // 转为 uint8_t 是 8位无符号整数 的标准类型（范围 0x00 ~ 0xFF），确保每个字节被当作非负数处理，二进制安全：直接操作原始字节，适用于任意数据类型（字符串、结构体、二进制文件等）
     const uint8_t* data = (const uint8_t*)(key);
     // 计算 包含多少个 4 字节
-    const int nblocks = len / 4;
-    // 转为 4 字节指针，进行指针++ 平移
-    const uint32_t* blocks = (const uint32_t*)(data); 
+    const size_t nblocks = len / 4;
     // 循环处理每一个 4 字节块
     for (size_t i = 0; i < nblocks; i++) {
-        // 读取处理一个 4 字节块
-        uint32_t k = blocks[i];
+        // 读取处理一个 4 字节块（按小端序解释，地址无需对齐）
+        uint32_t k = hash_load32(data + i * 4);
         // 乘法混淆数据
         k *= c1;               
         // 循环左移15位，原理：将 k 左移 r1 位，同时将溢出的高位补到低位，形成循环效果。作用：增强位级扩散，避免简单的位移导致信息丢失           
-        k *= (k << r1) | (k >> (32 - r1));
+        k = hash_rotl32(k, r1);
         // 再次乘法混淆
         k *= c2;
 
         // 异或操作更新哈希值，将混淆后的块与当前哈希值混合
         hash ^= k; 
         // 哈希值循环左移 13 位
-        hash = (hash << r2) | (hash >> (32 - r2));
+        hash = hash_rotl32(hash, r2);
         // 混合哈希值：线性混合进一步扩散数据
         hash = hash * m + n;
     }
     
     // 意义：确保不足 4字节 的数据仍参与哈希计算，避免数据遗漏
     // 处理尾部不足4字节的数据，指针平移到最后 nblocks * 4 的位置
-    const uint8_t* tail = (const uint8_t*)(data + nblocks * 4);
+    const uint8_t* tail = data + nblocks * 4;
     uint32_t k1 = 0;
     // 取余运算判断剩余字节数，技巧：利用 switch 的 case 穿透（fall-through）特性，简洁处理1-3字节的尾部数据
-    switch (len & 3) {                // len % 4
-        case 3: k1 ^= tail[2] << 16;  // 处理第3字节
-        case 2: k1 ^= tail[1] << 8;   // 处理第2字节
-        case 1: k1 ^= tail[0];        // 处理第1字节
-                k1 *= c1;             // 与分块相同的混淆操作
-                k1 *= (k1 << r1) | (k1 >> (32 - r1));
+    switch (len & 3) {                          // len % 4
+        case 3: k1 ^= (uint32_t)tail[2] << 16;  // 处理第3字节
+            /* fall through */
+        case 2: k1 ^= (uint32_t)tail[1] << 8;   // 处理第2字节
+            /* fall through */
+        case 1: k1 ^= tail[0];                  // 处理第1字节
+                k1 *= c1;                       // 与分块相同的混淆操作
+                k1 = hash_rotl32(k1, r1);
                 k1 *= c2;
-                hash ^= k1;           // 合并到哈希值
+                hash ^= k1;                     // 合并到哈希值
     }
     
     // 最终混合（消除规律性）目的：进一步打乱哈希值，确保即使输入有规律，输出也呈现均匀分布
-    // 混合数据长度
-    hash ^= len;
+    // 混合数据长度（参考实现按 32 位长度混合）
+    hash ^= (uint32_t)len;
     // 高16位与低16位混合
     hash ^= (hash >> 16); 
     // 乘法增强随机性  
@@ -192,6 +212,279 @@ uint32_t murmurHash3_32(const void *key, size_t len, uint32_t seed) {
     return hash;
 } 
 
+// 流式接口使用的分块混合与收尾，步骤与 murmurHash3_32 完全相同
+static inline uint32_t murmur3_32_block(uint32_t hash, uint32_t k) {
+    k *= 0xcc9e2d51;
+    k = hash_rotl32(k, 15);
+    k *= 0x1b873593;
+    hash ^= k;
+    hash = hash_rotl32(hash, 13);
+    return hash * 5 + 0xe6546b64;
+}
+
+// 处理剩余的整块与尾部（rem 为剩余字节数），再混入总长度 total 做最终混合
+static uint32_t murmur3_32_finish(uint32_t hash, const uint8_t* p, size_t rem, size_t total) {
+    while (rem >= 4) {
+        hash = murmur3_32_block(hash, hash_load32(p));
+        p += 4;
+        rem -= 4;
+    }
+
+    uint32_t k1 = 0;
+    switch (rem) {
+        case 3: k1 ^= (uint32_t)p[2] << 16;  /* fall through */
+        case 2: k1 ^= (uint32_t)p[1] << 8;   /* fall through */
+        case 1: k1 ^= p[0];
+                k1 *= 0xcc9e2d51;
+                k1 = hash_rotl32(k1, 15);
+                k1 *= 0x1b873593;
+                hash ^= k1;
+    }
+
+    hash ^= (uint32_t)total;
+    hash ^= (hash >> 16);
+    hash *= 0x85ebca6b;
+    hash ^= (hash >> 13);
+    hash *= 0xc2b2ae35;
+    hash ^= (hash >> 16);
+    return hash;
+}
+
+/**
+* @brief             MurmurHash3 32 位流式接口：初始化
+* @param   st        状态
+* @param   seed      种子
+*/
+void murmurHash3_32_init(Murmur3_32State* st, uint32_t seed) {
+    st->hash = seed;
+    st->buf_len = 0;
+    st->total = 0;
+}
+
+/**
+* @brief             MurmurHash3 32 位流式接口：输入一段数据
+* @note              上一次剩下不足 4 字节的数据先与本次数据拼成完整的块，其余整块直接从输入读取
+*/
+void murmurHash3_32_update(Murmur3_32State* st, const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    st->total += len;
+
+    if (st->buf_len > 0) {
+        if (!hash_buf_fill(st->buf, &st->buf_len, 4, &p, &len)) {
+            return;
+        }
+        st->hash = murmur3_32_block(st->hash, hash_load32(st->buf));
+        st->buf_len = 0;
+    }
+    while (len >= 4) {
+        st->hash = murmur3_32_block(st->hash, hash_load32(p));
+        p += 4;
+        len -= 4;
+    }
+    memcpy(st->buf, p, len);
+    st->buf_len = (uint32_t)len;
+}
+
+/**
+* @brief             MurmurHash3 32 位流式接口：输出哈希值
+* @note              不修改状态，可以在中途取结果后继续 update
+*/
+uint32_t murmurHash3_32_final(const Murmur3_32State* st) {
+    return murmur3_32_finish(st->hash, st->buf, st->buf_len, st->total);
+}
+
+/**
+* @brief             MurmurHash2 64A 哈希算法
+* @param   key       任意二进制数据
+* @param   len       数据长度（字节）
+* @param   seed      64 位种子
+* @return  uint64_t  64 位哈希值
+*
+* @note              Austin Appleby 为 64 位平台设计的 MurmurHash2 变体，单次循环处理 8 字节
+*/
+uint64_t murmurHash64A(const void* key, size_t len, uint64_t seed) {
+    const uint64_t m = 0xc6a4a7935bd1e995ULL;
+    const int r = 47;
+    const uint8_t* data = (const uint8_t*)key;
+    const size_t nblocks = len / 8;
+    uint64_t hash = seed ^ (len * m);
+
+    // 8 字节块：乘法、移位异或、乘法后并入哈希值
+    for (size_t i = 0; i < nblocks; i++) {
+        uint64_t k = hash_load64(data + i * 8);
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        hash ^= k;
+        hash *= m;
+    }
+
+    // 尾部 1~7 字节按小端序拼接
+    const uint8_t* tail = data + nblocks * 8;
+    switch (len & 7) {
+        case 7: hash ^= (uint64_t)tail[6] << 48; /* fall through */
+        case 6: hash ^= (uint64_t)tail[5] << 40; /* fall through */
+        case 5: hash ^= (uint64_t)tail[4] << 32; /* fall through */
+        case 4: hash ^= (uint64_t)tail[3] << 24; /* fall through */
+        case 3: hash ^= (uint64_t)tail[2] << 16; /* fall through */
+        case 2: hash ^= (uint64_t)tail[1] << 8;  /* fall through */
+        case 1: hash ^= (uint64_t)tail[0];
+                hash *= m;
+    }
+
+    // 最终混合
+    hash ^= hash >> r;
+    hash *= m;
+    hash ^= hash >> r;
+    return hash;
+}
+
+/**
+* @brief             MurmurHash3 x64_128 的最终混合（fmix64）
+*/
+static inline uint64_t murmur_fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+#define MURMUR3_128_C1 0x87c37b91114253d5ULL
+#define MURMUR3_128_C2 0x4cf5ad432745937fULL
+
+// 16 字节块：两条 64 位通道交叉混合，单次循环处理的数据是 x86_32 版本的 4 倍
+static inline void murmur3_128_block(uint64_t* h1, uint64_t* h2, const uint8_t* block) {
+    uint64_t k1 = hash_load64(block);
+    uint64_t k2 = hash_load64(block + 8);
+
+    k1 *= MURMUR3_128_C1; k1 = hash_rotl64(k1, 31); k1 *= MURMUR3_128_C2; *h1 ^= k1;
+    *h1 = hash_rotl64(*h1, 27); *h1 += *h2; *h1 = *h1 * 5 + 0x52dce729;
+
+    k2 *= MURMUR3_128_C2; k2 = hash_rotl64(k2, 33); k2 *= MURMUR3_128_C1; *h2 ^= k2;
+    *h2 = hash_rotl64(*h2, 31); *h2 += *h1; *h2 = *h2 * 5 + 0x38495ab5;
+}
+
+// 尾部 1~15 字节（前 8 字节并入 k1，其余并入 k2）与最终混合，len 为输入总长度
+static void murmur3_128_finish(uint64_t h1, uint64_t h2, const uint8_t* tail, size_t len, uint64_t out[2]) {
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    switch (len & 15) {
+        case 15: k2 ^= (uint64_t)tail[14] << 48; /* fall through */
+        case 14: k2 ^= (uint64_t)tail[13] << 40; /* fall through */
+        case 13: k2 ^= (uint64_t)tail[12] << 32; /* fall through */
+        case 12: k2 ^= (uint64_t)tail[11] << 24; /* fall through */
+        case 11: k2 ^= (uint64_t)tail[10] << 16; /* fall through */
+        case 10: k2 ^= (uint64_t)tail[9] << 8;   /* fall through */
+        case 9:  k2 ^= (uint64_t)tail[8];
+                 k2 *= MURMUR3_128_C2; k2 = hash_rotl64(k2, 33); k2 *= MURMUR3_128_C1; h2 ^= k2;
+                 /* fall through */
+        case 8:  k1 ^= (uint64_t)tail[7] << 56;  /* fall through */
+        case 7:  k1 ^= (uint64_t)tail[6] << 48;  /* fall through */
+        case 6:  k1 ^= (uint64_t)tail[5] << 40;  /* fall through */
+        case 5:  k1 ^= (uint64_t)tail[4] << 32;  /* fall through */
+        case 4:  k1 ^= (uint64_t)tail[3] << 24;  /* fall through */
+        case 3:  k1 ^= (uint64_t)tail[2] << 16;  /* fall through */
+        case 2:  k1 ^= (uint64_t)tail[1] << 8;   /* fall through */
+        case 1:  k1 ^= (uint64_t)tail[0];
+                 k1 *= MURMUR3_128_C1; k1 = hash_rotl64(k1, 31); k1 *= MURMUR3_128_C2; h1 ^= k1;
+    }
+
+    // 最终混合
+    h1 ^= (uint64_t)len;
+    h2 ^= (uint64_t)len;
+    h1 += h2;
+    h2 += h1;
+    h1 = murmur_fmix64(h1);
+    h2 = murmur_fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+
+    out[0] = h1;
+    out[1] = h2;
+}
+
+/**
+* @brief             MurmurHash3 x64_128 主体，h1、h2 都以 seed 初始化
+* @note              seed 小于 2^32 时与参考实现（uint32_t 种子）逐位一致
+*/
+static void murmur3_x64_128(const void* key, size_t len, uint64_t seed, uint64_t out[2]) {
+    const uint8_t* data = (const uint8_t*)key;
+    const size_t nblocks = len / 16;
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+
+    for (size_t i = 0; i < nblocks; i++) {
+        murmur3_128_block(&h1, &h2, data + i * 16);
+    }
+    murmur3_128_finish(h1, h2, data + nblocks * 16, len, out);
+}
+
+/**
+* @brief             MurmurHash3 x64_128 哈希算法
+* @param   key       任意二进制数据
+* @param   len       数据长度（字节）
+* @param   seed      种子
+* @param   out       输出 128 位哈希值，out[0] 为 h1（低 64 位），out[1] 为 h2
+*
+* @note              32 位哈希在超过 2^32 个键时必然大量碰撞（生日界约 2^16 个键就开始出现碰撞），
+*                    超大哈希表、去重等场景应使用 128 位（或至少 64 位）的输出
+*/
+void murmurHash3_x64_128(const void* key, size_t len, uint32_t seed, uint64_t out[2]) {
+    murmur3_x64_128(key, len, seed, out);
+}
+
+/**
+* @brief             MurmurHash3 x64_128 取 h1 作为 64 位哈希值
+* @note              64 位种子同时初始化 h1 与 h2，种子小于 2^32 时等于 murmurHash3_x64_128 的 out[0]
+*/
+uint64_t murmurHash3_x64_64(const void* key, size_t len, uint64_t seed) {
+    uint64_t out[2];
+    murmur3_x64_128(key, len, seed, out);
+    return out[0];
+}
+
+/**
+* @brief             MurmurHash3 x64_128 流式接口：初始化
+*/
+void murmurHash3_x64_128_init(Murmur3_128State* st, uint64_t seed) {
+    st->h1 = seed;
+    st->h2 = seed;
+    st->buf_len = 0;
+    st->total = 0;
+}
+
+/**
+* @brief             MurmurHash3 x64_128 流式接口：输入一段数据
+*/
+void murmurHash3_x64_128_update(Murmur3_128State* st, const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    st->total += len;
+
+    if (st->buf_len > 0) {
+        if (!hash_buf_fill(st->buf, &st->buf_len, 16, &p, &len)) {
+            return;
+        }
+        murmur3_128_block(&st->h1, &st->h2, st->buf);
+        st->buf_len = 0;
+    }
+    while (len >= 16) {
+        murmur3_128_block(&st->h1, &st->h2, p);
+        p += 16;
+        len -= 16;
+    }
+    memcpy(st->buf, p, len);
+    st->buf_len = (uint32_t)len;
+}
+
+/**
+* @brief             MurmurHash3 x64_128 流式接口：输出 128 位哈希值
+*/
+void murmurHash3_x64_128_final(const Murmur3_128State* st, uint64_t out[2]) {
+    murmur3_128_finish(st->h1, st->h2, st->buf, st->total, out);
+}
+
 /*
 （3）SHA-256：基于 Merkle-Damgård 结构，通过 64 轮非线性变换（逻辑函数、模加）处理 512 位块
  算法特点：
@@ -280,27 +573,45 @@ void sha3_256Hash(const void* input, size_t len, void* output) {
 */
 /**
 * @brief             SAX 哈希算法
-* @param   key       Param Description
-* @return  uint32_t  Return Description
+* @param   key       任意二进制数据
+* @param   len       数据长度（字节）
+* @param   seed      初始哈希值
+* @return  uint32_t  32 位哈希值
 *
 * @note              SAX 哈希并非标准哈希算法的通用名称，可能为某种自定义的简化哈希算法。以下内容基于常见的 Shift-Add-XOR 哈希逻辑进行假设性解析
 */
-uint32_t saxHash(const char* key) {
+uint32_t saxHash(const void* key, size_t len, uint32_t seed) {
+    const uint8_t* bytes = (const uint8_t*)key;
     // hash 初始值
-    uint32_t hash = 0;
+    uint32_t hash = seed;
 
-    // 逐个处理每个字符
-    while (*key) {
+    // 逐个处理每个字节
+    for (size_t i = 0; i < len; i++) {
         // Shift-Add-XOR 组合操作 （类似 Times33）
-        hash = (hash << 5) + hash + (uint8_t)(*key);
+        hash = (hash << 5) + hash + bytes[i];
         // XOR 右移后的值
         hash ^= (hash >> 3);
-        key++;
     }
 
     return hash;
 } 
 
+/**
+* @brief             SAX 哈希算法 64 位版本
+* @note              与 32 位版本步骤相同，状态扩展为 64 位
+*/
+uint64_t saxHash64(const void* key, size_t len, uint64_t seed) {
+    const uint8_t* bytes = (const uint8_t*)key;
+    uint64_t hash = seed;
+
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash << 5) + hash + bytes[i];
+        hash ^= (hash >> 3);
+    }
+
+    return hash;
+}
+
 /*
 （6）FNV
  算法特点：
@@ -325,18 +636,20 @@ uint32_t saxHash(const char* key) {
 */
 /**
 * @brief             FNV 哈希算法：FNV-1a 32位哈希函数
-* @param   key       Param Description
-* @return  uint32_t  Return Description
+* @param   key       任意二进制数据
+* @param   len       数据长度（字节）
+* @param   seed      种子，与 offset basis 异或后作为初始值，传 0 即标准 FNV-1a
+* @return  uint32_t  32 位哈希值
 *
 * @note              FNV (Fowler-Noll-Vo) 是一种简单高效的非加密哈希算法，广泛应用于快速哈希计算场景，如哈希表、数据分片和校验和生成。其核心思想是通过质数乘法和异或操作实现数据混合
 */
-uint32_t fnvHash(const char* key, size_t len) {
+uint32_t fnvHash(const void* key, size_t len, uint32_t seed) {
     // 初始值
     const uint32_t FNV_offset_basis = 0x811C9DC5; 
     // 质数 
     const uint32_t FNV_prime = 0x01000193;
     // 初始值 hash
-    uint32_t hash = FNV_offset_basis;
+    uint32_t hash = FNV_offset_basis ^ seed;
 
     // 转换为字节流        
     const uint8_t* bytes = (const uint8_t*)key;
@@ -351,6 +664,64 @@ uint32_t fnvHash(const char* key, size_t len) {
     return hash;
 }
 
+/**
+* @brief             FNV-1a 64位哈希函数
+* @note              64 位 offset basis 为 0xcbf29ce484222325，质数为 0x100000001b3
+*/
+uint64_t fnvHash64(const void* key, size_t len, uint64_t seed) {
+    const uint64_t FNV_offset_basis = 0xcbf29ce484222325ULL;
+    const uint64_t FNV_prime = 0x100000001b3ULL;
+    uint64_t hash = FNV_offset_basis ^ seed;
+
+    const uint8_t* bytes = (const uint8_t*)key;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_prime;
+    }
+
+    return hash;
+}
+
+/**
+* @brief             FNV-1a 流式接口
+* @note              FNV 逐字节处理，没有分块与收尾，状态就是当前的哈希值
+*/
+void fnvHash_init(FnvState* st, uint32_t seed) {
+    st->hash = 0x811C9DC5 ^ seed;
+}
+
+void fnvHash_update(FnvState* st, const void* data, size_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint32_t hash = st->hash;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= 0x01000193;
+    }
+    st->hash = hash;
+}
+
+uint32_t fnvHash_final(const FnvState* st) {
+    return st->hash;
+}
+
+void fnvHash64_init(Fnv64State* st, uint64_t seed) {
+    st->hash = 0xcbf29ce484222325ULL ^ seed;
+}
+
+void fnvHash64_update(Fnv64State* st, const void* data, size_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint64_t hash = st->hash;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    st->hash = hash;
+}
+
+uint64_t fnvHash64_final(const Fnv64State* st) {
+    return st->hash;
+}
+
 /*
 （7）OAT（OAAT）
  算法特点：
@@ -375,15 +746,16 @@ uint32_t fnvHash(const char* key, size_t len) {
 */
 /**
 * @brief             OAT 哈希算法
-* @param   key       Param Description
-* @param   len       Param Description
-* @return  uint32_t  Return Description
+* @param   key       任意二进制数据
+* @param   len       数据长度（字节）
+* @param   seed      初始哈希值
+* @return  uint32_t  32 位哈希值
 *
 * @note              OAT（OAAT）哈希是一种高效、简洁的非加密哈希算法，适用于需要快速计算哈希值的场景（如内存数据库、缓存系统）。其实现简单且对短数据表现良好，但在长数据或安全敏感场景中需谨慎使用。实际开发中，可根据需求选择更优化的算法（如 MurmurHash3）或加密哈希（如 SHA-256）
 */
-uint32_t oatHash(const char* key, size_t len) {
+uint32_t oatHash(const void* key, size_t len, uint32_t seed) {
     // 初始值 hash
-    uint32_t hash = 0;
+    uint32_t hash = seed;
     
     // 转换为字节流处理
     const uint8_t* bytes = (const uint8_t*)key;
@@ -405,6 +777,77 @@ uint32_t oatHash(const char* key, size_t len) {
     return hash;
 }
 
+/**
+* @brief             OAT 哈希算法 64 位版本
+* @note              与 32 位版本使用相同的位移量，状态扩展为 64 位；非标准变体，只保证自身的一致性
+*/
+uint64_t oatHash64(const void* key, size_t len, uint64_t seed) {
+    uint64_t hash = seed;
+
+    const uint8_t* bytes = (const uint8_t*)key;
+    for (size_t i = 0; i < len; i++) {
+        hash += bytes[i];
+        hash += hash << 10;
+        hash ^= hash >> 6;
+    }
+
+    hash += hash << 3;
+    hash ^= hash >> 11;
+    hash += hash << 15;
+
+    return hash;
+}
+
+/**
+* @brief             OAT 流式接口
+* @note              逐字节累加部分放在 update，最终混合放在 final
+*/
+void oatHash_init(OatState* st, uint32_t seed) {
+    st->hash = seed;
+}
+
+void oatHash_update(OatState* st, const void* data, size_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint32_t hash = st->hash;
+    for (size_t i = 0; i < len; i++) {
+        hash += bytes[i];
+        hash += hash << 10;
+        hash ^= hash >> 6;
+    }
+    st->hash = hash;
+}
+
+uint32_t oatHash_final(const OatState* st) {
+    uint32_t hash = st->hash;
+    hash += hash << 3;
+    hash ^= hash >> 11;
+    hash += hash << 15;
+    return hash;
+}
+
+void oatHash64_init(Oat64State* st, uint64_t seed) {
+    st->hash = seed;
+}
+
+void oatHash64_update(Oat64State* st, const void* data, size_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint64_t hash = st->hash;
+    for (size_t i = 0; i < len; i++) {
+        hash += bytes[i];
+        hash += hash << 10;
+        hash ^= hash >> 6;
+    }
+    st->hash = hash;
+}
+
+uint64_t oatHash64_final(const Oat64State* st) {
+    uint64_t hash = st->hash;
+    hash += hash << 3;
+    hash ^= hash >> 11;
+    hash += hash << 15;
+    return hash;
+}
+
 /*
 （8）JEN（Jenkins Lookup3）
  算法特点：
@@ -427,46 +870,85 @@ uint32_t oatHash(const char* key, size_t len) {
  - 网络协议：快速生成报文摘要（如去重检测）
 */
 /**
-* @brief             Jenkins Lookup3 哈希算法
-* @param   key       Param Description
-* @param   len       Param Description
-* @param   seed      Param Description
-* @return  uint32_t  Return Description
+* @brief             Jenkins Lookup3 哈希算法（hashlittle）
+* @param   key       任意二进制数据
+* @param   len       数据长度（字节）
+* @param   seed      种子（lookup3 中的 initval）
+* @return  uint32_t  32 位哈希值
 *
 * @note              Jenkins 哈希算法（"jen" 指 Bob Jenkins 设计的 Lookup3 或类似算法）Bob Jenkins 是著名哈希算法设计者，其开发的 Lookup3 和 SpookyHash 等算法以高效和低碰撞率著称
+*                    实现与 lookup3.c 的 hashlittle/hashlittle2 逐位一致：初始值包含长度，最后一块（1~12 字节）使用 final 而不是 mix
 */
-// 32位循环位移
-#define rol32(val, shift) (((val) << (shift)) | ((val) >> (32 - (shift))))
-// mix 混合函数
-#define mix(a, b, c) do {               \
-    (a) -= (c); (a) ^= rol32(c, 4); (c) += (b);   \
-    (b) -= (a); (b) ^= rol32(a, 6); (a) += (c);   \
-    (c) -= (b); (c) ^= rol32(b, 8); (b) += (a);   \
-    (a) -= (c); (a) ^= rol32(c, 16); (c) += (b);  \
-    (b) -= (a); (b) ^= rol32(a, 19); (a) += (c);  \
-    (c) -= (b); (c) ^= rol32(b, 4); (b) += (a);   \
+// mix 混合函数：可逆的混合，用于中间的 12 字节块
+#define mix(a, b, c) do {                                \
+    (a) -= (c); (a) ^= hash_rotl32(c, 4);  (c) += (b);   \
+    (b) -= (a); (b) ^= hash_rotl32(a, 6);  (a) += (c);   \
+    (c) -= (b); (c) ^= hash_rotl32(b, 8);  (b) += (a);   \
+    (a) -= (c); (a) ^= hash_rotl32(c, 16); (c) += (b);   \
+    (b) -= (a); (b) ^= hash_rotl32(a, 19); (a) += (c);   \
+    (c) -= (b); (c) ^= hash_rotl32(b, 4);  (b) += (a);   \
 } while(0)
 
-uint32_t jenHash(const char* key, size_t len, uint32_t seed) {
+// final 最终混合：让 a, b, c 的每一位都影响 c（和 b）的每一位
+#define final(a, b, c) do {                   \
+    (c) ^= (b); (c) -= hash_rotl32(b, 14);    \
+    (a) ^= (c); (a) -= hash_rotl32(c, 11);    \
+    (b) ^= (a); (b) -= hash_rotl32(a, 25);    \
+    (c) ^= (b); (c) -= hash_rotl32(b, 16);    \
+    (a) ^= (c); (a) -= hash_rotl32(c, 4);     \
+    (b) ^= (a); (b) -= hash_rotl32(a, 14);    \
+    (c) ^= (b); (c) -= hash_rotl32(b, 24);    \
+} while(0)
+
+// 12 字节块累加到 a, b, c 上（小端序，地址无需对齐）后混合
+static inline void lookup3_block(uint32_t* a, uint32_t* b, uint32_t* c, const uint8_t* data) {
+    *a += hash_load32(data);
+    *b += hash_load32(data + 4);
+    *c += hash_load32(data + 8);
+    mix(*a, *b, *c);
+}
+
+// 最后一块（0~12 字节）与最终混合，结果写入 pc、pb
+static void lookup3_last(uint32_t a, uint32_t b, uint32_t c, const uint8_t* data, size_t len,
+                         uint32_t* pc, uint32_t* pb) {
+    switch (len) {
+        case 12: c += ((uint32_t)data[11]) << 24;  /* fall through */
+        case 11: c += ((uint32_t)data[10]) << 16;  /* fall through */
+        case 10: c += ((uint32_t)data[9]) << 8;    /* fall through */
+        case 9:  c += data[8];                     /* fall through */
+        case 8:  b += ((uint32_t)data[7]) << 24;   /* fall through */
+        case 7:  b += ((uint32_t)data[6]) << 16;   /* fall through */
+        case 6:  b += ((uint32_t)data[5]) << 8;    /* fall through */
+        case 5:  b += data[4];                     /* fall through */
+        case 4:  a += ((uint32_t)data[3]) << 24;   /* fall through */
+        case 3:  a += ((uint32_t)data[2]) << 16;   /* fall through */
+        case 2:  a += ((uint32_t)data[1]) << 8;    /* fall through */
+        case 1:  a += data[0];
+                 break;
+        case 0:  // 只有长度为 0 时才会到这里，lookup3 规定此时不做 final
+                 *pc = c;
+                 *pb = b;
+                 return;
+    }
+    // 最终混合
+    final(a, b, c);
+
+    *pc = c;
+    *pb = b;
+}
+
+// lookup3 主体（hashlittle2）：pc、pb 输入为两个种子，输出为两个 32 位哈希值
+static void lookup3(const void* key, size_t len, uint32_t* pc, uint32_t* pb) {
     // 初始值
     uint32_t a, b, c;
-    a = b = 0xdeadbeef;  
-    c = seed;
+    a = b = c = 0xdeadbeef + (uint32_t)len + *pc;
+    c += *pb;
 
     // 转为 二进制字节流 1字节 8位
     const uint8_t* data = (const uint8_t*)(key);
-    // 12 字节 一次循环
-    while(len >= 12) {
-        // 每块转换为三个 uint32_t 值（小端序），并进行混合
-        uint32_t k1, k2, k3;
-        // 数据拷贝到 k1, k2, k3，使用 memcpy 代替直接类型转换（*(uint32_t*)data）以避免未对齐访问
-        memcpy(&k1, data, 4);
-        memcpy(&k2, data + 4, 4);
-        memcpy(&k3, data + 8, 4);
-        // 累加到 a, b, c上
-        a += k1; b += k2; c += k3;
-        // 调用混合函数
-        mix(a, b, c);
+    // 12 字节 一次循环，最后一块（可能正好 12 字节）留给尾部处理
+    while(len > 12) {
+        lookup3_block(&a, &b, &c, data);
         // 指针偏移 12 个字节
         data += 12;
         // 已处理长度减少 12 个字节
@@ -474,73 +956,543 @@ uint32_t jenHash(const char* key, size_t len, uint32_t seed) {
     }
 
     // 处理尾部字节
-    // 记录剩余长度
-    c += len;
-    switch (len) {
-        case 11: c += ((uint32_t)data[10]) << 24;
-        case 10: c += ((uint32_t)data[9]) << 16;   
-        case 9:  c += ((uint32_t)data[8]) << 8;    
-        case 8:  b += ((uint32_t)data[7]) << 24;   
-        case 7:  b += ((uint32_t)data[6]) << 16;   
-        case 6:  b += ((uint32_t)data[5]) << 8;    
-        case 5:  b += data[4];                     
-        case 4:  a += ((uint32_t)data[3]) << 24;   
-        case 3:  a += ((uint32_t)data[2]) << 16;   
-        case 2:  a += ((uint32_t)data[1]) << 8;    
-        case 1:  a += data[0];                     
-        case 0:  break;         
-    }
-    // 再次调用混合函数
-    mix(a, b, c);
+    lookup3_last(a, b, c, data, len, pc, pb);
+}
 
+uint32_t jenHash(const void* key, size_t len, uint32_t seed) {
+    uint32_t c = seed, b = 0;
+    lookup3(key, len, &c, &b);
     return c;
 }
 
-int main(void) {
-
-    // 示例1：计算字符串 "abcd" 的哈希值
-    const char* str = "abcd";
-    unsigned int hash1 = times33Hash(str);
-    printf("times33 Hash of \"%s\": %u\n", str, hash1);
-    // 示例2：验证碰撞案例（理论上可能）
-    const char* str2 = "A";
-    const char* str3 = "\0A";                            // 包含空字符的字符串
-    unsigned int hash2 = times33Hash(str2);
-    unsigned int hash3 = times33Hash(str3);
-    printf("times33 Hash of \"%s\": %u\n", str2, hash2);  // 输出 65
-    printf("times33 Hash of \"\\0A\": %u\n", hash3);      // 输出 65
-
-    // 示例1：计算字符串 "hello" 的哈希值
-    const char* murstr1 = "hello";
-    uint32_t murhash1 = murmurHash3_32((const void*)murstr1, strlen(murstr1), 0);
-    printf("murmur Hash of \"%s\": 0x%08x\n", murstr1, murhash1); // 输出 0x248bfa47
-    // 示例2：验证相同输入不同种子结果不同
-    uint32_t murhash2 = murmurHash3_32((const void*)murstr1, strlen(murstr1), 42);
-    printf("murmur Hash of \"%s\" (seed=42): 0x%08x\n", murstr1, murhash2); // 输出 0x5e928f0f
-    // 示例3：验证不同输入结果不同
-    const char* murstr2 = "world";
-    uint32_t murhash3 = murmurHash3_32((const void*)murstr2, strlen(murstr2), 0);
-    printf("murmur Hash of \"%s\": 0x%08x\n", murstr2, murhash3); // 输出 0x5ba3c492
-
-    // 示例1：计算字符串 "hello" 的哈希值
-    const char* saxstr = "hello";
-    uint32_t saxhash = saxHash(saxstr);
-    printf("sax hash of \"%s\": 0x%08x\n", saxstr, saxhash);
-
-    // 示例1：计算字符串 "hello" 的哈希值
-    const char* fnvstr = "hello";
-    uint32_t fnvhash = fnvHash(fnvstr, strlen(fnvstr));
-    printf("fnv-1a hash of \"%s\": 0x%08x\n", fnvstr, fnvhash);
-
-    // 示例1：计算字符串 "hello" 的哈希值
-    const char* oatstr = "hello";
-    uint32_t oathash = oatHash(oatstr, strlen(oatstr));
-    printf("oat hash of \"%s\": 0x%08x\n", oatstr, oathash);
-
-    // 示例1：计算字符串 "hello" 的哈希值
-    const char* jenstr = "hello";
-    uint32_t jenhash = jenHash(jenstr, strlen(jenstr), 0);
-    printf("jenkins hash of \"%s\": 0x%08x\n", jenstr, jenhash);
+/**
+* @brief             Jenkins Lookup3 64 位版本（hashlittle2）
+* @note              种子低 32 位作为 pc、高 32 位作为 pb 传入，返回 c | (b << 32)
+*/
+uint64_t jenHash64(const void* key, size_t len, uint64_t seed) {
+    uint32_t c = (uint32_t)seed, b = (uint32_t)(seed >> 32);
+    lookup3(key, len, &c, &b);
+    return (uint64_t)c | ((uint64_t)b << 32);
+}
+
+/**
+* @brief             Jenkins Lookup3 流式接口：初始化
+* @param   st        状态
+* @param   total_len 之后所有 update 的总字节数（lookup3 的初始状态包含长度）
+* @param   seed      种子，含义与 jenHash / jenHash64 相同
+*/
+void jenHash_init(JenState* st, size_t total_len, uint32_t seed) {
+    jenHash64_init(st, total_len, seed);
+}
+
+void jenHash64_init(JenState* st, size_t total_len, uint64_t seed) {
+    st->a = st->b = st->c = 0xdeadbeef + (uint32_t)total_len + (uint32_t)seed;
+    st->c += (uint32_t)(seed >> 32);
+    st->buf_len = 0;
+    st->expected = total_len;
+    st->total = 0;
+}
+
+/**
+* @brief             Jenkins Lookup3 流式接口：输入一段数据
+* @note              一次性版本把最后一块（1~12 字节）留给 final，流式版本无法提前知道哪一块是最后一块，
+*                    因此 buf 凑满 12 字节后先不处理，等到后面确实还有数据时才混合
+*/
+void jenHash_update(JenState* st, const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    st->total += len;
+
+    while (len > 0) {
+        if (st->buf_len == 12) {
+            lookup3_block(&st->a, &st->b, &st->c, st->buf);
+            st->buf_len = 0;
+        }
+        if (st->buf_len == 0) {
+            // 直接处理输入中的整块，至少留下 1 字节给 buf
+            while (len > 12) {
+                lookup3_block(&st->a, &st->b, &st->c, p);
+                p += 12;
+                len -= 12;
+            }
+        }
+        hash_buf_fill(st->buf, &st->buf_len, 12, &p, &len);
+    }
+}
+
+uint32_t jenHash_final(const JenState* st) {
+    return (uint32_t)jenHash64_final(st);
+}
+
+uint64_t jenHash64_final(const JenState* st) {
+    uint32_t c, b;
+    // 总长度与 init 时声明的不一致，结果不会等于一次性版本
+    assert(st->total == st->expected);
+    lookup3_last(st->a, st->b, st->c, st->buf, st->buf_len, &c, &b);
+    return (uint64_t)c | ((uint64_t)b << 32);
+}
+
+#undef mix
+#undef final
+
+/*
+（9）xxHash64：Yann Collet 设计的 64 位非加密哈希，属于 "宽通道" 哈希
+ 算法特点：
+ - 四条独立的 64 位累加器（lane），每次循环处理 32 字节，每条 lane 吃 8 字节，
+   四条 lane 之间没有数据依赖，乱序 CPU 可以同时执行四个乘法，长键吞吐远高于每次 4 字节的 MurmurHash3_32
+ - 64 位输出：适合键数量超过 2^32 的哈希表
+ - 输入小于 32 字节时跳过 lane 初始化，直接走尾部处理，短键延迟低
+ 核心步骤：
+ - 初始化：v1 = seed + P1 + P2，v2 = seed + P2，v3 = seed，v4 = seed - P1
+ - 条带处理（每 32 字节）：vi = rotl(vi + input_i * P2, 31) * P1
+ - 合并：h = rotl(v1,1) + rotl(v2,7) + rotl(v3,12) + rotl(v4,18)，再把每条 lane 逐一混入
+ - 尾部：剩余数据按 8 字节、4 字节、1 字节依次混入
+ - 雪崩：移位异或与乘法交替，消除残留的规律性
+ SIMD 版本：
+ - 四条 lane 正好放进一个 256 位 AVX2 寄存器，一条指令完成四条 lane 的加法/移位；
+   AVX2 没有 64 位乘法低位指令，用三次 32x32->64 乘法（vpmuludq）拼出，结果与标量版本逐位一致
+ - 运行时检测 CPU 是否支持 AVX2，不支持时回退到标量版本，编译时无需额外的 -mavx2 选项
+ - 注意：每条 lane 都是串行的依赖链（本轮的乘法依赖上一轮的结果），标量版本的四个 imul（延迟约 3 周期）
+   可以并行执行，而拼出来的 64 位向量乘法延迟在 10 周期以上，实测 AVX2 版本比标量版本慢约 30%，
+   因此默认实现 xxHash64 使用标量版本；AVX2 版本保留给一次哈希多个键的场景（每个键占一条 lane，没有串行依赖）
+*/
+#define XXH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3 0x165667B19E3779F9ULL
+#define XXH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t xxh64_round(uint64_t acc, uint64_t input) {
+    acc += input * XXH_PRIME64_2;
+    acc = hash_rotl64(acc, 31);
+    acc *= XXH_PRIME64_1;
+    return acc;
+}
+
+static inline uint64_t xxh64_merge_round(uint64_t acc, uint64_t val) {
+    val = xxh64_round(0, val);
+    acc ^= val;
+    acc = acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+    return acc;
+}
+
+// 四条 lane 合并为一个 64 位值
+static uint64_t xxh64_merge_lanes(const uint64_t v[4]) {
+    uint64_t h = hash_rotl64(v[0], 1) + hash_rotl64(v[1], 7) + hash_rotl64(v[2], 12) + hash_rotl64(v[3], 18);
+    for (int i = 0; i < 4; i++) {
+        h = xxh64_merge_round(h, v[i]);
+    }
+    return h;
+}
+
+// 处理不足 32 字节的尾部并做雪崩，h 中已经混入了总长度
+static uint64_t xxh64_finalize(uint64_t h, const uint8_t* p, size_t len) {
+    while (len >= 8) {
+        h ^= xxh64_round(0, hash_load64(p));
+        h = hash_rotl64(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        p += 8;
+        len -= 8;
+    }
+    if (len >= 4) {
+        h ^= (uint64_t)hash_load32(p) * XXH_PRIME64_1;
+        h = hash_rotl64(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+        len -= 4;
+    }
+    while (len > 0) {
+        h ^= (*p) * XXH_PRIME64_5;
+        h = hash_rotl64(h, 11) * XXH_PRIME64_1;
+        p++;
+        len--;
+    }
+
+    // 雪崩
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+static inline void xxh64_init_lanes(uint64_t v[4], uint64_t seed) {
+    v[0] = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+    v[1] = seed + XXH_PRIME64_2;
+    v[2] = seed;
+    v[3] = seed - XXH_PRIME64_1;
+}
+
+/**
+* @brief             xxHash64 标量版本
+* @param   key       任意二进制数据
+* @param   len       数据长度（字节）
+* @param   seed      64 位种子
+* @return  uint64_t  64 位哈希值，与 xxHash 参考实现 XXH64 逐位一致
+*/
+uint64_t xxHash64_scalar(const void* key, size_t len, uint64_t seed) {
+    const uint8_t* p = (const uint8_t*)key;
+    const size_t total = len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v[4];
+        xxh64_init_lanes(v, seed);
+        // 32 字节一个条带，四条 lane 互不依赖
+        do {
+            v[0] = xxh64_round(v[0], hash_load64(p));
+            v[1] = xxh64_round(v[1], hash_load64(p + 8));
+            v[2] = xxh64_round(v[2], hash_load64(p + 16));
+            v[3] = xxh64_round(v[3], hash_load64(p + 24));
+            p += 32;
+            len -= 32;
+        } while (len >= 32);
+        h = xxh64_merge_lanes(v);
+    } else {
+        h = seed + XXH_PRIME64_5;
+    }
+
+    h += (uint64_t)total;
+    return xxh64_finalize(h, p, len);
+}
+
+#if defined(__x86_64__) && defined(__GNUC__) && !HASH_BIG_ENDIAN
+#define HASH_HAVE_AVX2 1
+#include <immintrin.h>
+
+// 64 位乘法取低 64 位：a*b = lo(a)*lo(b) + ((hi(a)*lo(b) + lo(a)*hi(b)) << 32)
+__attribute__((target("avx2")))
+static inline __m256i xxh64_mullo_avx2(__m256i a, __m256i b, __m256i b_hi) {
+    __m256i lo = _mm256_mul_epu32(a, b);
+    __m256i c1 = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+    __m256i c2 = _mm256_mul_epu32(a, b_hi);
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(_mm256_add_epi64(c1, c2), 32));
+}
+
+__attribute__((target("avx2")))
+static uint64_t xxHash64_avx2_impl(const void* key, size_t len, uint64_t seed) {
+    const uint8_t* p = (const uint8_t*)key;
+    const size_t total = len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v[4];
+        xxh64_init_lanes(v, seed);
 
+        const __m256i p1 = _mm256_set1_epi64x((long long)XXH_PRIME64_1);
+        const __m256i p1_hi = _mm256_srli_epi64(p1, 32);
+        const __m256i p2 = _mm256_set1_epi64x((long long)XXH_PRIME64_2);
+        const __m256i p2_hi = _mm256_srli_epi64(p2, 32);
+        __m256i acc = _mm256_loadu_si256((const __m256i*)v);
+        // 一个条带正好是一个 256 位寄存器，四条 lane 同时完成 round
+        do {
+            __m256i in = _mm256_loadu_si256((const __m256i*)p);
+            acc = _mm256_add_epi64(acc, xxh64_mullo_avx2(in, p2, p2_hi));
+            acc = _mm256_or_si256(_mm256_slli_epi64(acc, 31), _mm256_srli_epi64(acc, 33));
+            acc = xxh64_mullo_avx2(acc, p1, p1_hi);
+            p += 32;
+            len -= 32;
+        } while (len >= 32);
+        _mm256_storeu_si256((__m256i*)v, acc);
+        h = xxh64_merge_lanes(v);
+    } else {
+        h = seed + XXH_PRIME64_5;
+    }
+
+    h += (uint64_t)total;
+    return xxh64_finalize(h, p, len);
+}
+#else
+#define HASH_HAVE_AVX2 0
+#endif
+
+/**
+* @brief             当前 CPU 是否可以使用 AVX2 版本
+* @return  int       1 可以，0 不可以（非 x86_64 或 CPU 不支持）
+*/
+int hash_cpu_has_avx2(void) {
+#if HASH_HAVE_AVX2
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return cached;
+#else
     return 0;
-}
\ No newline at end of file
+#endif
+}
+
+/**
+* @brief             xxHash64 AVX2 版本，CPU 不支持时回退到标量版本
+* @note              结果与 xxHash64_scalar 逐位一致
+*/
+uint64_t xxHash64_avx2(const void* key, size_t len, uint64_t seed) {
+#if HASH_HAVE_AVX2
+    if (hash_cpu_has_avx2()) {
+        return xxHash64_avx2_impl(key, len, seed);
+    }
+#endif
+    return xxHash64_scalar(key, len, seed);
+}
+
+/**
+* @brief             xxHash64（默认实现，标量版本）
+*/
+uint64_t xxHash64(const void* key, size_t len, uint64_t seed) {
+    return xxHash64_scalar(key, len, seed);
+}
+
+/*
+（10）批量哈希：一次调用哈希 N 个键
+ 单个键的 MurmurHash3 / xxHash 每一步都依赖上一步的乘法结果，短键的耗时基本就是这条乘法依赖链的延迟，
+ CPU 的多个乘法单元大部分时间是空闲的。批量接口把多个互不相关的键交错计算：
+ - 标量交错：每组 HASH_BATCH_LANES（4）个键，先按组内最短键的长度逐块轮流推进每个键的哈希状态，
+   各条依赖链之间没有数据依赖，乱序执行可以把它们重叠起来；剩余部分再逐个键收尾
+ - SIMD gather（定长键）：8 个键放进一个 AVX2 寄存器的 8 条 32 位 lane，每个块用一条 vpgatherdd 读取 8 个键的
+   同一位置，MurmurHash3_32 只需要 32 位乘法（vpmulld），8 个键一起完成一轮混合
+ 所有批量接口的结果与逐个调用单键版本逐位一致
+*/
+#define HASH_BATCH_LANES 4
+
+/**
+* @brief             MurmurHash3 32 位批量哈希（变长键）
+* @param   keys      n 个键的地址
+* @param   lens      n 个键的长度
+* @param   n         键的个数
+* @param   seed      种子（所有键相同）
+* @param   out       输出 n 个哈希值
+*/
+void murmurHash3_32_batch(const void* const keys[], const size_t lens[], size_t n, uint32_t seed, uint32_t out[]) {
+    size_t i = 0;
+    for (; i + HASH_BATCH_LANES <= n; i += HASH_BATCH_LANES) {
+        uint32_t h[HASH_BATCH_LANES];
+        size_t min_len = lens[i];
+        for (int l = 0; l < HASH_BATCH_LANES; l++) {
+            h[l] = seed;
+            if (lens[i + l] < min_len) {
+                min_len = lens[i + l];
+            }
+        }
+        // 所有键都有的整块部分交错计算
+        size_t common = min_len & ~(size_t)3;
+        for (size_t off = 0; off < common; off += 4) {
+            for (int l = 0; l < HASH_BATCH_LANES; l++) {
+                h[l] = murmur3_32_block(h[l], hash_load32((const uint8_t*)keys[i + l] + off));
+            }
+        }
+        for (int l = 0; l < HASH_BATCH_LANES; l++) {
+            out[i + l] = murmur3_32_finish(h[l], (const uint8_t*)keys[i + l] + common,
+                                           lens[i + l] - common, lens[i + l]);
+        }
+    }
+    for (; i < n; i++) {
+        out[i] = murmurHash3_32(keys[i], lens[i], seed);
+    }
+}
+
+/**
+* @brief             MurmurHash3 32 位批量哈希（定长键，标量交错版本）
+* @param   base      第一个键的地址
+* @param   stride    相邻两个键的地址间隔（键在结构体数组中时为结构体大小，紧密排列时等于 key_len）
+* @param   key_len   每个键的长度
+* @param   n         键的个数
+* @param   seed      种子
+* @param   out       输出 n 个哈希值
+*/
+void murmurHash3_32_batch_fixed_scalar(const void* base, size_t stride, size_t key_len, size_t n,
+                                       uint32_t seed, uint32_t out[]) {
+    const uint8_t* p = (const uint8_t*)base;
+    const size_t blocks = key_len & ~(size_t)3;
+    size_t i = 0;
+    for (; i + HASH_BATCH_LANES <= n; i += HASH_BATCH_LANES) {
+        uint32_t h[HASH_BATCH_LANES];
+        for (int l = 0; l < HASH_BATCH_LANES; l++) {
+            h[l] = seed;
+        }
+        for (size_t off = 0; off < blocks; off += 4) {
+            for (int l = 0; l < HASH_BATCH_LANES; l++) {
+                h[l] = murmur3_32_block(h[l], hash_load32(p + (i + l) * stride + off));
+            }
+        }
+        for (int l = 0; l < HASH_BATCH_LANES; l++) {
+            out[i + l] = murmur3_32_finish(h[l], p + (i + l) * stride + blocks, key_len - blocks, key_len);
+        }
+    }
+    for (; i < n; i++) {
+        out[i] = murmurHash3_32(p + i * stride, key_len, seed);
+    }
+}
+
+#if HASH_HAVE_AVX2
+__attribute__((target("avx2")))
+static inline __m256i murmur3_32_rotl_avx2(__m256i x, int r) {
+    return _mm256_or_si256(_mm256_slli_epi32(x, r), _mm256_srli_epi32(x, 32 - r));
+}
+
+// 8 个键的同一个 4 字节块：与 murmur3_32_block 相同的混合
+__attribute__((target("avx2")))
+static inline __m256i murmur3_32_mix_k_avx2(__m256i k) {
+    k = _mm256_mullo_epi32(k, _mm256_set1_epi32((int)0xcc9e2d51));
+    k = murmur3_32_rotl_avx2(k, 15);
+    return _mm256_mullo_epi32(k, _mm256_set1_epi32(0x1b873593));
+}
+
+__attribute__((target("avx2")))
+static void murmurHash3_32_batch_fixed_avx2(const uint8_t* p, size_t stride, size_t key_len, size_t n,
+                                            uint32_t seed, uint32_t out[]) {
+    const size_t blocks = key_len & ~(size_t)3;
+    const size_t rem = key_len & 3;
+    // 第 l 个键相对组首的偏移，gather 的下标是 32 位有符号数，最大为 7 * stride + key_len - 4，
+    // 调用方保证 7 * stride + key_len 不超过 INT32_MAX（键重叠即 key_len > stride 时同样成立）
+    const __m256i lane_off = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                _mm256_set1_epi32((int)stride));
+    const __m256i n_add = _mm256_set1_epi32((int)0xe6546b64);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int* group = (const int*)(p + i * stride);
+        __m256i h = _mm256_set1_epi32((int)seed);
+        for (size_t off = 0; off < blocks; off += 4) {
+            __m256i idx = _mm256_add_epi32(lane_off, _mm256_set1_epi32((int)off));
+            __m256i k = _mm256_i32gather_epi32(group, idx, 1);
+            h = _mm256_xor_si256(h, murmur3_32_mix_k_avx2(k));
+            h = murmur3_32_rotl_avx2(h, 13);
+            h = _mm256_add_epi32(_mm256_add_epi32(_mm256_slli_epi32(h, 2), h), n_add);
+        }
+        if (rem != 0) {
+            // 尾部：读取键的最后 4 个字节再右移，避免越过最后一个键的末尾读取
+            __m256i idx = _mm256_add_epi32(lane_off, _mm256_set1_epi32((int)(key_len - 4)));
+            __m256i k = _mm256_i32gather_epi32(group, idx, 1);
+            k = _mm256_srli_epi32(k, (int)(8 * (4 - rem)));
+            h = _mm256_xor_si256(h, murmur3_32_mix_k_avx2(k));
+        }
+        // 最终混合
+        h = _mm256_xor_si256(h, _mm256_set1_epi32((int)key_len));
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+        h = _mm256_mullo_epi32(h, _mm256_set1_epi32((int)0x85ebca6b));
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+        h = _mm256_mullo_epi32(h, _mm256_set1_epi32((int)0xc2b2ae35));
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+        _mm256_storeu_si256((__m256i*)(out + i), h);
+    }
+    for (; i < n; i++) {
+        out[i] = murmurHash3_32(p + i * stride, key_len, seed);
+    }
+}
+#endif
+
+/**
+* @brief             MurmurHash3 32 位批量哈希（定长键）
+* @note              CPU 支持 AVX2 时使用 gather 版本，否则使用标量交错版本；
+*                    键长小于 4 字节（尾部读取会越过键的开头）或 7 * stride + key_len 超出 gather 下标范围时也使用标量版本
+*/
+void murmurHash3_32_batch_fixed(const void* base, size_t stride, size_t key_len, size_t n,
+                                uint32_t seed, uint32_t out[]) {
+#if HASH_HAVE_AVX2
+    if (key_len >= 4 && key_len <= (size_t)INT32_MAX && stride <= ((size_t)INT32_MAX - key_len) / 7 &&
+        hash_cpu_has_avx2()) {
+        murmurHash3_32_batch_fixed_avx2((const uint8_t*)base, stride, key_len, n, seed, out);
+        return;
+    }
+#endif
+    murmurHash3_32_batch_fixed_scalar(base, stride, key_len, n, seed, out);
+}
+
+/**
+* @brief             xxHash64 批量哈希（变长键）
+* @note              短于 32 字节的键没有 4 条 lane 的条带循环，单键时是一条串行依赖链，
+*                    这里按组内都有的 8 字节字交错推进；32 字节及以上的键单键内部已经有 4 条并行的 lane，直接逐个计算
+*/
+void xxHash64_batch(const void* const keys[], const size_t lens[], size_t n, uint64_t seed, uint64_t out[]) {
+    size_t i = 0;
+    for (; i + HASH_BATCH_LANES <= n; i += HASH_BATCH_LANES) {
+        uint64_t h[HASH_BATCH_LANES];
+        size_t min_len = (size_t)-1;
+        size_t max_len = 0;
+        for (int l = 0; l < HASH_BATCH_LANES; l++) {
+            size_t len = lens[i + l];
+            h[l] = seed + XXH_PRIME64_5 + (uint64_t)len;
+            min_len = len < min_len ? len : min_len;
+            max_len = len > max_len ? len : max_len;
+        }
+        if (max_len >= 32) {
+            for (int l = 0; l < HASH_BATCH_LANES; l++) {
+                out[i + l] = xxHash64_scalar(keys[i + l], lens[i + l], seed);
+            }
+            continue;
+        }
+        size_t common = min_len & ~(size_t)7;
+        for (size_t off = 0; off < common; off += 8) {
+            for (int l = 0; l < HASH_BATCH_LANES; l++) {
+                h[l] ^= xxh64_round(0, hash_load64((const uint8_t*)keys[i + l] + off));
+                h[l] = hash_rotl64(h[l], 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+            }
+        }
+        for (int l = 0; l < HASH_BATCH_LANES; l++) {
+            out[i + l] = xxh64_finalize(h[l], (const uint8_t*)keys[i + l] + common, lens[i + l] - common);
+        }
+    }
+    for (; i < n; i++) {
+        out[i] = xxHash64_scalar(keys[i], lens[i], seed);
+    }
+}
+
+/*
+ 运行时选择哈希算法
+ 哈希表、过滤器等结构可以在创建时保存 HashAlg 或函数指针，不必在编译期绑定某一个算法
+*/
+// 64 位哈希取低 32 位作为 32 位版本，种子零扩展
+static uint32_t murmurHash3_x64_32(const void* key, size_t len, uint32_t seed) {
+    return (uint32_t)murmurHash3_x64_64(key, len, seed);
+}
+
+static uint32_t xxHash64_32(const void* key, size_t len, uint32_t seed) {
+    return (uint32_t)xxHash64(key, len, seed);
+}
+
+static uint32_t murmurHash64A_32(const void* key, size_t len, uint32_t seed) {
+    return (uint32_t)murmurHash64A(key, len, seed);
+}
+
+static const HashAlgInfo hash_alg_table[HASH_ALG_COUNT] = {
+    { HASH_ALG_TIMES33,   "times33",   times33Hash,        times33Hash64 },
+    { HASH_ALG_MURMUR,    "murmur",    murmurHash3_32,     murmurHash3_x64_64 },
+    { HASH_ALG_SAX,       "sax",       saxHash,            saxHash64 },
+    { HASH_ALG_FNV1A,     "fnv1a",     fnvHash,            fnvHash64 },
+    { HASH_ALG_OAT,       "oat",       oatHash,            oatHash64 },
+    { HASH_ALG_JENKINS,   "jenkins",   jenHash,            jenHash64 },
+    { HASH_ALG_MURMUR128, "murmur128", murmurHash3_x64_32, murmurHash3_x64_64 },
+    { HASH_ALG_XXH64,     "xxh64",     xxHash64_32,        xxHash64 },
+    { HASH_ALG_MURMUR64A, "murmur64a", murmurHash64A_32,   murmurHash64A },
+};
+
+const HashAlgInfo* hash_alg_get(HashAlg alg) {
+    if ((unsigned)alg >= HASH_ALG_COUNT) {
+        return NULL;
+    }
+    return &hash_alg_table[alg];
+}
+
+const HashAlgInfo* hash_alg_find(const char* name) {
+    if (name == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < HASH_ALG_COUNT; i++) {
+        if (strcmp(hash_alg_table[i].name, name) == 0) {
+            return &hash_alg_table[i];
+        }
+    }
+    return NULL;
+}
+
+uint32_t hash_alg32(HashAlg alg, const void* key, size_t len, uint32_t seed) {
+    if ((unsigned)alg >= HASH_ALG_COUNT) {
+        alg = HASH_ALG_MURMUR;
+    }
+    return hash_alg_table[alg].hash32(key, len, seed);
+}
+
+uint64_t hash_alg64(HashAlg alg, const void* key, size_t len, uint64_t seed) {
+    if ((unsigned)alg >= HASH_ALG_COUNT) {
+        alg = HASH_ALG_MURMUR;
+    }
+    return hash_alg_table[alg].hash64(key, len, seed);
+}
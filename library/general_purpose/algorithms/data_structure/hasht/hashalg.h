@@ -0,0 +1,176 @@
+#ifndef HASHALG_H
+#define HASHALG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ 非加密哈希函数库
+ （1）统一接口：所有函数都以 (const void* key, size_t len, seed) 接收任意二进制数据，
+      不依赖 '\0' 结尾，可以直接用于结构体、整数等定长键
+ （2）两种输出宽度：32 位版本使用 uint32_t 种子，64 位版本使用 uint64_t 种子
+ （3）可移植：分块读取使用 memcpy 加显式的小端序转换，未对齐的地址和大端平台上结果一致
+ （4）运行时选择：通过 HashAlg 枚举或名字查询函数指针，哈希表等结构可以在创建时指定哈希算法
+*/
+
+// 32 位与 64 位哈希函数指针类型
+typedef uint32_t (*hash32_fn)(const void* key, size_t len, uint32_t seed);
+typedef uint64_t (*hash64_fn)(const void* key, size_t len, uint64_t seed);
+
+// Times33（DJB）：hash = hash * 33 + byte，种子作为初始哈希值
+uint32_t times33Hash(const void* key, size_t len, uint32_t seed);
+uint64_t times33Hash64(const void* key, size_t len, uint64_t seed);
+
+// MurmurHash3 x86_32（与参考实现逐位一致）
+uint32_t murmurHash3_32(const void* key, size_t len, uint32_t seed);
+// MurmurHash2 64A，Murmur 系列的 64 位版本
+uint64_t murmurHash64A(const void* key, size_t len, uint64_t seed);
+
+// Shift-Add-XOR，种子作为初始哈希值
+uint32_t saxHash(const void* key, size_t len, uint32_t seed);
+uint64_t saxHash64(const void* key, size_t len, uint64_t seed);
+
+// FNV-1a，种子与 offset basis 异或后作为初始值（种子为0时即标准 FNV-1a）
+uint32_t fnvHash(const void* key, size_t len, uint32_t seed);
+uint64_t fnvHash64(const void* key, size_t len, uint64_t seed);
+
+// Jenkins one-at-a-time，种子作为初始哈希值
+uint32_t oatHash(const void* key, size_t len, uint32_t seed);
+uint64_t oatHash64(const void* key, size_t len, uint64_t seed);
+
+// Jenkins lookup3：32 位为 hashlittle，64 位为 hashlittle2（种子低32位为 pc、高32位为 pb）
+uint32_t jenHash(const void* key, size_t len, uint32_t seed);
+uint64_t jenHash64(const void* key, size_t len, uint64_t seed);
+
+// MurmurHash3 x64_128：out[0] 为 h1，out[1] 为 h2，与参考实现逐位一致
+void murmurHash3_x64_128(const void* key, size_t len, uint32_t seed, uint64_t out[2]);
+// 取 x64_128 的 h1 作为 64 位哈希值，64 位种子同时初始化 h1 与 h2
+uint64_t murmurHash3_x64_64(const void* key, size_t len, uint64_t seed);
+
+// xxHash64：四条 64 位 lane，每次循环 32 字节，与参考实现 XXH64 逐位一致
+// 默认实现为标量版本（单键哈希时比 AVX2 版本快，见 hashalg.c），_scalar/_avx2 供测试与基准测试直接调用
+uint64_t xxHash64(const void* key, size_t len, uint64_t seed);
+uint64_t xxHash64_scalar(const void* key, size_t len, uint64_t seed);
+// CPU 不支持 AVX2 时回退到标量版本
+uint64_t xxHash64_avx2(const void* key, size_t len, uint64_t seed);
+// 当前 CPU 是否可以使用 AVX2 版本
+int hash_cpu_has_avx2(void);
+
+/*
+ 流式接口（init / update / final）
+ 数据分多次到达（网络缓冲区、文件分块）时无需先拷贝到一块连续内存；
+ 任意切分方式下 final 的结果都与一次性版本逐位一致。状态结构体可以放在栈上，不分配内存
+*/
+typedef struct {
+    uint32_t hash;
+    uint32_t buf_len;       // buf 中未处理的字节数（< 4）
+    size_t total;           // 已输入的总字节数
+    uint8_t buf[4];
+} Murmur3_32State;
+
+void murmurHash3_32_init(Murmur3_32State* st, uint32_t seed);
+void murmurHash3_32_update(Murmur3_32State* st, const void* data, size_t len);
+uint32_t murmurHash3_32_final(const Murmur3_32State* st);
+
+typedef struct {
+    uint64_t h1;
+    uint64_t h2;
+    uint32_t buf_len;       // buf 中未处理的字节数（< 16）
+    size_t total;
+    uint8_t buf[16];
+} Murmur3_128State;
+
+// 种子小于 2^32 时 final 与 murmurHash3_x64_128 一致，任意 64 位种子与 murmurHash3_x64_64 一致（out[0]）
+void murmurHash3_x64_128_init(Murmur3_128State* st, uint64_t seed);
+void murmurHash3_x64_128_update(Murmur3_128State* st, const void* data, size_t len);
+void murmurHash3_x64_128_final(const Murmur3_128State* st, uint64_t out[2]);
+
+typedef struct { uint32_t hash; } FnvState;
+typedef struct { uint64_t hash; } Fnv64State;
+
+void fnvHash_init(FnvState* st, uint32_t seed);
+void fnvHash_update(FnvState* st, const void* data, size_t len);
+uint32_t fnvHash_final(const FnvState* st);
+void fnvHash64_init(Fnv64State* st, uint64_t seed);
+void fnvHash64_update(Fnv64State* st, const void* data, size_t len);
+uint64_t fnvHash64_final(const Fnv64State* st);
+
+typedef struct { uint32_t hash; } OatState;
+typedef struct { uint64_t hash; } Oat64State;
+
+void oatHash_init(OatState* st, uint32_t seed);
+void oatHash_update(OatState* st, const void* data, size_t len);
+uint32_t oatHash_final(const OatState* st);
+void oatHash64_init(Oat64State* st, uint64_t seed);
+void oatHash64_update(Oat64State* st, const void* data, size_t len);
+uint64_t oatHash64_final(const Oat64State* st);
+
+// lookup3 把总长度混入初始状态，因此 init 时必须给出总长度 total_len，
+// 之后 update 的字节数之和必须等于 total_len（调试版本在 final 时 assert 检查）
+typedef struct {
+    uint32_t a, b, c;
+    uint32_t buf_len;       // buf 中未处理的字节数（1~12，仅在输入为空时为 0）
+    size_t expected;        // init 时声明的总长度
+    size_t total;           // 已输入的总字节数
+    uint8_t buf[12];
+} JenState;
+
+void jenHash_init(JenState* st, size_t total_len, uint32_t seed);
+void jenHash64_init(JenState* st, size_t total_len, uint64_t seed);
+void jenHash_update(JenState* st, const void* data, size_t len);
+// 32 位结果（hashlittle），与 jenHash_init 配对
+uint32_t jenHash_final(const JenState* st);
+// 64 位结果（hashlittle2），与 jenHash64_init 配对
+uint64_t jenHash64_final(const JenState* st);
+
+/*
+ 批量接口：一次哈希 n 个键，多个键交错计算以隐藏乘法延迟，结果与逐个调用单键版本一致
+ 定长键接口按 base + i * stride 取第 i 个键，键可以是结构体数组中的一个字段
+*/
+void murmurHash3_32_batch(const void* const keys[], const size_t lens[], size_t n, uint32_t seed, uint32_t out[]);
+// CPU 支持 AVX2 时使用 gather 版本（8 个键一组），否则同 _scalar
+void murmurHash3_32_batch_fixed(const void* base, size_t stride, size_t key_len, size_t n,
+                                uint32_t seed, uint32_t out[]);
+void murmurHash3_32_batch_fixed_scalar(const void* base, size_t stride, size_t key_len, size_t n,
+                                       uint32_t seed, uint32_t out[]);
+void xxHash64_batch(const void* const keys[], const size_t lens[], size_t n, uint64_t seed, uint64_t out[]);
+
+// 运行时可选择的哈希算法
+typedef enum {
+    HASH_ALG_TIMES33,
+    HASH_ALG_MURMUR,            // MurmurHash3：32 位为 x86_32，64 位取 x64_128 的前 64 位（与 murmur128 相同）
+    HASH_ALG_SAX,
+    HASH_ALG_FNV1A,
+    HASH_ALG_OAT,
+    HASH_ALG_JENKINS,
+    HASH_ALG_MURMUR128,
+    HASH_ALG_XXH64,
+    HASH_ALG_MURMUR64A,         // MurmurHash2-64A，32 位取低 32 位
+    HASH_ALG_COUNT
+} HashAlg;
+
+typedef struct {
+    HashAlg alg;
+    const char* name;
+    hash32_fn hash32;
+    hash64_fn hash64;
+} HashAlgInfo;
+
+// 按枚举取算法描述，越界返回NULL
+const HashAlgInfo* hash_alg_get(HashAlg alg);
+// 按名字（如 "murmur"、"fnv1a"）取算法描述，未找到返回NULL
+const HashAlgInfo* hash_alg_find(const char* name);
+
+// 便捷调用：越界的 alg 回退到 HASH_ALG_MURMUR
+uint32_t hash_alg32(HashAlg alg, const void* key, size_t len, uint32_t seed);
+uint64_t hash_alg64(HashAlg alg, const void* key, size_t len, uint64_t seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HASHALG_H
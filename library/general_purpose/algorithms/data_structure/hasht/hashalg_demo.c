@@ -0,0 +1,47 @@
+#include "hashalg.h"
+#include <stdio.h>
+#include <string.h>
+
+int main(void) {
+
+    // 示例1：计算字符串 "abcd" 的哈希值
+    const char* str = "abcd";
+    uint32_t hash1 = times33Hash(str, strlen(str), 0);
+    printf("times33 Hash of \"%s\": %u\n", str, hash1);
+    // 示例2：按长度哈希可以处理包含空字符的数据，但 times33 种子为 0 时前导的 0 字节不改变结果（理论上的碰撞）
+    const char* str2 = "A";
+    const char str3[] = "\0A";                                  // 包含空字符的字符串
+    uint32_t hash2 = times33Hash(str2, 1, 0);
+    uint32_t hash3 = times33Hash(str3, 2, 0);
+    printf("times33 Hash of \"%s\": %u\n", str2, hash2);        // 输出 65
+    printf("times33 Hash of \"\\0A\": %u\n", hash3);            // 输出 65
+    printf("times33 Hash of \"\\0A\" (seed=5381): %u\n", times33Hash(str3, 2, 5381));
+
+    // 示例1：计算字符串 "hello" 的哈希值
+    const char* murstr1 = "hello";
+    uint32_t murhash1 = murmurHash3_32(murstr1, strlen(murstr1), 0);
+    printf("murmur Hash of \"%s\": 0x%08x\n", murstr1, murhash1); // 输出 0x248bfa47
+    // 示例2：验证相同输入不同种子结果不同
+    uint32_t murhash2 = murmurHash3_32(murstr1, strlen(murstr1), 42);
+    printf("murmur Hash of \"%s\" (seed=42): 0x%08x\n", murstr1, murhash2); // 输出 0xe2dbd2e1
+    // 示例3：验证不同输入结果不同
+    const char* murstr2 = "world";
+    uint32_t murhash3 = murmurHash3_32(murstr2, strlen(murstr2), 0);
+    printf("murmur Hash of \"%s\": 0x%08x\n", murstr2, murhash3); // 输出 0xfb963cfb
+
+    // 示例4：运行时按名字选择算法，同时输出 32 位与 64 位结果
+    const char* key = "hello";
+    for (int i = 0; i < HASH_ALG_COUNT; i++) {
+        const HashAlgInfo* info = hash_alg_get((HashAlg)i);
+        printf("%-8s hash of \"%s\": 0x%08x  0x%016llx\n", info->name, key,
+               info->hash32(key, strlen(key), 0),
+               (unsigned long long)info->hash64(key, strlen(key), 0));
+    }
+
+    const HashAlgInfo* fnv = hash_alg_find("fnv1a");
+    if (fnv != NULL) {
+        printf("fnv-1a hash of \"%s\": 0x%08x\n", key, fnv->hash32(key, strlen(key), 0));
+    }
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+#ifndef HASHALG_UTIL_H
+#define HASHALG_UTIL_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ 哈希实现内部使用的工具函数（不属于公开接口）
+ （1）分块读取：用 memcpy 读取，编译器在允许未对齐访问的平台上会生成单条 load 指令，
+      在严格对齐的平台（如部分 ARM）上也不会因未对齐访问出错
+ （2）字节序：所有算法按小端序定义分块的数值，大端平台上读取后做一次字节交换，
+      保证同一输入在任何平台上得到相同的哈希值
+*/
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define HASH_BIG_ENDIAN 1
+#else
+#define HASH_BIG_ENDIAN 0
+#endif
+
+static inline uint32_t hash_load32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+#if HASH_BIG_ENDIAN
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+static inline uint64_t hash_load64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#if HASH_BIG_ENDIAN
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static inline uint32_t hash_rotl32(uint32_t x, int r) {
+    return (x << r) | (x >> (32 - r));
+}
+
+static inline uint64_t hash_rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+/*
+ 流式接口的分块缓冲：把输入补进 buf，直到 buf 凑满 block 字节或输入耗尽
+ *p、*len 前移已拷贝的部分，buf 凑满时返回 1
+*/
+static inline int hash_buf_fill(uint8_t* buf, uint32_t* buf_len, uint32_t block,
+                                const uint8_t** p, size_t* len) {
+    size_t n = block - *buf_len;
+    if (n > *len) {
+        n = *len;
+    }
+    memcpy(buf + *buf_len, *p, n);
+    *buf_len += (uint32_t)n;
+    *p += n;
+    *len -= n;
+    return *buf_len == block;
+}
+
+#endif // HASHALG_UTIL_H
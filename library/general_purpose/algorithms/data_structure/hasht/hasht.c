@@ -1,4 +1,8 @@
-#include <stdio.h>
+#include "hasht.h"
+#include "hasht_group.h"
+#include <stdlib.h>
+#include <string.h>
+
 
 /* 
 一、哈希表（Hash Table）是一种高效的数据结构，用于存储键值对（Key-Value Pairs），支持快速的插入、删除和查找操作。其核心思想是通过哈希函数将键（Key）映射到数组的特定位置（索引），从而实现近似常数时间复杂度的操作
@@ -77,14 +81,505 @@
 哈希表通过巧妙的哈希函数和冲突处理机制，在大多数场景下提供了接近常数时间的操作效率，是现代软件开发中最常用的数据结构之一。其设计需权衡哈希函数质量、冲突策略、负载因子和内存消耗，合理选择参数可实现高性能存储与检索 
 */
 
-// 哈希表初始大小
+/*
+ 本文件的实现：开放寻址 + 分组控制字节（Swiss Table 风格）
+ （1）槽位数为 2 的幂，每 16 个槽位为一组；每个槽位有一个控制字节：
+      HASHT_EMPTY（空）、HASHT_DELETED（已删除）、0x00~0x7F（已占用，值为哈希值的低 7 位 h2）
+ （2）哈希值的其余位 h1 选择起始组，按组做三角数探测（g, g+1, g+3, g+6, ...），组数为 2 的幂时能遍历所有组
+ （3）查找：在一组的 16 个控制字节中找等于 h2 的槽位（一条 SSE2 比较 + movemask），
+      只有这些槽位才比较键，h2 随机时误匹配的概率为 1/128；组内有空槽位则说明键不在表中，停止探测
+ （4）删除：探测只会越过 "插入时没有空槽位" 的组，所以组内还有空槽位时，没有任何键的探测路径经过这一组，
+      可以直接置空；组已满时置为 HASHT_DELETED（墓碑），查找跳过墓碑，插入可以复用墓碑
+ （5）扩容：已占用与墓碑的槽位数达到 容量 * 最大负载因子 时重建；墓碑占多数时按原容量重建（清除墓碑），否则容量加倍
+ （6）渐进式扩容（类似 Redis 的 dict）：重建时不搬移元素，只分配新数组，旧数组保留为 old_ctrl / old_slots；
+      之后每次写操作（插入、删除）先按组号顺序迁移 incremental_step 组，全部迁移完后释放旧数组
+      - 新元素只插入新数组；查找、删除依次检查新、旧数组
+      - 旧数组中迁移走的槽位置为墓碑而不是置空：后面的组里可能有探测时越过这一组的键，置空会截断它们的探测
+      - 每次写操作最多占用新数组一个空位，开始迁移时按 新数组剩余空位 / 旧数组组数 提高每次迁移的组数（负载因子很小时），
+        保证迁移在新数组占满之前完成；防御起见，迁移期间需要再次扩容时先一次性完成当前迁移
+      - 单次写操作最多搬移 16 * incremental_step 个元素，停顿有上界；代价是迁移期间内存为新旧之和，未命中的查找要探测两个数组
+*/
+
+// 哈希表初始大小：至少一组
+#define HASHT_MIN_CAPACITY HASHT_GROUP_WIDTH
+
+// 哈希表结构：控制字节与槽位分开存放，查找时先只访问控制字节，命中后才访问槽位
+struct HashT {
+    uint8_t* ctrl;              // capacity 个控制字节，16 字节对齐
+    uint8_t* slots;             // capacity 个槽位，每个槽位为 键 + 值（按对齐补齐）
+    size_t capacity;            // 槽位数，2 的幂，>= HASHT_MIN_CAPACITY
+    size_t group_mask;          // 组数 - 1
+    size_t size;                // 元素数
+    size_t tombstones;          // 墓碑数
+    size_t growth_left;         // 还可以占用的空槽位数，为 0 时重建
+
+    // 渐进式扩容：迁移期间 old_ctrl 不为NULL，组号小于 migrate_pos 的组已经迁移
+    uint8_t* old_ctrl;
+    uint8_t* old_slots;
+    size_t old_capacity;        // 没有进行中的迁移时为 0
+    size_t old_group_mask;
+    size_t migrate_pos;
+    size_t migrate_step;        // 本次迁移每次写操作迁移的组数，>= incremental_step
+    size_t incremental_step;
+
+    size_t key_size;
+    size_t value_size;
+    size_t value_offset;        // 值在槽位中的偏移
+    size_t slot_size;
+    hash64_fn hash;
+    hasht_eq_fn eq;             // NULL 表示按字节比较
+    uint64_t seed;
+    double max_load;
+};
+
+static inline uint64_t hasht_hash(const HashT* t, const void* key) {
+    return t->hash(key, t->key_size, t->seed);
+}
+
+static inline uint8_t* slot_at(const HashT* t, size_t i) {
+    return t->slots + i * t->slot_size;
+}
+
+static inline int keys_equal(const HashT* t, const void* a, const void* b) {
+    if (t->eq != NULL) {
+        return t->eq(a, b, t->key_size) == 0;
+    }
+    // 常见的定长键直接比较，避免调用 memcmp
+    switch (t->key_size) {
+    case 4: {
+        uint32_t x, y;
+        memcpy(&x, a, 4);
+        memcpy(&y, b, 4);
+        return x == y;
+    }
+    case 8: {
+        uint64_t x, y;
+        memcpy(&x, a, 8);
+        memcpy(&y, b, 8);
+        return x == y;
+    }
+    default:
+        return memcmp(a, b, t->key_size) == 0;
+    }
+}
+
+static inline size_t max_occupied(size_t capacity, double max_load) {
+    size_t n = (size_t)((double)capacity * max_load);
+    // 至少留一个空槽位，保证未命中的查找能停止
+    return n >= capacity ? capacity - 1 : (n == 0 ? 1 : n);
+}
+
+static size_t capacity_for(size_t n, double max_load) {
+    size_t cap = HASHT_MIN_CAPACITY;
+    while (max_occupied(cap, max_load) < n) {
+        cap *= 2;
+    }
+    return cap;
+}
+
+static inline size_t value_align(size_t size) {
+    return size >= 8 ? 8 : (size >= 4 ? 4 : (size >= 2 ? 2 : 1));
+}
+
+static inline size_t round_up(size_t x, size_t a) {
+    return (x + a - 1) / a * a;
+}
+
+// 分配 capacity 个槽位，控制字节全部置空
+static int alloc_arrays(size_t capacity, size_t slot_size, uint8_t** ctrl, uint8_t** slots) {
+    *ctrl = (uint8_t*)aligned_alloc(HASHT_GROUP_WIDTH, capacity);
+    *slots = (uint8_t*)malloc(capacity * slot_size);
+    if (*ctrl == NULL || *slots == NULL) {
+        free(*ctrl);
+        free(*slots);
+        return -1;
+    }
+    memset(*ctrl, HASHT_EMPTY, capacity);
+    return 0;
+}
+
+// 在一组数组（当前数组或迁移中的旧数组）里查找键所在的槽位，不存在返回 (size_t)-1
+static size_t find_slot_in(const HashT* t, const uint8_t* ctrl, const uint8_t* slots, size_t group_mask,
+                           const void* key, uint64_t h) {
+    uint8_t h2 = hash_h2(h);
+    size_t g = hash_h1(h) & group_mask;
+    for (size_t step = 0; step <= group_mask; step++) {
+        const uint8_t* group = ctrl + g * HASHT_GROUP_WIDTH;
+        uint32_t m = group_match(group, h2);
+        while (m != 0) {
+            size_t i = g * HASHT_GROUP_WIDTH + (size_t)__builtin_ctz(m);
+            if (keys_equal(t, slots + i * t->slot_size, key)) {
+                return i;
+            }
+            m &= m - 1;
+        }
+        if (group_match_empty(group) != 0) {
+            break;
+        }
+        g = (g + step + 1) & group_mask;
+    }
+    return (size_t)-1;
+}
+
+static inline size_t find_slot(const HashT* t, const void* key, uint64_t h) {
+    return find_slot_in(t, t->ctrl, t->slots, t->group_mask, key, h);
+}
+
+static inline size_t find_old_slot(const HashT* t, const void* key, uint64_t h) {
+    return find_slot_in(t, t->old_ctrl, t->old_slots, t->old_group_mask, key, h);
+}
+
+// 删除槽位 i：所在组还有空槽位时直接置空返回0，否则置为墓碑返回 1
+static inline int erase_ctrl(uint8_t* ctrl, size_t i) {
+    if (group_match_empty(ctrl + (i & ~(size_t)(HASHT_GROUP_WIDTH - 1))) != 0) {
+        ctrl[i] = HASHT_EMPTY;
+        return 0;
+    }
+    ctrl[i] = HASHT_DELETED;
+    return 1;
+}
+
+// 沿探测序列找到第一个空或墓碑槽位（表中至少有一个空槽位）
+static size_t find_free_slot(const HashT* t, uint64_t h) {
+    size_t g = hash_h1(h) & t->group_mask;
+    for (size_t step = 0;; step++) {
+        uint32_t m = group_match_free(t->ctrl + g * HASHT_GROUP_WIDTH);
+        if (m != 0) {
+            return g * HASHT_GROUP_WIDTH + (size_t)__builtin_ctz(m);
+        }
+        g = (g + step + 1) & t->group_mask;
+    }
+}
 
-// 哈希表链表节点结构
+// 按新容量重建：所有元素重新插入，墓碑清零（调用前没有进行中的迁移）
+static int rehash(HashT* t, size_t new_capacity) {
+    uint8_t* ctrl;
+    uint8_t* slots;
+    if (alloc_arrays(new_capacity, t->slot_size, &ctrl, &slots) != 0) {
+        return -1;
+    }
+    uint8_t* old_ctrl = t->ctrl;
+    uint8_t* old_slots = t->slots;
+    size_t old_capacity = t->capacity;
 
-// 哈希表数组结构
+    t->ctrl = ctrl;
+    t->slots = slots;
+    t->capacity = new_capacity;
+    t->group_mask = new_capacity / HASHT_GROUP_WIDTH - 1;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_ctrl[i] & 0x80) {
+            continue;
+        }
+        const uint8_t* src = old_slots + i * t->slot_size;
+        uint64_t h = hasht_hash(t, src);
+        size_t j = find_free_slot(t, h);
+        t->ctrl[j] = hash_h2(h);
+        memcpy(slot_at(t, j), src, t->slot_size);
+    }
+    t->tombstones = 0;
+    t->growth_left = max_occupied(new_capacity, t->max_load) - t->size;
+    free(old_ctrl);
+    free(old_slots);
+    return 0;
+}
 
-// 哈希函数
+// 把旧数组的一组元素搬到新数组；新数组一定有空位（见文件头说明）
+static void migrate_group(HashT* t, size_t g) {
+    size_t base = g * HASHT_GROUP_WIDTH;
+    uint32_t full = ~group_match_free(t->old_ctrl + base) & 0xffffu;
+    while (full != 0) {
+        size_t i = base + (size_t)__builtin_ctz(full);
+        const uint8_t* src = t->old_slots + i * t->slot_size;
+        uint64_t h = hasht_hash(t, src);
+        size_t j = find_free_slot(t, h);
+        if (t->ctrl[j] == HASHT_DELETED) {
+            t->tombstones--;
+        } else {
+            t->growth_left--;
+        }
+        t->ctrl[j] = hash_h2(h);
+        memcpy(slot_at(t, j), src, t->slot_size);
+        t->old_ctrl[i] = HASHT_DELETED;
+        full &= full - 1;
+    }
+}
+
+// 迁移至多 groups 组，全部迁移完后释放旧数组
+static void migrate(HashT* t, size_t groups) {
+    size_t end = t->old_group_mask + 1;
+    for (; groups > 0 && t->migrate_pos < end; groups--) {
+        migrate_group(t, t->migrate_pos++);
+    }
+    if (t->migrate_pos == end) {
+        free(t->old_ctrl);
+        free(t->old_slots);
+        t->old_ctrl = NULL;
+        t->old_slots = NULL;
+        t->old_capacity = 0;
+        t->old_group_mask = 0;
+        t->migrate_pos = 0;
+    }
+}
+
+// 开始渐进式扩容：分配新数组，当前数组转为旧数组，元素留到之后的写操作中迁移
+static int start_incremental(HashT* t, size_t new_capacity) {
+    uint8_t* ctrl;
+    uint8_t* slots;
+    if (alloc_arrays(new_capacity, t->slot_size, &ctrl, &slots) != 0) {
+        return -1;
+    }
+    t->old_ctrl = t->ctrl;
+    t->old_slots = t->slots;
+    t->old_capacity = t->capacity;
+    t->old_group_mask = t->group_mask;
+    t->migrate_pos = 0;
+
+    t->ctrl = ctrl;
+    t->slots = slots;
+    t->capacity = new_capacity;
+    t->group_mask = new_capacity / HASHT_GROUP_WIDTH - 1;
+    t->tombstones = 0;
+    t->growth_left = max_occupied(new_capacity, t->max_load);
+
+    // 已有元素与触发扩容的这次插入之外，新数组剩余 room 个空位，迁移必须在 room 次写操作内完成
+    size_t groups = t->old_group_mask + 1;
+    size_t room = t->growth_left > t->size + 1 ? t->growth_left - t->size - 1 : 1;
+    size_t need = (groups + room - 1) / room;
+    t->migrate_step = need > t->incremental_step ? need : t->incremental_step;
+    return 0;
+}
+
+// 当前数组已满：原容量重建或容量加倍，按配置一次性完成或渐进式进行
+static int grow(HashT* t) {
+    if (t->old_ctrl != NULL) {
+        migrate(t, (size_t)-1);
+        if (t->growth_left != 0) {
+            return 0;
+        }
+    }
+    // 墓碑较多时原容量重建即可腾出空间
+    size_t limit = max_occupied(t->capacity, t->max_load);
+    size_t cap = t->size + 1 <= limit / 2 ? t->capacity : t->capacity * 2;
+    // 负载因子很小时容量加倍后可能仍放不下：至少容纳已有元素、这次插入，再给渐进式迁移留一个空位
+    size_t min_cap = capacity_for(t->size + 2, t->max_load);
+    if (cap < min_cap) {
+        cap = min_cap;
+    }
+    return t->incremental_step != 0 ? start_incremental(t, cap) : rehash(t, cap);
+}
 
 // 创建、销毁
+HashT* hasht_create(const HashTConfig* cfg) {
+    if (cfg == NULL || cfg->key_size == 0 || !(cfg->max_load >= 0.0 && cfg->max_load < 1.0)) {
+        return NULL;
+    }
+    HashT* t = (HashT*)calloc(1, sizeof(HashT));
+    if (t == NULL) {
+        return NULL;
+    }
+    t->key_size = cfg->key_size;
+    t->value_size = cfg->value_size;
+    size_t ka = value_align(cfg->key_size);
+    size_t va = cfg->value_size != 0 ? value_align(cfg->value_size) : 1;
+    t->slot_size = round_up(round_up(cfg->key_size, va) + cfg->value_size, ka > va ? ka : va);
+    // 没有值时 "值的地址" 即键的地址
+    t->value_offset = cfg->value_size != 0 ? round_up(cfg->key_size, va) : 0;
+    t->hash = cfg->hash != NULL ? cfg->hash : xxHash64;
+    t->eq = cfg->eq;
+    t->seed = cfg->seed;
+    t->max_load = cfg->max_load > 0.0 ? cfg->max_load : HASHT_DEFAULT_MAX_LOAD;
+    t->incremental_step = cfg->incremental_step;
+
+    t->capacity = capacity_for(cfg->initial_capacity, t->max_load);
+    t->group_mask = t->capacity / HASHT_GROUP_WIDTH - 1;
+    t->growth_left = max_occupied(t->capacity, t->max_load);
+    if (alloc_arrays(t->capacity, t->slot_size, &t->ctrl, &t->slots) != 0) {
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+void hasht_free(HashT* table) {
+    if (table == NULL) {
+        return;
+    }
+    free(table->ctrl);
+    free(table->slots);
+    free(table->old_ctrl);
+    free(table->old_slots);
+    free(table);
+}
+
+// 增、删、改、查
+void* hasht_upsert(HashT* table, const void* key, int* inserted) {
+    if (table->old_ctrl != NULL) {
+        migrate(table, table->migrate_step);
+    }
+    uint64_t h = hasht_hash(table, key);
+    size_t i = find_slot(table, key, h);
+    uint8_t* found = i != (size_t)-1 ? slot_at(table, i) : NULL;
+    if (found == NULL && table->old_ctrl != NULL) {
+        i = find_old_slot(table, key, h);
+        found = i != (size_t)-1 ? table->old_slots + i * table->slot_size : NULL;
+    }
+    if (found != NULL) {
+        if (inserted != NULL) {
+            *inserted = 0;
+        }
+        return found + table->value_offset;
+    }
+
+    i = find_free_slot(table, h);
+    if (table->ctrl[i] == HASHT_EMPTY && table->growth_left == 0) {
+        if (grow(table) != 0) {
+            return NULL;
+        }
+        i = find_free_slot(table, h);
+    }
+    if (table->ctrl[i] == HASHT_DELETED) {
+        table->tombstones--;
+    } else {
+        table->growth_left--;
+    }
+    table->ctrl[i] = hash_h2(h);
+    table->size++;
+    uint8_t* slot = slot_at(table, i);
+    memcpy(slot, key, table->key_size);
+    memset(slot + table->key_size, 0, table->slot_size - table->key_size);
+    if (inserted != NULL) {
+        *inserted = 1;
+    }
+    return slot + table->value_offset;
+}
+
+int hasht_put(HashT* table, const void* key, const void* value) {
+    int inserted = 0;
+    void* v = hasht_upsert(table, key, &inserted);
+    if (v == NULL) {
+        return -1;
+    }
+    if (table->value_size != 0) {
+        memcpy(v, value, table->value_size);
+    }
+    return inserted;
+}
+
+void* hasht_get(const HashT* table, const void* key) {
+    uint64_t h = hasht_hash(table, key);
+    size_t i = find_slot(table, key, h);
+    if (i != (size_t)-1) {
+        return slot_at(table, i) + table->value_offset;
+    }
+    if (table->old_ctrl != NULL) {
+        i = find_old_slot(table, key, h);
+        if (i != (size_t)-1) {
+            return table->old_slots + i * table->slot_size + table->value_offset;
+        }
+    }
+    return NULL;
+}
+
+int hasht_remove(HashT* table, const void* key, void* value_out) {
+    if (table->old_ctrl != NULL) {
+        migrate(table, table->migrate_step);
+    }
+    uint64_t h = hasht_hash(table, key);
+    size_t i = find_slot(table, key, h);
+    if (i != (size_t)-1) {
+        if (value_out != NULL && table->value_size != 0) {
+            memcpy(value_out, slot_at(table, i) + table->value_offset, table->value_size);
+        }
+        // 组内还有空槽位：没有探测路径经过这一组，直接置空
+        if (erase_ctrl(table->ctrl, i)) {
+            table->tombstones++;
+        } else {
+            table->growth_left++;
+        }
+        table->size--;
+        return 0;
+    }
+    if (table->old_ctrl == NULL || (i = find_old_slot(table, key, h)) == (size_t)-1) {
+        return -1;
+    }
+    // 旧数组中的键：不需要维护旧数组的空位与墓碑计数，迁移完就整体释放
+    if (value_out != NULL && table->value_size != 0) {
+        memcpy(value_out, table->old_slots + i * table->slot_size + table->value_offset, table->value_size);
+    }
+    erase_ctrl(table->old_ctrl, i);
+    table->size--;
+    return 0;
+}
+
+void hasht_clear(HashT* table) {
+    if (table->old_ctrl != NULL) {
+        free(table->old_ctrl);
+        free(table->old_slots);
+        table->old_ctrl = NULL;
+        table->old_slots = NULL;
+        table->old_capacity = 0;
+        table->old_group_mask = 0;
+        table->migrate_pos = 0;
+    }
+    memset(table->ctrl, HASHT_EMPTY, table->capacity);
+    table->size = 0;
+    table->tombstones = 0;
+    table->growth_left = max_occupied(table->capacity, table->max_load);
+}
+
+int hasht_reserve(HashT* table, size_t n) {
+    if (table->old_ctrl != NULL) {
+        migrate(table, (size_t)-1);
+    }
+    size_t cap = capacity_for(n, table->max_load);
+    if (cap <= table->capacity) {
+        return 0;
+    }
+    return rehash(table, cap);
+}
+
+int hasht_rehash_step(HashT* table, size_t groups) {
+    if (table->old_ctrl == NULL) {
+        return 0;
+    }
+    migrate(table, groups);
+    return table->old_ctrl != NULL;
+}
+
+// 迁移期间先遍历旧数组（下标 [0, old_capacity)），再遍历新数组
+int hasht_next(const HashT* table, size_t* iter, const void** key, void** value) {
+    size_t total = table->old_capacity + table->capacity;
+    for (size_t i = *iter; i < total; i++) {
+        int old = i < table->old_capacity;
+        const uint8_t* ctrl = old ? table->old_ctrl + i : table->ctrl + (i - table->old_capacity);
+        if ((*ctrl & 0x80) == 0) {
+            uint8_t* slot = old ? table->old_slots + i * table->slot_size : slot_at(table, i - table->old_capacity);
+            if (key != NULL) {
+                *key = slot;
+            }
+            if (value != NULL) {
+                *value = slot + table->value_offset;
+            }
+            *iter = i + 1;
+            return 1;
+        }
+    }
+    *iter = total;
+    return 0;
+}
+
+size_t hasht_size(const HashT* table) {
+    return table->size;
+}
+
+size_t hasht_capacity(const HashT* table) {
+    return table->capacity;
+}
+
+size_t hasht_tombstones(const HashT* table) {
+    return table->tombstones;
+}
 
-// 增、删、改、查
\ No newline at end of file
+size_t hasht_memory(const HashT* table) {
+    return (table->capacity + table->old_capacity) * (1 + table->slot_size);
+}
@@ -0,0 +1,117 @@
+#ifndef HASHT_H
+#define HASHT_H
+
+#include "hashalg.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ 开放寻址哈希表（SIMD 探测，Swiss Table 风格）
+ （1）键、值为定长的二进制块，按值拷贝存放在槽位数组中；变长键（字符串）可以存指针，并提供相应的哈希与比较函数
+ （2）每个槽位对应一个控制字节（空 / 已删除 / 哈希值的低 7 位），控制字节单独存放，
+      每 16 个槽位为一组，查找时用一条 SSE2 比较同时检查一组的 16 个控制字节，只有低 7 位相同的槽位才比较键
+ （3）删除时所在组仍有空槽位则直接置空，不留墓碑（tombstone）；只有组已满时才标记为已删除
+ （4）哈希函数与键比较函数可替换，默认 xxHash64 与 memcmp；最大负载因子可配置
+ （5）可选渐进式扩容（incremental_step 不为 0）：扩容时新旧两个数组同时存在，每次写操作只迁移几组，
+      把一次性搬移全部元素的停顿分摊到之后的写操作上
+*/
+
+// 键比较函数：相等返回0（与 memcmp 相同）
+typedef int (*hasht_eq_fn)(const void* a, const void* b, size_t len);
+
+typedef struct {
+    size_t key_size;            // 键的字节数，> 0
+    size_t value_size;          // 值的字节数，可以为 0（当作集合使用）
+    hash64_fn hash;             // 为NULL时使用 xxHash64；应当是各位都均匀的 64 位哈希（如 xxh64、murmur128）
+    hasht_eq_fn eq;             // 为NULL时使用 memcmp
+    uint64_t seed;              // 传给哈希函数的种子
+    double max_load;            // 最大负载因子，(0, 1)，为 0 时使用 HASHT_DEFAULT_MAX_LOAD
+    size_t initial_capacity;    // 预计的元素数，创建时按它分配，避免插入过程中扩容
+    size_t incremental_step;    // 渐进式扩容时每次写操作迁移的组数（每组 16 个槽位），为 0 时一次性扩容
+} HashTConfig;
+
+#define HASHT_DEFAULT_MAX_LOAD 0.875
+
+typedef struct HashT HashT;
+
+/**
+* @brief             创建哈希表
+* @param cfg         配置，创建后可以释放
+* @return            成功返回哈希表；key_size 为 0、max_load 不在 [0, 1) 内或内存不足返回NULL
+*/
+HashT* hasht_create(const HashTConfig* cfg);
+
+/**
+* @brief             销毁哈希表，table 为NULL时不做任何事
+*/
+void hasht_free(HashT* table);
+
+/**
+* @brief             插入或更新
+* @param value       值，value_size 为 0 时可以为NULL
+* @return            新插入返回 1，键已存在（值被覆盖）返回0，内存不足返回 -1
+*/
+int hasht_put(HashT* table, const void* key, const void* value);
+
+/**
+* @brief             查找键，不存在时插入（值清零），返回值所在的位置，用于原地修改（如计数）
+* @param inserted    不为NULL时输出是否为新插入
+* @return            值的地址，内存不足返回NULL；value_size 为 0 时返回键的地址
+* @note              返回的地址在下一次插入（可能扩容）之前有效
+*/
+void* hasht_upsert(HashT* table, const void* key, int* inserted);
+
+/**
+* @brief             查找
+* @return            值的地址，不存在返回NULL；value_size 为 0 时返回键的地址
+*/
+void* hasht_get(const HashT* table, const void* key);
+
+/**
+* @brief             删除
+* @param value_out   不为NULL时拷贝出被删除的值
+* @return            删除成功返回0，键不存在返回 -1
+*/
+int hasht_remove(HashT* table, const void* key, void* value_out);
+
+// 删除全部元素，保留容量
+void hasht_clear(HashT* table);
+
+/**
+* @brief             预留容量，之后插入 n 个元素以内不会扩容
+* @return            成功返回0，内存不足返回 -1
+* @note              正在渐进式扩容时先完成迁移，预留本身是一次性的
+*/
+int hasht_reserve(HashT* table, size_t n);
+
+/**
+* @brief             渐进式扩容时额外迁移若干组，用于只读为主、写操作很少的场景（如在空闲时调用）
+* @param groups      最多迁移的组数，传 (size_t)-1 一次迁移完
+* @return            迁移仍未完成返回 1，没有进行中的扩容返回0
+* @note              查找（hasht_get）不修改表，不迁移：迁移期间查找依次检查新、旧两个数组
+*/
+int hasht_rehash_step(HashT* table, size_t groups);
+
+/**
+* @brief             遍历：*iter 初始为 0，每次返回一个元素，顺序不确定
+* @return            取到元素返回 1，遍历结束返回0；遍历过程中不能插入或删除
+*/
+int hasht_next(const HashT* table, size_t* iter, const void** key, void** value);
+
+size_t hasht_size(const HashT* table);
+// 槽位总数（16 的倍数），迁移期间为新数组的槽位数
+size_t hasht_capacity(const HashT* table);
+// 已删除（墓碑）槽位数，扩容或原地重建时清零
+size_t hasht_tombstones(const HashT* table);
+// 表占用的字节数（控制字节 + 槽位），迁移期间包含新旧两个数组
+size_t hasht_memory(const HashT* table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HASHT_H
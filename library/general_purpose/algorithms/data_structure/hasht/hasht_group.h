@@ -0,0 +1,70 @@
+#ifndef HASHT_GROUP_H
+#define HASHT_GROUP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ 分组控制字节（Swiss Table 风格）的公共部分，hasht.c、concmap.c、hashtfile.c 与 lru/lru.c 共用，不对外安装
+ 每 16 个槽位为一组，每个槽位一个控制字节：HASHT_EMPTY、HASHT_DELETED、0x00~0x7F（已占用，值为 h2）
+*/
+
+#define HASHT_GROUP_WIDTH 16
+
+// 控制字节
+#define HASHT_EMPTY   ((uint8_t)0x80)
+#define HASHT_DELETED ((uint8_t)0xFE)
+
+/*
+ 组操作：返回位掩码，第 i 位表示组内第 i 个槽位满足条件
+ x86_64 一定支持 SSE2；其他平台逐字节比较
+*/
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+static inline uint32_t group_match(const uint8_t* ctrl, uint8_t h2) {
+    __m128i g = _mm_load_si128((const __m128i*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)h2)));
+}
+
+static inline uint32_t group_match_empty(const uint8_t* ctrl) {
+    __m128i g = _mm_load_si128((const __m128i*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)HASHT_EMPTY)));
+}
+
+// 空或墓碑：控制字节最高位为 1
+static inline uint32_t group_match_free(const uint8_t* ctrl) {
+    return (uint32_t)_mm_movemask_epi8(_mm_load_si128((const __m128i*)ctrl));
+}
+#else
+static inline uint32_t group_match(const uint8_t* ctrl, uint8_t h2) {
+    uint32_t m = 0;
+    for (int i = 0; i < HASHT_GROUP_WIDTH; i++) {
+        m |= (uint32_t)(ctrl[i] == h2) << i;
+    }
+    return m;
+}
+
+static inline uint32_t group_match_empty(const uint8_t* ctrl) {
+    return group_match(ctrl, HASHT_EMPTY);
+}
+
+static inline uint32_t group_match_free(const uint8_t* ctrl) {
+    uint32_t m = 0;
+    for (int i = 0; i < HASHT_GROUP_WIDTH; i++) {
+        m |= (uint32_t)(ctrl[i] >> 7) << i;
+    }
+    return m;
+}
+#endif
+
+// 哈希值拆分：h1 选组，h2 存入控制字节
+static inline size_t hash_h1(uint64_t h) {
+    return (size_t)(h >> 7);
+}
+
+static inline uint8_t hash_h2(uint64_t h) {
+    return (uint8_t)(h & 0x7f);
+}
+
+#endif // HASHT_GROUP_H
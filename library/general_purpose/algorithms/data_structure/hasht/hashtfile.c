@@ -0,0 +1,469 @@
+#include "hashtfile.h"
+#include "crc.h"
+#include "hasht.h"
+#include "hasht_group.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ 实现要点
+ （1）组数不取 2 的幂，按 HASHTFILE_MAX_LOAD 精确计算（4000 万个键时槽位目录比向上取整到 2 的幂小约 30%）；
+      起始组为 h1 % 组数，组间线性探测（三角数探测只有组数为 2 的幂时才保证走遍所有组），遇到有空槽位的组停止
+ （2）文件只读，没有删除，也就没有墓碑：控制字节只有 HASHT_EMPTY 与 h2 两种
+ （3）构建器的记录放在按块分配的内存里（块不移动），hasht 的键是记录指针，哈希函数直接取记录里预先算好的哈希值；
+      替换值时旧记录不回收，只在写文件时跳过
+ （4）写文件：ftruncate 到最终大小后映射为可写，直接在映射里填控制字节、槽位与记录，fsync 后 rename
+ （5）打开时只检查文件头（crc32c）与各区的大小，查找时再检查槽位里的偏移不越界，损坏的文件不会使读者越界访问
+*/
+
+#define HASHTFILE_HEADER_SIZE 64
+#define HASHTFILE_CHUNK_SIZE ((size_t)1 << 20)
+
+typedef struct {
+    char magic[8];              // HASHTFILE_MAGIC
+    uint32_t version;           // HASHTFILE_VERSION
+    uint32_t header_crc;        // 本字段为 0 时整个文件头的 crc32c
+    uint64_t seed;
+    uint64_t count;             // 键数
+    uint64_t ngroups;           // 组数，>= 1
+    uint64_t heap_offset;       // 数据区在文件中的偏移
+    uint64_t heap_size;
+    uint64_t file_size;
+} FileHeader;
+
+_Static_assert(sizeof(FileHeader) == HASHTFILE_HEADER_SIZE, "文件头应为 64 字节");
+
+static inline uint64_t round8(uint64_t x) {
+    return (x + 7) & ~(uint64_t)7;
+}
+
+// 记录在文件数据区中的字节数
+static inline uint64_t record_bytes(uint64_t key_len, uint64_t value_len) {
+    return 8 + round8(key_len) + round8(value_len);
+}
+
+static size_t groups_for(size_t n) {
+    size_t per_group = (size_t)(HASHT_GROUP_WIDTH * HASHTFILE_MAX_LOAD);
+    size_t g = (n + per_group - 1) / per_group;
+    return g == 0 ? 1 : g;
+}
+
+static inline uint64_t heap_offset_for(size_t ngroups) {
+    uint64_t capacity = (uint64_t)ngroups * HASHT_GROUP_WIDTH;
+    return round8(HASHTFILE_HEADER_SIZE + capacity + capacity * sizeof(uint32_t));
+}
+
+/*
+ 构建器
+*/
+
+typedef struct {
+    uint64_t hash;
+    uint32_t key_len;
+    uint32_t value_len;
+    unsigned char data[];       // 键，紧跟着值
+} BuildRecord;
+
+typedef struct Chunk {
+    struct Chunk* next;
+    size_t used;
+    size_t cap;
+    _Alignas(8) unsigned char data[];
+} Chunk;
+
+struct HashTFileBuilder {
+    HashT* index;               // 键为 BuildRecord*，不存值
+    Chunk* chunks;              // 当前块在链表头
+    uint64_t seed;
+    uint64_t heap_bytes;        // 现存记录写入文件后数据区的字节数
+};
+
+static inline const BuildRecord* load_record(const void* key) {
+    const BuildRecord* r;
+    memcpy(&r, key, sizeof(r));
+    return r;
+}
+
+static uint64_t record_hash(const void* key, size_t len, uint64_t seed) {
+    (void)len;
+    (void)seed;
+    return load_record(key)->hash;
+}
+
+static int record_eq(const void* a, const void* b, size_t len) {
+    (void)len;
+    const BuildRecord* x = load_record(a);
+    const BuildRecord* y = load_record(b);
+    if (x->key_len != y->key_len) {
+        return 1;
+    }
+    return memcmp(x->data, y->data, x->key_len);
+}
+
+static BuildRecord* alloc_record(HashTFileBuilder* b, size_t bytes) {
+    bytes = round8(bytes);
+    Chunk* c = b->chunks;
+    if (c == NULL || c->cap - c->used < bytes) {
+        size_t cap = bytes > HASHTFILE_CHUNK_SIZE ? bytes : HASHTFILE_CHUNK_SIZE;
+        c = (Chunk*)malloc(sizeof(Chunk) + cap);
+        if (c == NULL) {
+            return NULL;
+        }
+        c->next = b->chunks;
+        c->used = 0;
+        c->cap = cap;
+        b->chunks = c;
+    }
+    BuildRecord* r = (BuildRecord*)(c->data + c->used);
+    c->used += bytes;
+    return r;
+}
+
+HashTFileBuilder* hashtfile_builder_create(uint64_t seed, size_t expected) {
+    HashTFileBuilder* b = (HashTFileBuilder*)calloc(1, sizeof(HashTFileBuilder));
+    if (b == NULL) {
+        return NULL;
+    }
+    HashTConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.key_size = sizeof(BuildRecord*);
+    cfg.hash = record_hash;
+    cfg.eq = record_eq;
+    cfg.initial_capacity = expected;
+    b->index = hasht_create(&cfg);
+    if (b->index == NULL) {
+        free(b);
+        return NULL;
+    }
+    b->seed = seed;
+    return b;
+}
+
+void hashtfile_builder_free(HashTFileBuilder* builder) {
+    if (builder == NULL) {
+        return;
+    }
+    Chunk* c = builder->chunks;
+    while (c != NULL) {
+        Chunk* next = c->next;
+        free(c);
+        c = next;
+    }
+    hasht_free(builder->index);
+    free(builder);
+}
+
+int hashtfile_builder_add(HashTFileBuilder* builder, const void* key, size_t key_len, const void* value,
+                          size_t value_len) {
+    if (key_len > UINT32_MAX || value_len > UINT32_MAX) {
+        return -1;
+    }
+    BuildRecord* r = alloc_record(builder, sizeof(BuildRecord) + key_len + value_len);
+    if (r == NULL) {
+        return -1;
+    }
+    r->hash = xxHash64(key, key_len, builder->seed);
+    r->key_len = (uint32_t)key_len;
+    r->value_len = (uint32_t)value_len;
+    memcpy(r->data, key, key_len);
+    if (value_len != 0) {
+        memcpy(r->data + key_len, value, value_len);
+    }
+
+    int inserted = 0;
+    BuildRecord** slot = (BuildRecord**)hasht_upsert(builder->index, &r, &inserted);
+    if (slot == NULL) {
+        return -1;
+    }
+    if (!inserted) {
+        // 键相同，哈希值也相同，直接替换槽位里的记录指针
+        builder->heap_bytes -= record_bytes((*slot)->key_len, (*slot)->value_len);
+        *slot = r;
+    }
+    builder->heap_bytes += record_bytes(key_len, value_len);
+    return inserted;
+}
+
+size_t hashtfile_builder_size(const HashTFileBuilder* builder) {
+    return hasht_size(builder->index);
+}
+
+// 在映射好的文件里填写控制字节、槽位目录与数据区
+static void fill_file(const HashTFileBuilder* b, uint8_t* base, size_t ngroups, uint64_t heap_offset) {
+    size_t capacity = ngroups * HASHT_GROUP_WIDTH;
+    uint8_t* ctrl = base + HASHTFILE_HEADER_SIZE;
+    uint32_t* slots = (uint32_t*)(ctrl + capacity);
+    uint8_t* heap = base + heap_offset;
+    memset(ctrl, HASHT_EMPTY, capacity);
+
+    uint64_t pos = 0;
+    size_t iter = 0;
+    const void* key;
+    void* unused;
+    while (hasht_next(b->index, &iter, &key, &unused)) {
+        const BuildRecord* r = load_record(key);
+        size_t g = hash_h1(r->hash) % ngroups;
+        uint32_t m;
+        while ((m = group_match_empty(ctrl + g * HASHT_GROUP_WIDTH)) == 0) {
+            g = g + 1 == ngroups ? 0 : g + 1;
+        }
+        size_t i = g * HASHT_GROUP_WIDTH + (size_t)__builtin_ctz(m);
+        ctrl[i] = hash_h2(r->hash);
+        slots[i] = (uint32_t)(pos / 8);
+
+        uint8_t* out = heap + pos;
+        memcpy(out, &r->key_len, sizeof(uint32_t));
+        memcpy(out + 4, &r->value_len, sizeof(uint32_t));
+        memcpy(out + 8, r->data, r->key_len);
+        memcpy(out + 8 + round8(r->key_len), r->data + r->key_len, r->value_len);
+        pos += record_bytes(r->key_len, r->value_len);
+    }
+}
+
+int hashtfile_builder_write(const HashTFileBuilder* builder, const char* path) {
+    if (builder->heap_bytes > HASHTFILE_MAX_HEAP) {
+        errno = EFBIG;
+        return -1;
+    }
+    size_t n = hasht_size(builder->index);
+    size_t ngroups = groups_for(n);
+    uint64_t heap_offset = heap_offset_for(ngroups);
+    uint64_t file_size = heap_offset + builder->heap_bytes;
+
+    // 临时文件由 mkstemp 在同一目录下生成唯一名字，多个构建器写同一目标时不会截断彼此的临时文件
+    size_t path_len = strlen(path);
+    char* tmp = (char*)malloc(path_len + 8);
+    if (tmp == NULL) {
+        return -1;
+    }
+    memcpy(tmp, path, path_len);
+    memcpy(tmp + path_len, ".XXXXXX", 8);
+
+    int fd = mkstemp(tmp);
+    if (fd < 0) {
+        free(tmp);
+        return -1;
+    }
+    uint8_t* base = MAP_FAILED;
+    // mkstemp 以 0600 创建，改回与普通新建文件一致的 0644
+    if (fchmod(fd, 0644) != 0) {
+        goto fail;
+    }
+    if (ftruncate(fd, (off_t)file_size) != 0 ||
+        (base = (uint8_t*)mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        goto fail;
+    }
+    fill_file(builder, base, ngroups, heap_offset);
+
+    FileHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, HASHTFILE_MAGIC, sizeof(HASHTFILE_MAGIC));
+    hdr.version = HASHTFILE_VERSION;
+    hdr.seed = builder->seed;
+    hdr.count = n;
+    hdr.ngroups = ngroups;
+    hdr.heap_offset = heap_offset;
+    hdr.heap_size = builder->heap_bytes;
+    hdr.file_size = file_size;
+    hdr.header_crc = crc32c(&hdr, sizeof(hdr));
+    memcpy(base, &hdr, sizeof(hdr));
+
+    // Linux 上 fsync 同样写回通过映射修改的页面
+    munmap(base, file_size);
+    base = MAP_FAILED;
+    if (fsync(fd) != 0) {
+        goto fail;
+    }
+    int rc = close(fd);
+    fd = -1;
+    if (rc != 0 || rename(tmp, path) != 0) {
+        goto fail;
+    }
+    free(tmp);
+    return 0;
+
+fail: {
+    int err = errno;
+    if (base != MAP_FAILED) {
+        munmap(base, file_size);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    unlink(tmp);
+    free(tmp);
+    errno = err;
+    return -1;
+}
+}
+
+/*
+ 读取
+*/
+
+struct HashTFile {
+    const uint8_t* base;        // 整个文件的只读映射
+    size_t bytes;
+    const uint8_t* ctrl;
+    const uint32_t* slots;
+    const uint8_t* heap;
+    uint64_t heap_size;
+    size_t ngroups;
+    size_t count;
+    uint64_t seed;
+};
+
+// 检查文件头：魔数、版本、crc，以及各区的大小与文件大小一致
+static int header_valid(const FileHeader* hdr, uint64_t file_size) {
+    FileHeader copy = *hdr;
+    copy.header_crc = 0;
+    if (memcmp(hdr->magic, HASHTFILE_MAGIC, sizeof(HASHTFILE_MAGIC)) != 0 || hdr->version != HASHTFILE_VERSION ||
+        crc32c(&copy, sizeof(copy)) != hdr->header_crc) {
+        return 0;
+    }
+    if (hdr->file_size != file_size || hdr->ngroups == 0 || hdr->ngroups > file_size / HASHT_GROUP_WIDTH ||
+        hdr->heap_size > HASHTFILE_MAX_HEAP) {
+        return 0;
+    }
+    return hdr->heap_offset == heap_offset_for((size_t)hdr->ngroups) &&
+           hdr->heap_offset + hdr->heap_size == file_size && hdr->count <= hdr->ngroups * HASHT_GROUP_WIDTH;
+}
+
+HashTFile* hashtfile_open(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < HASHTFILE_HEADER_SIZE) {
+        close(fd);
+        return NULL;
+    }
+    size_t bytes = (size_t)st.st_size;
+    void* base = mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    // 映射建立后文件描述符不再需要
+    close(fd);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+    FileHeader hdr;
+    memcpy(&hdr, base, sizeof(hdr));
+    HashTFile* f = header_valid(&hdr, bytes) ? (HashTFile*)calloc(1, sizeof(HashTFile)) : NULL;
+    if (f == NULL) {
+        munmap(base, bytes);
+        return NULL;
+    }
+    f->base = (const uint8_t*)base;
+    f->bytes = bytes;
+    f->ngroups = (size_t)hdr.ngroups;
+    f->ctrl = f->base + HASHTFILE_HEADER_SIZE;
+    f->slots = (const uint32_t*)(f->ctrl + f->ngroups * HASHT_GROUP_WIDTH);
+    f->heap = f->base + hdr.heap_offset;
+    f->heap_size = hdr.heap_size;
+    f->count = (size_t)hdr.count;
+    f->seed = hdr.seed;
+    return f;
+}
+
+void hashtfile_close(HashTFile* file) {
+    if (file == NULL) {
+        return;
+    }
+    munmap((void*)file->base, file->bytes);
+    free(file);
+}
+
+// 槽位 i 指向的记录，偏移或长度越界（文件损坏）返回NULL
+static inline const uint8_t* record_at(const HashTFile* f, size_t i, uint32_t* key_len, uint32_t* value_len) {
+    uint64_t off = (uint64_t)f->slots[i] * 8;
+    if (off + 8 > f->heap_size) {
+        return NULL;
+    }
+    const uint8_t* rec = f->heap + off;
+    memcpy(key_len, rec, sizeof(uint32_t));
+    memcpy(value_len, rec + 4, sizeof(uint32_t));
+    if (off + record_bytes(*key_len, *value_len) > f->heap_size) {
+        return NULL;
+    }
+    return rec;
+}
+
+const void* hashtfile_get(const HashTFile* file, const void* key, size_t key_len, size_t* value_len) {
+    uint64_t h = xxHash64(key, key_len, file->seed);
+    uint8_t h2 = hash_h2(h);
+    size_t g = hash_h1(h) % file->ngroups;
+    for (size_t step = 0; step < file->ngroups; step++) {
+        const uint8_t* group = file->ctrl + g * HASHT_GROUP_WIDTH;
+        uint32_t m = group_match(group, h2);
+        while (m != 0) {
+            size_t i = g * HASHT_GROUP_WIDTH + (size_t)__builtin_ctz(m);
+            uint32_t klen, vlen;
+            const uint8_t* rec = record_at(file, i, &klen, &vlen);
+            if (rec != NULL && klen == key_len && memcmp(rec + 8, key, key_len) == 0) {
+                if (value_len != NULL) {
+                    *value_len = vlen;
+                }
+                return rec + 8 + round8(klen);
+            }
+            m &= m - 1;
+        }
+        if (group_match_empty(group) != 0) {
+            break;
+        }
+        g = g + 1 == file->ngroups ? 0 : g + 1;
+    }
+    return NULL;
+}
+
+int hashtfile_next(const HashTFile* file, size_t* iter, const void** key, size_t* key_len, const void** value,
+                   size_t* value_len) {
+    size_t capacity = file->ngroups * HASHT_GROUP_WIDTH;
+    for (size_t i = *iter; i < capacity; i++) {
+        if (file->ctrl[i] & 0x80) {
+            continue;
+        }
+        uint32_t klen, vlen;
+        const uint8_t* rec = record_at(file, i, &klen, &vlen);
+        if (rec == NULL) {
+            continue;
+        }
+        *iter = i + 1;
+        if (key != NULL) {
+            *key = rec + 8;
+        }
+        if (key_len != NULL) {
+            *key_len = klen;
+        }
+        if (value != NULL) {
+            *value = rec + 8 + round8(klen);
+        }
+        if (value_len != NULL) {
+            *value_len = vlen;
+        }
+        return 1;
+    }
+    *iter = capacity;
+    return 0;
+}
+
+int hashtfile_prefetch(const HashTFile* file) {
+    return madvise((void*)file->base, file->bytes, MADV_WILLNEED) == 0 ? 0 : -1;
+}
+
+size_t hashtfile_size(const HashTFile* file) {
+    return file->count;
+}
+
+size_t hashtfile_capacity(const HashTFile* file) {
+    return file->ngroups * HASHT_GROUP_WIDTH;
+}
+
+size_t hashtfile_bytes(const HashTFile* file) {
+    return file->bytes;
+}
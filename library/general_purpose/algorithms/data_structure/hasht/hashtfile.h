@@ -0,0 +1,103 @@
+#ifndef HASHTFILE_H
+#define HASHTFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ 只读哈希表文件：一次构建写入文件，之后各进程 mmap 打开即可查找，不需要反序列化（启动时不再从文本重建）
+ （1）文件内只用相对偏移，不存指针，映射到任何地址都能直接使用；多个进程映射同一个文件时共用页缓存
+ （2）结构与 hasht.h 相同的分组探测：每 16 个槽位一组，一组控制字节用一条 SSE2 比较；
+      槽位里只存记录在数据区中的偏移（4 字节，以 8 字节为单位），键值为变长的二进制块
+ （3）构建器用 hasht 去重（同一个键加入多次以最后一次为准），写入时先写临时文件再 rename，
+      正在使用旧文件的进程不受影响，重新打开即可看到新内容
+ 文件布局（小端，按本机字节序写入与读取）：
+   文件头（64 字节） | 控制字节（组数 * 16，16 字节对齐） | 槽位目录（组数 * 16 * 4 字节） | 数据区（8 字节对齐）
+   数据区中每条记录：键长（4 字节）、值长（4 字节）、键、补齐到 8 字节、值、补齐到 8 字节
+*/
+
+#define HASHTFILE_MAGIC "HASHTFL"
+#define HASHTFILE_VERSION 1
+
+// 构建时的负载因子，与 HASHT_DEFAULT_MAX_LOAD 相同
+#define HASHTFILE_MAX_LOAD 0.875
+
+// 数据区上限：槽位用 32 位存以 8 字节为单位的偏移
+#define HASHTFILE_MAX_HEAP ((uint64_t)UINT32_MAX * 8)
+
+typedef struct HashTFileBuilder HashTFileBuilder;
+typedef struct HashTFile HashTFile;
+
+/**
+* @brief             创建构建器
+* @param seed        xxHash64 的种子，写入文件头，读取时使用同一个种子
+* @param expected    预计的键数，用于预分配，可以为 0
+* @return            成功返回构建器，内存不足返回NULL
+*/
+HashTFileBuilder* hashtfile_builder_create(uint64_t seed, size_t expected);
+
+void hashtfile_builder_free(HashTFileBuilder* builder);
+
+/**
+* @brief             加入键值对，键和值都会被拷贝
+* @param key_len     键长，< 2^32
+* @param value_len   值长，< 2^32，可以为 0（当作集合使用）
+* @return            新键返回 1，键已存在（值被替换）返回0，长度超限或内存不足返回 -1
+*/
+int hashtfile_builder_add(HashTFileBuilder* builder, const void* key, size_t key_len, const void* value,
+                          size_t value_len);
+
+size_t hashtfile_builder_size(const HashTFileBuilder* builder);
+
+/**
+* @brief             写入文件：先写同目录下由 mkstemp 生成的 path.XXXXXX，fsync 后 rename 为 path
+* @return            成功返回0，数据区超过 HASHTFILE_MAX_HEAP 或 I/O 失败返回 -1（errno 为失败原因）
+* @note              写入后构建器仍可继续加入并再次写入
+*/
+int hashtfile_builder_write(const HashTFileBuilder* builder, const char* path);
+
+/**
+* @brief             只读映射打开文件，检查文件头与各区的大小
+* @return            成功返回句柄，文件不存在、格式不符或被截断返回NULL
+* @note              打开只映射不读取，页面在第一次访问时从页缓存（或磁盘）载入
+*/
+HashTFile* hashtfile_open(const char* path);
+
+// 解除映射，file 为NULL时不做任何事
+void hashtfile_close(HashTFile* file);
+
+/**
+* @brief             查找
+* @param value_len   不为NULL时输出值长
+* @return            值在映射中的地址（8 字节对齐，关闭文件前有效），不存在返回NULL
+*/
+const void* hashtfile_get(const HashTFile* file, const void* key, size_t key_len, size_t* value_len);
+
+/**
+* @brief             遍历：*iter 初始为 0，每次返回一个键值对，按槽位顺序
+* @return            取到返回 1，遍历结束返回0
+*/
+int hashtfile_next(const HashTFile* file, size_t* iter, const void** key, size_t* key_len, const void** value,
+                   size_t* value_len);
+
+/**
+* @brief             提示内核预读整个文件（madvise MADV_WILLNEED），用于启动后马上要大量查找的场景
+* @return            成功返回0，失败返回 -1
+*/
+int hashtfile_prefetch(const HashTFile* file);
+
+size_t hashtfile_size(const HashTFile* file);
+// 槽位总数（16 的倍数）
+size_t hashtfile_capacity(const HashTFile* file);
+// 文件（映射）的字节数
+size_t hashtfile_bytes(const HashTFile* file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HASHTFILE_H
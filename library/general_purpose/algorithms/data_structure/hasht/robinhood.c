@@ -0,0 +1,368 @@
+#include "robinhood.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ Robin Hood 哈希（Pedro Celis, 1986）
+ 线性探测的问题：负载因子升高后，先插入的元素占据起始槽位附近，后插入的元素被推得很远，探测长度的方差很大，
+ 最坏查找远超平均。Robin Hood 在插入时比较 "正在插入的元素已经走过的距离" 与 "当前槽位上元素的探测长度"，
+ 前者更大时抢占该槽位，被挤出的元素继续向后找位置。结果是同一段连续元素按起始槽位有序排列，
+ 每个元素的探测长度都接近平均值，查找在遇到 "探测长度比自己已走距离还短" 的元素时就可以断定键不存在
+
+ 本文件的实现：
+ （1）每个槽位一个字节的元数据 dist：0 为空，否则为 探测长度 + 1；键、值存放在另一个数组中
+ （2）起始槽位 = (哈希值 * 容量) >> 64（取高位相乘，容量不要求是 2 的幂，预留时可以按元素数精确分配）
+ （3）表尾多分配 ROBINHOOD_MAX_PROBE 个溢出槽位，探测不需要回绕到表头，插入与删除的移动都是连续内存的 memmove；
+      溢出区之后还有一个永远为空的元数据字节作为哨兵，保证查找与移动一定停止
+ （4）插入：元素按起始槽位有序，Robin Hood 的逐个交换等价于 "在第一个探测长度小于已走距离的位置插入，
+      后面到第一个空槽位为止的元素整体后移一格、探测长度各加 1"，因此先检查是否会超过探测长度上限，再一次 memmove
+ （5）删除（后移）：被删元素之后、探测长度大于 0 的连续元素整体前移一格、探测长度各减 1，不留墓碑
+ （6）扩容：元素数达到 容量 * 最大负载因子、探测长度超过上限或溢出区用完时容量加倍；
+      重建时按旧表的顺序重新插入，起始槽位单调不减，每个元素都追加在所在段的末尾，不需要移动
+*/
+
+#define ROBINHOOD_MIN_CAPACITY 16
+
+struct RobinHood {
+    uint8_t* dist;              // capacity + ROBINHOOD_MAX_PROBE + 1 个元数据，最后一个为哨兵
+    uint8_t* slots;             // capacity + ROBINHOOD_MAX_PROBE 个槽位
+    size_t capacity;            // 起始槽位的范围
+    size_t size;
+    size_t limit;               // 最多容纳的元素数
+
+    size_t key_size;
+    size_t value_size;
+    size_t value_offset;
+    size_t slot_size;
+    hash64_fn hash;
+    hasht_eq_fn eq;
+    uint64_t seed;
+    double max_load;
+};
+
+static inline size_t home_slot(const RobinHood* t, uint64_t h) {
+    return (size_t)(((unsigned __int128)h * t->capacity) >> 64);
+}
+
+static inline uint8_t* slot_at(const RobinHood* t, size_t i) {
+    return t->slots + i * t->slot_size;
+}
+
+static inline size_t total_slots(size_t capacity) {
+    return capacity + ROBINHOOD_MAX_PROBE;
+}
+
+static inline int keys_equal(const RobinHood* t, const void* a, const void* b) {
+    if (t->eq != NULL) {
+        return t->eq(a, b, t->key_size) == 0;
+    }
+    switch (t->key_size) {
+    case 4: {
+        uint32_t x, y;
+        memcpy(&x, a, 4);
+        memcpy(&y, b, 4);
+        return x == y;
+    }
+    case 8: {
+        uint64_t x, y;
+        memcpy(&x, a, 8);
+        memcpy(&y, b, 8);
+        return x == y;
+    }
+    default:
+        return memcmp(a, b, t->key_size) == 0;
+    }
+}
+
+static inline size_t max_occupied(size_t capacity, double max_load) {
+    size_t n = (size_t)((double)capacity * max_load);
+    return n >= capacity ? capacity - 1 : (n == 0 ? 1 : n);
+}
+
+static size_t capacity_for(size_t n, double max_load) {
+    size_t cap = (size_t)((double)n / max_load);
+    if (cap < ROBINHOOD_MIN_CAPACITY) {
+        cap = ROBINHOOD_MIN_CAPACITY;
+    }
+    while (max_occupied(cap, max_load) < n) {
+        cap++;
+    }
+    return cap;
+}
+
+static inline size_t value_align(size_t size) {
+    return size >= 8 ? 8 : (size >= 4 ? 4 : (size >= 2 ? 2 : 1));
+}
+
+static inline size_t round_up(size_t x, size_t a) {
+    return (x + a - 1) / a * a;
+}
+
+static int alloc_arrays(size_t capacity, size_t slot_size, uint8_t** dist, uint8_t** slots) {
+    *dist = (uint8_t*)calloc(total_slots(capacity) + 1, 1);
+    *slots = (uint8_t*)malloc(total_slots(capacity) * slot_size);
+    if (*dist == NULL || *slots == NULL) {
+        free(*dist);
+        free(*slots);
+        return -1;
+    }
+    return 0;
+}
+
+// 查找键所在的槽位，不存在返回 (size_t)-1
+static size_t find_slot(const RobinHood* t, const void* key, uint64_t h) {
+    size_t i = home_slot(t, h);
+    // d 为 已走距离 + 1；遇到元数据小于 d 的槽位（空，或者探测长度更短的元素）时键一定不在表中
+    for (unsigned d = 1;; i++, d++) {
+        unsigned m = t->dist[i];
+        if (m < d) {
+            return (size_t)-1;
+        }
+        if (m == d && keys_equal(t, slot_at(t, i), key)) {
+            return i;
+        }
+    }
+}
+
+/*
+ 在 i 处插入元数据为 d 的元素（键不在表中，i 为 find 停下的位置）：
+ [i, e) 的元素后移一格，e 为之后第一个空槽位；会超过探测长度上限或溢出区时返回 -1，表不变
+*/
+static int make_room(RobinHood* t, size_t i, unsigned d) {
+    if (d > ROBINHOOD_MAX_PROBE + 1) {
+        return -1;
+    }
+    size_t e = i;
+    while (t->dist[e] != 0) {
+        if (t->dist[e] == ROBINHOOD_MAX_PROBE + 1) {
+            return -1;
+        }
+        e++;
+    }
+    if (e >= total_slots(t->capacity)) {
+        return -1;
+    }
+    if (e > i) {
+        memmove(t->dist + i + 1, t->dist + i, e - i);
+        for (size_t j = i + 1; j <= e; j++) {
+            t->dist[j]++;
+        }
+        memmove(slot_at(t, i + 1), slot_at(t, i), (e - i) * t->slot_size);
+    }
+    t->dist[i] = (uint8_t)d;
+    return 0;
+}
+
+// 按新容量重建；失败（内存不足或探测长度超过上限）时表不变
+static int resize(RobinHood* t, size_t new_capacity) {
+    RobinHood n = *t;
+    if (alloc_arrays(new_capacity, t->slot_size, &n.dist, &n.slots) != 0) {
+        return -1;
+    }
+    n.capacity = new_capacity;
+    n.limit = max_occupied(new_capacity, t->max_load);
+    size_t total = total_slots(t->capacity);
+    for (size_t i = 0; i < total; i++) {
+        if (t->dist[i] == 0) {
+            continue;
+        }
+        const uint8_t* src = slot_at(t, i);
+        uint64_t h = t->hash(src, t->key_size, t->seed);
+        // 按旧表顺序插入时起始槽位单调不减，新元素总是落在所在段的末尾
+        size_t j = home_slot(&n, h);
+        unsigned d = 1;
+        while (n.dist[j] >= d) {
+            j++;
+            d++;
+        }
+        if (make_room(&n, j, d) != 0) {
+            free(n.dist);
+            free(n.slots);
+            return -1;
+        }
+        memcpy(slot_at(&n, j), src, t->slot_size);
+    }
+    free(t->dist);
+    free(t->slots);
+    *t = n;
+    return 0;
+}
+
+// 创建、销毁
+RobinHood* robinhood_create(const RobinHoodConfig* cfg) {
+    if (cfg == NULL || cfg->key_size == 0 || !(cfg->max_load >= 0.0 && cfg->max_load < 1.0)) {
+        return NULL;
+    }
+    RobinHood* t = (RobinHood*)calloc(1, sizeof(RobinHood));
+    if (t == NULL) {
+        return NULL;
+    }
+    t->key_size = cfg->key_size;
+    t->value_size = cfg->value_size;
+    size_t ka = value_align(cfg->key_size);
+    size_t va = cfg->value_size != 0 ? value_align(cfg->value_size) : 1;
+    t->slot_size = round_up(round_up(cfg->key_size, va) + cfg->value_size, ka > va ? ka : va);
+    t->value_offset = cfg->value_size != 0 ? round_up(cfg->key_size, va) : 0;
+    t->hash = cfg->hash != NULL ? cfg->hash : xxHash64;
+    t->eq = cfg->eq;
+    t->seed = cfg->seed;
+    t->max_load = cfg->max_load > 0.0 ? cfg->max_load : ROBINHOOD_DEFAULT_MAX_LOAD;
+
+    t->capacity = capacity_for(cfg->initial_capacity, t->max_load);
+    t->limit = max_occupied(t->capacity, t->max_load);
+    if (alloc_arrays(t->capacity, t->slot_size, &t->dist, &t->slots) != 0) {
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+void robinhood_free(RobinHood* table) {
+    if (table == NULL) {
+        return;
+    }
+    free(table->dist);
+    free(table->slots);
+    free(table);
+}
+
+// 增、删、改、查
+void* robinhood_upsert(RobinHood* table, const void* key, int* inserted) {
+    uint64_t h = table->hash(key, table->key_size, table->seed);
+    for (;;) {
+        size_t i = home_slot(table, h);
+        unsigned d = 1;
+        for (; table->dist[i] >= d; i++, d++) {
+            if (table->dist[i] == d && keys_equal(table, slot_at(table, i), key)) {
+                if (inserted != NULL) {
+                    *inserted = 0;
+                }
+                return slot_at(table, i) + table->value_offset;
+            }
+        }
+        if (table->size < table->limit && make_room(table, i, d) == 0) {
+            table->size++;
+            uint8_t* slot = slot_at(table, i);
+            memcpy(slot, key, table->key_size);
+            memset(slot + table->key_size, 0, table->slot_size - table->key_size);
+            if (inserted != NULL) {
+                *inserted = 1;
+            }
+            return slot + table->value_offset;
+        }
+        // 元素数未达上限却放不下：探测长度超过上限，表还很稀疏时扩容也无济于事（哈希函数过差）
+        if (table->size < table->limit / 4 || resize(table, table->capacity * 2) != 0) {
+            return NULL;
+        }
+    }
+}
+
+int robinhood_put(RobinHood* table, const void* key, const void* value) {
+    int inserted = 0;
+    void* v = robinhood_upsert(table, key, &inserted);
+    if (v == NULL) {
+        return -1;
+    }
+    if (table->value_size != 0) {
+        memcpy(v, value, table->value_size);
+    }
+    return inserted;
+}
+
+void* robinhood_get(const RobinHood* table, const void* key) {
+    size_t i = find_slot(table, key, table->hash(key, table->key_size, table->seed));
+    if (i == (size_t)-1) {
+        return NULL;
+    }
+    return slot_at(table, i) + table->value_offset;
+}
+
+int robinhood_remove(RobinHood* table, const void* key, void* value_out) {
+    size_t i = find_slot(table, key, table->hash(key, table->key_size, table->seed));
+    if (i == (size_t)-1) {
+        return -1;
+    }
+    if (value_out != NULL && table->value_size != 0) {
+        memcpy(value_out, slot_at(table, i) + table->value_offset, table->value_size);
+    }
+    // 后移：之后探测长度不为 0 的连续元素前移一格（哨兵保证停止）
+    size_t e = i + 1;
+    while (table->dist[e] > 1) {
+        e++;
+    }
+    if (e > i + 1) {
+        memmove(table->dist + i, table->dist + i + 1, e - i - 1);
+        for (size_t j = i; j < e - 1; j++) {
+            table->dist[j]--;
+        }
+        memmove(slot_at(table, i), slot_at(table, i + 1), (e - i - 1) * table->slot_size);
+    }
+    table->dist[e - 1] = 0;
+    table->size--;
+    return 0;
+}
+
+void robinhood_clear(RobinHood* table) {
+    memset(table->dist, 0, total_slots(table->capacity));
+    table->size = 0;
+}
+
+int robinhood_reserve(RobinHood* table, size_t n) {
+    size_t cap = capacity_for(n, table->max_load);
+    if (cap <= table->capacity) {
+        return 0;
+    }
+    return resize(table, cap);
+}
+
+int robinhood_next(const RobinHood* table, size_t* iter, const void** key, void** value) {
+    size_t total = total_slots(table->capacity);
+    for (size_t i = *iter; i < total; i++) {
+        if (table->dist[i] != 0) {
+            uint8_t* slot = slot_at(table, i);
+            if (key != NULL) {
+                *key = slot;
+            }
+            if (value != NULL) {
+                *value = slot + table->value_offset;
+            }
+            *iter = i + 1;
+            return 1;
+        }
+    }
+    *iter = total;
+    return 0;
+}
+
+size_t robinhood_probe_histogram(const RobinHood* table, size_t* hist, size_t buckets) {
+    if (hist != NULL) {
+        memset(hist, 0, buckets * sizeof(size_t));
+    }
+    size_t max_probe = 0;
+    size_t total = total_slots(table->capacity);
+    for (size_t i = 0; i < total; i++) {
+        if (table->dist[i] == 0) {
+            continue;
+        }
+        size_t probe = (size_t)table->dist[i] - 1;
+        if (probe > max_probe) {
+            max_probe = probe;
+        }
+        if (hist != NULL && buckets != 0) {
+            hist[probe < buckets ? probe : buckets - 1]++;
+        }
+    }
+    return max_probe;
+}
+
+size_t robinhood_size(const RobinHood* table) {
+    return table->size;
+}
+
+size_t robinhood_capacity(const RobinHood* table) {
+    return table->capacity;
+}
+
+size_t robinhood_memory(const RobinHood* table) {
+    return total_slots(table->capacity) * (1 + table->slot_size) + 1;
+}
@@ -0,0 +1,111 @@
+#ifndef ROBINHOOD_H
+#define ROBINHOOD_H
+
+#include "hasht.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ Robin Hood 哈希表（开放寻址的另一种策略，与 hasht.h 的分组探测表接口一致）
+ （1）线性探测，插入时 "劫富济贫"：离起始槽位近（探测长度短）的元素让位给探测长度长的元素，
+      探测长度的方差很小，负载因子 0.9 ~ 0.95 时最大探测长度仍只有几十
+ （2）删除使用后移（backward shift）：把后面的元素依次前移一格，不留墓碑，反复增删不会退化
+ （3）每个槽位只有 1 字节元数据（探测长度），容量不要求是 2 的幂，预留容量时按元素数精确分配，适合内存受限的大表
+ （4）提供探测长度直方图与最大探测长度
+*/
+
+typedef struct {
+    size_t key_size;            // 键的字节数，> 0
+    size_t value_size;          // 值的字节数，可以为 0（当作集合使用）
+    hash64_fn hash;             // 为NULL时使用 xxHash64；用哈希值的高位选择起始槽位
+    hasht_eq_fn eq;             // 为NULL时使用 memcmp
+    uint64_t seed;              // 传给哈希函数的种子
+    double max_load;            // 最大负载因子，(0, 1)，为 0 时使用 ROBINHOOD_DEFAULT_MAX_LOAD
+    size_t initial_capacity;    // 预计的元素数，创建时按它精确分配
+} RobinHoodConfig;
+
+#define ROBINHOOD_DEFAULT_MAX_LOAD 0.9
+
+// 最大探测长度（元数据为 1 字节），超过时扩容
+#define ROBINHOOD_MAX_PROBE 254
+
+typedef struct RobinHood RobinHood;
+
+/**
+* @brief             创建哈希表
+* @param cfg         配置，创建后可以释放
+* @return            成功返回哈希表；key_size 为 0、max_load 不在 [0, 1) 内或内存不足返回NULL
+*/
+RobinHood* robinhood_create(const RobinHoodConfig* cfg);
+
+/**
+* @brief             销毁哈希表，table 为NULL时不做任何事
+*/
+void robinhood_free(RobinHood* table);
+
+/**
+* @brief             插入或更新
+* @param value       值，value_size 为 0 时可以为NULL
+* @return            新插入返回 1，键已存在（值被覆盖）返回0，内存不足或哈希函数过差（稀疏时探测长度仍超过上限）返回 -1
+*/
+int robinhood_put(RobinHood* table, const void* key, const void* value);
+
+/**
+* @brief             查找键，不存在时插入（值清零），返回值所在的位置
+* @param inserted    不为NULL时输出是否为新插入
+* @return            值的地址，失败返回NULL；value_size 为 0 时返回键的地址
+* @note              插入与删除都会移动其他元素，返回的地址在下一次插入或删除之前有效
+*/
+void* robinhood_upsert(RobinHood* table, const void* key, int* inserted);
+
+/**
+* @brief             查找
+* @return            值的地址，不存在返回NULL；value_size 为 0 时返回键的地址
+*/
+void* robinhood_get(const RobinHood* table, const void* key);
+
+/**
+* @brief             删除（后移，不留墓碑）
+* @param value_out   不为NULL时拷贝出被删除的值
+* @return            删除成功返回0，键不存在返回 -1
+*/
+int robinhood_remove(RobinHood* table, const void* key, void* value_out);
+
+// 删除全部元素，保留容量
+void robinhood_clear(RobinHood* table);
+
+/**
+* @brief             预留容量，之后插入 n 个元素以内不会扩容；容量按 n / max_load 精确分配
+* @return            成功返回0，内存不足返回 -1
+*/
+int robinhood_reserve(RobinHood* table, size_t n);
+
+/**
+* @brief             遍历：*iter 初始为 0，每次返回一个元素，顺序不确定
+* @return            取到元素返回 1，遍历结束返回0；遍历过程中不能插入或删除
+*/
+int robinhood_next(const RobinHood* table, size_t* iter, const void** key, void** value);
+
+/**
+* @brief             探测长度统计（探测长度 = 元素所在槽位与起始槽位的距离，命中查找比较 探测长度 + 1 次）
+* @param hist        不为NULL时 hist[i] 为探测长度为 i 的元素数，hist[buckets - 1] 累计所有 >= buckets - 1 的元素
+* @param buckets     hist 的项数
+* @return            最大探测长度，空表返回0
+*/
+size_t robinhood_probe_histogram(const RobinHood* table, size_t* hist, size_t buckets);
+
+size_t robinhood_size(const RobinHood* table);
+// 槽位数（不含末尾的溢出区）
+size_t robinhood_capacity(const RobinHood* table);
+// 表占用的字节数（元数据 + 槽位，含溢出区）
+size_t robinhood_memory(const RobinHood* table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ROBINHOOD_H
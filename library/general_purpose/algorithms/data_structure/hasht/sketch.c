@@ -0,0 +1,426 @@
+#include "sketch.h"
+#include "hashalg.h"
+#include "hashalg_util.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ SimHash 与 MinHash
+ （1）SimHash（Charikar 2002）：每个特征的哈希值按位投票，第 b 位为 1 投 +w、为 0 投 -w，
+      票数为正的位置 1。相当于用 64 个随机超平面对特征向量做符号投影，
+      两个指纹某一位不同的概率为 θ/π（θ 为两个向量的夹角），所以汉明距离反映余弦相似度
+ （2）MinHash（Broder 1997）：对集合 A、B 和一个随机置换 π，min π(A) == min π(B) 的概率恰为 |A∩B| / |A∪B|，
+      k 个独立置换得到的签名中相等位置的比例就是 Jaccard 相似度的估计，标准差约 sqrt(J(1-J)/k)
+ （3）单次置换（OPH，Li 2012）：只用一个哈希函数，按哈希值把元素分到 k 个桶，每个桶取最小值，
+      计算量从 O(nk) 降到 O(n + k)；元素数少于 k 时会有空桶，
+      最优致密化（Shrivastava 2017）让每个空桶按自己的随机序列找到一个非空桶并复制它的值，
+      两个集合的同一空桶以 Jaccard 概率复制到相同的值，估计仍然无偏
+*/
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define SKETCH_HAVE_AVX2 1
+#include <immintrin.h>
+#else
+#define SKETCH_HAVE_AVX2 0
+#endif
+
+// MurmurHash3 的 64 位终混合
+static inline uint64_t sketch_fmix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// 把 x 均匀映射到 [0, n)：取 (x * n) 的高 32 位，比取模快
+static inline uint32_t fast_range32(uint32_t x, uint32_t n) {
+    return (uint32_t)(((uint64_t)x * n) >> 32);
+}
+
+static inline int is_space(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// 按顺序组合 count 个词的哈希值（从环形缓冲 ring 的 start 位置开始），结果与平台字节序无关
+static uint64_t shingle_hash(const uint64_t* ring, uint32_t start, uint32_t count, uint32_t k) {
+    uint64_t h = count;
+    for (uint32_t i = 0; i < count; i++) {
+        h ^= ring[(start + i) % k] * 0x87c37b91114253d5ULL;
+        h = hash_rotl64(h, 31) * 0x4cf5ad432745937fULL;
+    }
+    return sketch_fmix64(h);
+}
+
+size_t sketch_word_shingles(const void* text, size_t len, uint32_t k, uint64_t out[], size_t cap) {
+    if (k == 0 || k > SKETCH_MAX_SHINGLE) {
+        return 0;
+    }
+    const uint8_t* p = (const uint8_t*)text;
+    uint64_t ring[SKETCH_MAX_SHINGLE];     // 最近 k 个词的哈希值
+    size_t words = 0;
+    size_t count = 0;
+    size_t i = 0;
+    while (i < len) {
+        while (i < len && is_space(p[i])) {
+            i++;
+        }
+        size_t start = i;
+        while (i < len && !is_space(p[i])) {
+            i++;
+        }
+        if (i == start) {
+            break;
+        }
+        ring[words % k] = murmurHash3_x64_64(p + start, i - start, 0);
+        words++;
+        if (words >= k) {
+            if (count < cap) {
+                out[count] = shingle_hash(ring, (uint32_t)(words % k), k, k);
+            }
+            count++;
+        }
+    }
+    // 词数不足 k：整段作为一个 shingle
+    if (words > 0 && words < k) {
+        if (cap > 0) {
+            out[0] = shingle_hash(ring, 0, (uint32_t)words, k);
+        }
+        count = 1;
+    }
+    return count;
+}
+
+uint64_t simhash64_scalar(const uint64_t hashes[], const uint32_t weights[], size_t n) {
+    // votes[b] 为第 b 位为 1 的特征的权重和，第 b 位为 1 当且仅当它超过总权重的一半
+    uint64_t votes[64] = { 0 };
+    uint64_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t h = hashes[i];
+        uint64_t w = weights != NULL ? weights[i] : 1;
+        total += w;
+        for (int b = 0; b < 64; b++) {
+            votes[b] += w & (0 - ((h >> b) & 1));
+        }
+    }
+    uint64_t fp = 0;
+    for (int b = 0; b < 64; b++) {
+        fp |= (uint64_t)(2 * votes[b] > total) << b;
+    }
+    return fp;
+}
+
+#if SKETCH_HAVE_AVX2
+/**
+* @brief             AVX2 版本：64 个计数器放在 8 个寄存器中，每个特征用 8 次 and + cmpeq 得到各位的掩码
+* @note              第 v 个寄存器的第 j 个 32 位 lane 对应第 8v + j 位；计数器为 32 位，
+*                    累计的权重将要超过 2^32 - 1 时先并入 64 位的总和，结果与标量版本逐位一致
+*/
+__attribute__((target("avx2")))
+static uint64_t simhash64_avx2_impl(const uint64_t hashes[], const uint32_t weights[], size_t n) {
+    __m256i bits[8];
+    for (int v = 0; v < 8; v++) {
+        bits[v] = _mm256_setr_epi32(1 << ((8 * v) % 32), 1 << ((8 * v + 1) % 32), 1 << ((8 * v + 2) % 32),
+                                    1 << ((8 * v + 3) % 32), 1 << ((8 * v + 4) % 32), 1 << ((8 * v + 5) % 32),
+                                    1 << ((8 * v + 6) % 32), (int)(1u << ((8 * v + 7) % 32)));
+    }
+    __m256i cnt[8];
+    for (int v = 0; v < 8; v++) {
+        cnt[v] = _mm256_setzero_si256();
+    }
+    uint64_t votes[64] = { 0 };
+    uint64_t total = 0;
+    uint64_t pending = 0;       // 32 位计数器中尚未并入 votes 的权重上限
+
+    for (size_t i = 0; i < n; i++) {
+        uint32_t w = weights != NULL ? weights[i] : 1;
+        if (pending + w > UINT32_MAX) {
+            for (int v = 0; v < 8; v++) {
+                uint32_t lanes[8];
+                _mm256_storeu_si256((__m256i*)lanes, cnt[v]);
+                for (int j = 0; j < 8; j++) {
+                    votes[8 * v + j] += lanes[j];
+                }
+                cnt[v] = _mm256_setzero_si256();
+            }
+            pending = 0;
+        }
+        pending += w;
+        total += w;
+        __m256i lo = _mm256_set1_epi32((int)(uint32_t)hashes[i]);
+        __m256i hi = _mm256_set1_epi32((int)(uint32_t)(hashes[i] >> 32));
+        __m256i wv = _mm256_set1_epi32((int)w);
+        for (int v = 0; v < 8; v++) {
+            __m256i src = v < 4 ? lo : hi;
+            __m256i set = _mm256_cmpeq_epi32(_mm256_and_si256(src, bits[v]), bits[v]);
+            cnt[v] = _mm256_add_epi32(cnt[v], _mm256_and_si256(set, wv));
+        }
+    }
+
+    uint64_t fp = 0;
+    for (int v = 0; v < 8; v++) {
+        uint32_t lanes[8];
+        _mm256_storeu_si256((__m256i*)lanes, cnt[v]);
+        for (int j = 0; j < 8; j++) {
+            uint64_t sum = votes[8 * v + j] + lanes[j];
+            fp |= (uint64_t)(2 * sum > total) << (8 * v + j);
+        }
+    }
+    return fp;
+}
+#endif
+
+uint64_t simhash64_avx2(const uint64_t hashes[], const uint32_t weights[], size_t n) {
+#if SKETCH_HAVE_AVX2
+    if (hash_cpu_has_avx2()) {
+        return simhash64_avx2_impl(hashes, weights, n);
+    }
+#endif
+    return simhash64_scalar(hashes, weights, n);
+}
+
+uint64_t simhash64(const uint64_t hashes[], const uint32_t weights[], size_t n) {
+    return simhash64_avx2(hashes, weights, n);
+}
+
+int minhash_oph(const uint64_t hashes[], size_t n, uint32_t k, uint32_t sig[]) {
+    if (k == 0 || k > MINHASH_MAX_K) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < k; i++) {
+        sig[i] = MINHASH_EMPTY;
+    }
+    // 高 32 位选桶，低 32 位为桶内的值；值为 MINHASH_EMPTY 时减一，保留它作为空桶标记
+    for (size_t i = 0; i < n; i++) {
+        uint32_t bin = fast_range32((uint32_t)(hashes[i] >> 32), k);
+        uint32_t v = (uint32_t)hashes[i];
+        v -= v == MINHASH_EMPTY;
+        sig[bin] = v < sig[bin] ? v : sig[bin];
+    }
+
+    // 最优致密化：空桶 i 依次尝试 mix(i, 1), mix(i, 2), ... 指向的桶，复制第一个原本非空的桶的值
+    uint64_t filled[MINHASH_MAX_K / 64];
+    uint32_t nonempty = 0;
+    memset(filled, 0, sizeof(uint64_t) * ((k + 63) / 64));
+    for (uint32_t i = 0; i < k; i++) {
+        if (sig[i] != MINHASH_EMPTY) {
+            filled[i / 64] |= 1ULL << (i % 64);
+            nonempty++;
+        }
+    }
+    if (nonempty == 0 || nonempty == k) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < k; i++) {
+        if (filled[i / 64] & (1ULL << (i % 64))) {
+            continue;
+        }
+        for (uint64_t attempt = 1;; attempt++) {
+            uint32_t j = fast_range32((uint32_t)sketch_fmix64(((uint64_t)i << 32) | attempt), k);
+            if (filled[j / 64] & (1ULL << (j % 64))) {
+                sig[i] = sig[j];
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+int minhash_kperm(const uint64_t hashes[], size_t n, uint32_t k, uint32_t sig[]) {
+    if (k == 0) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < k; i++) {
+        // 第 i 个置换：h -> (a * h + b) 的高 32 位，a 为奇数
+        uint64_t a = sketch_fmix64(2 * (uint64_t)i + 1) | 1;
+        uint64_t b = sketch_fmix64(2 * (uint64_t)i + 2);
+        uint32_t m = MINHASH_EMPTY;
+        for (size_t j = 0; j < n; j++) {
+            uint32_t v = (uint32_t)((a * hashes[j] + b) >> 32);
+            v -= v == MINHASH_EMPTY;
+            m = v < m ? v : m;
+        }
+        sig[i] = m;
+    }
+    return 0;
+}
+
+size_t minhash_match_count_scalar(const uint32_t a[], const uint32_t b[], size_t k) {
+    size_t same = 0;
+    for (size_t i = 0; i < k; i++) {
+        same += a[i] == b[i];
+    }
+    return same;
+}
+
+#if SKETCH_HAVE_AVX2
+/**
+* @brief             AVX2 版本：每次比较 8 个值
+* @note              cmpeq 的结果相等时为 -1，累加器减去它即加 1；每个 32 位计数器最多累加 k / 8 次，不会溢出
+*/
+__attribute__((target("avx2")))
+static size_t minhash_match_count_avx2_impl(const uint32_t a[], const uint32_t b[], size_t k) {
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= k; i += 16) {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(b + i));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(a + i + 8));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(b + i + 8));
+        acc0 = _mm256_sub_epi32(acc0, _mm256_cmpeq_epi32(a0, b0));
+        acc1 = _mm256_sub_epi32(acc1, _mm256_cmpeq_epi32(a1, b1));
+    }
+    for (; i + 8 <= k; i += 8) {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(b + i));
+        acc0 = _mm256_sub_epi32(acc0, _mm256_cmpeq_epi32(a0, b0));
+    }
+    acc0 = _mm256_add_epi32(acc0, acc1);
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc0), _mm256_extracti128_si256(acc0, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    size_t same = (uint32_t)_mm_cvtsi128_si32(s);
+    return same + minhash_match_count_scalar(a + i, b + i, k - i);
+}
+#endif
+
+size_t minhash_match_count_avx2(const uint32_t a[], const uint32_t b[], size_t k) {
+#if SKETCH_HAVE_AVX2
+    if (hash_cpu_has_avx2()) {
+        return minhash_match_count_avx2_impl(a, b, k);
+    }
+#endif
+    return minhash_match_count_scalar(a, b, k);
+}
+
+size_t minhash_match_count(const uint32_t a[], const uint32_t b[], size_t k) {
+    return minhash_match_count_avx2(a, b, k);
+}
+
+double minhash_jaccard(const uint32_t a[], const uint32_t b[], size_t k) {
+    if (k == 0) {
+        return 0.0;
+    }
+    return (double)minhash_match_count(a, b, k) / (double)k;
+}
+
+typedef struct {
+    uint64_t hash;
+    uint32_t id;
+} BandEntry;
+
+static int cmp_band_entry(const void* x, const void* y) {
+    const BandEntry* a = (const BandEntry*)x;
+    const BandEntry* b = (const BandEntry*)y;
+    if (a->hash != b->hash) {
+        return a->hash < b->hash ? -1 : 1;
+    }
+    return a->id < b->id ? -1 : (a->id > b->id);
+}
+
+static int cmp_pair(const void* x, const void* y) {
+    const SketchPair* a = (const SketchPair*)x;
+    const SketchPair* b = (const SketchPair*)y;
+    if (a->a != b->a) {
+        return a->a < b->a ? -1 : 1;
+    }
+    return a->b < b->b ? -1 : (a->b > b->b);
+}
+
+int lsh_candidates(const uint32_t* sigs, size_t n, uint32_t k, uint32_t bands, uint32_t rows,
+                   SketchPair** pairs, size_t* npairs) {
+    if (pairs == NULL || npairs == NULL) {
+        return -1;
+    }
+    *pairs = NULL;
+    *npairs = 0;
+    if (bands == 0 || rows == 0 || (uint64_t)bands * rows > k || n > UINT32_MAX) {
+        return -1;
+    }
+    if (n < 2) {
+        return 0;
+    }
+
+    BandEntry* entries = (BandEntry*)malloc(n * sizeof(BandEntry));
+    if (entries == NULL) {
+        return -1;
+    }
+    SketchPair* out = NULL;
+    size_t count = 0;
+    size_t cap = 0;
+    for (uint32_t band = 0; band < bands; band++) {
+        for (size_t i = 0; i < n; i++) {
+            entries[i].hash = murmurHash3_x64_64(sigs + i * k + (size_t)band * rows, rows * sizeof(uint32_t), band);
+            entries[i].id = (uint32_t)i;
+        }
+        qsort(entries, n, sizeof(BandEntry), cmp_band_entry);
+
+        // 段哈希相同的连续区间内两两成为候选对（区间内序号已升序，a < b）
+        for (size_t lo = 0; lo < n;) {
+            size_t hi = lo + 1;
+            while (hi < n && entries[hi].hash == entries[lo].hash) {
+                hi++;
+            }
+            for (size_t x = lo; x < hi; x++) {
+                for (size_t y = x + 1; y < hi; y++) {
+                    if (count == cap) {
+                        size_t new_cap = cap != 0 ? cap * 2 : 1024;
+                        SketchPair* grown = (SketchPair*)realloc(out, new_cap * sizeof(SketchPair));
+                        if (grown == NULL) {
+                            free(out);
+                            free(entries);
+                            return -1;
+                        }
+                        out = grown;
+                        cap = new_cap;
+                    }
+                    out[count].a = entries[x].id;
+                    out[count].b = entries[y].id;
+                    count++;
+                }
+            }
+            lo = hi;
+        }
+    }
+    free(entries);
+
+    // 同一对可能在多个段中相同，排序后去重
+    if (count > 1) {
+        qsort(out, count, sizeof(SketchPair), cmp_pair);
+        size_t w = 1;
+        for (size_t i = 1; i < count; i++) {
+            if (out[i].a != out[w - 1].a || out[i].b != out[w - 1].b) {
+                out[w++] = out[i];
+            }
+        }
+        count = w;
+    }
+    *pairs = out;
+    *npairs = count;
+    return 0;
+}
+
+double lsh_probability(double s, uint32_t bands, uint32_t rows) {
+    return 1.0 - pow(1.0 - pow(s, (double)rows), (double)bands);
+}
+
+int lsh_choose_bands(uint32_t k, double threshold, uint32_t* bands, uint32_t* rows) {
+    if (k == 0 || !(threshold > 0.0 && threshold < 1.0) || bands == NULL || rows == NULL) {
+        return -1;
+    }
+    double best = 2.0;
+    for (uint32_t r = 1; r <= k; r++) {
+        uint32_t b = k / r;
+        double knee = pow(1.0 / (double)b, 1.0 / (double)r);
+        double diff = fabs(knee - threshold);
+        if (diff < best) {
+            best = diff;
+            *bands = b;
+            *rows = r;
+        }
+    }
+    return 0;
+}
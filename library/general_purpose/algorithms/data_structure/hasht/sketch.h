@@ -0,0 +1,117 @@
+#ifndef SKETCH_H
+#define SKETCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ 近似去重用的文档指纹（sketch）
+ （1）shingle：文本按空白切成词，每 k 个相邻的词组成一个 shingle，文档表示为 shingle 哈希值的集合
+ （2）SimHash：64 位指纹，两个文档的汉明距离近似反映余弦相似度，适合 "距离 <= 3 位" 这类查重
+ （3）MinHash：k 个 32 位值组成的签名，两个签名相等位置的比例是 Jaccard 相似度的无偏估计；
+      默认使用单次置换（One Permutation Hashing）：每个元素只哈希一次，按哈希值分桶取桶内最小值，
+      比 k 次独立置换快 k 倍，空桶用最优致密化（optimal densification）填充
+ （4）LSH banding：签名切成 bands 段、每段 rows 个值，任一段完全相同的文档成为候选对，
+      相似度为 s 的两个文档成为候选的概率为 1 - (1 - s^rows)^bands，不需要两两比较
+*/
+
+// 单个 shingle 最多包含的词数
+#define SKETCH_MAX_SHINGLE 16
+// MinHash 签名的最大长度（致密化使用栈上的位图）
+#define MINHASH_MAX_K 4096
+// MinHash 空桶（集合为空时所有桶都是空桶）
+#define MINHASH_EMPTY 0xffffffffu
+
+/**
+* @brief             计算文本的词级 shingle 哈希
+* @param text        文本，以空白字符（空格、制表符、换行）分词，不要求 '\0' 结尾
+* @param k           每个 shingle 的词数，1 ~ SKETCH_MAX_SHINGLE
+* @param out         输出 shingle 的 64 位哈希值（murmurHash3_x64_64），最多写入 cap 个
+* @return            shingle 总数（可能大于 cap，此时只写入前 cap 个）；词数不足 k 时整段作为一个 shingle，
+*                    没有词时返回 0；k 无效时返回 0
+*/
+size_t sketch_word_shingles(const void* text, size_t len, uint32_t k, uint64_t out[], size_t cap);
+
+/**
+* @brief             由特征哈希计算 64 位 SimHash
+* @param hashes      特征（如 shingle）的 64 位哈希值
+* @param weights     各特征的权重（如词频、TF-IDF），为NULL时权重都为 1
+* @return            指纹：第 b 位为 1 当且仅当第 b 位为 1 的特征的权重和大于第 b 位为 0 的特征的权重和
+* @note              CPU 支持 AVX2 时 64 位的计票并行进行
+*/
+uint64_t simhash64(const uint64_t hashes[], const uint32_t weights[], size_t n);
+// _scalar / _avx2 版本供测试与基准测试直接调用，_avx2 在 CPU 不支持时回退到标量版本
+uint64_t simhash64_scalar(const uint64_t hashes[], const uint32_t weights[], size_t n);
+uint64_t simhash64_avx2(const uint64_t hashes[], const uint32_t weights[], size_t n);
+
+// 两个 SimHash 指纹的汉明距离
+static inline int simhash_distance(uint64_t a, uint64_t b) {
+    return __builtin_popcountll(a ^ b);
+}
+
+/**
+* @brief             单次置换 MinHash 签名（OPH + 最优致密化）
+* @param hashes      集合元素的 64 位哈希值，允许重复
+* @param k           签名长度，1 ~ MINHASH_MAX_K
+* @param sig         输出 k 个值
+* @return            成功返回0，k 无效返回 -1
+* @note              元素按哈希值高 32 位分到 k 个桶，桶内取低 32 位的最小值；
+*                    集合为空时 sig 全部为 MINHASH_EMPTY
+*/
+int minhash_oph(const uint64_t hashes[], size_t n, uint32_t k, uint32_t sig[]);
+
+/**
+* @brief             经典 k 次置换 MinHash 签名，第 i 个值为所有元素在第 i 个置换下的最小值
+* @return            成功返回0，k 为 0 返回 -1
+* @note              置换为 64 位哈希上的 multiply-shift，每个元素要计算 k 次，只用于对比与检验
+*/
+int minhash_kperm(const uint64_t hashes[], size_t n, uint32_t k, uint32_t sig[]);
+
+/**
+* @brief             两个签名中相等的位置数，CPU 支持 AVX2 时每次比较 8 个值
+* @note              _scalar / _avx2 版本供测试与基准测试直接调用，_avx2 在 CPU 不支持时回退到标量版本
+*/
+size_t minhash_match_count(const uint32_t a[], const uint32_t b[], size_t k);
+size_t minhash_match_count_scalar(const uint32_t a[], const uint32_t b[], size_t k);
+size_t minhash_match_count_avx2(const uint32_t a[], const uint32_t b[], size_t k);
+
+// 由两个签名估计 Jaccard 相似度
+double minhash_jaccard(const uint32_t a[], const uint32_t b[], size_t k);
+
+// 候选对，a < b 为签名在数组中的序号
+typedef struct {
+    uint32_t a;
+    uint32_t b;
+} SketchPair;
+
+/**
+* @brief             LSH banding 查找候选对
+* @param sigs        n 个签名连续存放，第 i 个签名为 sigs[i * k .. i * k + k)
+* @param bands       段数，bands * rows 不超过 k（多出的签名值不参与）
+* @param pairs       输出候选对数组（按 (a, b) 升序、无重复），由调用者 free；没有候选对时为NULL
+* @param npairs      输出候选对个数
+* @return            成功返回0，参数无效或内存不足返回 -1
+* @note              每段把 (段哈希, 序号) 排序后取相同段哈希的连续区间，耗时 O(bands * n log n + 候选对数)；
+*                    大量完全相同的文档会产生平方级的候选对，可以先按 SimHash 或精确哈希去掉完全重复
+*/
+int lsh_candidates(const uint32_t* sigs, size_t n, uint32_t k, uint32_t bands, uint32_t rows,
+                   SketchPair** pairs, size_t* npairs);
+
+// 相似度为 s 的两个签名成为候选对的概率
+double lsh_probability(double s, uint32_t bands, uint32_t rows);
+
+/**
+* @brief             为给定的签名长度选择 bands 与 rows，使 S 形曲线的拐点 (1/bands)^(1/rows) 最接近阈值
+* @return            成功返回0，k 为 0 或 threshold 不在 (0,1) 内返回 -1
+*/
+int lsh_choose_bands(uint32_t k, double threshold, uint32_t* bands, uint32_t* rows);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SKETCH_H
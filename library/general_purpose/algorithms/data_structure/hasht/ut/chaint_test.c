@@ -0,0 +1,225 @@
+#include "chaint.h"
+#include "ut_check.h"
+#include "ut_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ 链地址法哈希表测试：基本增删查、与参考实现对比的随机操作（链表模式与树化模式、正常哈希与全部碰撞的哈希），
+ 树化与转回链表的阈值、碰撞时停止扩容、树的高度为对数、构造的 Java 字符串哈希碰撞
+*/
+
+typedef struct {
+    uint64_t id;
+    int value;
+    ChainTNode node;
+} Item;
+
+static uint64_t g_rng = 0x6a09e667f3bcc909ULL;
+
+// Java String.hashCode：s[0]*31^(n-1) + ... + s[n-1]，"Aa" 与 "BB" 的哈希值相同
+static uint32_t java_hash(const void* key, size_t len, uint32_t seed) {
+    const unsigned char* p = (const unsigned char*)key;
+    uint32_t h = seed;
+    for (size_t i = 0; i < len; i++) {
+        h = h * 31 + p[i];
+    }
+    return h;
+}
+
+static ChainT* make_table(hash32_fn hash, int treeify) {
+    ChainTConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.hash = hash;
+    cfg.treeify = treeify;
+    return chaint_create(&cfg);
+}
+
+static void count_node(ChainTNode* node, void* arg) {
+    (void)node;
+    (*(size_t*)arg)++;
+}
+
+static void free_item(ChainTNode* node, void* arg) {
+    (void)arg;
+    free(CHAINT_ENTRY(node, Item, node));
+}
+
+static void test_basic(void) {
+    CHECK(chaint_create(NULL) == NULL);
+    for (int treeify = 0; treeify <= 1; treeify++) {
+        ChainT* t = make_table(NULL, treeify);
+        CHECK_EQ(chaint_bucket_count(t), 32);
+        for (uint64_t i = 0; i < 1000; i++) {
+            Item* it = (Item*)malloc(sizeof(Item));
+            it->id = i;
+            it->value = (int)i * 2;
+            CHECK_EQ(chaint_add(t, &it->node, &it->id, sizeof(it->id)), 0);
+        }
+        CHECK_EQ(chaint_count(t), 1000);
+        CHECK(chaint_bucket_count(t) > 32);
+        CHECK(!chaint_noexpand(t));
+
+        Item dup = { 5, 0, { 0 } };
+        CHECK_EQ(chaint_add(t, &dup.node, &dup.id, sizeof(dup.id)), 1);
+        uint64_t k = 5;
+        ChainTNode* n = chaint_find(t, &k, sizeof(k));
+        CHECK(n != NULL && CHAINT_ENTRY(n, Item, node)->value == 10);
+        k = 5000;
+        CHECK(chaint_find(t, &k, sizeof(k)) == NULL);
+        CHECK(chaint_remove(t, &k, sizeof(k)) == NULL);
+
+        k = 5;
+        n = chaint_remove(t, &k, sizeof(k));
+        CHECK(n != NULL && CHAINT_ENTRY(n, Item, node)->id == 5);
+        free(CHAINT_ENTRY(n, Item, node));
+        CHECK(chaint_find(t, &k, sizeof(k)) == NULL);
+        CHECK_EQ(chaint_count(t), 999);
+
+        size_t visited = 0;
+        chaint_foreach(t, count_node, &visited);
+        CHECK_EQ(visited, 999);
+        chaint_foreach(t, free_item, NULL);
+        chaint_free(t);
+    }
+    chaint_free(NULL);
+}
+
+// 与参考数组对比的随机操作
+static void run_random_ops(hash32_fn hash, int treeify, int ops, uint64_t key_range) {
+    ChainT* t = make_table(hash, treeify);
+    Item* items = (Item*)calloc(key_range, sizeof(Item));
+    uint8_t* present = (uint8_t*)calloc(key_range, 1);
+    size_t size = 0;
+    for (int op = 0; op < ops; op++) {
+        uint64_t k = ut_rand(&g_rng) % key_range;
+        uint64_t r = ut_rand(&g_rng) % 10;
+        if (r < 5) {
+            if (present[k]) {
+                Item other = { k, 0, { 0 } };
+                CHECK_EQ(chaint_add(t, &other.node, &other.id, sizeof(other.id)), 1);
+            } else {
+                items[k].id = k;
+                CHECK_EQ(chaint_add(t, &items[k].node, &items[k].id, sizeof(uint64_t)), 0);
+                present[k] = 1;
+                size++;
+            }
+        } else if (r < 8) {
+            ChainTNode* n = chaint_remove(t, &k, sizeof(k));
+            CHECK(n == (present[k] ? &items[k].node : NULL));
+            size -= present[k];
+            present[k] = 0;
+        } else {
+            ChainTNode* n = chaint_find(t, &k, sizeof(k));
+            CHECK(n == (present[k] ? &items[k].node : NULL));
+        }
+        CHECK_EQ(chaint_count(t), size);
+    }
+    for (uint64_t k = 0; k < key_range; k++) {
+        CHECK(chaint_find(t, &k, sizeof(k)) == (present[k] ? &items[k].node : NULL));
+    }
+    size_t visited = 0;
+    chaint_foreach(t, count_node, &visited);
+    CHECK_EQ(visited, size);
+    free(items);
+    free(present);
+    chaint_free(t);
+}
+
+static void test_random(void) {
+    run_random_ops(NULL, 0, 100000, 5000);
+    run_random_ops(NULL, 1, 100000, 5000);
+    run_random_ops(ut_const_hash32, 0, 20000, 300);
+    run_random_ops(ut_const_hash32, 1, 100000, 3000);
+}
+
+static void test_treeify(void) {
+    // 全部碰撞：第 9 个元素树化，删除到 6 个时转回链表
+    ChainT* t = make_table(ut_const_hash32, 1);
+    Item items[2000];
+    for (uint64_t i = 0; i < 8; i++) {
+        items[i].id = i;
+        chaint_add(t, &items[i].node, &items[i].id, sizeof(uint64_t));
+    }
+    CHECK_EQ(chaint_tree_buckets(t), 0);
+    CHECK_EQ(chaint_max_depth(t), 8);
+    items[8].id = 8;
+    chaint_add(t, &items[8].node, &items[8].id, sizeof(uint64_t));
+    CHECK_EQ(chaint_tree_buckets(t), 1);
+    CHECK_EQ(chaint_max_depth(t), 4);
+    for (uint64_t i = 0; i < 2; i++) {
+        CHECK(chaint_remove(t, &items[i].id, sizeof(uint64_t)) == &items[i].node);
+    }
+    CHECK_EQ(chaint_tree_buckets(t), 1);                // 7 个元素仍是树
+    CHECK(chaint_remove(t, &items[2].id, sizeof(uint64_t)) == &items[2].node);
+    CHECK_EQ(chaint_tree_buckets(t), 0);
+    CHECK_EQ(chaint_max_depth(t), 6);
+    for (uint64_t i = 3; i < 9; i++) {
+        CHECK(chaint_find(t, &items[i].id, sizeof(uint64_t)) == &items[i].node);
+    }
+
+    // 继续加到 2000 个：扩容无效后停止扩容，树高为对数级
+    for (uint64_t i = 9; i < 2000; i++) {
+        items[i].id = i;
+        chaint_add(t, &items[i].node, &items[i].id, sizeof(uint64_t));
+    }
+    CHECK(chaint_noexpand(t));
+    CHECK(chaint_bucket_count(t) <= 128);
+    CHECK(chaint_max_depth(t) <= 16);                  // AVL：1.44 * log2(2000) 约 15.8
+    for (uint64_t i = 3; i < 2000; i++) {
+        CHECK(chaint_find(t, &items[i].id, sizeof(uint64_t)) == &items[i].node);
+    }
+    chaint_free(t);
+
+    // 链表模式：同样的键使链表长到 2000
+    t = make_table(ut_const_hash32, 0);
+    for (uint64_t i = 0; i < 2000; i++) {
+        chaint_add(t, &items[i].node, &items[i].id, sizeof(uint64_t));
+    }
+    CHECK(chaint_noexpand(t));
+    CHECK_EQ(chaint_max_depth(t), 2000);
+    CHECK_EQ(chaint_tree_buckets(t), 0);
+    chaint_free(t);
+}
+
+// Java 字符串哈希的碰撞：由 "Aa" / "BB" 拼成的 2^k 个字符串哈希值全部相同
+static void test_java_collisions(void) {
+    enum { BLOCKS = 10, N = 1 << BLOCKS, LEN = 2 * BLOCKS };
+    char (*keys)[LEN] = malloc(sizeof(char[N][LEN]));
+    Item* items = (Item*)malloc(N * sizeof(Item));
+    for (int i = 0; i < N; i++) {
+        for (int b = 0; b < BLOCKS; b++) {
+            memcpy(keys[i] + 2 * b, (i >> b) & 1 ? "BB" : "Aa", 2);
+        }
+        CHECK_EQ(java_hash(keys[i], LEN, 0), java_hash(keys[0], LEN, 0));
+    }
+    for (int treeify = 0; treeify <= 1; treeify++) {
+        ChainT* t = make_table(java_hash, treeify);
+        for (int i = 0; i < N; i++) {
+            CHECK_EQ(chaint_add(t, &items[i].node, keys[i], LEN), 0);
+        }
+        CHECK_EQ(chaint_max_depth(t), treeify ? 11 : N);
+        for (int i = 0; i < N; i++) {
+            CHECK(chaint_find(t, keys[i], LEN) == &items[i].node);
+        }
+        for (int i = 0; i < N; i += 2) {
+            CHECK(chaint_remove(t, keys[i], LEN) == &items[i].node);
+        }
+        for (int i = 0; i < N; i++) {
+            CHECK(chaint_find(t, keys[i], LEN) == (i % 2 ? &items[i].node : NULL));
+        }
+        chaint_free(t);
+    }
+    free(keys);
+    free(items);
+}
+
+int main(void) {
+    test_basic();
+    test_random();
+    test_treeify();
+    test_java_collisions();
+
+    return ut_report("chaint_test");
+}
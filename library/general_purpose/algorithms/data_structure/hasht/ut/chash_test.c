@@ -0,0 +1,210 @@
+#include "chash.h"
+#include "hashalg.h"
+#include "ut_check.h"
+#include <stdio.h>
+#include <string.h>
+
+/*
+ 一致性哈希测试：跳跃一致性哈希的参考值与单调性，Ketama 环与 Rendezvous 哈希在节点增删时
+ 只有涉及的节点上的键移动、结果与加入顺序无关、各节点分到的键数与权重成正比
+*/
+
+#define KEYS 20000
+
+static int g_before[KEYS];
+static int g_after[KEYS];
+
+static void node_name(char* buf, size_t size, int i) {
+    snprintf(buf, size, "10.0.%d.%d:11211", i / 256, i % 256);
+}
+
+static int lookup_key(const ChashRing* ring, uint32_t k) {
+    return chash_ring_lookup(ring, &k, sizeof(k));
+}
+
+static void test_jump(void) {
+    // 参考值由论文中的算法（Python 逐步实现）计算
+    CHECK_EQ(jump_consistent_hash(0, 1), 0);
+    CHECK_EQ(jump_consistent_hash(1, 10), 6);
+    CHECK_EQ(jump_consistent_hash(0xdeadbeefULL, 1000), 285);
+    CHECK_EQ(jump_consistent_hash(0xffffffffffffffffULL, 100000), 18311);
+    CHECK_EQ(jump_consistent_hash(12345678901234567ULL, 7), 5);
+    CHECK_EQ(jump_consistent_hash(0x8000000000000000ULL, 2147483647), 1119800965);
+    CHECK_EQ(jump_consistent_hash(42, 0), -1);
+    CHECK_EQ(jump_consistent_hash(42, -3), -1);
+
+    // 桶数 n -> n+1：键要么不动，要么移到新桶 n
+    int moved = 0;
+    for (uint32_t k = 0; k < KEYS; k++) {
+        uint64_t h = xxHash64(&k, sizeof(k), 0);
+        int32_t a = jump_consistent_hash(h, 9);
+        int32_t b = jump_consistent_hash(h, 10);
+        CHECK(a >= 0 && a < 9);
+        CHECK(b == a || b == 9);
+        moved += b != a;
+    }
+    // 期望 1/10，允许较宽的统计误差
+    CHECK(moved > KEYS / 10 * 8 / 10 && moved < KEYS / 10 * 12 / 10);
+}
+
+static void test_ring_basic(void) {
+    ChashRing* ring = chash_ring_create(0);
+    CHECK(ring != NULL);
+    CHECK_EQ(chash_ring_lookup(ring, "a", 1), -1);
+
+    int a = chash_ring_add(ring, "a", 1);
+    CHECK_EQ(a, 0);
+    CHECK_EQ(chash_ring_point_count(ring), CHASH_DEFAULT_VNODES);
+    CHECK_EQ(chash_ring_add(ring, "a", 1), -1);     // 重名
+    CHECK_EQ(chash_ring_add(ring, "b", 0), -1);     // 权重为 0
+    for (uint32_t k = 0; k < 100; k++) {
+        CHECK_EQ(lookup_key(ring, k), a);           // 只有一个节点
+    }
+
+    int b = chash_ring_add(ring, "b", 2);
+    CHECK_EQ(b, 1);
+    CHECK_EQ(chash_ring_node_count(ring), 2);
+    CHECK_EQ(chash_ring_point_count(ring), 3 * CHASH_DEFAULT_VNODES);
+    CHECK(strcmp(chash_ring_node_name(ring, b), "b") == 0);
+
+    // 回绕：大于最后一个虚拟节点的位置属于第一个虚拟节点
+    CHECK_EQ(chash_ring_lookup_hash(ring, 0xffffffffu), chash_ring_lookup_hash(ring, 0));
+
+    CHECK_EQ(chash_ring_remove(ring, "a"), 0);
+    CHECK_EQ(chash_ring_remove(ring, "a"), -1);
+    CHECK(chash_ring_node_name(ring, a) == NULL);
+    CHECK_EQ(chash_ring_point_count(ring), 2 * CHASH_DEFAULT_VNODES);
+    for (uint32_t k = 0; k < 100; k++) {
+        CHECK_EQ(lookup_key(ring, k), b);
+    }
+    CHECK_EQ(chash_ring_add(ring, "a", 1), 2);      // 编号不复用
+    chash_ring_free(ring);
+    chash_ring_free(NULL);
+}
+
+// 加入或删除一个节点时，只有新节点上 / 被删节点上的键变化；删除后再加入恢复原映射
+static void test_ring_movement(void) {
+    enum { NODES = 20 };
+    char name[32];
+    ChashRing* ring = chash_ring_create(0);
+    for (int i = 0; i < NODES; i++) {
+        node_name(name, sizeof(name), i);
+        CHECK(chash_ring_add(ring, name, 1) >= 0);
+    }
+    for (uint32_t k = 0; k < KEYS; k++) {
+        g_before[k] = lookup_key(ring, k);
+    }
+
+    node_name(name, sizeof(name), NODES);
+    int added = chash_ring_add(ring, name, 1);
+    int moved = 0;
+    for (uint32_t k = 0; k < KEYS; k++) {
+        g_after[k] = lookup_key(ring, k);
+        CHECK(g_after[k] == g_before[k] || g_after[k] == added);
+        moved += g_after[k] != g_before[k];
+    }
+    // 期望 1/21，虚拟节点使各节点的份额在 ±30% 内
+    CHECK(moved > KEYS / 21 * 7 / 10 && moved < KEYS / 21 * 13 / 10);
+
+    node_name(name, sizeof(name), 3);
+    CHECK_EQ(chash_ring_remove(ring, name), 0);
+    for (uint32_t k = 0; k < KEYS; k++) {
+        int now = lookup_key(ring, k);
+        const char* was = chash_ring_node_name(ring, g_after[k]);
+        if (was != NULL) {
+            CHECK_EQ(now, g_after[k]);              // 不在被删节点上的键不动
+        }
+    }
+
+    node_name(name, sizeof(name), NODES);
+    CHECK_EQ(chash_ring_remove(ring, name), 0);
+    node_name(name, sizeof(name), 3);
+    int readded = chash_ring_add(ring, name, 1);
+    for (uint32_t k = 0; k < KEYS; k++) {
+        int now = lookup_key(ring, k);
+        const char* a = chash_ring_node_name(ring, now);
+        const char* b = chash_ring_node_name(ring, g_before[k]);
+        // 节点 3 重新加入后编号变了，按名字比较
+        CHECK(a != NULL && strcmp(a, b != NULL ? b : chash_ring_node_name(ring, readded)) == 0);
+    }
+    chash_ring_free(ring);
+}
+
+// 相同的节点集合以不同顺序加入，映射到同名节点；权重为 3 的节点分到约 3 倍的键
+static void test_ring_order_and_weight(void) {
+    enum { NODES = 8 };
+    char name[32];
+    ChashRing* fwd = chash_ring_create(100);
+    ChashRing* rev = chash_ring_create(100);
+    for (int i = 0; i < NODES; i++) {
+        node_name(name, sizeof(name), i);
+        chash_ring_add(fwd, name, i == 0 ? 3 : 1);
+        node_name(name, sizeof(name), NODES - 1 - i);
+        chash_ring_add(rev, name, i == NODES - 1 ? 3 : 1);
+    }
+    int heavy = 0;
+    for (uint32_t k = 0; k < KEYS; k++) {
+        const char* a = chash_ring_node_name(fwd, lookup_key(fwd, k));
+        const char* b = chash_ring_node_name(rev, lookup_key(rev, k));
+        CHECK(strcmp(a, b) == 0);
+        heavy += lookup_key(fwd, k) == 0;
+    }
+    // 节点 0 的份额期望 3/10
+    CHECK(heavy > KEYS * 3 / 10 * 8 / 10 && heavy < KEYS * 3 / 10 * 12 / 10);
+    chash_ring_free(fwd);
+    chash_ring_free(rev);
+}
+
+static void test_rendezvous(void) {
+    enum { NODES = 10 };
+    uint64_t nodes[NODES];
+    uint64_t shuffled[NODES];
+    char name[32];
+    for (int i = 0; i < NODES; i++) {
+        node_name(name, sizeof(name), i);
+        nodes[i] = xxHash64(name, strlen(name), 0);
+        shuffled[NODES - 1 - i] = nodes[i];
+    }
+    CHECK_EQ(rendezvous_hash(1, nodes, 0), -1);
+
+    // 删除最后一个节点：只有原属于它的键移动；数组顺序不影响结果
+    int counts[NODES] = { 0 };
+    for (uint32_t k = 0; k < KEYS; k++) {
+        uint64_t h = xxHash64(&k, sizeof(k), 0);
+        int32_t a = rendezvous_hash(h, nodes, NODES);
+        int32_t b = rendezvous_hash(h, nodes, NODES - 1);
+        CHECK(a == NODES - 1 || b == a);
+        CHECK_EQ(shuffled[rendezvous_hash(h, shuffled, NODES)], nodes[a]);
+        counts[a]++;
+    }
+    for (int i = 0; i < NODES; i++) {
+        CHECK(counts[i] > KEYS / NODES * 8 / 10 && counts[i] < KEYS / NODES * 12 / 10);
+    }
+
+    // 权重 1:2:...:10
+    double weights[NODES];
+    int wcounts[NODES] = { 0 };
+    for (int i = 0; i < NODES; i++) {
+        weights[i] = (double)(i + 1);
+    }
+    for (uint32_t k = 0; k < KEYS; k++) {
+        uint64_t h = xxHash64(&k, sizeof(k), 0);
+        wcounts[rendezvous_hash_weighted(h, nodes, weights, NODES)]++;
+    }
+    for (int i = 0; i < NODES; i++) {
+        double expect = (double)KEYS * (i + 1) / 55.0;
+        CHECK(wcounts[i] > expect * 0.8 - 30 && wcounts[i] < expect * 1.2 + 30);
+    }
+    double zeros[NODES] = { 0 };
+    CHECK_EQ(rendezvous_hash_weighted(1, nodes, zeros, NODES), -1);
+}
+
+int main(void) {
+    test_jump();
+    test_ring_basic();
+    test_ring_movement();
+    test_ring_order_and_weight();
+    test_rendezvous();
+
+    return ut_report("chash_test");
+}
@@ -0,0 +1,346 @@
+#include "concmap.h"
+#include "ut_check.h"
+#include "ut_util.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ 并发哈希表测试：单线程的增删改查与参考实现对比（含全部键落在同一段、负载因子很小/很大），
+ 纪元推进与旧表的回收（含 detach 后转为孤儿的表）、线程登记上限，
+ 多个写线程（各自负责一部分键，反复插入、更新、删除，触发各段扩容）与多个无锁读线程同时运行：
+ 读到的值必须是某次完整写入的值，预先插入且从不删除的键必须始终能读到，结束后与各写线程的参考结果一致
+*/
+
+static ConcMap* make_map(hash64_fn hash, size_t segments, double max_load, size_t initial) {
+    ConcMapConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.key_size = sizeof(uint64_t);
+    cfg.value_size = sizeof(uint64_t);
+    cfg.hash = hash;
+    cfg.segments = segments;
+    cfg.max_load = max_load;
+    cfg.initial_capacity = initial;
+    return concmap_create(&cfg);
+}
+
+static void test_basic(void) {
+    ConcMapConfig bad;
+    memset(&bad, 0, sizeof(bad));
+    CHECK(concmap_create(&bad) == NULL);
+    bad.key_size = 8;
+    bad.max_load = 1.0;
+    CHECK(concmap_create(&bad) == NULL);
+    CHECK(concmap_create(NULL) == NULL);
+
+    ConcMap* m = make_map(NULL, 5, 0, 0);
+    CHECK_EQ(concmap_segments(m), 8);
+    ConcMapThread* th = concmap_attach(m);
+    for (uint64_t k = 0; k < 1000; k++) {
+        uint64_t v = k * 3;
+        CHECK_EQ(concmap_put(th, &k, &v), 1);
+    }
+    CHECK_EQ(concmap_size(m), 1000);
+    for (uint64_t k = 0; k < 1000; k++) {
+        uint64_t v = 0;
+        CHECK_EQ(concmap_get(th, &k, &v), 0);
+        CHECK_EQ(v, k * 3);
+    }
+    uint64_t k = 7, v = 70, out = 0;
+    CHECK_EQ(concmap_put(th, &k, &v), 0);
+    CHECK_EQ(concmap_get(th, &k, &out), 0);
+    CHECK_EQ(out, 70);
+    CHECK_EQ(concmap_remove(th, &k, &out), 0);
+    CHECK_EQ(out, 70);
+    CHECK_EQ(concmap_remove(th, &k, NULL), -1);
+    CHECK_EQ(concmap_get(th, &k, NULL), -1);
+    k = 5000;
+    CHECK_EQ(concmap_get(th, &k, NULL), -1);
+    CHECK_EQ(concmap_size(m), 999);
+    concmap_detach(th);
+    concmap_free(m);
+    concmap_free(NULL);
+}
+
+// 单线程随机操作，与以键为下标的数组对比
+static void run_random_ops(hash64_fn hash, size_t segments, double max_load, int ops, uint64_t key_range) {
+    ConcMap* m = make_map(hash, segments, max_load, 0);
+    ConcMapThread* th = concmap_attach(m);
+    uint64_t* ref = (uint64_t*)calloc(key_range, sizeof(uint64_t));    // 0 表示不存在，否则为 值 + 1
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+    size_t n = 0;
+    for (int i = 0; i < ops; i++) {
+        uint64_t k = ut_rand(&rng) % key_range;
+        uint64_t v = ut_rand(&rng) >> 1;
+        uint64_t out = 0;
+        switch (ut_rand(&rng) % 3) {
+        case 0:
+            CHECK_EQ(concmap_put(th, &k, &v), ref[k] == 0 ? 1 : 0);
+            n += ref[k] == 0;
+            ref[k] = v + 1;
+            break;
+        case 1:
+            CHECK_EQ(concmap_remove(th, &k, &out), ref[k] != 0 ? 0 : -1);
+            if (ref[k] != 0) {
+                CHECK_EQ(out, ref[k] - 1);
+                ref[k] = 0;
+                n--;
+            }
+            break;
+        default:
+            CHECK_EQ(concmap_get(th, &k, &out), ref[k] != 0 ? 0 : -1);
+            if (ref[k] != 0) {
+                CHECK_EQ(out, ref[k] - 1);
+            }
+            break;
+        }
+    }
+    CHECK_EQ(concmap_size(m), n);
+    for (uint64_t k = 0; k < key_range; k++) {
+        uint64_t out = 0;
+        CHECK_EQ(concmap_get(th, &k, &out), ref[k] != 0 ? 0 : -1);
+        if (ref[k] != 0) {
+            CHECK_EQ(out, ref[k] - 1);
+        }
+    }
+    free(ref);
+    concmap_detach(th);
+    concmap_free(m);
+}
+
+static void test_random(void) {
+    run_random_ops(NULL, 0, 0, 200000, 5000);
+    run_random_ops(NULL, 1, 0.95, 200000, 5000);
+    run_random_ops(NULL, 4, 0.05, 100000, 2000);
+    // 全部落在同一段、同一组：探测遍历整张表，删除产生大量墓碑
+    run_random_ops(ut_const_hash, 16, 0, 20000, 300);
+}
+
+// 没有读者时纪元随扩容与写操作推进，旧表陆续释放；detach 后剩余的表由 concmap_free 释放
+static void test_reclaim(void) {
+    ConcMap* m = make_map(NULL, 4, 0, 0);
+    ConcMapThread* th = concmap_attach(m);
+    for (uint64_t k = 0; k < 100000; k++) {
+        concmap_put(th, &k, &k);
+    }
+    CHECK(concmap_epoch(m) > 10);
+    for (uint64_t v = 0; v < 1000; v++) {
+        uint64_t k = v % 10;
+        concmap_put(th, &k, &v);
+    }
+    CHECK_EQ(concmap_pending(m), 0);
+    concmap_detach(th);
+    concmap_free(m);
+}
+
+// 读者停在 eq 里：第一次调用时通知 reader_parked，等到 reader_release 再返回
+static int reader_block, reader_parked, reader_release;
+
+static int blocking_eq(const void* a, const void* b, size_t len) {
+    int expected = 1;
+    if (__atomic_compare_exchange_n(&reader_block, &expected, 0, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&reader_parked, 1, __ATOMIC_RELEASE);
+        while (!__atomic_load_n(&reader_release, __ATOMIC_ACQUIRE)) {
+            sched_yield();
+        }
+    }
+    return memcmp(a, b, len);
+}
+
+static void* parked_reader_main(void* arg) {
+    ConcMapThread* th = (ConcMapThread*)arg;
+    uint64_t k = 0, v;
+    concmap_get(th, &k, &v);
+    return NULL;
+}
+
+// detach 时尚未到期的表（有读者停在旧纪元）转为孤儿，之后由其他线程的写操作释放，不必等到 concmap_free
+static void test_reclaim_orphans(void) {
+    ConcMapConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.key_size = sizeof(uint64_t);
+    cfg.value_size = sizeof(uint64_t);
+    cfg.eq = blocking_eq;
+    cfg.segments = 1;
+    ConcMap* m = concmap_create(&cfg);
+    ConcMapThread* a = concmap_attach(m);
+    ConcMapThread* b = concmap_attach(m);
+    uint64_t k = 0;
+    concmap_put(a, &k, &k);
+
+    __atomic_store_n(&reader_block, 1, __ATOMIC_RELEASE);
+    pthread_t tid;
+    pthread_create(&tid, NULL, parked_reader_main, b);
+    while (!__atomic_load_n(&reader_parked, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+    for (k = 1; k < 10000; k++) {
+        concmap_put(a, &k, &k);
+    }
+    size_t orphaned = concmap_pending(m);
+    CHECK(orphaned > 0);
+    concmap_detach(a);
+    CHECK_EQ(concmap_pending(m), orphaned);
+
+    __atomic_store_n(&reader_release, 1, __ATOMIC_RELEASE);
+    pthread_join(tid, NULL);
+    for (uint64_t v = 0; v < 1000; v++) {
+        k = v % 10;
+        concmap_put(b, &k, &v);
+    }
+    CHECK_EQ(concmap_pending(m), 0);
+    concmap_detach(b);
+    concmap_free(m);
+}
+
+static void test_attach_limit(void) {
+    ConcMap* m = make_map(NULL, 1, 0, 0);
+    ConcMapThread* ths[CONCMAP_MAX_THREADS];
+    for (int i = 0; i < CONCMAP_MAX_THREADS; i++) {
+        ths[i] = concmap_attach(m);
+        CHECK(ths[i] != NULL);
+    }
+    CHECK(concmap_attach(m) == NULL);
+    concmap_detach(ths[10]);
+    ConcMapThread* th = concmap_attach(m);
+    CHECK(th == ths[10]);
+    uint64_t k = 1, v = 2;
+    CHECK_EQ(concmap_put(th, &k, &v), 1);
+    concmap_free(m);
+}
+
+/*
+ 并发：值的低 32 位为键，高 32 位为写入的代数，读到的值低 32 位必须等于键（没有读到半个值或别的键的值）
+ 键 < STABLE_KEYS 预先插入，之后只更新不删除；其余的键按 键 % WRITERS 分给各写线程
+*/
+#define WRITERS 4
+#define READERS 4
+#define STABLE_KEYS 1000
+#define KEY_RANGE 200000
+#define WRITER_OPS 200000
+
+typedef struct {
+    ConcMap* map;
+    int id;
+    int stop;                   // 读线程的停止标志
+    uint64_t* ref;              // 写线程：以键为下标的参考结果，0 表示不存在
+    long failures;
+    long found;
+} Worker;
+
+static void* writer_main(void* arg) {
+    Worker* w = (Worker*)arg;
+    ConcMapThread* th = concmap_attach(w->map);
+    uint64_t rng = 0x51ed2701 + (uint64_t)w->id * 7919;
+    for (uint64_t gen = 1; gen <= WRITER_OPS; gen++) {
+        uint64_t r = ut_rand(&rng);
+        uint64_t k = STABLE_KEYS + (r % (KEY_RANGE / WRITERS)) * WRITERS + (uint64_t)w->id;
+        uint64_t v = (gen << 32) | k;
+        if ((r >> 40) % 4 == 0) {
+            // 也更新稳定键，使读者在稳定键上与更新并发
+            uint64_t s = (r >> 20) % STABLE_KEYS;
+            uint64_t sv = (gen << 32) | s;
+            w->failures += concmap_put(th, &s, &sv) != 0;
+        } else if ((r >> 40) % 4 == 1) {
+            w->failures += concmap_remove(th, &k, NULL) != (w->ref[k] != 0 ? 0 : -1);
+            w->ref[k] = 0;
+        } else {
+            w->failures += concmap_put(th, &k, &v) != (w->ref[k] == 0 ? 1 : 0);
+            w->ref[k] = v;
+        }
+    }
+    concmap_detach(th);
+    return NULL;
+}
+
+static void* reader_main(void* arg) {
+    Worker* w = (Worker*)arg;
+    ConcMapThread* th = concmap_attach(w->map);
+    uint64_t rng = 0x2545f4914f6cdd1dULL + (uint64_t)w->id;
+    while (!__atomic_load_n(&w->stop, __ATOMIC_ACQUIRE)) {
+        uint64_t r = ut_rand(&rng);
+        uint64_t k = (r & 1) ? r % STABLE_KEYS : r % (KEY_RANGE + STABLE_KEYS);
+        uint64_t v = 0;
+        int rc = concmap_get(th, &k, &v);
+        if (k < STABLE_KEYS && rc != 0) {
+            w->failures++;
+        }
+        if (rc == 0) {
+            w->found++;
+            w->failures += (v & 0xffffffffULL) != k;
+        }
+    }
+    concmap_detach(th);
+    return NULL;
+}
+
+static void test_concurrent(void) {
+    ConcMap* m = make_map(NULL, 8, 0, 0);
+    ConcMapThread* th = concmap_attach(m);
+    for (uint64_t k = 0; k < STABLE_KEYS; k++) {
+        concmap_put(th, &k, &k);
+    }
+    concmap_detach(th);
+
+    Worker writers[WRITERS], readers[READERS];
+    pthread_t tids[WRITERS + READERS];
+    memset(writers, 0, sizeof(writers));
+    memset(readers, 0, sizeof(readers));
+    for (int i = 0; i < READERS; i++) {
+        readers[i].map = m;
+        readers[i].id = i;
+        pthread_create(&tids[WRITERS + i], NULL, reader_main, &readers[i]);
+    }
+    for (int i = 0; i < WRITERS; i++) {
+        writers[i].map = m;
+        writers[i].id = i;
+        writers[i].ref = (uint64_t*)calloc(KEY_RANGE + STABLE_KEYS, sizeof(uint64_t));
+        pthread_create(&tids[i], NULL, writer_main, &writers[i]);
+    }
+    for (int i = 0; i < WRITERS; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    for (int i = 0; i < READERS; i++) {
+        __atomic_store_n(&readers[i].stop, 1, __ATOMIC_RELEASE);
+        pthread_join(tids[WRITERS + i], NULL);
+    }
+
+    th = concmap_attach(m);
+    size_t expect = STABLE_KEYS;
+    for (int i = 0; i < WRITERS; i++) {
+        CHECK_EQ(writers[i].failures, 0);
+        for (uint64_t k = STABLE_KEYS; k < KEY_RANGE + STABLE_KEYS; k++) {
+            if ((k - STABLE_KEYS) % WRITERS != (uint64_t)i) {
+                continue;
+            }
+            uint64_t v = 0;
+            int rc = concmap_get(th, &k, &v);
+            CHECK_EQ(rc, writers[i].ref[k] != 0 ? 0 : -1);
+            if (rc == 0) {
+                CHECK_EQ(v, writers[i].ref[k]);
+                expect++;
+            }
+        }
+        free(writers[i].ref);
+    }
+    for (int i = 0; i < READERS; i++) {
+        CHECK_EQ(readers[i].failures, 0);
+        CHECK(readers[i].found > 0);
+    }
+    CHECK_EQ(concmap_size(m), expect);
+    concmap_detach(th);
+    concmap_free(m);
+}
+
+int main(void) {
+    test_basic();
+    test_random();
+    test_reclaim();
+    test_reclaim_orphans();
+    test_attach_limit();
+    test_concurrent();
+
+    return ut_report("concmap_test");
+}
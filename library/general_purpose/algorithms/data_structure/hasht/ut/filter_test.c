@@ -0,0 +1,247 @@
+#include "filter.h"
+#include "hashalg.h"
+#include "ut_check.h"
+#include "ut_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ 近似成员查询过滤器测试：
+ 分块布隆过滤器的参数选择（满足目标且块数最少）、没有假阴性、实测假阳性率与估计一致、AVX2 与标量版本结果一致；
+ 布谷鸟过滤器的参数选择、各种指纹宽度下没有假阴性、假阳性率不超过目标、重复加入与删除、填满后的备用槽位
+*/
+
+static uint64_t g_rng = 0x853c49e6748fea9bULL;
+
+// 键 i 的哈希值：用不同的种子区分 "加入的键" 与 "不在集合中的键"
+static uint64_t key_hash(uint64_t i, uint64_t seed) {
+    return xxHash64(&i, sizeof(i), seed);
+}
+
+static void test_bloom_params(void) {
+    size_t nblocks;
+    unsigned k;
+    CHECK_EQ(bloom_params(1000, 0.0, &nblocks, &k), -1);
+    CHECK_EQ(bloom_params(1000, 1.0, &nblocks, &k), -1);
+    CHECK(bloom_create(1000, 2.0) == NULL);
+    CHECK(bloom_create_blocks(0, 4) == NULL);
+    CHECK(bloom_create_blocks(16, 0) == NULL);
+    CHECK(bloom_create_blocks(16, BLOOM_BLOCK_WORDS + 1) == NULL);
+    CHECK(bloom_fpr(100, 8, 0) == 0.0);
+
+    const double targets[] = {0.1, 0.01, 0.001, 0.0001};
+    for (int t = 0; t < 4; t++) {
+        CHECK_EQ(bloom_params(100000, targets[t], &nblocks, &k), 0);
+        CHECK(bloom_fpr(nblocks, k, 100000) <= targets[t]);
+        // 块数最少：任何 k 下少一块都达不到目标
+        for (unsigned kk = 1; kk <= BLOOM_BLOCK_WORDS; kk++) {
+            CHECK(bloom_fpr(nblocks - 1, kk, 100000) > targets[t]);
+        }
+    }
+    // 1% 时每个键约 10 ~ 11 位（标准布隆过滤器为 9.6 位）
+    CHECK_EQ(bloom_params(100000, 0.01, &nblocks, &k), 0);
+    double bits_per_key = (double)nblocks * 512 / 100000;
+    CHECK(bits_per_key > 9.6 && bits_per_key < 12.0);
+}
+
+static void run_bloom(size_t n, double fpr) {
+    BloomFilter* f = bloom_create(n, fpr);
+    CHECK(f != NULL);
+    for (uint64_t i = 0; i < n; i++) {
+        bloom_add_hash(f, key_hash(i, 1));
+    }
+    size_t missing = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        missing += !bloom_contains_hash(f, key_hash(i, 1));
+    }
+    CHECK_EQ(missing, 0);
+
+    size_t trials = 1000000, positives = 0;
+    for (uint64_t i = 0; i < trials; i++) {
+        positives += bloom_contains_hash(f, key_hash(i, 2));
+    }
+    double measured = (double)positives / (double)trials;
+    double expected = bloom_fpr(bloom_blocks(f), bloom_k(f), n);
+    CHECK(measured <= fpr * 1.2);
+    CHECK(measured >= expected * 0.7 && measured <= expected * 1.3);
+
+    bloom_clear(f);
+    positives = 0;
+    for (uint64_t i = 0; i < 1000; i++) {
+        positives += bloom_contains_hash(f, key_hash(i, 1));
+    }
+    CHECK_EQ(positives, 0);
+    bloom_free(f);
+}
+
+static void test_bloom(void) {
+    run_bloom(100000, 0.01);
+    run_bloom(100000, 0.001);
+    run_bloom(20000, 0.2);
+    run_bloom(1, 0.01);
+
+    BloomFilter* f = bloom_create(1000, 0.01);
+    const char* words[] = {"apple", "banana", "cherry", ""};
+    for (int i = 0; i < 4; i++) {
+        bloom_add(f, words[i], strlen(words[i]));
+    }
+    for (int i = 0; i < 4; i++) {
+        CHECK(bloom_contains(f, words[i], strlen(words[i])));
+    }
+    bloom_free(f);
+    bloom_free(NULL);
+}
+
+// 默认版本（AVX2）与标量版本：同样的加入得到同样的位，同样的查询得到同样的结果
+static void test_bloom_scalar(void) {
+    for (unsigned k = 1; k <= BLOOM_BLOCK_WORDS; k++) {
+        BloomFilter* a = bloom_create_blocks(37, k);
+        BloomFilter* b = bloom_create_blocks(37, k);
+        for (int i = 0; i < 300; i++) {
+            uint64_t h = ut_rand(&g_rng);
+            bloom_add_hash(a, h);
+            bloom_add_hash_scalar(b, h);
+        }
+        for (int i = 0; i < 20000; i++) {
+            uint64_t h = ut_rand(&g_rng);
+            int r = bloom_contains_hash(a, h);
+            CHECK_EQ(bloom_contains_hash_scalar(a, h), r);
+            CHECK_EQ(bloom_contains_hash(b, h), r);
+        }
+        bloom_free(a);
+        bloom_free(b);
+    }
+}
+
+static void test_cuckoo_params(void) {
+    size_t nbuckets;
+    unsigned fp_bits;
+    CHECK_EQ(cuckoo_filter_params(1000, 0.0, &nbuckets, &fp_bits), -1);
+    CHECK_EQ(cuckoo_filter_params(1000, 1e-12, &nbuckets, &fp_bits), -1);
+    CHECK(cuckoo_filter_create_buckets(16, 3) == NULL);
+    CHECK(cuckoo_filter_create_buckets(16, 33) == NULL);
+    CHECK_EQ(cuckoo_filter_params(1000000, 0.01, &nbuckets, &fp_bits), 0);
+    CHECK_EQ(fp_bits, 10);
+    CHECK_EQ(nbuckets, 263158);         // 1000000 / (4 * 0.95) 向上取整
+    CHECK_EQ(cuckoo_filter_params(10, 0.5, &nbuckets, &fp_bits), 0);
+    CHECK_EQ(fp_bits, 4);
+    CHECK_EQ(nbuckets, 3);
+    CHECK_EQ(cuckoo_filter_params(0, 0.5, &nbuckets, &fp_bits), 0);
+    CHECK_EQ(nbuckets, 2);
+
+    CuckooFilter* f = cuckoo_filter_create_buckets(5, 12);
+    CHECK_EQ(cuckoo_filter_capacity(f), 20);
+    CHECK_EQ(cuckoo_filter_memory(f), 30);
+    CHECK_EQ(cuckoo_filter_fp_bits(f), 12);
+    cuckoo_filter_free(f);
+    cuckoo_filter_free(NULL);
+}
+
+static void run_cuckoo(size_t n, double fpr) {
+    CuckooFilter* f = cuckoo_filter_create(n, fpr);
+    CHECK(f != NULL);
+    size_t failed = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        failed += cuckoo_filter_add_hash(f, key_hash(i, 1)) != 0;
+    }
+    CHECK_EQ(failed, 0);
+    CHECK_EQ(cuckoo_filter_count(f), n);
+    size_t missing = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        missing += !cuckoo_filter_contains_hash(f, key_hash(i, 1));
+    }
+    CHECK_EQ(missing, 0);
+
+    size_t trials = 1000000, positives = 0;
+    for (uint64_t i = 0; i < trials; i++) {
+        positives += cuckoo_filter_contains_hash(f, key_hash(i, 2));
+    }
+    // 目标很小时期望的假阳性只有几个，留出泊松波动的余量
+    CHECK((double)positives <= fpr * 1.2 * (double)trials + 5);
+
+    // 删除一半，另一半仍然存在
+    for (uint64_t i = 0; i < n; i += 2) {
+        CHECK_EQ(cuckoo_filter_remove_hash(f, key_hash(i, 1)), 0);
+    }
+    missing = 0;
+    for (uint64_t i = 1; i < n; i += 2) {
+        missing += !cuckoo_filter_contains_hash(f, key_hash(i, 1));
+    }
+    CHECK_EQ(missing, 0);
+    CHECK_EQ(cuckoo_filter_count(f), n / 2);
+    for (uint64_t i = 1; i < n; i += 2) {
+        CHECK_EQ(cuckoo_filter_remove_hash(f, key_hash(i, 1)), 0);
+    }
+    CHECK_EQ(cuckoo_filter_count(f), 0);
+    positives = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        positives += cuckoo_filter_contains_hash(f, key_hash(i, 1));
+    }
+    CHECK_EQ(positives, 0);
+    cuckoo_filter_free(f);
+}
+
+static void test_cuckoo(void) {
+    run_cuckoo(100000, 0.01);       // 10 位指纹
+    run_cuckoo(100000, 0.03);       // 8 位指纹
+    run_cuckoo(100000, 1e-6);       // 23 位指纹
+    run_cuckoo(100000, 2e-9);       // 32 位指纹
+    run_cuckoo(1000, 0.5);          // 4 位指纹
+
+    // 重复加入
+    CuckooFilter* f = cuckoo_filter_create(1000, 0.001);
+    const char* key = "duplicate";
+    for (int i = 0; i < 3; i++) {
+        CHECK_EQ(cuckoo_filter_add(f, key, strlen(key)), 0);
+    }
+    CHECK_EQ(cuckoo_filter_count(f), 3);
+    CHECK_EQ(cuckoo_filter_remove(f, key, strlen(key)), 0);
+    CHECK_EQ(cuckoo_filter_remove(f, key, strlen(key)), 0);
+    CHECK(cuckoo_filter_contains(f, key, strlen(key)));
+    CHECK_EQ(cuckoo_filter_remove(f, key, strlen(key)), 0);
+    CHECK(!cuckoo_filter_contains(f, key, strlen(key)));
+    CHECK_EQ(cuckoo_filter_remove(f, key, strlen(key)), -1);
+    cuckoo_filter_free(f);
+}
+
+// 填满：加入失败之前加入的键都还在（包括被挤到备用槽位的指纹）；删除一个后备用指纹放回表中，其余的键仍然都在
+static void test_cuckoo_full(void) {
+    CuckooFilter* f = cuckoo_filter_create_buckets(64, 16);
+    uint64_t added = 0;
+    while (cuckoo_filter_add_hash(f, key_hash(added, 3)) == 0) {
+        added++;
+        if (added > cuckoo_filter_capacity(f)) {
+            break;
+        }
+    }
+    CHECK(added <= cuckoo_filter_capacity(f));
+    CHECK((double)added >= 0.9 * (double)cuckoo_filter_capacity(f));
+    CHECK_EQ(cuckoo_filter_count(f), added);
+    size_t missing = 0;
+    for (uint64_t i = 0; i < added; i++) {
+        missing += !cuckoo_filter_contains_hash(f, key_hash(i, 3));
+    }
+    CHECK_EQ(missing, 0);
+    CHECK_EQ(cuckoo_filter_add_hash(f, key_hash(added + 1, 3)), -1);
+
+    CHECK_EQ(cuckoo_filter_remove_hash(f, key_hash(0, 3)), 0);
+    missing = 0;
+    for (uint64_t i = 1; i < added; i++) {
+        missing += !cuckoo_filter_contains_hash(f, key_hash(i, 3));
+    }
+    CHECK_EQ(missing, 0);
+    CHECK_EQ(cuckoo_filter_count(f), added - 1);
+    cuckoo_filter_free(f);
+}
+
+int main(void) {
+    test_bloom_params();
+    test_bloom();
+    test_bloom_scalar();
+    test_cuckoo_params();
+    test_cuckoo();
+    test_cuckoo_full();
+
+    return ut_report("filter_test");
+}
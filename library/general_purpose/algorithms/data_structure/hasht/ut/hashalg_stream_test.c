@@ -0,0 +1,175 @@
+#include "hashalg.h"
+#include "ut_check.h"
+#include "ut_util.h"
+#include <stdio.h>
+#include <string.h>
+
+/*
+ 流式接口测试：对每个长度、多组随机切分，流式结果必须与一次性版本逐位一致
+ 切分中包含长度为 0 的 update，以及与块边界（4/12/16 字节）错开的各种片段
+*/
+
+#define MAX_LEN   600
+#define SPLITS    24
+
+static uint64_t g_rng = 0x243f6a8885a308d3ULL;
+
+// 随机生成一组片段长度，和为 len；片段长度偏向小值，使片段经常跨越块边界
+static size_t make_chunks(size_t len, size_t* chunks, size_t max_chunks) {
+    size_t n = 0;
+    size_t left = len;
+    while (left > 0 && n + 1 < max_chunks) {
+        size_t r = ut_rand(&g_rng);
+        size_t c = (r & 3) == 0 ? r % (left + 1) : (r >> 8) % 20;
+        if (c > left) {
+            c = left;
+        }
+        chunks[n++] = c;
+        left -= c;
+    }
+    chunks[n++] = left;
+    return n;
+}
+
+static unsigned char g_data[MAX_LEN];
+
+static void test_murmur3_32(const size_t* chunks, size_t n, size_t len, uint32_t seed) {
+    Murmur3_32State st;
+    const unsigned char* p = g_data;
+    murmurHash3_32_init(&st, seed);
+    for (size_t i = 0; i < n; i++) {
+        murmurHash3_32_update(&st, p, chunks[i]);
+        p += chunks[i];
+    }
+    CHECK_EQ(murmurHash3_32_final(&st), murmurHash3_32(g_data, len, seed));
+}
+
+static void test_murmur3_128(const size_t* chunks, size_t n, size_t len, uint64_t seed) {
+    Murmur3_128State st;
+    uint64_t expect[2];
+    uint64_t out[2];
+    const unsigned char* p = g_data;
+    murmurHash3_x64_128_init(&st, seed);
+    for (size_t i = 0; i < n; i++) {
+        murmurHash3_x64_128_update(&st, p, chunks[i]);
+        p += chunks[i];
+    }
+    murmurHash3_x64_128_final(&st, out);
+    murmurHash3_x64_128(g_data, len, (uint32_t)seed, expect);
+    CHECK_EQ(out[0], expect[0]);
+    CHECK_EQ(out[1], expect[1]);
+    // 64 位种子：与 murmurHash3_x64_64 一致
+    murmurHash3_x64_128_init(&st, seed << 32 | seed);
+    murmurHash3_x64_128_update(&st, g_data, len);
+    murmurHash3_x64_128_final(&st, out);
+    CHECK_EQ(out[0], murmurHash3_x64_64(g_data, len, seed << 32 | seed));
+}
+
+static void test_fnv(const size_t* chunks, size_t n, size_t len, uint64_t seed) {
+    FnvState st;
+    Fnv64State st64;
+    const unsigned char* p = g_data;
+    fnvHash_init(&st, (uint32_t)seed);
+    fnvHash64_init(&st64, seed);
+    for (size_t i = 0; i < n; i++) {
+        fnvHash_update(&st, p, chunks[i]);
+        fnvHash64_update(&st64, p, chunks[i]);
+        p += chunks[i];
+    }
+    CHECK_EQ(fnvHash_final(&st), fnvHash(g_data, len, (uint32_t)seed));
+    CHECK_EQ(fnvHash64_final(&st64), fnvHash64(g_data, len, seed));
+}
+
+static void test_oat(const size_t* chunks, size_t n, size_t len, uint64_t seed) {
+    OatState st;
+    Oat64State st64;
+    const unsigned char* p = g_data;
+    oatHash_init(&st, (uint32_t)seed);
+    oatHash64_init(&st64, seed);
+    for (size_t i = 0; i < n; i++) {
+        oatHash_update(&st, p, chunks[i]);
+        oatHash64_update(&st64, p, chunks[i]);
+        p += chunks[i];
+    }
+    CHECK_EQ(oatHash_final(&st), oatHash(g_data, len, (uint32_t)seed));
+    CHECK_EQ(oatHash64_final(&st64), oatHash64(g_data, len, seed));
+}
+
+static void test_jenkins(const size_t* chunks, size_t n, size_t len, uint64_t seed) {
+    JenState st;
+    JenState st64;
+    const unsigned char* p = g_data;
+    jenHash_init(&st, len, (uint32_t)seed);
+    jenHash64_init(&st64, len, seed);
+    for (size_t i = 0; i < n; i++) {
+        jenHash_update(&st, p, chunks[i]);
+        jenHash_update(&st64, p, chunks[i]);
+        p += chunks[i];
+    }
+    CHECK_EQ(jenHash_final(&st), jenHash(g_data, len, (uint32_t)seed));
+    CHECK_EQ(jenHash64_final(&st64), jenHash64(g_data, len, seed));
+}
+
+// 固定切分：逐字节输入，以及在每个块边界附近一分为二
+static void test_fixed_splits(void) {
+    size_t chunks[MAX_LEN + 1];
+    for (size_t len = 0; len <= 64; len++) {
+        for (size_t i = 0; i < len; i++) {
+            chunks[i] = 1;
+        }
+        size_t n = len;
+        if (n == 0) {
+            chunks[n++] = 0;
+        }
+        test_murmur3_32(chunks, n, len, 1);
+        test_murmur3_128(chunks, n, len, 2);
+        test_fnv(chunks, n, len, 3);
+        test_oat(chunks, n, len, 4);
+        test_jenkins(chunks, n, len, 5);
+
+        for (size_t cut = 0; cut <= len; cut++) {
+            chunks[0] = cut;
+            chunks[1] = len - cut;
+            test_murmur3_32(chunks, 2, len, 0);
+            test_murmur3_128(chunks, 2, len, 0);
+            test_jenkins(chunks, 2, len, 0);
+        }
+    }
+}
+
+static void test_random_splits(void) {
+    size_t chunks[MAX_LEN + 1];
+    for (size_t len = 0; len < MAX_LEN; len += 1 + len / 16) {
+        for (int s = 0; s < SPLITS; s++) {
+            size_t n = make_chunks(len, chunks, MAX_LEN + 1);
+            uint64_t seed = ut_rand(&g_rng);
+            test_murmur3_32(chunks, n, len, (uint32_t)seed);
+            test_murmur3_128(chunks, n, len, (uint32_t)seed);
+            test_fnv(chunks, n, len, seed);
+            test_oat(chunks, n, len, seed);
+            test_jenkins(chunks, n, len, seed);
+        }
+    }
+}
+
+// final 不修改状态：中途取结果后继续输入，最终结果不变
+static void test_final_is_pure(void) {
+    Murmur3_32State st;
+    murmurHash3_32_init(&st, 9);
+    murmurHash3_32_update(&st, g_data, 7);
+    CHECK_EQ(murmurHash3_32_final(&st), murmurHash3_32(g_data, 7, 9));
+    murmurHash3_32_update(&st, g_data + 7, 30);
+    CHECK_EQ(murmurHash3_32_final(&st), murmurHash3_32(g_data, 37, 9));
+}
+
+int main(void) {
+    for (size_t i = 0; i < MAX_LEN; i++) {
+        g_data[i] = (unsigned char)ut_rand(&g_rng);
+    }
+
+    test_fixed_splits();
+    test_random_splits();
+    test_final_is_pure();
+
+    return ut_report("hashalg_stream_test");
+}
@@ -0,0 +1,192 @@
+#include "hashalg.h"
+#include "ut_check.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* FOX = "The quick brown fox jumps over the lazy dog";
+
+// 参考向量：MurmurHash3 取自参考实现（mmh3），lookup3 取自 lookup3.c 自带的 driver，FNV 取自官方测试集
+static void test_vectors(void) {
+    CHECK_EQ(murmurHash3_32("", 0, 0), 0);
+    CHECK_EQ(murmurHash3_32("", 0, 1), 0x514e28b7);
+    CHECK_EQ(murmurHash3_32("hello", 5, 0), 0x248bfa47);
+    CHECK_EQ(murmurHash3_32("hello", 5, 42), 0xe2dbd2e1);
+    CHECK_EQ(murmurHash3_32("abc", 3, 0x9747b28c), 0xc84a62dd);
+    CHECK_EQ(murmurHash3_32(FOX, strlen(FOX), 0), 0x2e4ff723);
+
+    CHECK_EQ(murmurHash64A("", 0, 0), 0);
+    CHECK_EQ(murmurHash64A("hello", 5, 0), 0x1e68d17c457bf117ULL);
+    CHECK_EQ(murmurHash64A(FOX, strlen(FOX), 0x1234), 0xf38241f13ae451dfULL);
+
+    CHECK_EQ(jenHash("", 0, 0), 0xdeadbeef);
+    CHECK_EQ(jenHash("Four score and seven years ago", 30, 0), 0x17770551);
+    CHECK_EQ(jenHash("Four score and seven years ago", 30, 1), 0xcd628161);
+    // hashlittle2 的 pc 输出与相同种子的 hashlittle 一致
+    CHECK_EQ((uint32_t)jenHash64("Four score and seven years ago", 30, 0), 0x17770551);
+    CHECK_EQ(jenHash64("", 0, 0), 0xdeadbeefdeadbeefULL);
+
+    CHECK_EQ(fnvHash("a", 1, 0), 0xe40c292c);
+    CHECK_EQ(fnvHash("foobar", 6, 0), 0xbf9cf968);
+    CHECK_EQ(fnvHash64("a", 1, 0), 0xaf63dc4c8601ec8cULL);
+    CHECK_EQ(fnvHash64("foobar", 6, 0), 0x85944171f73967e8ULL);
+
+    // times33 种子为 5381 时即 DJB2
+    CHECK_EQ(times33Hash("a", 1, 5381), 177670);
+    CHECK_EQ(times33Hash64("a", 1, 5381), 177670);
+}
+
+// 测试数据：data[i] = i * 131 + 7
+static void fill_pattern(unsigned char* buf, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (unsigned char)(i * 131 + 7);
+    }
+}
+
+// 宽输出哈希：MurmurHash3 x64_128 取自 mmh3.hash64，xxHash64 取自参考实现（python xxhash）
+static void test_wide_vectors(void) {
+    unsigned char data[200];
+    uint64_t out[2];
+    fill_pattern(data, sizeof(data));
+
+    murmurHash3_x64_128("", 0, 0, out);
+    CHECK_EQ(out[0], 0);
+    CHECK_EQ(out[1], 0);
+    murmurHash3_x64_128("hello", 5, 0, out);
+    CHECK_EQ(out[0], 0xcbd8a7b341bd9b02ULL);
+    CHECK_EQ(out[1], 0x5b1e906a48ae1d19ULL);
+    murmurHash3_x64_128(FOX, strlen(FOX), 0, out);
+    CHECK_EQ(out[0], 0xe34bbc7bbc071b6cULL);
+    CHECK_EQ(out[1], 0x7a433ca9c49a9347ULL);
+    murmurHash3_x64_128(FOX, strlen(FOX), 0x9747b28c, out);
+    CHECK_EQ(out[0], 0x738a7f3bd2633121ULL);
+    CHECK_EQ(out[1], 0xf94573727ec016e5ULL);
+    murmurHash3_x64_128(data, 200, 0, out);
+    CHECK_EQ(out[0], 0x3b0b8bb9afad568eULL);
+    CHECK_EQ(out[1], 0xb9cbe5de25017675ULL);
+    murmurHash3_x64_128(data, 31, 123, out);
+    CHECK_EQ(out[0], 0xd09602ae3a117320ULL);
+    CHECK_EQ(out[1], 0x4fdf73f67dfb5008ULL);
+    CHECK_EQ(murmurHash3_x64_64(data, 31, 123), 0xd09602ae3a117320ULL);
+
+    const char* spam = "Nobody inspects the spammish repetition";
+    CHECK_EQ(xxHash64("", 0, 0), 0xef46db3751d8e999ULL);
+    CHECK_EQ(xxHash64("a", 1, 0), 0xd24ec4f1a98c6e5bULL);
+    CHECK_EQ(xxHash64("abc", 3, 0), 0x44bc2cf5ad770999ULL);
+    CHECK_EQ(xxHash64(spam, strlen(spam), 0), 0xfbcea83c8a378bf1ULL);
+    CHECK_EQ(xxHash64(data, 100, 0), 0x9ddada11d3dc2d8fULL);
+    CHECK_EQ(xxHash64(data, 200, 0x9e3779b97f4a7c15ULL), 0xcd5273f408a4cfbcULL);
+}
+
+// AVX2 版本必须与标量版本逐位一致（CPU 不支持 AVX2 时两者是同一实现）
+static void test_xxh64_avx2(void) {
+    unsigned char data[1100];
+    fill_pattern(data, sizeof(data));
+    for (size_t len = 0; len <= 1024; len++) {
+        uint64_t seed = len * 0x9e3779b97f4a7c15ULL;
+        CHECK_EQ(xxHash64_avx2(data + (len & 7), len, seed), xxHash64_scalar(data + (len & 7), len, seed));
+        CHECK_EQ(xxHash64(data, len, seed), xxHash64_scalar(data, len, seed));
+    }
+}
+
+// 批量接口必须与逐个调用单键版本一致：变长键覆盖组内长度不同、跨 32 字节的情况，定长键覆盖所有键长与 stride
+static void test_batch(void) {
+    enum { N = 37 };                      // 不是 8 的倍数，覆盖剩余的键
+    unsigned char data[N * 80 + 8];
+    const void* keys[N];
+    size_t lens[N];
+    uint32_t out32[N];
+    uint64_t out64[N];
+    fill_pattern(data, sizeof(data));
+
+    for (size_t base_len = 0; base_len <= 40; base_len++) {
+        for (size_t i = 0; i < N; i++) {
+            keys[i] = data + i * 79;
+            lens[i] = base_len + (base_len % 3 == 0 ? 0 : i % 5);
+        }
+        murmurHash3_32_batch(keys, lens, N, 0x5eed, out32);
+        xxHash64_batch(keys, lens, N, 0x5eed, out64);
+        for (size_t i = 0; i < N; i++) {
+            CHECK_EQ(out32[i], murmurHash3_32(keys[i], lens[i], 0x5eed));
+            CHECK_EQ(out64[i], xxHash64(keys[i], lens[i], 0x5eed));
+        }
+    }
+
+    for (size_t key_len = 0; key_len <= 70; key_len++) {
+        // stride 为 1 时相邻键重叠（滑动窗口）
+        size_t strides[3] = { 1, key_len, key_len + 5 };
+        for (int s = 0; s < 3; s++) {
+            size_t stride = strides[s];
+            // 从奇数地址开始，gather 读取未对齐的键
+            const unsigned char* base = data + 1;
+            murmurHash3_32_batch_fixed(base, stride, key_len, N, 77, out32);
+            for (size_t i = 0; i < N; i++) {
+                CHECK_EQ(out32[i], murmurHash3_32(base + i * stride, key_len, 77));
+            }
+            murmurHash3_32_batch_fixed_scalar(base, stride, key_len, N, 77, out32);
+            for (size_t i = 0; i < N; i++) {
+                CHECK_EQ(out32[i], murmurHash3_32(base + i * stride, key_len, 77));
+            }
+        }
+    }
+}
+
+// 同一数据放在不同对齐的地址上，结果必须相同；覆盖所有尾部长度
+static void test_unaligned(void) {
+    unsigned char src[80];
+    unsigned char buf[96];
+    fill_pattern(src, sizeof(src));
+    for (int a = 0; a < HASH_ALG_COUNT; a++) {
+        const HashAlgInfo* info = hash_alg_get((HashAlg)a);
+        for (size_t len = 0; len <= 64; len++) {
+            uint32_t h32 = info->hash32(src, len, 0x1234);
+            uint64_t h64 = info->hash64(src, len, 0x123456789ULL);
+            for (size_t off = 1; off < 8; off++) {
+                memcpy(buf + off, src, len);
+                CHECK_EQ(info->hash32(buf + off, len, 0x1234), h32);
+                CHECK_EQ(info->hash64(buf + off, len, 0x123456789ULL), h64);
+            }
+        }
+    }
+}
+
+// 种子必须参与计算；对于按字节累加的算法，不同种子同一输入结果不同
+static void test_seed(void) {
+    for (int a = 0; a < HASH_ALG_COUNT; a++) {
+        const HashAlgInfo* info = hash_alg_get((HashAlg)a);
+        CHECK(info->hash32(FOX, strlen(FOX), 1) != info->hash32(FOX, strlen(FOX), 2));
+        CHECK(info->hash64(FOX, strlen(FOX), 1) != info->hash64(FOX, strlen(FOX), 2));
+        // 64 位种子的高位也要参与计算
+        CHECK(info->hash64(FOX, strlen(FOX), 1) != info->hash64(FOX, strlen(FOX), 1 | (1ULL << 40)));
+    }
+}
+
+static void test_registry(void) {
+    for (int a = 0; a < HASH_ALG_COUNT; a++) {
+        const HashAlgInfo* info = hash_alg_get((HashAlg)a);
+        CHECK(info != NULL);
+        CHECK_EQ(info->alg, a);
+        CHECK(hash_alg_find(info->name) == info);
+        CHECK_EQ(hash_alg32((HashAlg)a, "key", 3, 7), info->hash32("key", 3, 7));
+        CHECK_EQ(hash_alg64((HashAlg)a, "key", 3, 7), info->hash64("key", 3, 7));
+    }
+    CHECK(hash_alg_get(HASH_ALG_COUNT) == NULL);
+    CHECK(hash_alg_find("md5") == NULL);
+    CHECK(hash_alg_find(NULL) == NULL);
+    CHECK_EQ(hash_alg32(HASH_ALG_COUNT, "hello", 5, 0), 0x248bfa47);
+    // "murmur" 的两个宽度都是 MurmurHash3，MurmurHash2-64A 单独一项
+    CHECK_EQ(hash_alg64(HASH_ALG_MURMUR, FOX, strlen(FOX), 7), murmurHash3_x64_64(FOX, strlen(FOX), 7));
+    CHECK_EQ(hash_alg64(HASH_ALG_MURMUR64A, FOX, strlen(FOX), 7), murmurHash64A(FOX, strlen(FOX), 7));
+    CHECK(hash_alg_find("murmur64a") == hash_alg_get(HASH_ALG_MURMUR64A));
+}
+
+int main(void) {
+    test_vectors();
+    test_wide_vectors();
+    test_xxh64_avx2();
+    test_batch();
+    test_unaligned();
+    test_seed();
+    test_registry();
+
+    return ut_report("hashalg_test");
+}
@@ -0,0 +1,373 @@
+#include "hasht.h"
+#include "ut_check.h"
+#include "ut_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ 开放寻址哈希表测试：基本增删改查、与参考实现对比的随机操作（含强制冲突的哈希函数与高负载因子），
+ 墓碑只在组已满时产生、字符串指针键、集合用法、遍历、预留容量与清空、渐进式扩容
+*/
+
+static uint64_t g_rng = 0x853c49e6748fea9bULL;
+
+static HashT* make_table(hash64_fn hash, double max_load, size_t initial, size_t incremental_step) {
+    HashTConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.key_size = sizeof(uint64_t);
+    cfg.value_size = sizeof(uint64_t);
+    cfg.hash = hash;
+    cfg.max_load = max_load;
+    cfg.initial_capacity = initial;
+    cfg.incremental_step = incremental_step;
+    return hasht_create(&cfg);
+}
+
+static HashT* make_u64_table(hash64_fn hash, double max_load, size_t initial) {
+    return make_table(hash, max_load, initial, 0);
+}
+
+static void test_basic(void) {
+    HashTConfig bad;
+    memset(&bad, 0, sizeof(bad));
+    CHECK(hasht_create(&bad) == NULL);                  // key_size 为 0
+    bad.key_size = 8;
+    bad.max_load = 1.0;
+    CHECK(hasht_create(&bad) == NULL);
+    CHECK(hasht_create(NULL) == NULL);
+
+    HashT* t = make_u64_table(NULL, 0, 0);
+    CHECK(t != NULL);
+    CHECK_EQ(hasht_capacity(t), 16);
+    for (uint64_t k = 0; k < 1000; k++) {
+        uint64_t v = k * 3;
+        CHECK_EQ(hasht_put(t, &k, &v), 1);
+    }
+    CHECK_EQ(hasht_size(t), 1000);
+    CHECK(hasht_capacity(t) * HASHT_DEFAULT_MAX_LOAD >= 1000);
+    for (uint64_t k = 0; k < 1000; k++) {
+        uint64_t* v = (uint64_t*)hasht_get(t, &k);
+        CHECK(v != NULL && *v == k * 3);
+    }
+    uint64_t k = 5000, v = 1;
+    CHECK(hasht_get(t, &k) == NULL);
+
+    // 更新
+    k = 7;
+    v = 700;
+    CHECK_EQ(hasht_put(t, &k, &v), 0);
+    CHECK_EQ(*(uint64_t*)hasht_get(t, &k), 700);
+    CHECK_EQ(hasht_size(t), 1000);
+
+    // upsert 原地计数
+    int inserted = -1;
+    uint64_t* cnt = (uint64_t*)hasht_upsert(t, &k, &inserted);
+    CHECK_EQ(inserted, 0);
+    (*cnt)++;
+    CHECK_EQ(*(uint64_t*)hasht_get(t, &k), 701);
+    k = 123456;
+    cnt = (uint64_t*)hasht_upsert(t, &k, &inserted);
+    CHECK_EQ(inserted, 1);
+    CHECK_EQ(*cnt, 0);                                  // 新插入的值清零
+
+    // 删除
+    uint64_t out = 0;
+    k = 7;
+    CHECK_EQ(hasht_remove(t, &k, &out), 0);
+    CHECK_EQ(out, 701);
+    CHECK_EQ(hasht_remove(t, &k, NULL), -1);
+    CHECK(hasht_get(t, &k) == NULL);
+    CHECK_EQ(hasht_size(t), 1000);
+
+    hasht_clear(t);
+    CHECK_EQ(hasht_size(t), 0);
+    k = 1;
+    CHECK(hasht_get(t, &k) == NULL);
+    hasht_free(t);
+    hasht_free(NULL);
+}
+
+// 与参考数组对比的随机操作
+static void run_random_ops(hash64_fn hash, double max_load, int ops, uint64_t key_range, size_t incremental_step) {
+    HashT* t = make_table(hash, max_load, 0, incremental_step);
+    uint8_t* present = (uint8_t*)calloc(key_range, 1);
+    uint64_t* values = (uint64_t*)calloc(key_range, sizeof(uint64_t));
+    size_t size = 0;
+    for (int op = 0; op < ops; op++) {
+        uint64_t k = ut_rand(&g_rng) % key_range;
+        uint64_t r = ut_rand(&g_rng) % 10;
+        if (r < 5) {
+            uint64_t v = ut_rand(&g_rng);
+            int res = hasht_put(t, &k, &v);
+            CHECK_EQ(res, present[k] ? 0 : 1);
+            size += !present[k];
+            present[k] = 1;
+            values[k] = v;
+        } else if (r < 8) {
+            uint64_t out = 0;
+            int res = hasht_remove(t, &k, &out);
+            CHECK_EQ(res, present[k] ? 0 : -1);
+            if (present[k]) {
+                CHECK_EQ(out, values[k]);
+                size--;
+            }
+            present[k] = 0;
+        } else {
+            uint64_t* v = (uint64_t*)hasht_get(t, &k);
+            CHECK_EQ(v != NULL, present[k]);
+            if (v != NULL) {
+                CHECK_EQ(*v, values[k]);
+            }
+        }
+        CHECK_EQ(hasht_size(t), size);
+    }
+    // 最后全部核对一遍，并检查遍历恰好访问每个元素一次
+    size_t iter = 0, visited = 0;
+    const void* key;
+    void* value;
+    while (hasht_next(t, &iter, &key, &value)) {
+        uint64_t k;
+        memcpy(&k, key, sizeof(k));
+        CHECK(k < key_range && present[k]);
+        CHECK_EQ(*(uint64_t*)value, values[k]);
+        visited++;
+    }
+    CHECK_EQ(visited, size);
+    CHECK(hasht_size(t) + hasht_tombstones(t) < hasht_capacity(t) || hasht_rehash_step(t, 0));
+    free(present);
+    free(values);
+    hasht_free(t);
+}
+
+static void test_random(void) {
+    run_random_ops(NULL, 0, 200000, 5000, 0);
+    run_random_ops(NULL, 0.95, 200000, 20000, 0);
+    run_random_ops(NULL, 0.5, 100000, 1000, 0);
+    run_random_ops(ut_weak_hash, 0.9, 50000, 600, 0);
+
+    // 渐进式扩容：迁移与增删查交错进行
+    run_random_ops(NULL, 0, 200000, 20000, 1);
+    run_random_ops(NULL, 0.95, 200000, 20000, 2);
+    run_random_ops(NULL, 0.05, 50000, 2000, 1);          // 负载因子很小：每次迁移的组数自动提高
+    run_random_ops(ut_weak_hash, 0.9, 50000, 600, 1);
+    run_random_ops(ut_const_hash, 0, 20000, 100, 1);        // 反复的原容量重建
+}
+
+static void test_tombstones(void) {
+    // 组内有空槽位时删除不留墓碑
+    HashT* t = make_u64_table(NULL, 0, 1000);
+    for (uint64_t k = 0; k < 100; k++) {
+        hasht_put(t, &k, &k);
+    }
+    for (uint64_t k = 0; k < 100; k++) {
+        CHECK_EQ(hasht_remove(t, &k, NULL), 0);
+    }
+    CHECK_EQ(hasht_tombstones(t), 0);
+    hasht_free(t);
+
+    // 所有键哈希相同：前 16 个填满第 0 组，后面的键探测到下一组；删除第 0 组的键只能留墓碑
+    t = make_u64_table(ut_const_hash, 0, 100);
+    for (uint64_t k = 0; k < 20; k++) {
+        hasht_put(t, &k, &k);
+    }
+    uint64_t k = 3;
+    CHECK_EQ(hasht_remove(t, &k, NULL), 0);
+    CHECK_EQ(hasht_tombstones(t), 1);
+    for (uint64_t j = 0; j < 20; j++) {
+        CHECK_EQ(hasht_get(t, &j) != NULL, j != 3);     // 墓碑之后的键仍然能找到
+    }
+    // 第 1 组未满，删除不留墓碑
+    k = 19;
+    CHECK_EQ(hasht_remove(t, &k, NULL), 0);
+    CHECK_EQ(hasht_tombstones(t), 1);
+    // 新插入复用墓碑
+    k = 100;
+    hasht_put(t, &k, &k);
+    CHECK_EQ(hasht_tombstones(t), 0);
+    hasht_free(t);
+
+    // 反复插入删除不同的键：墓碑触发原容量重建，容量不会无限增长
+    t = make_u64_table(ut_const_hash, 0, 0);
+    for (uint64_t j = 0; j < 5000; j++) {
+        hasht_put(t, &j, &j);
+        if (j >= 20) {
+            uint64_t old = j - 20;
+            hasht_remove(t, &old, NULL);
+        }
+    }
+    CHECK_EQ(hasht_size(t), 20);
+    CHECK(hasht_capacity(t) <= 64);
+    hasht_free(t);
+}
+
+static uint64_t str_hash(const void* key, size_t len, uint64_t seed) {
+    const char* s;
+    (void)len;
+    memcpy(&s, key, sizeof(s));
+    return xxHash64(s, strlen(s), seed);
+}
+
+static int str_eq(const void* a, const void* b, size_t len) {
+    const char* x;
+    const char* y;
+    (void)len;
+    memcpy(&x, a, sizeof(x));
+    memcpy(&y, b, sizeof(y));
+    return strcmp(x, y);
+}
+
+static void test_string_keys_and_set(void) {
+    HashTConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.key_size = sizeof(const char*);
+    cfg.value_size = sizeof(int);
+    cfg.hash = str_hash;
+    cfg.eq = str_eq;
+    HashT* t = hasht_create(&cfg);
+    static const char* words[] = { "apple", "banana", "cherry", "date", "elder" };
+    for (int i = 0; i < 5; i++) {
+        hasht_put(t, &words[i], &i);
+    }
+    char buf[16];
+    strcpy(buf, "cherry");                               // 内容相同、地址不同的键
+    const char* probe = buf;
+    int* v = (int*)hasht_get(t, &probe);
+    CHECK(v != NULL && *v == 2);
+    probe = "fig";
+    CHECK(hasht_get(t, &probe) == NULL);
+    hasht_free(t);
+
+    // value_size 为 0：集合，返回键的地址；3 字节的键
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.key_size = 3;
+    t = hasht_create(&cfg);
+    CHECK(hasht_put(t, "abc", NULL) == 1);
+    CHECK(hasht_put(t, "abc", NULL) == 0);
+    CHECK(hasht_put(t, "abd", NULL) == 1);
+    CHECK(memcmp(hasht_get(t, "abd"), "abd", 3) == 0);
+    CHECK(hasht_get(t, "abe") == NULL);
+    CHECK_EQ(hasht_size(t), 2);
+    hasht_free(t);
+
+    // 值的对齐：1 字节键 + 8 字节值
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.key_size = 1;
+    cfg.value_size = 8;
+    t = hasht_create(&cfg);
+    for (int i = 0; i < 200; i++) {
+        uint8_t key = (uint8_t)i;
+        uint64_t* slot = (uint64_t*)hasht_upsert(t, &key, NULL);
+        CHECK(((uintptr_t)slot & 7) == 0);
+        *slot = (uint64_t)i << 40;
+    }
+    for (int i = 0; i < 200; i++) {
+        uint8_t key = (uint8_t)i;
+        CHECK_EQ(*(uint64_t*)hasht_get(t, &key), (uint64_t)i << 40);
+    }
+    hasht_free(t);
+}
+
+static void test_reserve(void) {
+    HashT* t = make_u64_table(NULL, 0.5, 0);
+    CHECK_EQ(hasht_reserve(t, 10000), 0);
+    size_t cap = hasht_capacity(t);
+    CHECK(cap >= 20000);
+    for (uint64_t k = 0; k < 10000; k++) {
+        hasht_put(t, &k, &k);
+    }
+    CHECK_EQ(hasht_capacity(t), cap);                   // 预留后插入不扩容
+    CHECK_EQ(hasht_reserve(t, 10), 0);                  // 不缩小
+    CHECK_EQ(hasht_capacity(t), cap);
+    CHECK_EQ(hasht_memory(t), cap * (1 + 16));
+    hasht_free(t);
+}
+
+static void test_incremental(void) {
+    HashT* t = make_table(NULL, 0, 0, 1);
+    size_t cap = hasht_capacity(t);
+    uint64_t k = 0;
+    // 插满第一个数组：下一次插入开始迁移，此时新旧数组同时存在
+    while (hasht_capacity(t) == cap) {
+        hasht_put(t, &k, &k);
+        k++;
+    }
+    CHECK_EQ(hasht_capacity(t), cap * 2);
+    CHECK_EQ(hasht_rehash_step(t, 0), 1);
+    CHECK_EQ(hasht_memory(t), (cap + cap * 2) * (1 + 16));
+
+    // 迁移期间：查找、更新、删除旧数组中的键，遍历同时覆盖两个数组
+    uint64_t v = 1000;
+    CHECK_EQ(*(uint64_t*)hasht_get(t, &(uint64_t){ 3 }), 3);
+    CHECK_EQ(hasht_put(t, &(uint64_t){ 3 }, &v), 0);
+    CHECK_EQ(*(uint64_t*)hasht_get(t, &(uint64_t){ 3 }), 1000);
+    CHECK_EQ(hasht_remove(t, &(uint64_t){ 5 }, &v), 0);
+    CHECK_EQ(v, 5);
+    CHECK(hasht_get(t, &(uint64_t){ 5 }) == NULL);
+    size_t iter = 0, visited = 0;
+    while (hasht_next(t, &iter, NULL, NULL)) {
+        visited++;
+    }
+    CHECK_EQ(visited, hasht_size(t));
+
+    // 每次写操作迁移一组：旧数组只有一组，上面的写操作已经迁移完
+    CHECK_EQ(hasht_rehash_step(t, 0), 0);
+    CHECK_EQ(hasht_memory(t), cap * 2 * (1 + 16));
+    for (uint64_t j = 0; j < k; j++) {
+        CHECK_EQ(hasht_get(t, &j) != NULL, j != 5);
+    }
+    hasht_free(t);
+
+    // 大表：每次写操作迁移一组，单次插入最多搬移 16 个元素；迁移期间 hasht_rehash_step 可以提前完成
+    t = make_table(NULL, 0, 0, 1);
+    for (k = 0; k < 100000; k++) {
+        hasht_put(t, &k, &k);
+    }
+    cap = hasht_capacity(t);
+    while (hasht_capacity(t) == cap) {
+        hasht_put(t, &k, &k);
+        k++;
+    }
+    CHECK_EQ(hasht_rehash_step(t, 10), 1);
+    CHECK_EQ(hasht_rehash_step(t, (size_t)-1), 0);
+    for (uint64_t j = 0; j < k; j++) {
+        uint64_t* p = (uint64_t*)hasht_get(t, &j);
+        CHECK(p != NULL && *p == j);
+    }
+
+    // 迁移期间预留、清空
+    cap = hasht_capacity(t);
+    while (hasht_capacity(t) == cap) {
+        hasht_put(t, &k, &k);
+        k++;
+    }
+    CHECK_EQ(hasht_reserve(t, k * 4), 0);
+    CHECK_EQ(hasht_rehash_step(t, 0), 0);
+    CHECK_EQ(hasht_size(t), k);
+    for (uint64_t j = 0; j < k; j++) {
+        CHECK(hasht_get(t, &j) != NULL);
+    }
+    hasht_clear(t);
+    CHECK_EQ(hasht_size(t), 0);
+    CHECK(hasht_get(t, &(uint64_t){ 1 }) == NULL);
+    hasht_free(t);
+
+    // 迁移中途销毁不泄漏（配合 -fsanitize=address 检查）
+    t = make_table(NULL, 0, 0, 1);
+    for (k = 0; k < 15; k++) {                          // 第 15 个元素触发扩容
+        hasht_put(t, &k, &k);
+    }
+    CHECK_EQ(hasht_rehash_step(t, 0), 1);
+    hasht_free(t);
+}
+
+int main(void) {
+    test_basic();
+    test_random();
+    test_tombstones();
+    test_string_keys_and_set();
+    test_reserve();
+    test_incremental();
+
+    return ut_report("hasht_test");
+}
@@ -0,0 +1,221 @@
+#include "hashtfile.h"
+#include "ut_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*
+ 只读哈希表文件测试：构建、写入、打开后逐个查找（含变长键、空值、重复加入以最后一次为准、不存在的键），
+ 空表、遍历、值的对齐、重新写入后旧映射不受影响，子进程打开同一个文件，
+ 文件头损坏、被截断、不存在时打开失败
+*/
+
+static char g_path[256];
+
+static void make_key(char* buf, size_t* len, uint64_t i) {
+    // 长度 1 ~ 40 不等
+    *len = (size_t)snprintf(buf, 64, "k%llu", (unsigned long long)i);
+    size_t extra = (size_t)(i % 30);
+    memset(buf + *len, 'x', extra);
+    *len += extra;
+}
+
+static HashTFileBuilder* build(uint64_t n) {
+    HashTFileBuilder* b = hashtfile_builder_create(0x1234, n);
+    char key[64];
+    size_t len;
+    for (uint64_t i = 0; i < n; i++) {
+        make_key(key, &len, i);
+        uint64_t v = i * 7;
+        // i % 5 == 0 的键没有值
+        CHECK_EQ(hashtfile_builder_add(b, key, len, &v, i % 5 == 0 ? 0 : sizeof(v)), 1);
+    }
+    return b;
+}
+
+static void check_contents(const HashTFile* f, uint64_t n, uint64_t delta) {
+    char key[64];
+    size_t len;
+    size_t missing = 0, wrong = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        make_key(key, &len, i);
+        size_t vlen = 99;
+        const void* v = hashtfile_get(f, key, len, &vlen);
+        if (v == NULL) {
+            missing++;
+            continue;
+        }
+        if (((uintptr_t)v & 7) != 0) {
+            wrong++;
+        }
+        if (i % 5 == 0) {
+            wrong += vlen != 0;
+        } else {
+            uint64_t x;
+            memcpy(&x, v, sizeof(x));
+            wrong += vlen != sizeof(x) || x != i * 7 + delta;
+        }
+    }
+    CHECK_EQ(missing, 0);
+    CHECK_EQ(wrong, 0);
+}
+
+static void test_roundtrip(void) {
+    const uint64_t n = 100000;
+    HashTFileBuilder* b = build(n);
+    // 重复加入：值以最后一次为准，键数不变
+    char key[64];
+    size_t len;
+    for (uint64_t i = 1; i < n; i += 3) {
+        if (i % 5 == 0) {
+            continue;
+        }
+        make_key(key, &len, i);
+        uint64_t v = i * 7;
+        uint64_t old = 0;
+        CHECK_EQ(hashtfile_builder_add(b, key, len, &old, sizeof(old)), 0);
+        CHECK_EQ(hashtfile_builder_add(b, key, len, &v, sizeof(v)), 0);
+    }
+    CHECK_EQ(hashtfile_builder_size(b), n);
+    CHECK_EQ(hashtfile_builder_write(b, g_path), 0);
+    hashtfile_builder_free(b);
+
+    HashTFile* f = hashtfile_open(g_path);
+    CHECK(f != NULL);
+    CHECK_EQ(hashtfile_size(f), n);
+    CHECK(hashtfile_capacity(f) % 16 == 0);
+    CHECK((double)n / (double)hashtfile_capacity(f) > 0.8);
+    CHECK_EQ(hashtfile_prefetch(f), 0);
+    check_contents(f, n, 0);
+
+    // 不存在的键：前缀相同、长度不同、空键
+    size_t found = 0;
+    for (uint64_t i = n; i < 2 * n; i++) {
+        make_key(key, &len, i);
+        found += hashtfile_get(f, key, len, NULL) != NULL;
+    }
+    make_key(key, &len, 7);
+    found += hashtfile_get(f, key, len - 1, NULL) != NULL;
+    found += hashtfile_get(f, "", 0, NULL) != NULL;
+    CHECK_EQ(found, 0);
+
+    // 遍历：每个键恰好出现一次
+    unsigned char* seen = (unsigned char*)calloc(n, 1);
+    size_t iter = 0, count = 0, bad = 0;
+    const void *k, *v;
+    size_t klen, vlen;
+    while (hashtfile_next(f, &iter, &k, &klen, &v, &vlen)) {
+        char buf[64];
+        memcpy(buf, k, klen);
+        buf[klen] = '\0';
+        uint64_t i = strtoull(buf + 1, NULL, 10);
+        if (i >= n || seen[i]) {
+            bad++;
+            continue;
+        }
+        seen[i] = 1;
+        count++;
+    }
+    CHECK_EQ(count, n);
+    CHECK_EQ(bad, 0);
+    free(seen);
+
+    // 重新写入同一个路径（rename 替换）：已打开的映射仍是旧内容，重新打开看到新内容
+    b = hashtfile_builder_create(0x1234, 0);
+    uint64_t one = 1;
+    hashtfile_builder_add(b, "new", 3, &one, sizeof(one));
+    CHECK_EQ(hashtfile_builder_write(b, g_path), 0);
+    hashtfile_builder_free(b);
+    check_contents(f, 1000, 0);
+    CHECK(hashtfile_get(f, "new", 3, NULL) == NULL);
+    HashTFile* g = hashtfile_open(g_path);
+    CHECK(g != NULL);
+    CHECK_EQ(hashtfile_size(g), 1);
+    CHECK(hashtfile_get(g, "new", 3, &vlen) != NULL);
+    CHECK_EQ(vlen, sizeof(one));
+    hashtfile_close(g);
+    hashtfile_close(f);
+    hashtfile_close(NULL);
+}
+
+static void test_empty(void) {
+    HashTFileBuilder* b = hashtfile_builder_create(0, 0);
+    CHECK_EQ(hashtfile_builder_write(b, g_path), 0);
+    hashtfile_builder_free(b);
+    HashTFile* f = hashtfile_open(g_path);
+    CHECK(f != NULL);
+    CHECK_EQ(hashtfile_size(f), 0);
+    CHECK_EQ(hashtfile_capacity(f), 16);
+    CHECK(hashtfile_get(f, "a", 1, NULL) == NULL);
+    size_t iter = 0;
+    CHECK_EQ(hashtfile_next(f, &iter, NULL, NULL, NULL, NULL), 0);
+    hashtfile_close(f);
+    hashtfile_builder_free(NULL);
+}
+
+// 子进程映射同一个文件查找，与父进程共用页缓存
+static void test_fork(void) {
+    HashTFileBuilder* b = build(5000);
+    CHECK_EQ(hashtfile_builder_write(b, g_path), 0);
+    hashtfile_builder_free(b);
+    pid_t pid = fork();
+    if (pid == 0) {
+        HashTFile* f = hashtfile_open(g_path);
+        check_contents(f, 5000, 0);
+        hashtfile_close(f);
+        _exit(g_failures == 0 ? 0 : 1);
+    }
+    int status = 0;
+    CHECK_EQ(waitpid(pid, &status, 0), pid);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+static void rewrite_byte(long off, int delta) {
+    FILE* fp = fopen(g_path, "r+b");
+    fseek(fp, off, SEEK_SET);
+    int c = fgetc(fp);
+    fseek(fp, off, SEEK_SET);
+    fputc(c + delta, fp);
+    fclose(fp);
+}
+
+static void test_corrupt(void) {
+    CHECK(hashtfile_open("/nonexistent/hashtfile") == NULL);
+
+    HashTFileBuilder* b = build(1000);
+    CHECK_EQ(hashtfile_builder_write(b, g_path), 0);
+    // 文件头任一字节被改动：crc 不符
+    for (long off = 0; off < 64; off += 7) {
+        rewrite_byte(off, 1);
+        CHECK(hashtfile_open(g_path) == NULL);
+        rewrite_byte(off, -1);
+    }
+    HashTFile* f = hashtfile_open(g_path);
+    CHECK(f != NULL);
+    size_t bytes = hashtfile_bytes(f);
+    hashtfile_close(f);
+
+    // 截断
+    CHECK_EQ(truncate(g_path, (off_t)bytes - 8), 0);
+    CHECK(hashtfile_open(g_path) == NULL);
+    CHECK_EQ(truncate(g_path, 10), 0);
+    CHECK(hashtfile_open(g_path) == NULL);
+
+    // 写到不存在的目录失败
+    CHECK_EQ(hashtfile_builder_write(b, "/nonexistent/dir/file"), -1);
+    hashtfile_builder_free(b);
+}
+
+int main(void) {
+    snprintf(g_path, sizeof(g_path), "/tmp/hashtfile_test_%d.tbl", (int)getpid());
+
+    test_roundtrip();
+    test_empty();
+    test_fork();
+    test_corrupt();
+    unlink(g_path);
+
+    return ut_report("hashtfile_test");
+}
@@ -0,0 +1,226 @@
+#include "robinhood.h"
+#include "ut_check.h"
+#include "ut_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ Robin Hood 哈希表测试：基本增删改查、高负载因子下与参考实现对比的随机操作、
+ 后移删除后不留空洞（探测长度直方图与元素数一致）、探测长度上限、按元素数精确预留容量
+*/
+
+static uint64_t g_rng = 0xda942042e4dd58b5ULL;
+
+static RobinHood* make_table(hash64_fn hash, double max_load, size_t initial) {
+    RobinHoodConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.key_size = sizeof(uint64_t);
+    cfg.value_size = sizeof(uint64_t);
+    cfg.hash = hash;
+    cfg.max_load = max_load;
+    cfg.initial_capacity = initial;
+    return robinhood_create(&cfg);
+}
+
+static void test_basic(void) {
+    RobinHoodConfig bad;
+    memset(&bad, 0, sizeof(bad));
+    CHECK(robinhood_create(&bad) == NULL);
+    bad.key_size = 8;
+    bad.max_load = 1.0;
+    CHECK(robinhood_create(&bad) == NULL);
+    CHECK(robinhood_create(NULL) == NULL);
+
+    RobinHood* t = make_table(NULL, 0, 0);
+    for (uint64_t k = 0; k < 1000; k++) {
+        uint64_t v = k * 3;
+        CHECK_EQ(robinhood_put(t, &k, &v), 1);
+    }
+    CHECK_EQ(robinhood_size(t), 1000);
+    for (uint64_t k = 0; k < 1000; k++) {
+        uint64_t* v = (uint64_t*)robinhood_get(t, &k);
+        CHECK(v != NULL && *v == k * 3);
+    }
+    uint64_t k = 5000, v = 700;
+    CHECK(robinhood_get(t, &k) == NULL);
+    k = 7;
+    CHECK_EQ(robinhood_put(t, &k, &v), 0);
+    CHECK_EQ(*(uint64_t*)robinhood_get(t, &k), 700);
+
+    int inserted = -1;
+    uint64_t* cnt = (uint64_t*)robinhood_upsert(t, &k, &inserted);
+    CHECK_EQ(inserted, 0);
+    (*cnt)++;
+    k = 123456;
+    cnt = (uint64_t*)robinhood_upsert(t, &k, &inserted);
+    CHECK_EQ(inserted, 1);
+    CHECK_EQ(*cnt, 0);
+
+    uint64_t out = 0;
+    k = 7;
+    CHECK_EQ(robinhood_remove(t, &k, &out), 0);
+    CHECK_EQ(out, 701);
+    CHECK_EQ(robinhood_remove(t, &k, NULL), -1);
+    CHECK_EQ(robinhood_size(t), 1000);
+
+    robinhood_clear(t);
+    CHECK_EQ(robinhood_size(t), 0);
+    k = 1;
+    CHECK(robinhood_get(t, &k) == NULL);
+    CHECK_EQ(robinhood_probe_histogram(t, NULL, 0), 0);
+    robinhood_free(t);
+    robinhood_free(NULL);
+
+    // 集合：value_size 为 0 时返回键的地址
+    RobinHoodConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.key_size = 3;
+    t = robinhood_create(&cfg);
+    CHECK_EQ(robinhood_put(t, "abc", NULL), 1);
+    CHECK_EQ(robinhood_put(t, "abc", NULL), 0);
+    CHECK(memcmp(robinhood_get(t, "abc"), "abc", 3) == 0);
+    CHECK(robinhood_get(t, "abd") == NULL);
+    robinhood_free(t);
+}
+
+// 与参考数组对比的随机操作，最后核对遍历与探测长度直方图
+static void run_random_ops(hash64_fn hash, double max_load, int ops, uint64_t key_range, size_t max_probe_limit) {
+    RobinHood* t = make_table(hash, max_load, 0);
+    uint8_t* present = (uint8_t*)calloc(key_range, 1);
+    uint64_t* values = (uint64_t*)calloc(key_range, sizeof(uint64_t));
+    size_t size = 0;
+    for (int op = 0; op < ops; op++) {
+        uint64_t k = ut_rand(&g_rng) % key_range;
+        uint64_t r = ut_rand(&g_rng) % 10;
+        if (r < 5) {
+            uint64_t v = ut_rand(&g_rng);
+            CHECK_EQ(robinhood_put(t, &k, &v), present[k] ? 0 : 1);
+            size += !present[k];
+            present[k] = 1;
+            values[k] = v;
+        } else if (r < 8) {
+            uint64_t out = 0;
+            CHECK_EQ(robinhood_remove(t, &k, &out), present[k] ? 0 : -1);
+            if (present[k]) {
+                CHECK_EQ(out, values[k]);
+                size--;
+            }
+            present[k] = 0;
+        } else {
+            uint64_t* v = (uint64_t*)robinhood_get(t, &k);
+            CHECK_EQ(v != NULL, present[k]);
+            if (v != NULL) {
+                CHECK_EQ(*v, values[k]);
+            }
+        }
+    }
+    CHECK_EQ(robinhood_size(t), size);
+    for (uint64_t k = 0; k < key_range; k++) {
+        uint64_t* v = (uint64_t*)robinhood_get(t, &k);
+        CHECK_EQ(v != NULL, present[k]);
+    }
+    size_t iter = 0, visited = 0;
+    const void* key;
+    void* value;
+    while (robinhood_next(t, &iter, &key, &value)) {
+        uint64_t k;
+        memcpy(&k, key, sizeof(k));
+        CHECK(k < key_range && present[k]);
+        CHECK_EQ(*(uint64_t*)value, values[k]);
+        visited++;
+    }
+    CHECK_EQ(visited, size);
+
+    size_t hist[8], total = 0;
+    size_t max_probe = robinhood_probe_histogram(t, hist, 8);
+    for (int i = 0; i < 8; i++) {
+        total += hist[i];
+    }
+    CHECK_EQ(total, size);
+    CHECK(max_probe <= max_probe_limit);
+    free(present);
+    free(values);
+    robinhood_free(t);
+}
+
+static void test_random(void) {
+    run_random_ops(NULL, 0, 200000, 20000, 64);
+    run_random_ops(NULL, 0.95, 200000, 20000, 96);
+    run_random_ops(NULL, 0.99, 100000, 5000, ROBINHOOD_MAX_PROBE);
+    run_random_ops(ut_weak_hash, 0.9, 50000, 1600, ROBINHOOD_MAX_PROBE);
+}
+
+// 高负载下探测长度集中：0.95 负载、10 万个元素时平均探测长度只有几，最大不超过几十
+static void test_probe_length(void) {
+    RobinHood* t = make_table(NULL, 0.95, 100000);
+    size_t cap = robinhood_capacity(t);
+    CHECK(cap <= 100000 / 0.95 + 2);                    // 按元素数精确分配，不取 2 的幂
+    for (uint64_t k = 0; k < 100000; k++) {
+        robinhood_put(t, &k, &k);
+    }
+    CHECK_EQ(robinhood_capacity(t), cap);
+    size_t hist[256];
+    size_t max_probe = robinhood_probe_histogram(t, hist, 256);
+    double sum = 0;
+    for (int i = 0; i < 256; i++) {
+        sum += (double)hist[i] * i;
+    }
+    CHECK(sum / 100000 < 12);
+    CHECK(max_probe < 100);
+    CHECK(robinhood_memory(t) < 100000 * 19);           // 每个元素约 17 / 0.95 字节
+
+    // 删除一半（后移，无墓碑）后探测长度只会变短
+    for (uint64_t k = 0; k < 100000; k += 2) {
+        CHECK_EQ(robinhood_remove(t, &k, NULL), 0);
+    }
+    CHECK(robinhood_probe_histogram(t, NULL, 0) <= max_probe);
+    for (uint64_t k = 0; k < 100000; k++) {
+        CHECK_EQ(robinhood_get(t, &k) != NULL, (int)(k & 1));
+    }
+    robinhood_free(t);
+
+    // 所有键哈希相同：探测长度到达上限后放弃，已有元素不受影响
+    t = make_table(ut_const_hash, 0, 0);
+    uint64_t k = 0;
+    while (robinhood_put(t, &k, &k) == 1) {
+        k++;
+    }
+    CHECK_EQ(k, ROBINHOOD_MAX_PROBE + 1);
+    CHECK_EQ(robinhood_size(t), k);
+    CHECK_EQ(robinhood_probe_histogram(t, NULL, 0), ROBINHOOD_MAX_PROBE);
+    for (uint64_t j = 0; j < k; j++) {
+        CHECK(robinhood_get(t, &j) != NULL);
+    }
+    // 删除最前面的元素，其余全部前移
+    k = 0;
+    CHECK_EQ(robinhood_remove(t, &k, NULL), 0);
+    CHECK_EQ(robinhood_probe_histogram(t, NULL, 0), ROBINHOOD_MAX_PROBE - 1);
+    robinhood_free(t);
+}
+
+static void test_reserve(void) {
+    RobinHood* t = make_table(NULL, 0.9, 0);
+    CHECK_EQ(robinhood_reserve(t, 10000), 0);
+    size_t cap = robinhood_capacity(t);
+    CHECK(cap >= 10000 / 0.9 && cap <= 10000 / 0.9 + 2);
+    for (uint64_t k = 0; k < 10000; k++) {
+        robinhood_put(t, &k, &k);
+    }
+    CHECK_EQ(robinhood_capacity(t), cap);
+    CHECK_EQ(robinhood_reserve(t, 10), 0);
+    CHECK_EQ(robinhood_capacity(t), cap);
+    for (uint64_t k = 0; k < 10000; k++) {
+        CHECK_EQ(*(uint64_t*)robinhood_get(t, &k), k);
+    }
+    robinhood_free(t);
+}
+
+int main(void) {
+    test_basic();
+    test_random();
+    test_probe_length();
+    test_reserve();
+
+    return ut_report("robinhood_test");
+}
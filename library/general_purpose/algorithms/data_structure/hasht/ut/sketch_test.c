@@ -0,0 +1,216 @@
+#include "sketch.h"
+#include "hashalg.h"
+#include "ut_check.h"
+#include "ut_util.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ SimHash / MinHash 测试：shingle 与空白无关，SimHash 单特征等于特征哈希、近似文档距离小，
+ OPH 与 k 次置换的 Jaccard 估计在统计误差内、与元素顺序和重复无关，AVX2 比较与标量一致，LSH 找到全部相似对
+*/
+
+static uint64_t g_rng = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t int_hash(uint32_t x) {
+    return murmurHash3_x64_64(&x, sizeof(x), 0);
+}
+
+static void test_shingles(void) {
+    uint64_t a[8], b[8];
+    CHECK_EQ(sketch_word_shingles("the quick brown fox", 19, 2, a, 8), 3);
+    CHECK_EQ(sketch_word_shingles("  the\tquick\n\nbrown   fox ", 25, 2, b, 8), 3);
+    CHECK(memcmp(a, b, 3 * sizeof(uint64_t)) == 0);
+    CHECK(a[0] != a[1] && a[1] != a[2]);
+
+    // 顺序不同的词组成不同的 shingle
+    CHECK_EQ(sketch_word_shingles("quick the", 9, 2, b, 8), 1);
+    CHECK_EQ(sketch_word_shingles("the quick", 9, 2, a, 8), 1);
+    CHECK(a[0] != b[0]);
+
+    // 词数不足 k 时整段为一个 shingle；cap 不足时只写前 cap 个但返回总数
+    CHECK_EQ(sketch_word_shingles("one two", 7, 5, a, 8), 1);
+    CHECK_EQ(sketch_word_shingles("a b c d e f", 11, 1, a, 2), 6);
+    CHECK_EQ(sketch_word_shingles("   ", 3, 2, a, 8), 0);
+    CHECK_EQ(sketch_word_shingles("a b", 3, 0, a, 8), 0);
+    CHECK_EQ(sketch_word_shingles("a b", 3, SKETCH_MAX_SHINGLE + 1, a, 8), 0);
+}
+
+static void test_simhash(void) {
+    uint64_t h = 0x0123456789abcdefULL;
+    CHECK_EQ(simhash64(&h, NULL, 1), h);     // 单个特征：每一位只有一票
+    CHECK_EQ(simhash64(NULL, NULL, 0), 0);
+
+    enum { N = 400 };
+    uint64_t f[N], g[N];
+    uint32_t ones[N];
+    for (int i = 0; i < N; i++) {
+        f[i] = int_hash((uint32_t)i);
+        g[i] = i < 10 ? int_hash((uint32_t)(i + 100000)) : f[i];     // 替换 2.5% 的特征
+        ones[i] = 1;
+    }
+    uint64_t a = simhash64(f, NULL, N);
+    CHECK_EQ(simhash64(f, ones, N), a);
+    CHECK(simhash_distance(a, simhash64(g, NULL, N)) <= 8);
+
+    // 不相关的集合：距离约 32
+    for (int i = 0; i < N; i++) {
+        g[i] = int_hash((uint32_t)(i + 200000));
+    }
+    int d = simhash_distance(a, simhash64(g, NULL, N));
+    CHECK(d >= 16 && d <= 48);
+
+    // 权重：一个权重极大的特征决定全部位
+    ones[7] = 1000000;
+    CHECK_EQ(simhash64(f, ones, N), f[7]);
+
+    // AVX2 与标量一致：各种长度、随机权重，以及累计权重超过 32 位计数器的情况
+    for (size_t n = 0; n <= 100; n++) {
+        for (size_t i = 0; i < n; i++) {
+            ones[i] = (uint32_t)(ut_rand(&g_rng) % 5);
+        }
+        CHECK_EQ(simhash64_avx2(f, NULL, n), simhash64_scalar(f, NULL, n));
+        CHECK_EQ(simhash64_avx2(f, ones, n), simhash64_scalar(f, ones, n));
+    }
+    for (int i = 0; i < N; i++) {
+        ones[i] = 0xf0000000u + (uint32_t)(ut_rand(&g_rng) % 0x10000000u);
+    }
+    CHECK_EQ(simhash64_avx2(f, ones, N), simhash64_scalar(f, ones, N));
+}
+
+// 集合 A = [a0, a1)、B = [b0, b1) 的整数，签名长度 k，Jaccard 估计与真实值的差
+static double jaccard_error(uint32_t a0, uint32_t a1, uint32_t b0, uint32_t b1, uint32_t k, int kperm) {
+    uint64_t* ha = (uint64_t*)malloc((a1 - a0) * sizeof(uint64_t));
+    uint64_t* hb = (uint64_t*)malloc((b1 - b0) * sizeof(uint64_t));
+    uint32_t* sa = (uint32_t*)malloc(k * sizeof(uint32_t));
+    uint32_t* sb = (uint32_t*)malloc(k * sizeof(uint32_t));
+    for (uint32_t x = a0; x < a1; x++) {
+        ha[x - a0] = int_hash(x);
+    }
+    for (uint32_t x = b0; x < b1; x++) {
+        hb[x - b0] = int_hash(x);
+    }
+    if (kperm) {
+        minhash_kperm(ha, a1 - a0, k, sa);
+        minhash_kperm(hb, b1 - b0, k, sb);
+    } else {
+        minhash_oph(ha, a1 - a0, k, sa);
+        minhash_oph(hb, b1 - b0, k, sb);
+    }
+    uint32_t lo = a0 > b0 ? a0 : b0;
+    uint32_t hi = a1 < b1 ? a1 : b1;
+    double inter = hi > lo ? (double)(hi - lo) : 0.0;
+    double truth = inter / ((double)(a1 - a0) + (double)(b1 - b0) - inter);
+    double err = fabs(minhash_jaccard(sa, sb, k) - truth);
+    free(ha);
+    free(hb);
+    free(sa);
+    free(sb);
+    return err;
+}
+
+static void test_minhash(void) {
+    uint32_t sig[64];
+    CHECK_EQ(minhash_oph(NULL, 0, 64, sig), 0);
+    for (int i = 0; i < 64; i++) {
+        CHECK_EQ(sig[i], MINHASH_EMPTY);
+    }
+    CHECK_EQ(minhash_oph(NULL, 0, 0, sig), -1);
+    CHECK_EQ(minhash_oph(NULL, 0, MINHASH_MAX_K + 1, sig), -1);
+    CHECK_EQ(minhash_kperm(NULL, 0, 0, sig), -1);
+
+    // 元素顺序与重复不影响签名；元素少于 k 时致密化后没有空桶
+    uint64_t h[30], r[60];
+    uint32_t s1[64], s2[64];
+    for (int i = 0; i < 30; i++) {
+        h[i] = int_hash((uint32_t)i);
+        r[59 - i] = h[i];
+        r[i] = h[i];
+    }
+    minhash_oph(h, 30, 64, s1);
+    minhash_oph(r, 60, 64, s2);
+    CHECK(memcmp(s1, s2, sizeof(s1)) == 0);
+    for (int i = 0; i < 64; i++) {
+        CHECK(s1[i] != MINHASH_EMPTY);
+    }
+
+    // 标准差 sqrt(J(1-J)/k)：k = 512 时约 0.022，允许 4 倍
+    CHECK(jaccard_error(0, 3000, 1000, 4000, 512, 0) < 0.09);      // J = 0.5
+    CHECK(jaccard_error(0, 3000, 1000, 4000, 512, 1) < 0.09);
+    CHECK(jaccard_error(0, 1000, 100, 1100, 512, 0) < 0.07);       // J ≈ 0.82
+    CHECK(jaccard_error(0, 50, 25, 75, 256, 0) < 0.12);            // 元素少于 k，J = 1/3
+    CHECK(jaccard_error(0, 50, 25, 75, 256, 1) < 0.12);
+    CHECK(jaccard_error(0, 500, 500, 1000, 256, 0) < 0.03);        // 不相交
+}
+
+static void test_match_count(void) {
+    uint32_t a[100], b[100];
+    for (int i = 0; i < 100; i++) {
+        a[i] = (uint32_t)ut_rand(&g_rng);
+        b[i] = (ut_rand(&g_rng) & 1) ? a[i] : (uint32_t)ut_rand(&g_rng);
+    }
+    for (size_t k = 0; k <= 100; k++) {
+        size_t expect = minhash_match_count_scalar(a, b, k);
+        CHECK_EQ(minhash_match_count_avx2(a, b, k), expect);
+        CHECK_EQ(minhash_match_count(a + 1, b + 1, k > 0 ? k - 1 : 0), minhash_match_count_scalar(a + 1, b + 1, k > 0 ? k - 1 : 0));
+    }
+    CHECK_EQ(minhash_match_count(a, a, 100), 100);
+}
+
+// 100 对相似度约 0.9 的签名混在 200 个不相关的签名中，LSH（32 段 x 4 行）找回全部相似对
+static void test_lsh(void) {
+    enum { PAIRS = 100, NOISE = 200, N = 2 * PAIRS + NOISE, K = 128, SET = 200 };
+    uint32_t* sigs = (uint32_t*)malloc((size_t)N * K * sizeof(uint32_t));
+    uint64_t h[SET];
+    for (int d = 0; d < N; d++) {
+        // 第 2i 与 2i+1 个文档共享前 190 个元素：J = 190 / 210 ≈ 0.9
+        int base = d < 2 * PAIRS ? d / 2 : d;
+        for (int e = 0; e < SET; e++) {
+            uint32_t x = e < 190 ? (uint32_t)(base * 1000 + e) : (uint32_t)(d * 1000 + 500 + e);
+            h[e] = int_hash(x);
+        }
+        minhash_oph(h, SET, K, sigs + (size_t)d * K);
+    }
+
+    SketchPair* pairs = NULL;
+    size_t npairs = 0;
+    CHECK_EQ(lsh_candidates(sigs, N, K, 32, 4, &pairs, &npairs), 0);
+    int found = 0;
+    for (size_t i = 0; i < npairs; i++) {
+        CHECK(pairs[i].a < pairs[i].b);
+        if (i > 0) {
+            CHECK(pairs[i - 1].a < pairs[i].a || (pairs[i - 1].a == pairs[i].a && pairs[i - 1].b < pairs[i].b));
+        }
+        found += pairs[i].b < 2 * PAIRS && pairs[i].a % 2 == 0 && pairs[i].b == pairs[i].a + 1;
+    }
+    CHECK_EQ(found, PAIRS);
+    CHECK(npairs < PAIRS + 20);        // 不相关的文档几乎不会成为候选
+    free(pairs);
+
+    CHECK_EQ(lsh_candidates(sigs, N, K, 33, 4, &pairs, &npairs), -1);  // bands * rows > k
+    CHECK_EQ(lsh_candidates(sigs, 1, K, 32, 4, &pairs, &npairs), 0);
+    CHECK(pairs == NULL && npairs == 0);
+    free(sigs);
+
+    CHECK(fabs(lsh_probability(0.5, 1, 1) - 0.5) < 1e-12);
+    CHECK(lsh_probability(0.9, 32, 4) > 0.999);
+    CHECK(lsh_probability(0.2, 32, 4) < 0.06);
+    uint32_t bands = 0, rows = 0;
+    CHECK_EQ(lsh_choose_bands(128, 0.5, &bands, &rows), 0);
+    CHECK(bands * rows <= 128);
+    CHECK(fabs(pow(1.0 / bands, 1.0 / rows) - 0.5) < 0.05);
+    CHECK_EQ(lsh_choose_bands(128, 1.5, &bands, &rows), -1);
+}
+
+int main(void) {
+    test_shingles();
+    test_simhash();
+    test_minhash();
+    test_match_count();
+    test_lsh();
+
+    printf("sketch_test: AVX2 %s\n", hash_cpu_has_avx2() ? "可用" : "不可用");
+    return ut_report("sketch_test");
+}
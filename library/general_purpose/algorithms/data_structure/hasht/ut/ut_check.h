@@ -0,0 +1,39 @@
+#ifndef UT_CHECK_H
+#define UT_CHECK_H
+
+#include <stdio.h>
+
+/*
+ 单元测试共用的检查宏
+ 不依赖 assert：Release 构建定义了 NDEBUG 时检查仍然生效；失败时打印位置并计数，main 最后用 ut_report 根据计数返回
+*/
+static int g_failures = 0;
+
+#define CHECK_EQ(actual, expected) do {                                        \
+    unsigned long long a_ = (unsigned long long)(actual);                      \
+    unsigned long long e_ = (unsigned long long)(expected);                    \
+    if (a_ != e_) {                                                            \
+        fprintf(stderr, "%s:%d: %s = 0x%llx, 期望 0x%llx\n",                   \
+                __FILE__, __LINE__, #actual, a_, e_);                          \
+        g_failures++;                                                          \
+    }                                                                          \
+} while (0)
+
+#define CHECK(cond) do {                                                       \
+    if (!(cond)) {                                                             \
+        fprintf(stderr, "%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #cond);   \
+        g_failures++;                                                          \
+    }                                                                          \
+} while (0)
+
+// main 的结尾：打印结果，返回进程的退出码
+static inline int ut_report(const char* name) {
+    if (g_failures != 0) {
+        fprintf(stderr, "%s: %d 项检查失败\n", name, g_failures);
+        return 1;
+    }
+    printf("%s: 全部通过\n", name);
+    return 0;
+}
+
+#endif // UT_CHECK_H
@@ -0,0 +1,47 @@
+#ifndef UT_UTIL_H
+#define UT_UTIL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ 单元测试共用的随机数与退化的哈希函数
+ （1）ut_rand：xorshift64，状态由调用者保存（初值不能为 0），固定种子每次运行得到相同的序列，失败可以复现
+ （2）ut_const_hash / ut_const_hash32：所有键的哈希值相同，覆盖全部冲突时的探测、树化与墓碑路径
+ （3）ut_weak_hash：8 字节的键只有 16 个不同的哈希值，低 7 位都为 0（组探测的 h2 全部冲突），
+      7 ~ 10 位与最高 4 位随键变化：按低位选组、按高位选起始槽位的表都只用到 16 个位置
+*/
+
+static inline uint64_t ut_rand(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+static inline uint64_t ut_const_hash(const void* key, size_t len, uint64_t seed) {
+    (void)key;
+    (void)len;
+    (void)seed;
+    return 0;
+}
+
+static inline uint32_t ut_const_hash32(const void* key, size_t len, uint32_t seed) {
+    (void)key;
+    (void)len;
+    (void)seed;
+    return 0;
+}
+
+static inline uint64_t ut_weak_hash(const void* key, size_t len, uint64_t seed) {
+    uint64_t k;
+    (void)len;
+    (void)seed;
+    memcpy(&k, key, sizeof(k));
+    return (k & 15) * 0x1000000000000080ULL;
+}
+
+#endif // UT_UTIL_H
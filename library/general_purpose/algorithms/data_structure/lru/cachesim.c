@@ -0,0 +1,441 @@
+/*
+ 缓存 trace 重放模拟器：把访问序列重放到 lru.h 的全部淘汰策略上，输出各容量下的命中率曲线与吞吐，
+ 用来选择缓存的容量与淘汰策略，不再靠猜
+ （1）LRU 用栈距离（stackdist.h）一遍得到所有容量的命中率；其他策略没有包含性，每个 (策略, 容量) 单独重放一遍，
+      这些重放互不依赖，由多个线程（默认为 CPU 数）领取并行执行；LRU 也按容量重放，只用来测吞吐，
+      命中率仍取栈距离的结果（两者逐次一致）
+ （2）trace 由 cachetrace.h 读入：二进制 trace 直接映射，各线程共用同一份映射；文本 trace 可以先 convert 成二进制
+ （3）每次访问先 get，未命中再 put（读穿透），与 lru_policy_bench 相同；吞吐是单个线程重放的每秒百万次访问
+ （4）容量默认在 [不同键数 / 1000, 不同键数] 之间按对数等分取 --points 个点，也可以用 --caps 指定
+
+ 用法：
+   cachesim run TRACE [--caps N1,N2,...] [--points N] [--policies lru,clock,2q,arc,w-tinylfu] [--threads N] [--csv]
+   cachesim convert TRACE OUT.bin                文本（或二进制）trace 转成二进制
+   cachesim gen KEYS LEN ALPHA OUT.bin           生成 zipf 分布的合成 trace（二进制）
+*/
+#include "cachetrace.h"
+#include "lru.h"
+#include "stackdist.h"
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_CAPS 64
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int usage(const char* prog) {
+    fprintf(stderr,
+            "用法:\n"
+            "  %s run TRACE [--caps N1,N2,...] [--points N] [--policies lru,clock,2q,arc,w-tinylfu] [--threads N] "
+            "[--csv]\n"
+            "  %s convert TRACE OUT.bin\n"
+            "  %s gen KEYS LEN ALPHA OUT.bin\n",
+            prog, prog, prog);
+    return 2;
+}
+
+// 按名字查策略：不区分大小写，忽略 '-'（"wtinylfu" 与 "W-TinyLFU" 相同），找不到返回 -1
+static int parse_policy(const char* s, size_t len) {
+    for (int p = 0; p < LRU_POLICY_COUNT; p++) {
+        const char* name = lru_policy_name((LRUPolicy)p);
+        size_t i = 0;
+        const char* q = name;
+        for (;;) {
+            while (i < len && s[i] == '-') {
+                i++;
+            }
+            while (*q == '-') {
+                q++;
+            }
+            if (i == len || *q == '\0' || tolower((unsigned char)s[i]) != tolower((unsigned char)*q)) {
+                break;
+            }
+            i++;
+            q++;
+        }
+        if (i == len && *q == '\0') {
+            return p;
+        }
+    }
+    return -1;
+}
+
+static int cmp_size(const void* a, const void* b) {
+    size_t x = *(const size_t*)a, y = *(const size_t*)b;
+    return x < y ? -1 : (x > y);
+}
+
+// 排序并去掉重复与 0
+static size_t normalize_caps(size_t caps[], size_t n) {
+    qsort(caps, n, sizeof(size_t), cmp_size);
+    size_t m = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (caps[i] != 0 && (m == 0 || caps[m - 1] != caps[i])) {
+            caps[m++] = caps[i];
+        }
+    }
+    return m;
+}
+
+/*
+ 并行重放
+*/
+
+typedef struct {
+    LRUPolicy policy;
+    size_t capacity;
+    double hit;                 // 创建缓存失败时为 -1
+    double mops;
+} Job;
+
+typedef struct {
+    const uint64_t* keys;
+    size_t len;
+    Job* jobs;
+    size_t njobs;
+    size_t next;                // 下一个待领取的任务，原子递增
+} Pool;
+
+static void run_job(const Pool* pool, Job* job) {
+    LRUConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.capacity = job->capacity;
+    cfg.max_key_size = sizeof(uint64_t);
+    cfg.policy = job->policy;
+    LRUCache* c = lru_create(&cfg);
+    if (c == NULL) {
+        job->hit = -1;
+        return;
+    }
+    double start = now_sec();
+    for (size_t i = 0; i < pool->len; i++) {
+        if (lru_get(c, &pool->keys[i], sizeof(uint64_t), NULL) != 0) {
+            lru_put(c, &pool->keys[i], sizeof(uint64_t), NULL);
+        }
+    }
+    double elapsed = now_sec() - start;
+    job->mops = elapsed > 0 ? (double)pool->len / elapsed / 1e6 : 0;
+    job->hit = lru_hit_ratio(c);
+    lru_free(c);
+}
+
+static void* worker(void* arg) {
+    Pool* pool = (Pool*)arg;
+    for (;;) {
+        size_t j = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED);
+        if (j >= pool->njobs) {
+            return NULL;
+        }
+        run_job(pool, &pool->jobs[j]);
+    }
+}
+
+static int cmd_run(int argc, char* argv[]) {
+    if (argc < 3) {
+        return usage(argv[0]);
+    }
+    const char* path = argv[2];
+    size_t caps[MAX_CAPS];
+    size_t ncaps = 0;
+    size_t points = 10;
+    int use[LRU_POLICY_COUNT];
+    for (int p = 0; p < LRU_POLICY_COUNT; p++) {
+        use[p] = 1;
+    }
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int csv = 0;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--caps") == 0 && i + 1 < argc) {
+            ncaps = 0;
+            for (char* s = argv[++i]; *s != '\0';) {
+                char* end;
+                errno = 0;
+                unsigned long long v = strtoull(s, &end, 10);
+                // lru.h 的容量上限为 UINT32_MAX - 1
+                if (!isdigit((unsigned char)*s) || (*end != ',' && *end != '\0') || errno == ERANGE ||
+                    v >= UINT32_MAX) {
+                    fprintf(stderr, "--caps 应为逗号分隔的、小于 %u 的整数: %s\n", UINT32_MAX, argv[i]);
+                    return 2;
+                }
+                if (ncaps == MAX_CAPS) {
+                    fprintf(stderr, "--caps 最多 %d 个容量\n", MAX_CAPS);
+                    return 2;
+                }
+                caps[ncaps++] = (size_t)v;
+                s = *end == ',' ? end + 1 : end;
+            }
+        } else if (strcmp(argv[i], "--points") == 0 && i + 1 < argc) {
+            points = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--policies") == 0 && i + 1 < argc) {
+            memset(use, 0, sizeof(use));
+            for (const char* s = argv[++i]; *s != '\0';) {
+                size_t n = strcspn(s, ",");
+                int p = parse_policy(s, n);
+                if (p < 0) {
+                    fprintf(stderr, "未知的策略: %.*s\n", (int)n, s);
+                    return 2;
+                }
+                use[p] = 1;
+                s += n + (s[n] == ',');
+            }
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (points < 2 || points > MAX_CAPS) {
+        points = points < 2 ? 2 : MAX_CAPS;
+    }
+    threads = threads < 1 ? 1 : threads;
+
+    CacheTrace* t = cachetrace_open(path);
+    if (t == NULL) {
+        fprintf(stderr, "打开 %s 失败（不存在、二进制文件头损坏或内存不足）\n", path);
+        return 1;
+    }
+    const uint64_t* keys = cachetrace_keys(t);
+    size_t len = cachetrace_len(t);
+    if (len == 0) {
+        fprintf(stderr, "%s 中没有访问\n", path);
+        cachetrace_close(t);
+        return 1;
+    }
+
+    // LRU：一遍栈距离，同时得到不同键数
+    double start = now_sec();
+    StackDist* sd = stackdist_create(0);
+    for (size_t i = 0; i < len && sd != NULL; i++) {
+        if (stackdist_access(sd, keys[i], NULL) != 0) {
+            stackdist_free(sd);
+            sd = NULL;
+        }
+    }
+    if (sd == NULL) {
+        fprintf(stderr, "内存不足\n");
+        cachetrace_close(t);
+        return 1;
+    }
+    double sd_sec = now_sec() - start;
+    size_t unique = stackdist_unique(sd);
+
+    if (ncaps == 0) {
+        double lo = unique >= 1000 ? (double)unique / 1000 : 1;
+        for (size_t i = 0; i < points; i++) {
+            caps[ncaps++] = (size_t)llround(lo * pow((double)unique / lo, (double)i / (double)(points - 1)));
+        }
+    }
+    ncaps = normalize_caps(caps, ncaps);
+    if (ncaps == 0) {
+        fprintf(stderr, "容量应大于 0\n");
+        stackdist_free(sd);
+        cachetrace_close(t);
+        return 2;
+    }
+    uint64_t lru_hits[MAX_CAPS];
+    stackdist_curve(sd, caps, ncaps, lru_hits);
+    stackdist_free(sd);
+
+    // 每个 (策略, 容量) 一个任务
+    Pool pool;
+    memset(&pool, 0, sizeof(pool));
+    pool.keys = keys;
+    pool.len = len;
+    pool.jobs = (Job*)calloc(LRU_POLICY_COUNT * ncaps, sizeof(Job));
+    if (pool.jobs == NULL) {
+        fprintf(stderr, "内存不足\n");
+        cachetrace_close(t);
+        return 1;
+    }
+    for (int p = 0; p < LRU_POLICY_COUNT; p++) {
+        for (size_t c = 0; c < ncaps && use[p]; c++) {
+            pool.jobs[pool.njobs].policy = (LRUPolicy)p;
+            pool.jobs[pool.njobs].capacity = caps[c];
+            pool.njobs++;
+        }
+    }
+    if ((size_t)threads > pool.njobs) {
+        threads = pool.njobs > 0 ? (long)pool.njobs : 1;
+    }
+    start = now_sec();
+    pthread_t* tids = (pthread_t*)calloc((size_t)threads, sizeof(pthread_t));
+    long started = 0;
+    for (; tids != NULL && started < threads - 1; started++) {
+        if (pthread_create(&tids[started], NULL, worker, &pool) != 0) {
+            break;
+        }
+    }
+    worker(&pool);
+    for (long i = 0; i < started; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    threads = started + 1;
+    double sim_sec = now_sec() - start;
+    free(tids);
+
+    int failed = 0;
+    for (size_t j = 0; j < pool.njobs; j++) {
+        if (pool.jobs[j].hit < 0) {
+            fprintf(stderr, "%s 容量 %zu：创建缓存失败（内存不足）\n", lru_policy_name(pool.jobs[j].policy),
+                    pool.jobs[j].capacity);
+            failed = 1;
+        }
+    }
+    if (failed) {
+        free(pool.jobs);
+        cachetrace_close(t);
+        return 1;
+    }
+
+    // 结果按 [策略][容量] 取
+    double hit[LRU_POLICY_COUNT][MAX_CAPS], mops[LRU_POLICY_COUNT][MAX_CAPS];
+    for (size_t j = 0; j < pool.njobs; j++) {
+        const Job* job = &pool.jobs[j];
+        size_t c = 0;
+        while (caps[c] != job->capacity) {
+            c++;
+        }
+        hit[job->policy][c] = job->hit;
+        mops[job->policy][c] = job->mops;
+    }
+    for (size_t c = 0; c < ncaps; c++) {
+        hit[LRU_POLICY_LRU][c] = (double)lru_hits[c] / (double)len;
+    }
+    free(pool.jobs);
+
+    if (csv) {
+        printf("capacity,policy,hit_ratio,mops\n");
+        for (size_t c = 0; c < ncaps; c++) {
+            for (int p = 0; p < LRU_POLICY_COUNT; p++) {
+                if (!use[p]) {
+                    continue;
+                }
+                printf("%zu,%s,%.6f,%.3f\n", caps[c], lru_policy_name((LRUPolicy)p), hit[p][c], mops[p][c]);
+            }
+        }
+    } else {
+        printf("%s：%zu 次访问，%zu 个不同的键（%s）\n", path, len, unique,
+               cachetrace_mapped(t) ? "二进制，映射" : "文本");
+        printf("LRU 栈距离：一遍 %.2f s，%zu 个容量的命中率\n", sd_sec, ncaps);
+        printf("重放：%zu 次（策略 × 容量），%ld 个线程，%.2f s\n", pool.njobs, threads, sim_sec);
+        for (int table = 0; table < 2; table++) {
+            printf("  %-10s", table == 0 ? "hit%" : "Mops");
+            for (int p = 0; p < LRU_POLICY_COUNT; p++) {
+                if (use[p]) {
+                    printf(" %10s", lru_policy_name((LRUPolicy)p));
+                }
+            }
+            printf("\n");
+            for (size_t c = 0; c < ncaps; c++) {
+                printf("  %-10zu", caps[c]);
+                for (int p = 0; p < LRU_POLICY_COUNT; p++) {
+                    if (use[p]) {
+                        printf(" %10.2f", table == 0 ? hit[p][c] * 100 : mops[p][c]);
+                    }
+                }
+                printf("\n");
+            }
+        }
+    }
+    cachetrace_close(t);
+    return 0;
+}
+
+static int cmd_convert(int argc, char* argv[]) {
+    if (argc != 4) {
+        return usage(argv[0]);
+    }
+    CacheTrace* t = cachetrace_open(argv[2]);
+    if (t == NULL) {
+        fprintf(stderr, "打开 %s 失败\n", argv[2]);
+        return 1;
+    }
+    int rc = cachetrace_write(argv[3], cachetrace_keys(t), cachetrace_len(t));
+    if (rc != 0) {
+        perror(argv[3]);
+    } else {
+        printf("%zu 次访问写入 %s\n", cachetrace_len(t), argv[3]);
+    }
+    cachetrace_close(t);
+    return rc != 0;
+}
+
+// zipf 分布：按累积分布反查，键编号打散
+static int cmd_gen(int argc, char* argv[]) {
+    if (argc != 6) {
+        return usage(argv[0]);
+    }
+    size_t nkeys = (size_t)strtoull(argv[2], NULL, 10);
+    size_t len = (size_t)strtoull(argv[3], NULL, 10);
+    double alpha = strtod(argv[4], NULL);
+    if (nkeys == 0 || len == 0 || alpha < 0) {
+        fprintf(stderr, "KEYS、LEN 应大于 0，ALPHA 不小于 0\n");
+        return 2;
+    }
+    double* cdf = (double*)malloc(nkeys * sizeof(double));
+    uint64_t* keys = (uint64_t*)malloc(len * sizeof(uint64_t));
+    if (cdf == NULL || keys == NULL) {
+        fprintf(stderr, "内存不足\n");
+        free(cdf);
+        free(keys);
+        return 1;
+    }
+    double sum = 0;
+    for (size_t i = 0; i < nkeys; i++) {
+        sum += 1.0 / pow((double)(i + 1), alpha);
+        cdf[i] = sum;
+    }
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < len; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        double u = (double)(rng >> 11) * 0x1.0p-53 * sum;
+        size_t lo = 0, hi = nkeys - 1;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (cdf[mid] < u) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        keys[i] = lo * 0x9e3779b97f4a7c15ULL;
+    }
+    int rc = cachetrace_write(argv[5], keys, len);
+    if (rc != 0) {
+        perror(argv[5]);
+    }
+    free(cdf);
+    free(keys);
+    return rc != 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        return usage(argv[0]);
+    }
+    if (strcmp(argv[1], "run") == 0) {
+        return cmd_run(argc, argv);
+    }
+    if (strcmp(argv[1], "convert") == 0) {
+        return cmd_convert(argc, argv);
+    }
+    if (strcmp(argv[1], "gen") == 0) {
+        return cmd_gen(argc, argv);
+    }
+    return usage(argv[0]);
+}
@@ -0,0 +1,202 @@
+#include "cachetrace.h"
+#include "crc.h"
+#include "hashalg.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ 实现要点
+ （1）二进制文件头带 crc32c，打开时检查 magic、版本、crc 与 "文件大小 = 文件头 + 8 × 访问次数"
+ （2）重放是从头到尾顺序读，二进制 trace 映射后提示内核顺序预读（MADV_SEQUENTIAL）
+ （3）文本解析先按行数的上界（换行符个数 + 1）一次分配编号数组，不需要边解析边扩容
+*/
+
+#define CACHETRACE_HEADER_SIZE 32
+
+typedef struct {
+    char magic[8];              // CACHETRACE_MAGIC
+    uint32_t version;           // CACHETRACE_VERSION
+    uint32_t header_crc;        // 本字段为 0 时整个文件头的 crc32c
+    uint64_t count;             // 访问次数
+    uint64_t reserved;
+} FileHeader;
+
+_Static_assert(sizeof(FileHeader) == CACHETRACE_HEADER_SIZE, "文件头应为 32 字节");
+
+struct CacheTrace {
+    const uint64_t* keys;
+    size_t len;
+    void* map;                  // 二进制格式的映射，文本格式为NULL
+    size_t map_bytes;
+    uint64_t* owned;            // 文本格式解析出的数组
+};
+
+static inline int is_space(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\r';
+}
+
+size_t cachetrace_parse_text(const char* text, size_t len, uint64_t** keys_out) {
+    size_t lines = 1;
+    for (const char* p = text; (p = (const char*)memchr(p, '\n', (size_t)(text + len - p))) != NULL; p++) {
+        lines++;
+    }
+    uint64_t* keys = (uint64_t*)malloc(lines * sizeof(uint64_t));
+    if (keys == NULL) {
+        return (size_t)-1;
+    }
+    size_t n = 0;
+    const char* end = text + len;
+    for (const char* line = text; line < end;) {
+        const char* eol = (const char*)memchr(line, '\n', (size_t)(end - line));
+        if (eol == NULL) {
+            eol = end;
+        }
+        const char* p = line;
+        while (p < eol && is_space(*p)) {
+            p++;
+        }
+        const char* q = p;
+        while (q < eol && !is_space(*q)) {
+            q++;
+        }
+        if (q > p && *p != '#') {
+            keys[n++] = xxHash64(p, (size_t)(q - p), CACHETRACE_TEXT_SEED);
+        }
+        line = eol + 1;
+    }
+    *keys_out = keys;
+    return n;
+}
+
+static int header_valid(const FileHeader* hdr, size_t bytes) {
+    FileHeader h = *hdr;
+    h.header_crc = 0;
+    if (memcmp(h.magic, CACHETRACE_MAGIC, sizeof(CACHETRACE_MAGIC)) != 0 || h.version != CACHETRACE_VERSION ||
+        crc32c(&h, sizeof(h)) != hdr->header_crc) {
+        return 0;
+    }
+    return hdr->count <= (bytes - CACHETRACE_HEADER_SIZE) / sizeof(uint64_t) &&
+           CACHETRACE_HEADER_SIZE + hdr->count * sizeof(uint64_t) == bytes;
+}
+
+CacheTrace* cachetrace_open(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+    CacheTrace* t = (CacheTrace*)calloc(1, sizeof(CacheTrace));
+    if (t == NULL) {
+        close(fd);
+        return NULL;
+    }
+    size_t bytes = (size_t)st.st_size;
+    if (bytes == 0) {
+        // 空文件按空的文本 trace 处理（mmap 不能映射 0 字节）
+        close(fd);
+        return t;
+    }
+    void* base = mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        free(t);
+        return NULL;
+    }
+    if (bytes >= CACHETRACE_HEADER_SIZE && memcmp(base, CACHETRACE_MAGIC, sizeof(CACHETRACE_MAGIC)) == 0) {
+        FileHeader hdr;
+        memcpy(&hdr, base, sizeof(hdr));
+        if (!header_valid(&hdr, bytes)) {
+            munmap(base, bytes);
+            free(t);
+            return NULL;
+        }
+        madvise(base, bytes, MADV_SEQUENTIAL);
+        t->map = base;
+        t->map_bytes = bytes;
+        t->keys = (const uint64_t*)((const uint8_t*)base + CACHETRACE_HEADER_SIZE);
+        t->len = (size_t)hdr.count;
+        return t;
+    }
+    size_t n = cachetrace_parse_text((const char*)base, bytes, &t->owned);
+    munmap(base, bytes);
+    if (n == (size_t)-1) {
+        free(t);
+        return NULL;
+    }
+    t->keys = t->owned;
+    t->len = n;
+    return t;
+}
+
+void cachetrace_close(CacheTrace* trace) {
+    if (trace == NULL) {
+        return;
+    }
+    if (trace->map != NULL) {
+        munmap(trace->map, trace->map_bytes);
+    }
+    free(trace->owned);
+    free(trace);
+}
+
+int cachetrace_write(const char* path, const uint64_t* keys, size_t len) {
+    size_t path_len = strlen(path);
+    char* tmp = (char*)malloc(path_len + 5);
+    if (tmp == NULL) {
+        return -1;
+    }
+    memcpy(tmp, path, path_len);
+    memcpy(tmp + path_len, ".tmp", 5);
+
+    FileHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, CACHETRACE_MAGIC, sizeof(CACHETRACE_MAGIC));
+    hdr.version = CACHETRACE_VERSION;
+    hdr.count = len;
+    hdr.header_crc = crc32c(&hdr, sizeof(hdr));
+
+    FILE* fp = fopen(tmp, "wb");
+    if (fp == NULL) {
+        free(tmp);
+        return -1;
+    }
+    int ok = fwrite(&hdr, sizeof(hdr), 1, fp) == 1 && (len == 0 || fwrite(keys, sizeof(uint64_t), len, fp) == len) &&
+             fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+    int err = errno;
+    if (fclose(fp) != 0 && ok) {
+        err = errno;
+        ok = 0;
+    }
+    if (ok && rename(tmp, path) != 0) {
+        err = errno;
+        ok = 0;
+    }
+    if (!ok) {
+        unlink(tmp);
+        errno = err;
+    }
+    free(tmp);
+    return ok ? 0 : -1;
+}
+
+const uint64_t* cachetrace_keys(const CacheTrace* trace) {
+    return trace->keys;
+}
+
+size_t cachetrace_len(const CacheTrace* trace) {
+    return trace->len;
+}
+
+int cachetrace_mapped(const CacheTrace* trace) {
+    return trace->map != NULL;
+}
@@ -0,0 +1,62 @@
+#ifndef CACHETRACE_H
+#define CACHETRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ 缓存访问序列（trace）：每次访问是一个 64 位的键编号，用于离线重放到各种淘汰策略上比较命中率
+ （1）文本格式：每行一次访问，取行首第一个由空白分隔的字段作为键（之后的字段忽略，可以是操作名、大小等），
+      空行与 # 开头的行跳过；键按字节串用 xxHash64（种子 CACHETRACE_TEXT_SEED）映射为编号，
+      不同的键映射到同一编号的概率可以忽略（10^6 个不同的键约 3 × 10^-8）
+ （2）二进制格式：32 字节文件头 + 每次访问 8 字节的键编号（按本机字节序），同样的访问序列比文本小几倍，
+      打开时只做映射，键数组直接指向映射：不读入内存，可以重放比内存大的 trace（页面由页缓存换入换出）
+ （3）打开时按文件头的 magic 自动识别格式；文本 trace 也是映射后解析，编号放在 malloc 的数组里，
+      可以用 cachetrace_write 转成二进制，之后直接映射
+*/
+
+#define CACHETRACE_MAGIC "CACHETR"
+#define CACHETRACE_VERSION 1
+#define CACHETRACE_TEXT_SEED 0
+
+typedef struct CacheTrace CacheTrace;
+
+/**
+* @brief             打开 trace 文件，按文件头识别二进制格式，否则按文本解析
+* @return            成功返回句柄；文件不存在、二进制文件头损坏或被截断、内存不足返回NULL
+* @note              空的文本文件得到长度为 0 的 trace
+*/
+CacheTrace* cachetrace_open(const char* path);
+
+// 解除映射并释放，trace 为NULL时不做任何事
+void cachetrace_close(CacheTrace* trace);
+
+/**
+* @brief             按文本格式解析一段内存中的 trace
+* @param keys_out    输出 malloc 分配的键编号数组（长度为 0 时也可能为NULL），由调用者 free
+* @return            访问次数，内存不足返回 (size_t)-1
+*/
+size_t cachetrace_parse_text(const char* text, size_t len, uint64_t** keys_out);
+
+/**
+* @brief             写成二进制格式：先写 path.tmp，fsync 后 rename 为 path
+* @return            成功返回0，I/O 失败返回 -1（errno 为失败原因）
+*/
+int cachetrace_write(const char* path, const uint64_t* keys, size_t len);
+
+// 键编号数组（二进制格式时指向映射，关闭前有效）
+const uint64_t* cachetrace_keys(const CacheTrace* trace);
+// 访问次数
+size_t cachetrace_len(const CacheTrace* trace);
+// 是否为直接映射的二进制 trace
+int cachetrace_mapped(const CacheTrace* trace);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CACHETRACE_H
@@ -0,0 +1,128 @@
+#include "freqsketch.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ 实现要点
+ （1）第 r 行的计数器下标用双重哈希得到：(a + r * b) 的高位，a、b 由键的哈希值再混合一次得到，
+      4 行的下标近似独立；第 r 行第 j 个计数器在 words[r * width / 16 + j / 16] 的第 (j % 16) * 4 位
+ （2）老化：每个字右移 1 位后与 0x7777... 相与，16 个计数器同时减半；
+      additions 也减半，下一次老化在又增加 sample_size / 2 次之后
+*/
+
+#define FREQSKETCH_DEPTH 4
+
+struct FreqSketch {
+    uint64_t* words;
+    size_t width;               // 每行的计数器数，2 的幂
+    unsigned width_bits;
+    size_t additions;           // 上次老化以来增加的次数（老化后减半）
+    size_t sample_size;
+    uint64_t agings;
+};
+
+static inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// 4 行各自的计数器下标（行内编号）
+static inline void counter_index(const FreqSketch* s, uint64_t hash, size_t idx[FREQSKETCH_DEPTH]) {
+    uint64_t a = mix64(hash);
+    uint64_t b = mix64(hash ^ 0x9e3779b97f4a7c15ULL) | 1;
+    for (int r = 0; r < FREQSKETCH_DEPTH; r++) {
+        idx[r] = (size_t)((a + (uint64_t)r * b) >> (64 - s->width_bits));
+    }
+}
+
+static inline uint32_t counter_get(const FreqSketch* s, int r, size_t j) {
+    uint64_t w = s->words[((size_t)r * s->width + j) / 16];
+    return (uint32_t)(w >> ((j & 15) * 4)) & 0xf;
+}
+
+FreqSketch* freqsketch_create(size_t expected) {
+    FreqSketch* s = (FreqSketch*)calloc(1, sizeof(FreqSketch));
+    if (s == NULL) {
+        return NULL;
+    }
+    s->width = 64;
+    s->width_bits = 6;
+    while (s->width < 4 * expected && s->width_bits < 40) {
+        s->width *= 2;
+        s->width_bits++;
+    }
+    s->sample_size = 10 * (expected > 16 ? expected : 16);
+    s->words = (uint64_t*)calloc(FREQSKETCH_DEPTH * s->width / 16, sizeof(uint64_t));
+    if (s->words == NULL) {
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+void freqsketch_free(FreqSketch* sketch) {
+    if (sketch == NULL) {
+        return;
+    }
+    free(sketch->words);
+    free(sketch);
+}
+
+static void age(FreqSketch* s) {
+    size_t n = FREQSKETCH_DEPTH * s->width / 16;
+    for (size_t i = 0; i < n; i++) {
+        s->words[i] = (s->words[i] >> 1) & 0x7777777777777777ULL;
+    }
+    s->additions /= 2;
+    s->agings++;
+}
+
+void freqsketch_add(FreqSketch* sketch, uint64_t hash) {
+    size_t idx[FREQSKETCH_DEPTH];
+    counter_index(sketch, hash, idx);
+    uint32_t min = FREQSKETCH_MAX;
+    for (int r = 0; r < FREQSKETCH_DEPTH; r++) {
+        uint32_t v = counter_get(sketch, r, idx[r]);
+        min = v < min ? v : min;
+    }
+    if (min == FREQSKETCH_MAX) {
+        return;
+    }
+    // 保守更新：只增加等于最小值的计数器
+    for (int r = 0; r < FREQSKETCH_DEPTH; r++) {
+        if (counter_get(sketch, r, idx[r]) == min) {
+            sketch->words[((size_t)r * sketch->width + idx[r]) / 16] += (uint64_t)1 << ((idx[r] & 15) * 4);
+        }
+    }
+    if (++sketch->additions >= sketch->sample_size) {
+        age(sketch);
+    }
+}
+
+uint32_t freqsketch_estimate(const FreqSketch* sketch, uint64_t hash) {
+    size_t idx[FREQSKETCH_DEPTH];
+    counter_index(sketch, hash, idx);
+    uint32_t min = FREQSKETCH_MAX;
+    for (int r = 0; r < FREQSKETCH_DEPTH; r++) {
+        uint32_t v = counter_get(sketch, r, idx[r]);
+        min = v < min ? v : min;
+    }
+    return min;
+}
+
+void freqsketch_clear(FreqSketch* sketch) {
+    memset(sketch->words, 0, FREQSKETCH_DEPTH * sketch->width / 16 * sizeof(uint64_t));
+    sketch->additions = 0;
+}
+
+size_t freqsketch_memory(const FreqSketch* sketch) {
+    return FREQSKETCH_DEPTH * sketch->width / 16 * sizeof(uint64_t);
+}
+
+uint64_t freqsketch_agings(const FreqSketch* sketch) {
+    return sketch->agings;
+}
@@ -0,0 +1,56 @@
+#ifndef FREQSKETCH_H
+#define FREQSKETCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ 访问频率估计：count-min sketch，用于缓存的准入判断（W-TinyLFU）
+ （1）4 行计数器，每行 width 个 4 位计数器（width 为 2 的幂，不少于预计键数的 4 倍），16 个计数器打包在一个 64 位字里；
+      键按哈希值在每行选一个计数器，估计值取 4 个计数器的最小值（只会高估，不会低估）
+ （2）保守更新（conservative update）：加 1 时只增加等于最小值的那些计数器，减少与其他键冲突带来的高估
+ （3）计数器最大为 15；累计增加 sample_size（10 × 预计键数）次后，全部计数器减半（老化），
+      过去的热点逐渐冷却，估计值反映的是最近一段时间的频率
+*/
+
+typedef struct FreqSketch FreqSketch;
+
+// 计数器的最大值
+#define FREQSKETCH_MAX 15
+
+/**
+* @brief             创建频率估计器
+* @param expected    预计同时关注的键数（一般为缓存容量）；每行计数器数为它的 4 倍向上取整为 2 的幂，至少 64，
+*                    每个键约占 8 字节
+* @return            成功返回估计器，内存不足返回NULL
+*/
+FreqSketch* freqsketch_create(size_t expected);
+
+void freqsketch_free(FreqSketch* sketch);
+
+/**
+* @brief             记录一次访问
+* @param hash        键的 64 位哈希值
+*/
+void freqsketch_add(FreqSketch* sketch, uint64_t hash);
+
+// 估计访问次数，0 ~ FREQSKETCH_MAX
+uint32_t freqsketch_estimate(const FreqSketch* sketch, uint64_t hash);
+
+// 计数器全部清零
+void freqsketch_clear(FreqSketch* sketch);
+
+// 计数器占用的字节数
+size_t freqsketch_memory(const FreqSketch* sketch);
+// 已经老化（全部减半）的次数
+uint64_t freqsketch_agings(const FreqSketch* sketch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FREQSKETCH_H
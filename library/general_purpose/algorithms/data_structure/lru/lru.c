@@ -0,0 +1,455 @@
+#include "lru_impl.h"
+#include "hasht_group.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/*
+ 实现要点
+ （1）节点：头部（前驱、后继、所在的索引槽位、键长，各 32 位）+ 键（max_key_size 字节）+ 值，
+      连续存放在 slab 里；未使用的节点用 next 串成空闲链表
+ （2）链表头为最近使用，尾为最久未使用；命中时把节点移到头部，只改几个下标
+ （3）索引：控制字节 + 节点下标数组，探测与 hasht.c 相同（三角数探测组、空组停止探测）；
+      节点记录自己所在的槽位，淘汰与删除时不需要重新计算哈希值找槽位
+ （4）删除时所在组还有空槽位则直接置空，否则留墓碑；槽位数至少为容量的 2 倍，墓碑很少，
+      已占用 + 墓碑的槽位占到 7/8 时原地重建索引（遍历链表重新插入，不分配内存）
+ （5）CLOCK 策略不用链表（prev / next 不维护）：meta[i] 为节点 i 的访问位，命中只置 1；
+      空闲链表为空（已满）时才淘汰，此时所有节点都在用，指针 hand 从上次停下的位置扫描，
+      访问位为 1 的清零跳过，第一个为 0 的就是被淘汰的节点；新插入的节点访问位为 0
+      （指针要转一整圈才回到它，相当于已经给了一次机会）
+ （6）2Q、ARC、W-TinyLFU 在 lru_policy.c：节点按 meta[i] 分在 lists[] 的几个链表里，
+      本文件只负责索引与节点，在命中、插入新键、删除时调用 policy_* 维护队列
+ （7）容量大时节点与索引有几十 MB，随机访问的耗时主要花在 TLB 未命中上：2 MiB 以上的数组按 2 MiB 对齐分配
+      并提示内核使用透明大页（MADV_HUGEPAGE），10^6 个节点时命中查找快约一倍
+*/
+
+#define LRU_HUGE_PAGE ((size_t)2 << 20)
+
+static inline size_t round_up(size_t x, size_t a) {
+    return (x + a - 1) / a * a;
+}
+
+static inline size_t value_align(size_t size) {
+    return size >= 8 ? 8 : (size >= 4 ? 4 : (size >= 2 ? 2 : 1));
+}
+
+// 标记为最近使用，h 为键的哈希值（只有 W-TinyLFU 用到）
+static inline void mark_used(LRUCache* c, uint32_t i, uint64_t h) {
+    if (c->policy == LRU_POLICY_LRU) {
+        move_to_front(c, &c->lists[0], i);
+    } else if (c->policy == LRU_POLICY_CLOCK) {
+        c->meta[i] = 1;
+    } else {
+        policy_hit(c, i, h);
+    }
+}
+
+// 插入新键之前调用：已满时选出被淘汰的节点并从队列中摘下（CLOCK 不维护链表），未满时返回 LRU_NIL
+static uint32_t pick_victim(LRUCache* c, uint64_t h) {
+    if (c->policy >= LRU_POLICY_2Q) {
+        return policy_miss(c, h);
+    }
+    if (c->free_list != LRU_NIL) {
+        return LRU_NIL;
+    }
+    if (c->policy == LRU_POLICY_LRU) {
+        uint32_t i = c->lists[0].tail;
+        list_unlink(c, &c->lists[0], i);
+        return i;
+    }
+    size_t hand = c->hand;
+    while (c->meta[hand] != 0) {
+        c->meta[hand] = 0;
+        hand = hand + 1 < c->capacity ? hand + 1 : 0;
+    }
+    c->hand = hand + 1 < c->capacity ? hand + 1 : 0;
+    return (uint32_t)hand;
+}
+
+// 索引操作
+static uint32_t index_find(const LRUCache* c, const void* key, size_t key_len, uint64_t h) {
+    uint8_t h2 = hash_h2(h);
+    size_t g = hash_h1(h) & c->group_mask;
+    // 槽位的地址不依赖控制字节，与控制字节的读取并行取入缓存
+    __builtin_prefetch(c->slots + g * HASHT_GROUP_WIDTH);
+    for (size_t step = 0; step <= c->group_mask; step++) {
+        const uint8_t* group = c->ctrl + g * HASHT_GROUP_WIDTH;
+        uint32_t m = group_match(group, h2);
+        while (m != 0) {
+            uint32_t i = c->slots[g * HASHT_GROUP_WIDTH + (size_t)__builtin_ctz(m)];
+            NodeHeader* n = node_at(c, i);
+            if (n->key_len == key_len && memcmp(node_key(n), key, key_len) == 0) {
+                return i;
+            }
+            m &= m - 1;
+        }
+        if (group_match_empty(group) != 0) {
+            break;
+        }
+        g = (g + step + 1) & c->group_mask;
+    }
+    return LRU_NIL;
+}
+
+static void index_insert_at(LRUCache* c, uint32_t i, uint64_t h) {
+    size_t g = hash_h1(h) & c->group_mask;
+    for (size_t step = 0;; step++) {
+        uint32_t m = group_match_free(c->ctrl + g * HASHT_GROUP_WIDTH);
+        if (m != 0) {
+            size_t s = g * HASHT_GROUP_WIDTH + (size_t)__builtin_ctz(m);
+            c->index_used += c->ctrl[s] == HASHT_EMPTY;
+            c->ctrl[s] = hash_h2(h);
+            c->slots[s] = i;
+            node_at(c, i)->slot = (uint32_t)s;
+            return;
+        }
+        g = (g + step + 1) & c->group_mask;
+    }
+}
+
+// 原地重建：清空控制字节，把在用的节点（slot 不为 LRU_NIL）重新插入（重新计算哈希值）
+static void index_rebuild(LRUCache* c) {
+    memset(c->ctrl, HASHT_EMPTY, c->index_capacity);
+    c->index_used = 0;
+    for (size_t i = 0; i < c->capacity; i++) {
+        NodeHeader* n = node_at(c, (uint32_t)i);
+        if (n->slot != LRU_NIL) {
+            index_insert_at(c, (uint32_t)i, c->hash(node_key(n), n->key_len, c->seed));
+        }
+    }
+}
+
+static inline void index_insert(LRUCache* c, uint32_t i, uint64_t h) {
+    if (c->index_used >= c->index_limit) {
+        index_rebuild(c);
+    }
+    index_insert_at(c, i, h);
+}
+
+static inline void index_erase(LRUCache* c, uint32_t i) {
+    size_t s = node_at(c, i)->slot;
+    if (group_match_empty(c->ctrl + (s & ~(size_t)(HASHT_GROUP_WIDTH - 1))) != 0) {
+        c->ctrl[s] = HASHT_EMPTY;
+        c->index_used--;
+    } else {
+        c->ctrl[s] = HASHT_DELETED;
+    }
+}
+
+// 分配创建时就确定大小的数组（16 字节对齐），大数组尽量使用透明大页；用 free 释放
+static void* array_alloc(size_t bytes) {
+    if (bytes > SIZE_MAX - LRU_HUGE_PAGE) {
+        return NULL;
+    }
+    if (bytes < LRU_HUGE_PAGE) {
+        return aligned_alloc(HASHT_GROUP_WIDTH, round_up(bytes, HASHT_GROUP_WIDTH));
+    }
+    bytes = round_up(bytes, LRU_HUGE_PAGE);
+    void* p = aligned_alloc(LRU_HUGE_PAGE, bytes);
+#ifdef MADV_HUGEPAGE
+    if (p != NULL) {
+        madvise(p, bytes, MADV_HUGEPAGE);
+    }
+#endif
+    return p;
+}
+
+// 全部节点放回空闲链表，索引清空
+static void reset(LRUCache* c) {
+    for (size_t i = 0; i < c->capacity; i++) {
+        NodeHeader* n = node_at(c, (uint32_t)i);
+        n->next = i + 1 < c->capacity ? (uint32_t)(i + 1) : LRU_NIL;
+        n->slot = LRU_NIL;
+    }
+    c->free_list = 0;
+    for (int l = 0; l < LRU_MAX_LISTS; l++) {
+        c->lists[l].head = LRU_NIL;
+        c->lists[l].tail = LRU_NIL;
+        c->lists[l].size = 0;
+    }
+    c->size = 0;
+    c->hand = 0;
+    if (c->meta != NULL) {
+        memset(c->meta, 0, c->capacity);
+    }
+    memset(c->ctrl, HASHT_EMPTY, c->index_capacity);
+    c->index_used = 0;
+    if (c->policy >= LRU_POLICY_2Q) {
+        policy_reset(c);
+    }
+}
+
+LRUCache* lru_create(const LRUConfig* cfg) {
+    // value_size 限制在 SIZE_MAX / 2 以内，下面计算节点大小时不会回绕
+    if (cfg == NULL || cfg->capacity == 0 || cfg->capacity >= LRU_NIL || cfg->max_key_size == 0 ||
+        cfg->max_key_size > UINT32_MAX || cfg->value_size > SIZE_MAX / 2 ||
+        (unsigned)cfg->policy >= LRU_POLICY_COUNT) {
+        return NULL;
+    }
+    LRUCache* c = (LRUCache*)calloc(1, sizeof(LRUCache));
+    if (c == NULL) {
+        return NULL;
+    }
+    c->capacity = cfg->capacity;
+    c->max_key_size = cfg->max_key_size;
+    c->value_size = cfg->value_size;
+    size_t va = cfg->value_size != 0 ? value_align(cfg->value_size) : 1;
+    size_t align = va > 4 ? va : 4;
+    c->value_offset = round_up(sizeof(NodeHeader) + cfg->max_key_size, va);
+    c->node_size = round_up(c->value_offset + cfg->value_size, align);
+    // 没有值时 "值的地址" 即键的地址
+    if (cfg->value_size == 0) {
+        c->value_offset = sizeof(NodeHeader);
+    }
+    c->hash = cfg->hash != NULL ? cfg->hash : xxHash64;
+    c->seed = cfg->seed;
+    c->on_evict = cfg->on_evict;
+    c->evict_ctx = cfg->evict_ctx;
+    c->policy = cfg->policy;
+
+    c->index_capacity = HASHT_GROUP_WIDTH;
+    while (c->index_capacity < 2 * cfg->capacity) {
+        c->index_capacity *= 2;
+    }
+    c->group_mask = c->index_capacity / HASHT_GROUP_WIDTH - 1;
+    c->index_limit = c->index_capacity - c->index_capacity / 8;
+
+    // 节点数组与索引的字节数不能溢出，否则会分配到过小的内存
+    if (c->node_size > SIZE_MAX / c->capacity || c->index_capacity > SIZE_MAX / sizeof(uint32_t)) {
+        lru_free(c);
+        return NULL;
+    }
+    c->slab = (uint8_t*)array_alloc(c->capacity * c->node_size);
+    c->ctrl = (uint8_t*)array_alloc(c->index_capacity);
+    c->slots = (uint32_t*)array_alloc(c->index_capacity * sizeof(uint32_t));
+    if (c->policy != LRU_POLICY_LRU) {
+        c->meta = (uint8_t*)array_alloc(c->capacity);
+    }
+    if (c->slab == NULL || c->ctrl == NULL || c->slots == NULL || (c->policy != LRU_POLICY_LRU && c->meta == NULL) ||
+        (c->policy >= LRU_POLICY_2Q && policy_init(c) != 0)) {
+        lru_free(c);
+        return NULL;
+    }
+    reset(c);
+    return c;
+}
+
+void lru_free(LRUCache* cache) {
+    if (cache == NULL) {
+        return;
+    }
+    free(cache->slab);
+    free(cache->ctrl);
+    free(cache->slots);
+    free(cache->meta);
+    if (cache->policy >= LRU_POLICY_2Q) {
+        policy_free(cache);
+    }
+    free(cache);
+}
+
+void* lru_get_ref(LRUCache* cache, const void* key, size_t key_len) {
+    uint64_t h = cache->hash(key, key_len, cache->seed);
+    uint32_t i = index_find(cache, key, key_len, h);
+    if (i == LRU_NIL) {
+        cache->stats.misses++;
+        return NULL;
+    }
+    cache->stats.hits++;
+    mark_used(cache, i, h);
+    return node_value(cache, node_at(cache, i));
+}
+
+int lru_get(LRUCache* cache, const void* key, size_t key_len, void* value_out) {
+    void* v = lru_get_ref(cache, key, key_len);
+    if (v == NULL) {
+        return -1;
+    }
+    if (value_out != NULL && cache->value_size != 0) {
+        memcpy(value_out, v, cache->value_size);
+    }
+    return 0;
+}
+
+const void* lru_peek(const LRUCache* cache, const void* key, size_t key_len) {
+    uint32_t i = index_find(cache, key, key_len, cache->hash(key, key_len, cache->seed));
+    return i == LRU_NIL ? NULL : node_value(cache, node_at(cache, i));
+}
+
+const void* lru_find(const LRUCache* cache, const void* key, size_t key_len, uint32_t* node) {
+    uint32_t i = index_find(cache, key, key_len, cache->hash(key, key_len, cache->seed));
+    if (i == LRU_NIL) {
+        return NULL;
+    }
+    if (node != NULL) {
+        *node = i;
+    }
+    return node_value(cache, node_at(cache, i));
+}
+
+void lru_touch(LRUCache* cache, uint32_t node) {
+    if (node < cache->capacity && node_at(cache, node)->slot != LRU_NIL) {
+        // 只有 W-TinyLFU 需要哈希值（记入频率估计）
+        mark_used(cache, node, cache->policy == LRU_POLICY_WTINYLFU ? node_hash(cache, node) : 0);
+    }
+}
+
+static inline void store_value(LRUCache* c, NodeHeader* n, const void* value) {
+    if (c->value_size == 0) {
+        return;
+    }
+    if (value != NULL) {
+        memcpy(node_value(c, n), value, c->value_size);
+    } else {
+        memset(node_value(c, n), 0, c->value_size);
+    }
+}
+
+int lru_put(LRUCache* cache, const void* key, size_t key_len, const void* value) {
+    if (key_len > cache->max_key_size) {
+        return -1;
+    }
+    uint64_t h = cache->hash(key, key_len, cache->seed);
+    uint32_t i = index_find(cache, key, key_len, h);
+    if (i != LRU_NIL) {
+        store_value(cache, node_at(cache, i), value);
+        mark_used(cache, i, h);
+        return 0;
+    }
+
+    i = pick_victim(cache, h);
+    if (i == LRU_NIL) {
+        i = cache->free_list;
+        cache->free_list = node_at(cache, i)->next;
+        cache->size++;
+    } else {
+        // 已满：复用被淘汰的节点
+        NodeHeader* victim = node_at(cache, i);
+        index_erase(cache, i);
+        cache->stats.evictions++;
+        if (cache->on_evict != NULL) {
+            cache->on_evict(node_key(victim), victim->key_len, node_value(cache, victim), cache->evict_ctx);
+        }
+    }
+    NodeHeader* n = node_at(cache, i);
+    n->key_len = (uint32_t)key_len;
+    memcpy(node_key(n), key, key_len);
+    store_value(cache, n, value);
+    // 插入索引前 slot 为 LRU_NIL：索引需要重建时只重新插入在用的节点，新节点由 index_insert_at 插入
+    n->slot = LRU_NIL;
+    index_insert(cache, i, h);
+    if (cache->policy == LRU_POLICY_LRU) {
+        list_push_front(cache, &cache->lists[0], i);
+    } else if (cache->policy == LRU_POLICY_CLOCK) {
+        cache->meta[i] = 0;
+    } else {
+        policy_insert(cache, i);
+    }
+    return 1;
+}
+
+int lru_remove(LRUCache* cache, const void* key, size_t key_len, void* value_out) {
+    uint32_t i = index_find(cache, key, key_len, cache->hash(key, key_len, cache->seed));
+    if (i == LRU_NIL) {
+        return -1;
+    }
+    NodeHeader* n = node_at(cache, i);
+    if (value_out != NULL && cache->value_size != 0) {
+        memcpy(value_out, node_value(cache, n), cache->value_size);
+    }
+    index_erase(cache, i);
+    if (cache->policy == LRU_POLICY_LRU) {
+        list_unlink(cache, &cache->lists[0], i);
+    } else if (cache->policy >= LRU_POLICY_2Q) {
+        policy_remove(cache, i);
+    }
+    n->slot = LRU_NIL;
+    n->next = cache->free_list;
+    cache->free_list = i;
+    cache->size--;
+    return 0;
+}
+
+void lru_clear(LRUCache* cache) {
+    reset(cache);
+}
+
+int lru_next(const LRUCache* cache, size_t* iter, const void** key, size_t* key_len, const void** value) {
+    NodeHeader* n;
+    if (cache->policy != LRU_POLICY_LRU) {
+        // *iter 为下一个要检查的节点下标，跳过空闲节点
+        size_t i = *iter;
+        while (i < cache->capacity && node_at(cache, (uint32_t)i)->slot == LRU_NIL) {
+            i++;
+        }
+        if (i >= cache->capacity) {
+            *iter = cache->capacity;
+            return 0;
+        }
+        n = node_at(cache, (uint32_t)i);
+        *iter = i + 1;
+    } else {
+        // *iter 为 0 表示从头开始，否则为 下一个节点下标 + 1，LRU_NIL + 1 表示结束
+        uint32_t i = *iter == 0 ? cache->lists[0].head : (uint32_t)(*iter - 1);
+        if (i == LRU_NIL) {
+            *iter = (size_t)LRU_NIL + 1;
+            return 0;
+        }
+        n = node_at(cache, i);
+        *iter = (size_t)n->next + 1;
+    }
+    if (key != NULL) {
+        *key = node_key(n);
+    }
+    if (key_len != NULL) {
+        *key_len = n->key_len;
+    }
+    if (value != NULL) {
+        *value = node_value(cache, n);
+    }
+    return 1;
+}
+
+size_t lru_size(const LRUCache* cache) {
+    return cache->size;
+}
+
+size_t lru_capacity(const LRUCache* cache) {
+    return cache->capacity;
+}
+
+LRUPolicy lru_policy(const LRUCache* cache) {
+    return cache->policy;
+}
+
+const char* lru_policy_name(LRUPolicy policy) {
+    static const char* const names[LRU_POLICY_COUNT] = {"LRU", "CLOCK", "2Q", "ARC", "W-TinyLFU"};
+    return (unsigned)policy < LRU_POLICY_COUNT ? names[policy] : "unknown";
+}
+
+void lru_get_stats(const LRUCache* cache, LRUStats* stats) {
+    *stats = cache->stats;
+}
+
+void lru_reset_stats(LRUCache* cache) {
+    memset(&cache->stats, 0, sizeof(cache->stats));
+}
+
+double lru_hit_ratio(const LRUCache* cache) {
+    uint64_t total = cache->stats.hits + cache->stats.misses;
+    return total != 0 ? (double)cache->stats.hits / (double)total : 0.0;
+}
+
+size_t lru_memory(const LRUCache* cache) {
+    size_t bytes = cache->capacity * cache->node_size + cache->index_capacity * (1 + sizeof(uint32_t)) +
+                   (cache->meta != NULL ? cache->capacity : 0);
+    for (int g = 0; g < 2; g++) {
+        if (cache->ghosts[g] != NULL) {
+            bytes += lru_memory(cache->ghosts[g]);
+        }
+    }
+    if (cache->sketch != NULL) {
+        bytes += freqsketch_memory(cache->sketch);
+    }
+    return bytes;
+}
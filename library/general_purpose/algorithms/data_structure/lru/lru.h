@@ -0,0 +1,154 @@
+#ifndef LRU_H
+#define LRU_H
+
+#include "hashalg.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ LRU 缓存：容量固定，满了以后插入新键时淘汰最久未使用的键
+ （1）键为任意字节串（长度不超过 max_key_size），值为定长的二进制块，都按值拷贝存放在节点里
+ （2）节点在创建时按容量一次分配（slab），双向链表用 32 位节点下标串起来；淘汰时直接复用被淘汰的节点，
+      创建之后的查找、插入、淘汰、删除都不调用 malloc / free
+ （3）索引是内嵌的开放寻址表（与 hasht 相同的 16 槽位分组 + SSE2 控制字节），槽位只存节点下标，
+      槽位数为容量的 2 倍以上（2 的幂），同样在创建时分配
+ （4）淘汰策略可选：精确的 LRU（命中时把节点移到链表头，要改前后节点的指针），
+      或 CLOCK（second chance：每个节点在一个平坦数组里有一个访问位，命中只置位；
+      淘汰时指针循环扫过节点，访问位为 1 的清零并跳过，淘汰第一个为 0 的），命中率接近 LRU，命中只写一个字节
+ （5）抗扫描的策略：只访问一次的键（如一次性的顺序扫描）不会把反复访问的键挤出去
+      - 2Q：新键先进 FIFO 队列 A1in（容量的 1/4），被挤出后只留键的哈希值在 A1out（容量的 1/2）；
+        在 A1out 中再次出现才进入 LRU 队列 Am
+      - ARC：T1（只访问过一次）与 T2（至少两次）两个 LRU 队列，各有一个只存哈希值的影子队列 B1、B2；
+        命中影子队列时调整 T1 的目标大小 p，在 "最近" 与 "频繁" 之间自适应
+      - W-TinyLFU：1% 的窗口 LRU 接纳新键，其余为分段 LRU（试用段 20% + 保护段 80%）；
+        窗口挤出的候选者与试用段尾部的键比较 count-min sketch 估计的访问频率（freqsketch.h，定期老化），
+        频率更高的才留下
+      影子队列与频率估计器同样在创建时分配，创建之后仍然不分配内存
+*/
+
+// 淘汰策略
+typedef enum {
+    LRU_POLICY_LRU,             // 精确 LRU：双向链表
+    LRU_POLICY_CLOCK,           // CLOCK / second chance：访问位 + 循环指针
+    LRU_POLICY_2Q,              // 2Q：FIFO 的 A1in + 影子 A1out + LRU 的 Am
+    LRU_POLICY_ARC,             // ARC：T1 / T2 + 影子 B1 / B2，自适应
+    LRU_POLICY_WTINYLFU,        // W-TinyLFU：窗口 LRU + 频率准入 + 分段 LRU
+    LRU_POLICY_COUNT
+} LRUPolicy;
+
+// 淘汰回调：put 淘汰最久未使用的键时调用，key / value 在回调返回后被新键覆盖
+typedef void (*lru_evict_fn)(const void* key, size_t key_len, void* value, void* ctx);
+
+typedef struct {
+    size_t capacity;            // 最多缓存的键数，1 ~ UINT32_MAX - 1
+    size_t max_key_size;        // 键的最大字节数，> 0；每个节点按它预留空间
+    size_t value_size;          // 值的字节数，可以为 0（当作集合使用）
+    hash64_fn hash;             // 为NULL时使用 xxHash64
+    uint64_t seed;              // 传给哈希函数的种子
+    lru_evict_fn on_evict;      // 可以为NULL
+    void* evict_ctx;            // 传给 on_evict
+    LRUPolicy policy;           // 淘汰策略，默认（0）为 LRU_POLICY_LRU
+} LRUConfig;
+
+typedef struct LRUCache LRUCache;
+
+// 统计：hits / misses 由 lru_get、lru_get_ref 计数（lru_peek、lru_find 不计）
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;         // put 时因为已满淘汰的键数
+    uint64_t rejections;        // W-TinyLFU：窗口挤出的候选者因频率不够被淘汰的次数（也计入 evictions）
+} LRUStats;
+
+/**
+* @brief             创建 LRU 缓存，按容量分配全部节点与索引
+* @param cfg         配置，创建后可以释放
+* @return            成功返回缓存；capacity、max_key_size 为 0、容量超限、节点总大小溢出、策略不合法或内存不足返回NULL
+*/
+LRUCache* lru_create(const LRUConfig* cfg);
+
+/**
+* @brief             销毁缓存，cache 为NULL时不做任何事（不调用淘汰回调）
+*/
+void lru_free(LRUCache* cache);
+
+/*
+ 以下 "标记为最近使用"：LRU 策略为移到链表头，CLOCK 策略为设置访问位，其他策略按各自的命中规则处理
+*/
+
+/**
+* @brief             查找并标记为最近使用
+* @param value_out   不为NULL时拷贝出值
+* @return            找到返回0，不存在返回 -1
+*/
+int lru_get(LRUCache* cache, const void* key, size_t key_len, void* value_out);
+
+/**
+* @brief             查找并标记为最近使用，返回值在节点中的地址，用于原地读写
+* @return            值的地址，不存在返回NULL；value_size 为 0 时返回键的地址
+* @note              地址在下一次 put / remove / clear 之前有效（节点可能被淘汰复用）
+*/
+void* lru_get_ref(LRUCache* cache, const void* key, size_t key_len);
+
+// 查找但不改变使用顺序
+const void* lru_peek(const LRUCache* cache, const void* key, size_t key_len);
+
+/**
+* @brief             查找但不改变使用顺序，并取出节点编号；之后可以用 lru_touch 补记这次使用
+*                    （并发封装在读锁下查找，把节点编号攒起来，拿到写锁后批量更新顺序）
+* @param node        不为NULL时写入节点编号，未找到时不修改
+* @return            值的地址，不存在返回NULL
+*/
+const void* lru_find(const LRUCache* cache, const void* key, size_t key_len, uint32_t* node);
+
+/**
+* @brief             把 lru_find 取到的节点标记为最近使用；节点已被删除时不做任何事
+* @note              节点若已被淘汰并复用给别的键，标记的是新键：只影响淘汰顺序，不影响查找结果
+*/
+void lru_touch(LRUCache* cache, uint32_t node);
+
+/**
+* @brief             插入或更新，并标记为最近使用；已满时先按策略淘汰一个键（LRU 为最久未使用的键）
+* @param value       值，为NULL时值清零
+* @return            新插入返回 1，键已存在（值被替换）返回0，键长超过 max_key_size 返回 -1
+*/
+int lru_put(LRUCache* cache, const void* key, size_t key_len, const void* value);
+
+/**
+* @brief             删除
+* @param value_out   不为NULL时拷贝出被删除的值
+* @return            删除成功返回0，键不存在返回 -1
+*/
+int lru_remove(LRUCache* cache, const void* key, size_t key_len, void* value_out);
+
+// 删除全部键（不调用淘汰回调），影子队列与频率估计一并清空，统计不变
+void lru_clear(LRUCache* cache);
+
+/**
+* @brief             遍历：*iter 初始为 0；LRU 策略从最近使用到最久未使用，其他策略按节点顺序
+* @return            取到返回 1，遍历结束返回0；遍历过程中不能修改缓存
+*/
+int lru_next(const LRUCache* cache, size_t* iter, const void** key, size_t* key_len, const void** value);
+
+size_t lru_size(const LRUCache* cache);
+size_t lru_capacity(const LRUCache* cache);
+LRUPolicy lru_policy(const LRUCache* cache);
+// 策略的名字，如 "LRU"、"W-TinyLFU"
+const char* lru_policy_name(LRUPolicy policy);
+
+void lru_get_stats(const LRUCache* cache, LRUStats* stats);
+void lru_reset_stats(LRUCache* cache);
+// 命中率 hits / (hits + misses)，没有查找时为 0
+double lru_hit_ratio(const LRUCache* cache);
+// 节点、索引、影子队列与频率估计器占用的字节数（创建时确定，之后不变）
+size_t lru_memory(const LRUCache* cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LRU_H
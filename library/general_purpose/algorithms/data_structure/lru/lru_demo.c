@@ -0,0 +1,73 @@
+#include "lru.h"
+#include <stdio.h>
+#include <string.h>
+
+// 淘汰时打印被淘汰的键
+static void print_evicted(const void* key, size_t key_len, void* value, void* ctx) {
+    (void)value;
+    (void)ctx;
+    if (key_len == sizeof(int)) {
+        int k;
+        memcpy(&k, key, sizeof(k));
+        printf("淘汰 %d\n", k);
+    } else {
+        printf("淘汰 \"%.*s\"\n", (int)key_len, (const char*)key);
+    }
+}
+
+static int get_int(LRUCache* cache, int key) {
+    int value;
+    return lru_get(cache, &key, sizeof(key), &value) == 0 ? value : -1;
+}
+
+static void put_int(LRUCache* cache, int key, int value) {
+    lru_put(cache, &key, sizeof(key), &value);
+}
+
+int main(void) {
+    // 创建容量为2的LRU缓存，键为 int
+    LRUConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.capacity = 2;
+    cfg.max_key_size = sizeof(int);
+    cfg.value_size = sizeof(int);
+    cfg.on_evict = print_evicted;
+    LRUCache* cache = lru_create(&cfg);
+
+    // 测试用例
+    put_int(cache, 1, 1);                   // 缓存是 {1=1}
+    put_int(cache, 2, 2);                   // 缓存是 {1=1, 2=2}
+    printf("%d\n", get_int(cache, 1));      // 返回 1
+    put_int(cache, 3, 3);                   // 删除 key 2，缓存是 {1=1, 3=3}
+    printf("%d\n", get_int(cache, 2));      // 返回 -1 (未找到)
+    put_int(cache, 4, 4);                   // 删除 key 1，缓存是 {4=4, 3=3}
+    printf("%d\n", get_int(cache, 1));      // 返回 -1 (未找到)
+    printf("%d\n", get_int(cache, 3));      // 返回 3
+    printf("%d\n", get_int(cache, 4));      // 返回 4
+    // 不再限于 0 ~ 10000 的键
+    put_int(cache, -7, 7);
+    put_int(cache, 1000000000, 9);
+    printf("%d\n", get_int(cache, -7));     // 返回 7
+    lru_free(cache);
+
+    // 变长字符串键
+    cfg.max_key_size = 32;
+    cache = lru_create(&cfg);
+    const char* words[] = {"apple", "banana", "cherry", "apple", "durian"};
+    for (int i = 0; i < 5; i++) {
+        lru_put(cache, words[i], strlen(words[i]), &i);
+    }
+    size_t iter = 0;
+    const void* key;
+    size_t key_len;
+    const void* value;
+    while (lru_next(cache, &iter, &key, &key_len, &value)) {
+        int v;
+        memcpy(&v, value, sizeof(v));
+        printf("%.*s=%d\n", (int)key_len, (const char*)key, v);    // durian=4、apple=3
+    }
+
+    // 释放缓存
+    lru_free(cache);
+    return 0;
+}
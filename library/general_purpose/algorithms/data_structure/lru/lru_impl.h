@@ -0,0 +1,140 @@
+#ifndef LRU_IMPL_H
+#define LRU_IMPL_H
+
+/*
+ lru.c 与 lru_policy.c 共用的内部结构，不对外安装
+*/
+
+#include "freqsketch.h"
+#include "lru.h"
+#include <string.h>
+
+#define LRU_NIL UINT32_MAX
+
+typedef struct {
+    uint32_t prev;
+    uint32_t next;
+    uint32_t slot;              // 所在的索引槽位，空闲节点为 LRU_NIL
+    uint32_t key_len;
+} NodeHeader;
+
+// 双向链表，头为最近使用
+typedef struct {
+    uint32_t head;              // 空时为 LRU_NIL
+    uint32_t tail;
+    size_t size;
+} LRUList;
+
+// 多队列策略最多的队列数
+#define LRU_MAX_LISTS 3
+
+struct LRUCache {
+    uint8_t* slab;              // capacity 个节点
+    size_t node_size;
+    size_t value_offset;        // 值在节点中的偏移
+    size_t capacity;
+    size_t size;
+    uint32_t free_list;
+    LRUPolicy policy;
+    LRUList lists[LRU_MAX_LISTS];   // LRU 只用 lists[0]，CLOCK 不用
+    uint8_t* meta;              // 每个节点 1 字节：CLOCK 为访问位，多队列策略为所在的队列；LRU 为NULL
+    size_t hand;                // CLOCK 的循环指针
+
+    // 多队列策略的参数与状态（lru_policy.c）
+    LRUCache* ghosts[2];        // 只存键哈希值的影子队列：2Q 的 A1out；ARC 的 B1、B2
+    FreqSketch* sketch;         // W-TinyLFU 的频率估计
+    size_t limits[LRU_MAX_LISTS];   // 2Q：A1in 上限；ARC：limits[0] 为 T1 的目标大小 p；W-TinyLFU：窗口、-、保护段上限
+    uint8_t pending_list;       // policy_miss 决定的新节点所在队列
+
+    uint8_t* ctrl;              // index_capacity 个控制字节，16 字节对齐
+    uint32_t* slots;            // 节点下标
+    size_t index_capacity;
+    size_t group_mask;
+    size_t index_used;          // 已占用 + 墓碑的槽位数
+    size_t index_limit;         // index_used 超过后重建
+
+    size_t max_key_size;
+    size_t value_size;
+    hash64_fn hash;
+    uint64_t seed;
+    lru_evict_fn on_evict;
+    void* evict_ctx;
+    LRUStats stats;
+};
+
+static inline NodeHeader* node_at(const LRUCache* c, uint32_t i) {
+    return (NodeHeader*)(c->slab + (size_t)i * c->node_size);
+}
+
+static inline uint8_t* node_key(NodeHeader* n) {
+    return (uint8_t*)(n + 1);
+}
+
+static inline uint8_t* node_value(const LRUCache* c, NodeHeader* n) {
+    return (uint8_t*)n + c->value_offset;
+}
+
+static inline uint64_t node_hash(const LRUCache* c, uint32_t i) {
+    NodeHeader* n = node_at(c, i);
+    return c->hash(node_key(n), n->key_len, c->seed);
+}
+
+// 链表操作
+static inline void list_unlink(LRUCache* c, LRUList* l, uint32_t i) {
+    NodeHeader* n = node_at(c, i);
+    if (n->prev != LRU_NIL) {
+        node_at(c, n->prev)->next = n->next;
+    } else {
+        l->head = n->next;
+    }
+    if (n->next != LRU_NIL) {
+        node_at(c, n->next)->prev = n->prev;
+    } else {
+        l->tail = n->prev;
+    }
+    l->size--;
+}
+
+static inline void list_push_front(LRUCache* c, LRUList* l, uint32_t i) {
+    NodeHeader* n = node_at(c, i);
+    n->prev = LRU_NIL;
+    n->next = l->head;
+    if (l->head != LRU_NIL) {
+        node_at(c, l->head)->prev = i;
+    } else {
+        l->tail = i;
+    }
+    l->head = i;
+    l->size++;
+}
+
+static inline void move_to_front(LRUCache* c, LRUList* l, uint32_t i) {
+    if (l->head != i) {
+        list_unlink(c, l, i);
+        list_push_front(c, l, i);
+    }
+}
+
+/*
+ 多队列策略（2Q、ARC、W-TinyLFU），lru_policy.c
+*/
+
+// 创建时分配影子队列与频率估计器、计算各队列的上限，失败返回 -1（已分配的由 lru_free 释放）
+int policy_init(LRUCache* c);
+void policy_free(LRUCache* c);
+// lru_clear 时清空队列、影子队列与频率估计
+void policy_reset(LRUCache* c);
+// 命中节点 i（h 为键的哈希值）
+void policy_hit(LRUCache* c, uint32_t i, uint64_t h);
+/**
+* @brief             插入新键（哈希值 h）之前调用：处理影子队列、决定新节点进入的队列（pending_list），
+*                    缓存已满（没有空闲节点）时选出被淘汰的节点并从队列中摘下
+* @return            被淘汰的节点（索引仍指向它，由调用者清除），不需要淘汰时返回 LRU_NIL
+*/
+uint32_t policy_miss(LRUCache* c, uint64_t h);
+// 新节点 i 放入 pending_list 指定的队列
+void policy_insert(LRUCache* c, uint32_t i);
+// 删除节点 i 时从所在队列摘下
+void policy_remove(LRUCache* c, uint32_t i);
+
+#endif // LRU_IMPL_H
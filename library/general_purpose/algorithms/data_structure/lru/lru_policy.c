@@ -0,0 +1,294 @@
+#include "lru_impl.h"
+
+/*
+ 实现要点
+ （1）影子队列是内部的 LRU 缓存（lru.c 本身）：键为 8 字节的键哈希值，值为 0 字节，哈希函数直接取键本身；
+      容量固定，满了以后 put 自动淘汰其中最久的哈希值，创建后同样不分配内存。
+      只存哈希值，不同的键哈希值相同时会被当成同一个键（只影响命中率，不影响正确性）
+ （2）被淘汰的节点的哈希值在淘汰时重新计算（节点里只有键），每次淘汰最多多算一两次哈希
+ （3）2Q（Johnson & Shasha 的完整版）：lists[0] = A1in（FIFO，命中不调整），lists[1] = Am（LRU），
+      ghosts[0] = A1out；已满时 |A1in| > Kin 或 Am 为空则淘汰 A1in 的尾部并把哈希值记入 A1out，否则淘汰 Am 的尾部
+ （4）ARC（Megiddo & Modha）：lists[0] = T1，lists[1] = T2，ghosts[0] = B1，ghosts[1] = B2，limits[0] = p；
+      命中 B1 时 p 增加 max(1, |B2| / |B1|)，命中 B2 时减少 max(1, |B1| / |B2|)（用移出前的大小）；
+      REPLACE 只在已满时进行：|T1| > p（或命中 B2 且 |T1| = p）时淘汰 T1 的尾部进 B1，否则淘汰 T2 的尾部进 B2；
+      都未命中且 |T1| + |B1| 达到容量时，B1 不空则丢掉 B1 最久的哈希值再 REPLACE，否则直接丢掉 T1 的尾部
+ （5）W-TinyLFU（Einziger 等）：lists[0] = 窗口，lists[1] = 试用段，lists[2] = 保护段；
+      命中与插入新键都记入频率估计；已满且窗口已满时窗口尾部的候选者与主区的淘汰对象（试用段尾部，为空时取保护段尾部）
+      比较估计频率，候选者严格更高才进入试用段，否则淘汰候选者（频率相同时保留原来的，抵抗一次性的键）
+*/
+
+#define Q_2Q_A1IN 0
+#define Q_2Q_AM 1
+#define Q_ARC_T1 0
+#define Q_ARC_T2 1
+#define Q_TLFU_WINDOW 0
+#define Q_TLFU_PROBATION 1
+#define Q_TLFU_PROTECTED 2
+
+// 影子队列的键本身就是哈希值
+static uint64_t ghost_hash(const void* key, size_t len, uint64_t seed) {
+    (void)len;
+    (void)seed;
+    uint64_t h;
+    memcpy(&h, key, sizeof(h));
+    return h;
+}
+
+static LRUCache* ghost_create(size_t capacity) {
+    LRUConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.capacity = capacity;
+    cfg.max_key_size = sizeof(uint64_t);
+    cfg.hash = ghost_hash;
+    return lru_create(&cfg);
+}
+
+static inline int ghost_contains(const LRUCache* g, uint64_t h) {
+    return lru_peek(g, &h, sizeof(h)) != NULL;
+}
+
+static inline void ghost_remove(LRUCache* g, uint64_t h) {
+    lru_remove(g, &h, sizeof(h), NULL);
+}
+
+static inline void ghost_add(LRUCache* g, uint64_t h) {
+    lru_put(g, &h, sizeof(h), NULL);
+}
+
+// 丢掉影子队列中最久的哈希值
+static void ghost_drop_oldest(LRUCache* g) {
+    uint32_t i = g->lists[0].tail;
+    if (i != LRU_NIL) {
+        lru_remove(g, node_key(node_at(g, i)), sizeof(uint64_t), NULL);
+    }
+}
+
+// 摘下队列 q 的尾部
+static inline uint32_t pop_tail(LRUCache* c, int q) {
+    uint32_t i = c->lists[q].tail;
+    list_unlink(c, &c->lists[q], i);
+    return i;
+}
+
+static inline void push_front(LRUCache* c, int q, uint32_t i) {
+    c->meta[i] = (uint8_t)q;
+    list_push_front(c, &c->lists[q], i);
+}
+
+static inline size_t max_size(size_t a, size_t b) {
+    return a > b ? a : b;
+}
+
+int policy_init(LRUCache* c) {
+    size_t cap = c->capacity;
+    switch (c->policy) {
+    case LRU_POLICY_2Q:
+        c->limits[0] = max_size(1, cap / 4);
+        c->ghosts[0] = ghost_create(max_size(1, cap / 2));
+        return c->ghosts[0] != NULL ? 0 : -1;
+    case LRU_POLICY_ARC:
+        c->ghosts[0] = ghost_create(cap);
+        c->ghosts[1] = ghost_create(cap);
+        return c->ghosts[0] != NULL && c->ghosts[1] != NULL ? 0 : -1;
+    case LRU_POLICY_WTINYLFU:
+        c->limits[Q_TLFU_WINDOW] = max_size(1, cap / 100);
+        c->limits[Q_TLFU_PROTECTED] = (cap - c->limits[Q_TLFU_WINDOW]) * 4 / 5;
+        c->sketch = freqsketch_create(cap);
+        return c->sketch != NULL ? 0 : -1;
+    default:
+        return 0;
+    }
+}
+
+void policy_free(LRUCache* c) {
+    lru_free(c->ghosts[0]);
+    lru_free(c->ghosts[1]);
+    freqsketch_free(c->sketch);
+}
+
+void policy_reset(LRUCache* c) {
+    for (int g = 0; g < 2; g++) {
+        if (c->ghosts[g] != NULL) {
+            lru_clear(c->ghosts[g]);
+        }
+    }
+    if (c->sketch != NULL) {
+        freqsketch_clear(c->sketch);
+    }
+    if (c->policy == LRU_POLICY_ARC) {
+        c->limits[0] = 0;
+    }
+    c->pending_list = 0;
+}
+
+/*
+ 2Q
+*/
+
+static uint32_t q2_miss(LRUCache* c, uint64_t h) {
+    if (ghost_contains(c->ghosts[0], h)) {
+        ghost_remove(c->ghosts[0], h);
+        c->pending_list = Q_2Q_AM;
+    } else {
+        c->pending_list = Q_2Q_A1IN;
+    }
+    if (c->free_list != LRU_NIL) {
+        return LRU_NIL;
+    }
+    if (c->lists[Q_2Q_A1IN].size > c->limits[0] || c->lists[Q_2Q_AM].size == 0) {
+        uint32_t i = pop_tail(c, Q_2Q_A1IN);
+        ghost_add(c->ghosts[0], node_hash(c, i));
+        return i;
+    }
+    return pop_tail(c, Q_2Q_AM);
+}
+
+/*
+ ARC
+*/
+
+// 已满时按 p 从 T1 或 T2 淘汰一个，哈希值记入对应的影子队列
+static uint32_t arc_replace(LRUCache* c, int in_b2) {
+    size_t t1 = c->lists[Q_ARC_T1].size;
+    size_t p = c->limits[0];
+    if (t1 != 0 && (t1 > p || (in_b2 && t1 == p) || c->lists[Q_ARC_T2].size == 0)) {
+        uint32_t i = pop_tail(c, Q_ARC_T1);
+        ghost_add(c->ghosts[0], node_hash(c, i));
+        return i;
+    }
+    uint32_t i = pop_tail(c, Q_ARC_T2);
+    ghost_add(c->ghosts[1], node_hash(c, i));
+    return i;
+}
+
+static uint32_t arc_miss(LRUCache* c, uint64_t h) {
+    LRUCache* b1 = c->ghosts[0];
+    LRUCache* b2 = c->ghosts[1];
+    int full = c->free_list == LRU_NIL;
+    if (ghost_contains(b1, h)) {
+        size_t delta = max_size(1, b2->size / b1->size);
+        c->limits[0] = c->limits[0] + delta < c->capacity ? c->limits[0] + delta : c->capacity;
+        ghost_remove(b1, h);
+        c->pending_list = Q_ARC_T2;
+        return full ? arc_replace(c, 0) : LRU_NIL;
+    }
+    if (ghost_contains(b2, h)) {
+        size_t delta = max_size(1, b1->size / b2->size);
+        c->limits[0] = c->limits[0] > delta ? c->limits[0] - delta : 0;
+        ghost_remove(b2, h);
+        c->pending_list = Q_ARC_T2;
+        return full ? arc_replace(c, 1) : LRU_NIL;
+    }
+
+    c->pending_list = Q_ARC_T1;
+    size_t t1 = c->lists[Q_ARC_T1].size;
+    if (t1 + b1->size >= c->capacity) {
+        if (t1 < c->capacity) {
+            ghost_drop_oldest(b1);
+            return full ? arc_replace(c, 0) : LRU_NIL;
+        }
+        // B1 为空、T1 占满：直接丢掉 T1 的尾部，不进影子队列
+        return pop_tail(c, Q_ARC_T1);
+    }
+    if (c->size + b1->size + b2->size >= 2 * c->capacity) {
+        ghost_drop_oldest(b2);
+    }
+    return full ? arc_replace(c, 0) : LRU_NIL;
+}
+
+/*
+ W-TinyLFU
+*/
+
+// 主区的淘汰对象：试用段尾部，为空时取保护段尾部；返回所在队列，主区为空返回 -1
+static inline int tlfu_main_victim_queue(const LRUCache* c) {
+    if (c->lists[Q_TLFU_PROBATION].size != 0) {
+        return Q_TLFU_PROBATION;
+    }
+    return c->lists[Q_TLFU_PROTECTED].size != 0 ? Q_TLFU_PROTECTED : -1;
+}
+
+static uint32_t tlfu_miss(LRUCache* c, uint64_t h) {
+    freqsketch_add(c->sketch, h);
+    c->pending_list = Q_TLFU_WINDOW;
+    int window_full = c->lists[Q_TLFU_WINDOW].size >= c->limits[Q_TLFU_WINDOW];
+    if (c->free_list != LRU_NIL) {
+        // 未满：窗口满了就把尾部直接移入试用段
+        if (window_full) {
+            push_front(c, Q_TLFU_PROBATION, pop_tail(c, Q_TLFU_WINDOW));
+        }
+        return LRU_NIL;
+    }
+    int q = tlfu_main_victim_queue(c);
+    if (!window_full) {
+        // 删除造成窗口不满：从主区淘汰（主区为空时只能是窗口）
+        return pop_tail(c, q >= 0 ? q : Q_TLFU_WINDOW);
+    }
+    uint32_t candidate = pop_tail(c, Q_TLFU_WINDOW);
+    if (q < 0) {
+        return candidate;
+    }
+    uint32_t victim = c->lists[q].tail;
+    if (freqsketch_estimate(c->sketch, node_hash(c, candidate)) > freqsketch_estimate(c->sketch, node_hash(c, victim))) {
+        list_unlink(c, &c->lists[q], victim);
+        push_front(c, Q_TLFU_PROBATION, candidate);
+        return victim;
+    }
+    c->stats.rejections++;
+    return candidate;
+}
+
+static void tlfu_hit(LRUCache* c, uint32_t i, uint64_t h) {
+    freqsketch_add(c->sketch, h);
+    int q = c->meta[i];
+    if (q != Q_TLFU_PROBATION) {
+        move_to_front(c, &c->lists[q], i);
+        return;
+    }
+    list_unlink(c, &c->lists[Q_TLFU_PROBATION], i);
+    push_front(c, Q_TLFU_PROTECTED, i);
+    if (c->lists[Q_TLFU_PROTECTED].size > c->limits[Q_TLFU_PROTECTED]) {
+        push_front(c, Q_TLFU_PROBATION, pop_tail(c, Q_TLFU_PROTECTED));
+    }
+}
+
+void policy_hit(LRUCache* c, uint32_t i, uint64_t h) {
+    switch (c->policy) {
+    case LRU_POLICY_2Q:
+        // A1in 是 FIFO，命中不调整
+        if (c->meta[i] == Q_2Q_AM) {
+            move_to_front(c, &c->lists[Q_2Q_AM], i);
+        }
+        break;
+    case LRU_POLICY_ARC:
+        list_unlink(c, &c->lists[c->meta[i]], i);
+        push_front(c, Q_ARC_T2, i);
+        break;
+    case LRU_POLICY_WTINYLFU:
+        tlfu_hit(c, i, h);
+        break;
+    default:
+        break;
+    }
+}
+
+uint32_t policy_miss(LRUCache* c, uint64_t h) {
+    switch (c->policy) {
+    case LRU_POLICY_2Q:
+        return q2_miss(c, h);
+    case LRU_POLICY_ARC:
+        return arc_miss(c, h);
+    case LRU_POLICY_WTINYLFU:
+        return tlfu_miss(c, h);
+    default:
+        return LRU_NIL;
+    }
+}
+
+void policy_insert(LRUCache* c, uint32_t i) {
+    push_front(c, c->pending_list, i);
+}
+
+void policy_remove(LRUCache* c, uint32_t i) {
+    list_unlink(c, &c->lists[c->meta[i]], i);
+}
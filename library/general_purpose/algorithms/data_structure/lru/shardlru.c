@@ -0,0 +1,197 @@
+#define _GNU_SOURCE
+#include "shardlru.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ 实现要点
+ （1）分片结构按缓存行对齐，锁与环形缓冲区的写下标分在不同的缓存行：读者都要原子递增写下标，
+      不与读写锁的计数互相干扰
+ （2）缓冲区：读者对 tail 原子加 1 得到序号 t，把节点编号写到 buf[t % SHARDLRU_BUFFER]；
+      写下标是单调递增的 64 位计数，drained 记录已补记到的序号（只在写锁内读写）
+ （3）补记在写锁内进行，此时没有读者持有读锁，所有已取得序号的读者都写完了自己的记录；
+      只补记最近一轮（序号 [tail - SHARDLRU_BUFFER, tail)）中 drained 之后的部分，更早的已被覆盖
+ （4）lru_touch 会忽略已删除的节点；节点被淘汰后复用给别的键时，补记的是新键（只是顺序上的偏差）
+ （5）键先在分片外算一次哈希值选分片，lru 内部查找时再算一次（同一个哈希函数与种子，高位选分片、低位选组，互不相关）
+*/
+
+#define SHARDLRU_CACHE_LINE 64
+
+typedef struct {
+    _Alignas(SHARDLRU_CACHE_LINE) pthread_rwlock_t lock;
+    LRUCache* lru;
+    uint64_t drained;           // 已补记到的序号，写锁内修改
+    _Alignas(SHARDLRU_CACHE_LINE) uint64_t tail;   // 下一个缓冲序号，读者原子递增
+    uint32_t buf[SHARDLRU_BUFFER];
+} Shard;
+
+struct ShardLRU {
+    Shard* shards;
+    size_t shard_count;
+    unsigned shard_bits;
+    size_t capacity;            // 各分片容量之和
+    size_t value_size;
+    hash64_fn hash;
+    uint64_t seed;
+};
+
+static inline Shard* shard_of(const ShardLRU* c, const void* key, size_t key_len) {
+    if (c->shard_bits == 0) {
+        return &c->shards[0];
+    }
+    uint64_t h = c->hash(key, key_len, c->seed);
+    return &c->shards[h >> (64 - c->shard_bits)];
+}
+
+// 把缓冲的命中按顺序标记为最近使用，调用者持有分片的写锁
+static void drain(Shard* s) {
+    uint64_t tail = __atomic_load_n(&s->tail, __ATOMIC_ACQUIRE);
+    uint64_t from = s->drained;
+    if (tail - from > SHARDLRU_BUFFER) {
+        from = tail - SHARDLRU_BUFFER;
+    }
+    for (uint64_t t = from; t < tail; t++) {
+        lru_touch(s->lru, __atomic_load_n(&s->buf[t & (SHARDLRU_BUFFER - 1)], __ATOMIC_RELAXED));
+    }
+    s->drained = tail;
+}
+
+ShardLRU* shardlru_create(const ShardLRUConfig* cfg) {
+    if (cfg == NULL || cfg->capacity == 0 || cfg->max_key_size == 0) {
+        return NULL;
+    }
+    ShardLRU* c = (ShardLRU*)calloc(1, sizeof(ShardLRU));
+    if (c == NULL) {
+        return NULL;
+    }
+    size_t want = cfg->shards != 0 ? cfg->shards : SHARDLRU_DEFAULT_SHARDS;
+    c->shard_count = 1;
+    while (c->shard_count < want && c->shard_count * 2 <= cfg->capacity && c->shard_bits < 16) {
+        c->shard_count *= 2;
+        c->shard_bits++;
+    }
+    c->value_size = cfg->value_size;
+    c->hash = cfg->hash != NULL ? cfg->hash : xxHash64;
+    c->seed = cfg->seed;
+    c->shards = (Shard*)aligned_alloc(SHARDLRU_CACHE_LINE, c->shard_count * sizeof(Shard));
+    if (c->shards == NULL) {
+        free(c);
+        return NULL;
+    }
+    memset(c->shards, 0, c->shard_count * sizeof(Shard));
+
+    LRUConfig lc;
+    memset(&lc, 0, sizeof(lc));
+    lc.capacity = (cfg->capacity + c->shard_count - 1) / c->shard_count;
+    lc.max_key_size = cfg->max_key_size;
+    lc.value_size = cfg->value_size;
+    lc.hash = c->hash;
+    lc.seed = c->seed;
+    lc.on_evict = cfg->on_evict;
+    lc.evict_ctx = cfg->evict_ctx;
+    lc.policy = cfg->policy;
+    // glibc 的读写锁默认读者优先，读多的分片里写者可能一直等下去
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+#ifdef __GLIBC__
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    for (size_t i = 0; i < c->shard_count; i++) {
+        Shard* s = &c->shards[i];
+        s->lru = lru_create(&lc);
+        if (s->lru == NULL) {
+            pthread_rwlockattr_destroy(&attr);
+            c->shard_count = i;
+            shardlru_free(c);
+            return NULL;
+        }
+        pthread_rwlock_init(&s->lock, &attr);
+        c->capacity += lc.capacity;
+    }
+    pthread_rwlockattr_destroy(&attr);
+    return c;
+}
+
+void shardlru_free(ShardLRU* cache) {
+    if (cache == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < cache->shard_count; i++) {
+        pthread_rwlock_destroy(&cache->shards[i].lock);
+        lru_free(cache->shards[i].lru);
+    }
+    free(cache->shards);
+    free(cache);
+}
+
+int shardlru_get(ShardLRU* cache, const void* key, size_t key_len, void* value_out) {
+    Shard* s = shard_of(cache, key, key_len);
+    pthread_rwlock_rdlock(&s->lock);
+    uint32_t node;
+    const void* v = lru_find(s->lru, key, key_len, &node);
+    if (v == NULL) {
+        pthread_rwlock_unlock(&s->lock);
+        return -1;
+    }
+    if (value_out != NULL && cache->value_size != 0) {
+        memcpy(value_out, v, cache->value_size);
+    }
+    uint64_t t = __atomic_fetch_add(&s->tail, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&s->buf[t & (SHARDLRU_BUFFER - 1)], node, __ATOMIC_RELAXED);
+    pthread_rwlock_unlock(&s->lock);
+
+    // 写满一轮：尝试补记，写锁被占用（有写者，它会补记）或有其他读者时放弃
+    if ((t & (SHARDLRU_BUFFER - 1)) == SHARDLRU_BUFFER - 1 && pthread_rwlock_trywrlock(&s->lock) == 0) {
+        drain(s);
+        pthread_rwlock_unlock(&s->lock);
+    }
+    return 0;
+}
+
+int shardlru_put(ShardLRU* cache, const void* key, size_t key_len, const void* value) {
+    Shard* s = shard_of(cache, key, key_len);
+    pthread_rwlock_wrlock(&s->lock);
+    drain(s);
+    int ret = lru_put(s->lru, key, key_len, value);
+    pthread_rwlock_unlock(&s->lock);
+    return ret;
+}
+
+int shardlru_remove(ShardLRU* cache, const void* key, size_t key_len, void* value_out) {
+    Shard* s = shard_of(cache, key, key_len);
+    pthread_rwlock_wrlock(&s->lock);
+    drain(s);
+    int ret = lru_remove(s->lru, key, key_len, value_out);
+    pthread_rwlock_unlock(&s->lock);
+    return ret;
+}
+
+void shardlru_clear(ShardLRU* cache) {
+    for (size_t i = 0; i < cache->shard_count; i++) {
+        Shard* s = &cache->shards[i];
+        pthread_rwlock_wrlock(&s->lock);
+        lru_clear(s->lru);
+        s->drained = __atomic_load_n(&s->tail, __ATOMIC_RELAXED);
+        pthread_rwlock_unlock(&s->lock);
+    }
+}
+
+size_t shardlru_size(ShardLRU* cache) {
+    size_t n = 0;
+    for (size_t i = 0; i < cache->shard_count; i++) {
+        Shard* s = &cache->shards[i];
+        pthread_rwlock_rdlock(&s->lock);
+        n += lru_size(s->lru);
+        pthread_rwlock_unlock(&s->lock);
+    }
+    return n;
+}
+
+size_t shardlru_capacity(const ShardLRU* cache) {
+    return cache->capacity;
+}
+
+size_t shardlru_shard_count(const ShardLRU* cache) {
+    return cache->shard_count;
+}
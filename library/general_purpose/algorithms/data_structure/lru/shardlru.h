@@ -0,0 +1,85 @@
+#ifndef SHARDLRU_H
+#define SHARDLRU_H
+
+#include "lru.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ 分片的并发 LRU 缓存：可以被多个线程同时使用
+ （1）按键的哈希值高位分到若干分片（2 的幂），每个分片是一个独立的 lru.h 缓存（自己的链表、索引与节点）和一把读写锁，
+      淘汰只在分片内进行（每个分片的容量为总容量 / 分片数，近似全局 LRU）
+ （2）命中不在锁内调整顺序：get 只持有读锁查找并拷贝值，把命中的节点编号写进分片的环形缓冲区（原子递增下标，不加锁）；
+      缓冲区每攒满一轮，由恰好写满的那个读者尝试取写锁（trylock，取不到就放弃）按顺序补记这些命中；
+      put / remove 拿到写锁后也先补记缓冲区，淘汰前的使用顺序不会漏掉已缓冲的命中
+ （3）缓冲区满了还没来得及补记时，旧的记录被覆盖（丢失的只是部分命中的顺序更新），读者永远不会等待写锁以外的东西
+*/
+
+typedef struct {
+    size_t capacity;            // 总容量，平均分到各分片（向上取整）
+    size_t shards;              // 分片数，向上取整为 2 的幂且不超过容量，为 0 时使用 SHARDLRU_DEFAULT_SHARDS
+    size_t max_key_size;        // 键的最大字节数，> 0
+    size_t value_size;          // 值的字节数，可以为 0
+    hash64_fn hash;             // 为NULL时使用 xxHash64；高位选分片
+    uint64_t seed;              // 传给哈希函数的种子
+    lru_evict_fn on_evict;      // 可以为NULL；在分片的写锁内调用，不能再访问本缓存
+    void* evict_ctx;            // 传给 on_evict
+    LRUPolicy policy;           // 每个分片的淘汰策略，默认（0）为 LRU_POLICY_LRU
+} ShardLRUConfig;
+
+#define SHARDLRU_DEFAULT_SHARDS 64
+
+// 每个分片缓冲的命中次数（2 的幂）
+#define SHARDLRU_BUFFER 64
+
+typedef struct ShardLRU ShardLRU;
+
+/**
+* @brief             创建分片 LRU 缓存，按容量分配全部分片
+* @param cfg         配置，创建后可以释放
+* @return            成功返回缓存；参数不合法（同 lru_create）或内存不足返回NULL
+*/
+ShardLRU* shardlru_create(const ShardLRUConfig* cfg);
+
+/**
+* @brief             销毁缓存，cache 为NULL时不做任何事；调用时不能再有线程在使用缓存
+*/
+void shardlru_free(ShardLRU* cache);
+
+/**
+* @brief             查找（分片读锁），命中记入分片的缓冲区，稍后批量标记为最近使用
+* @param value_out   不为NULL时拷贝出值
+* @return            找到返回0，不存在返回 -1
+*/
+int shardlru_get(ShardLRU* cache, const void* key, size_t key_len, void* value_out);
+
+/**
+* @brief             插入或更新并标记为最近使用（分片写锁），分片已满时淘汰分片内最久未使用的键
+* @return            新插入返回 1，键已存在返回0，键长超过 max_key_size 返回 -1
+*/
+int shardlru_put(ShardLRU* cache, const void* key, size_t key_len, const void* value);
+
+/**
+* @brief             删除（分片写锁）
+* @return            删除成功返回0，键不存在返回 -1
+*/
+int shardlru_remove(ShardLRU* cache, const void* key, size_t key_len, void* value_out);
+
+// 逐个分片清空（不调用淘汰回调）
+void shardlru_clear(ShardLRU* cache);
+
+// 各分片的元素数之和（逐个分片加读锁，并发修改时是近似值）
+size_t shardlru_size(ShardLRU* cache);
+// 各分片容量之和（>= 配置的容量）
+size_t shardlru_capacity(const ShardLRU* cache);
+size_t shardlru_shard_count(const ShardLRU* cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SHARDLRU_H
@@ -0,0 +1,270 @@
+#include "stackdist.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ 实现要点
+ （1）每个不同的键一个条目（编号按首次出现的顺序），键到条目用线性探测的开放寻址表，槽位数为条目数的 2 倍以上
+ （2）时间位置：每次访问占用下一个位置 now，条目记录自己的位置 pos[e]，位置记录占用它的条目 owner[p]；
+      标记总数等于不同键数 unique，距离 = unique - prefix(pos[e])（prefix 含自身，得到位置在它之后的标记数）
+ （3）位置用完时压缩：按位置顺序把仍有标记的位置（pos[owner[p]] == p）重新编号为 0 ~ unique - 1，
+      原地改写 owner 与 pos，再 O(n) 重建树状数组；标记占到一半以上时位置数翻倍，均摊每次访问 O(1)
+*/
+
+#define STACKDIST_NIL UINT32_MAX
+#define STACKDIST_MAX_UNIQUE ((size_t)1 << 30)
+
+struct StackDist {
+    uint64_t* slot_keys;
+    uint32_t* slot_ents;        // 条目编号，空槽位为 STACKDIST_NIL
+    size_t slot_mask;
+    uint32_t* pos;              // 条目 -> 最近一次访问的位置
+    size_t ent_cap;
+    size_t unique;
+
+    uint32_t* tree;             // 树状数组，下标从 1 开始，tree_cap + 1 个
+    uint32_t* owner;            // 位置 -> 条目
+    size_t tree_cap;
+    size_t now;                 // 下一个位置
+
+    uint64_t* hist;             // hist[d]：栈距离为 d 的访问次数
+    size_t hist_cap;
+    uint64_t accesses;
+};
+
+static inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static inline void tree_add(StackDist* sd, size_t p, int delta) {
+    for (size_t i = p + 1; i <= sd->tree_cap; i += i & (~i + 1)) {
+        sd->tree[i] += (uint32_t)delta;
+    }
+}
+
+// 位置 0 ~ p 的标记数
+static inline size_t tree_prefix(const StackDist* sd, size_t p) {
+    size_t sum = 0;
+    for (size_t i = p + 1; i > 0; i &= i - 1) {
+        sum += sd->tree[i];
+    }
+    return sum;
+}
+
+static int slots_alloc(StackDist* sd, size_t n) {
+    sd->slot_keys = (uint64_t*)malloc(n * sizeof(uint64_t));
+    sd->slot_ents = (uint32_t*)malloc(n * sizeof(uint32_t));
+    if (sd->slot_keys == NULL || sd->slot_ents == NULL) {
+        return -1;
+    }
+    memset(sd->slot_ents, 0xff, n * sizeof(uint32_t));
+    sd->slot_mask = n - 1;
+    return 0;
+}
+
+StackDist* stackdist_create(size_t expected) {
+    StackDist* sd = (StackDist*)calloc(1, sizeof(StackDist));
+    if (sd == NULL) {
+        return NULL;
+    }
+    size_t n = 1024;
+    while (n < expected && n < STACKDIST_MAX_UNIQUE) {
+        n *= 2;
+    }
+    sd->ent_cap = n;
+    sd->tree_cap = 2 * n;
+    sd->hist_cap = n;
+    sd->pos = (uint32_t*)malloc(sd->ent_cap * sizeof(uint32_t));
+    sd->tree = (uint32_t*)calloc(sd->tree_cap + 1, sizeof(uint32_t));
+    sd->owner = (uint32_t*)malloc(sd->tree_cap * sizeof(uint32_t));
+    sd->hist = (uint64_t*)calloc(sd->hist_cap, sizeof(uint64_t));
+    if (sd->pos == NULL || sd->tree == NULL || sd->owner == NULL || sd->hist == NULL || slots_alloc(sd, 2 * n) != 0) {
+        stackdist_free(sd);
+        return NULL;
+    }
+    return sd;
+}
+
+void stackdist_free(StackDist* sd) {
+    if (sd == NULL) {
+        return;
+    }
+    free(sd->slot_keys);
+    free(sd->slot_ents);
+    free(sd->pos);
+    free(sd->tree);
+    free(sd->owner);
+    free(sd->hist);
+    free(sd);
+}
+
+// 槽位数翻倍，重新插入全部键
+static int slots_grow(StackDist* sd) {
+    uint64_t* keys = sd->slot_keys;
+    uint32_t* ents = sd->slot_ents;
+    size_t old = sd->slot_mask + 1;
+    if (slots_alloc(sd, old * 2) != 0) {
+        free(sd->slot_keys);
+        free(sd->slot_ents);
+        sd->slot_keys = keys;
+        sd->slot_ents = ents;
+        sd->slot_mask = old - 1;
+        return -1;
+    }
+    for (size_t i = 0; i < old; i++) {
+        if (ents[i] != STACKDIST_NIL) {
+            size_t s = mix64(keys[i]) & sd->slot_mask;
+            while (sd->slot_ents[s] != STACKDIST_NIL) {
+                s = (s + 1) & sd->slot_mask;
+            }
+            sd->slot_keys[s] = keys[i];
+            sd->slot_ents[s] = ents[i];
+        }
+    }
+    free(keys);
+    free(ents);
+    return 0;
+}
+
+// 位置用完：压缩已有标记，必要时位置数翻倍
+static int compact(StackDist* sd) {
+    size_t cap = sd->tree_cap;
+    if (2 * (sd->unique + 1) > cap) {
+        cap *= 2;
+        uint32_t* owner = (uint32_t*)realloc(sd->owner, cap * sizeof(uint32_t));
+        if (owner == NULL) {
+            return -1;
+        }
+        sd->owner = owner;
+        uint32_t* tree = (uint32_t*)realloc(sd->tree, (cap + 1) * sizeof(uint32_t));
+        if (tree == NULL) {
+            return -1;
+        }
+        sd->tree = tree;
+        sd->tree_cap = cap;
+    }
+    size_t j = 0;
+    for (size_t p = 0; p < sd->now; p++) {
+        uint32_t e = sd->owner[p];
+        if (sd->pos[e] == p) {
+            sd->owner[j] = e;
+            sd->pos[e] = (uint32_t)j;
+            j++;
+        }
+    }
+    sd->now = j;
+    // 位置 0 ~ j - 1 全有标记：先放 1，再把每个结点的和加到父结点上
+    memset(sd->tree, 0, (sd->tree_cap + 1) * sizeof(uint32_t));
+    for (size_t i = 1; i <= sd->tree_cap; i++) {
+        sd->tree[i] += i <= j;
+        size_t parent = i + (i & (~i + 1));
+        if (parent <= sd->tree_cap) {
+            sd->tree[parent] += sd->tree[i];
+        }
+    }
+    return 0;
+}
+
+static int hist_add(StackDist* sd, size_t d) {
+    if (d >= sd->hist_cap) {
+        size_t cap = sd->hist_cap * 2;
+        while (cap <= d) {
+            cap *= 2;
+        }
+        uint64_t* hist = (uint64_t*)realloc(sd->hist, cap * sizeof(uint64_t));
+        if (hist == NULL) {
+            return -1;
+        }
+        memset(hist + sd->hist_cap, 0, (cap - sd->hist_cap) * sizeof(uint64_t));
+        sd->hist = hist;
+        sd->hist_cap = cap;
+    }
+    sd->hist[d]++;
+    return 0;
+}
+
+int stackdist_access(StackDist* sd, uint64_t key, size_t* distance) {
+    if (sd->now == sd->tree_cap && compact(sd) != 0) {
+        return -1;
+    }
+    size_t s = mix64(key) & sd->slot_mask;
+    while (sd->slot_ents[s] != STACKDIST_NIL && sd->slot_keys[s] != key) {
+        s = (s + 1) & sd->slot_mask;
+    }
+    uint32_t e = sd->slot_ents[s];
+    size_t d;
+    if (e != STACKDIST_NIL) {
+        size_t p = sd->pos[e];
+        d = sd->unique - tree_prefix(sd, p);
+        if (hist_add(sd, d) != 0) {
+            return -1;
+        }
+        tree_add(sd, p, -1);
+    } else {
+        if (sd->unique >= STACKDIST_MAX_UNIQUE) {
+            return -1;
+        }
+        if (sd->unique == sd->ent_cap) {
+            uint32_t* pos = (uint32_t*)realloc(sd->pos, sd->ent_cap * 2 * sizeof(uint32_t));
+            if (pos == NULL) {
+                return -1;
+            }
+            sd->pos = pos;
+            sd->ent_cap *= 2;
+        }
+        // 槽位保持至少一半为空
+        if (2 * (sd->unique + 1) > sd->slot_mask + 1) {
+            if (slots_grow(sd) != 0) {
+                return -1;
+            }
+            s = mix64(key) & sd->slot_mask;
+            while (sd->slot_ents[s] != STACKDIST_NIL) {
+                s = (s + 1) & sd->slot_mask;
+            }
+        }
+        e = (uint32_t)sd->unique++;
+        sd->slot_keys[s] = key;
+        sd->slot_ents[s] = e;
+        d = STACKDIST_COLD;
+    }
+    sd->pos[e] = (uint32_t)sd->now;
+    sd->owner[sd->now] = e;
+    tree_add(sd, sd->now, 1);
+    sd->now++;
+    sd->accesses++;
+    if (distance != NULL) {
+        *distance = d;
+    }
+    return 0;
+}
+
+void stackdist_curve(const StackDist* sd, const size_t capacities[], size_t n, uint64_t hits[]) {
+    uint64_t sum = 0;
+    size_t d = 0;
+    for (size_t i = 0; i < n; i++) {
+        size_t limit = capacities[i] < sd->hist_cap ? capacities[i] : sd->hist_cap;
+        for (; d < limit; d++) {
+            sum += sd->hist[d];
+        }
+        hits[i] = sum;
+    }
+}
+
+uint64_t stackdist_hits(const StackDist* sd, size_t capacity) {
+    uint64_t hits;
+    stackdist_curve(sd, &capacity, 1, &hits);
+    return hits;
+}
+
+uint64_t stackdist_accesses(const StackDist* sd) {
+    return sd->accesses;
+}
+
+size_t stackdist_unique(const StackDist* sd) {
+    return sd->unique;
+}
@@ -0,0 +1,60 @@
+#ifndef STACKDIST_H
+#define STACKDIST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ LRU 栈距离（Mattson 等 1970）：一遍扫过访问序列，得到所有容量下 LRU 缓存的命中次数
+ （1）一次访问的栈距离 = 与上一次访问同一个键之间访问过的不同键的个数；LRU 满足包含性（容量 C 的缓存内容
+      总是容量 C + 1 的子集），容量为 C 的 LRU 缓存命中当且仅当栈距离 < C，第一次访问的键总是未命中
+ （2）按距离记直方图，任意容量的命中次数是直方图的前缀和，不需要按容量逐个重放
+ （3）距离用树状数组计算：每个键只在它最近一次访问的位置上有标记，距离 = 该位置之后的标记数，每次访问 O(log n)
+ 结果与 lru.h 的 LRU 策略（get 未命中再 put）逐次访问完全一致；只适用于 LRU，其他策略没有包含性，仍需逐个容量重放
+*/
+
+typedef struct StackDist StackDist;
+
+// 第一次访问（冷启动未命中）的距离
+#define STACKDIST_COLD SIZE_MAX
+
+/**
+* @brief             创建
+* @param expected    预计的不同键数，用于预分配，可以为 0
+* @return            成功返回对象，内存不足返回NULL
+*/
+StackDist* stackdist_create(size_t expected);
+
+void stackdist_free(StackDist* sd);
+
+/**
+* @brief             记录一次访问
+* @param distance    不为NULL时输出栈距离，第一次访问为 STACKDIST_COLD
+* @return            成功返回0，内存不足（或不同键数超过 2^30）返回 -1，此时这次访问未被记录
+*/
+int stackdist_access(StackDist* sd, uint64_t key, size_t* distance);
+
+/**
+* @brief             一遍计算多个容量下 LRU 缓存的命中次数
+* @param capacities  容量，升序
+* @param hits        输出，与 capacities 一一对应
+*/
+void stackdist_curve(const StackDist* sd, const size_t capacities[], size_t n, uint64_t hits[]);
+
+// 容量为 capacity 的 LRU 缓存（从空开始）的命中次数
+uint64_t stackdist_hits(const StackDist* sd, size_t capacity);
+
+// 访问次数
+uint64_t stackdist_accesses(const StackDist* sd);
+// 不同键的个数（容量不小于它时只有冷启动未命中）
+size_t stackdist_unique(const StackDist* sd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STACKDIST_H
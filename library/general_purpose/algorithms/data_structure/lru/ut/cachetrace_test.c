@@ -0,0 +1,110 @@
+#include "cachetrace.h"
+#include "hashalg.h"
+#include "ut_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ trace 文件测试：文本解析（字段、空行、注释、无结尾换行）、二进制写入后映射打开、文本文件打开、损坏与截断的文件
+*/
+
+static uint64_t text_key(const char* s) {
+    return xxHash64(s, strlen(s), CACHETRACE_TEXT_SEED);
+}
+
+static void test_parse_text(void) {
+    const char* text = "# 注释\nalpha\n  beta GET 100\n\n\tgamma\r\nalpha";
+    uint64_t* keys = NULL;
+    size_t n = cachetrace_parse_text(text, strlen(text), &keys);
+    CHECK_EQ(n, 4);
+    CHECK_EQ(keys[0], text_key("alpha"));
+    CHECK_EQ(keys[1], text_key("beta"));
+    CHECK_EQ(keys[2], text_key("gamma"));
+    CHECK_EQ(keys[3], keys[0]);
+    free(keys);
+
+    n = cachetrace_parse_text("", 0, &keys);
+    CHECK_EQ(n, 0);
+    free(keys);
+}
+
+static void write_file(const char* path, const void* data, size_t len) {
+    FILE* fp = fopen(path, "wb");
+    fwrite(data, 1, len, fp);
+    fclose(fp);
+}
+
+static void test_files(void) {
+    char dir[] = "/tmp/cachetrace_testXXXXXX";
+    CHECK(mkdtemp(dir) != NULL);
+    char bin[64], txt[64], bad[64];
+    snprintf(bin, sizeof(bin), "%s/t.bin", dir);
+    snprintf(txt, sizeof(txt), "%s/t.txt", dir);
+    snprintf(bad, sizeof(bad), "%s/bad.bin", dir);
+
+    enum { N = 100000 };
+    uint64_t* keys = (uint64_t*)malloc(N * sizeof(uint64_t));
+    for (size_t i = 0; i < N; i++) {
+        keys[i] = i * i * 0x9e3779b97f4a7c15ULL;
+    }
+    CHECK_EQ(cachetrace_write(bin, keys, N), 0);
+    CacheTrace* t = cachetrace_open(bin);
+    CHECK(t != NULL);
+    CHECK_EQ(cachetrace_len(t), N);
+    CHECK_EQ(cachetrace_mapped(t), 1);
+    CHECK(memcmp(cachetrace_keys(t), keys, N * sizeof(uint64_t)) == 0);
+    cachetrace_close(t);
+
+    // 截断：访问次数与文件大小不符
+    FILE* fp = fopen(bin, "rb");
+    uint8_t* raw = (uint8_t*)malloc(32 + N * sizeof(uint64_t));
+    CHECK_EQ(fread(raw, 1, 32 + N * sizeof(uint64_t), fp), 32 + N * sizeof(uint64_t));
+    fclose(fp);
+    write_file(bad, raw, 32 + (N - 1) * sizeof(uint64_t));
+    CHECK(cachetrace_open(bad) == NULL);
+    // 文件头损坏
+    raw[16] ^= 1;
+    write_file(bad, raw, 32 + N * sizeof(uint64_t));
+    CHECK(cachetrace_open(bad) == NULL);
+    free(raw);
+
+    const char* text = "x 1\ny 2\nx 3\n";
+    write_file(txt, text, strlen(text));
+    t = cachetrace_open(txt);
+    CHECK(t != NULL);
+    CHECK_EQ(cachetrace_len(t), 3);
+    CHECK_EQ(cachetrace_mapped(t), 0);
+    CHECK_EQ(cachetrace_keys(t)[2], text_key("x"));
+    // 文本转二进制后内容相同
+    CHECK_EQ(cachetrace_write(bin, cachetrace_keys(t), cachetrace_len(t)), 0);
+    CacheTrace* b = cachetrace_open(bin);
+    CHECK(b != NULL && cachetrace_len(b) == 3 && memcmp(cachetrace_keys(b), cachetrace_keys(t), 24) == 0);
+    cachetrace_close(b);
+    cachetrace_close(t);
+
+    // 空文件、不存在的文件、空 trace 的二进制文件
+    write_file(txt, "", 0);
+    t = cachetrace_open(txt);
+    CHECK(t != NULL && cachetrace_len(t) == 0);
+    cachetrace_close(t);
+    CHECK(cachetrace_open("/nonexistent/trace") == NULL);
+    CHECK_EQ(cachetrace_write(bin, NULL, 0), 0);
+    t = cachetrace_open(bin);
+    CHECK(t != NULL && cachetrace_len(t) == 0);
+    cachetrace_close(t);
+
+    unlink(bin);
+    unlink(txt);
+    unlink(bad);
+    rmdir(dir);
+    free(keys);
+}
+
+int main(void) {
+    test_parse_text();
+    test_files();
+
+    return ut_report("cachetrace_test");
+}
@@ -0,0 +1,113 @@
+#include "freqsketch.h"
+#include "ut_check.h"
+#include "ut_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ 频率估计测试：不低估（老化前）、计数上限、偏斜分布下热键与冷键可区分、老化减半、清空
+*/
+
+// 键编号到哈希值（模拟缓存传入的键哈希）
+static uint64_t key_hash(uint64_t k) {
+    return (k + 1) * 0x9e3779b97f4a7c15ULL;
+}
+
+// 老化之前估计值 >= min(真实次数, 15)
+static void test_no_underestimate(void) {
+    FreqSketch* s = freqsketch_create(1000);
+    CHECK(s != NULL);
+    enum { KEYS = 3000 };
+    uint32_t* truth = (uint32_t*)calloc(KEYS, sizeof(uint32_t));
+    uint64_t rng = 1;
+    // 10 × 1000 次后才老化
+    for (int i = 0; i < 9000; i++) {
+        uint64_t k = ut_rand(&rng) % KEYS;
+        freqsketch_add(s, key_hash(k));
+        truth[k]++;
+    }
+    CHECK_EQ(freqsketch_agings(s), 0);
+    size_t wrong = 0;
+    for (uint64_t k = 0; k < KEYS; k++) {
+        uint32_t want = truth[k] < FREQSKETCH_MAX ? truth[k] : FREQSKETCH_MAX;
+        wrong += freqsketch_estimate(s, key_hash(k)) < want;
+    }
+    CHECK_EQ(wrong, 0);
+    free(truth);
+
+    // 计数不超过上限
+    for (int i = 0; i < 100; i++) {
+        freqsketch_add(s, key_hash(12345678));
+    }
+    CHECK_EQ(freqsketch_estimate(s, key_hash(12345678)), FREQSKETCH_MAX);
+    freqsketch_free(s);
+}
+
+// 偏斜分布：少数热键访问多次，大量冷键只访问一次，冷键的估计值基本不被热键抬高
+static void test_skew(void) {
+    FreqSketch* s = freqsketch_create(1000);
+    for (int round = 0; round < 8; round++) {
+        for (uint64_t k = 0; k < 100; k++) {
+            freqsketch_add(s, key_hash(k));
+        }
+    }
+    for (uint64_t k = 1000; k < 2000; k++) {
+        freqsketch_add(s, key_hash(k));
+    }
+    size_t hot_low = 0, cold_high = 0;
+    for (uint64_t k = 0; k < 100; k++) {
+        hot_low += freqsketch_estimate(s, key_hash(k)) < 8;
+    }
+    for (uint64_t k = 1000; k < 2000; k++) {
+        cold_high += freqsketch_estimate(s, key_hash(k)) > 2;
+    }
+    CHECK_EQ(hot_low, 0);
+    CHECK(cold_high < 10);
+    // 没出现过的键多数为 0
+    size_t unseen = 0;
+    for (uint64_t k = 5000; k < 6000; k++) {
+        unseen += freqsketch_estimate(s, key_hash(k)) == 0;
+    }
+    CHECK(unseen > 900);
+    freqsketch_free(s);
+}
+
+// 增加 10 × expected 次后全部计数器减半
+static void test_aging(void) {
+    FreqSketch* s = freqsketch_create(100);
+    for (int i = 0; i < 12; i++) {
+        freqsketch_add(s, key_hash(7));
+    }
+    CHECK_EQ(freqsketch_estimate(s, key_hash(7)), 12);
+    uint64_t rng = 3;
+    // 其余的增加分散在很多键上，凑满 1000 次
+    for (int i = 12; i < 999; i++) {
+        freqsketch_add(s, key_hash(1000 + ut_rand(&rng) % 100000));
+    }
+    CHECK_EQ(freqsketch_agings(s), 0);
+    freqsketch_add(s, key_hash(1000000));
+    CHECK_EQ(freqsketch_agings(s), 1);
+    CHECK_EQ(freqsketch_estimate(s, key_hash(7)), 6);
+    // 计数减半后，下一次老化在又增加 500 次之后
+    for (int i = 0; i < 499; i++) {
+        freqsketch_add(s, key_hash(2000000 + (uint64_t)i));
+    }
+    CHECK_EQ(freqsketch_agings(s), 1);
+    freqsketch_add(s, key_hash(3000000));
+    CHECK_EQ(freqsketch_agings(s), 2);
+    CHECK_EQ(freqsketch_estimate(s, key_hash(7)), 3);
+
+    freqsketch_clear(s);
+    CHECK_EQ(freqsketch_estimate(s, key_hash(7)), 0);
+    CHECK(freqsketch_memory(s) >= 4 * 400 / 2);
+    freqsketch_free(s);
+}
+
+int main(void) {
+    test_no_underestimate();
+    test_skew();
+    test_aging();
+
+    return ut_report("freqsketch_test");
+}
@@ -0,0 +1,641 @@
+#include "lru.h"
+#include "ut_check.h"
+#include "ut_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+/*
+ LRU 缓存测试：原 simplelru 的用例、参数检查、变长键与超长键、淘汰回调与淘汰顺序、删除与清空、遍历顺序、find / touch，
+ 随机操作与参考实现（时间戳数组，淘汰时线性查找最久未使用的键）对比（含全部键哈希冲突、反复删除触发索引重建），
+ CLOCK 策略（second chance 的淘汰顺序、与参考实现对比），2Q / ARC / W-TinyLFU（随机操作下的内容与淘汰回调一致、
+ 抗扫描、统计），以及创建之后的操作不再分配内存
+*/
+
+static LRUCache* make_policy_cache(LRUPolicy policy, size_t capacity, size_t max_key, size_t value_size,
+                                   hash64_fn hash, lru_evict_fn cb, void* ctx) {
+    LRUConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.capacity = capacity;
+    cfg.max_key_size = max_key;
+    cfg.value_size = value_size;
+    cfg.hash = hash;
+    cfg.on_evict = cb;
+    cfg.evict_ctx = ctx;
+    cfg.policy = policy;
+    return lru_create(&cfg);
+}
+
+static LRUCache* make_cache(size_t capacity, size_t max_key, size_t value_size, hash64_fn hash, lru_evict_fn cb,
+                            void* ctx) {
+    return make_policy_cache(LRU_POLICY_LRU, capacity, max_key, value_size, hash, cb, ctx);
+}
+
+static int get_int(LRUCache* c, int key) {
+    int v;
+    return lru_get(c, &key, sizeof(key), &v) == 0 ? v : -1;
+}
+
+static void test_simple(void) {
+    LRUConfig bad;
+    memset(&bad, 0, sizeof(bad));
+    CHECK(lru_create(NULL) == NULL);
+    CHECK(lru_create(&bad) == NULL);
+    bad.capacity = 4;
+    CHECK(lru_create(&bad) == NULL);
+    bad.max_key_size = 4;
+    bad.policy = LRU_POLICY_COUNT;
+    CHECK(lru_create(&bad) == NULL);
+    // 节点大小乘容量溢出时不能分配过小的内存
+    bad.policy = LRU_POLICY_LRU;
+    bad.capacity = 1u << 20;
+    bad.value_size = SIZE_MAX / 2;
+    CHECK(lru_create(&bad) == NULL);
+    bad.value_size = SIZE_MAX / 4;
+    CHECK(lru_create(&bad) == NULL);
+
+    // 原 simplelru.c 的用例
+    LRUCache* c = make_cache(2, sizeof(int), sizeof(int), NULL, NULL, NULL);
+    int k, v;
+    k = 1, v = 1;
+    CHECK_EQ(lru_put(c, &k, sizeof(k), &v), 1);
+    k = 2, v = 2;
+    CHECK_EQ(lru_put(c, &k, sizeof(k), &v), 1);
+    CHECK_EQ(get_int(c, 1), 1);
+    k = 3, v = 3;
+    lru_put(c, &k, sizeof(k), &v);
+    CHECK_EQ(get_int(c, 2), -1);
+    k = 4, v = 4;
+    lru_put(c, &k, sizeof(k), &v);
+    CHECK_EQ(get_int(c, 1), -1);
+    CHECK_EQ(get_int(c, 3), 3);
+    CHECK_EQ(get_int(c, 4), 4);
+    CHECK_EQ(lru_size(c), 2);
+    CHECK_EQ(lru_capacity(c), 2);
+    // 原实现越界的键
+    k = 20000, v = 5;
+    CHECK_EQ(lru_put(c, &k, sizeof(k), &v), 1);
+    k = -1, v = 6;
+    CHECK_EQ(lru_put(c, &k, sizeof(k), &v), 1);
+    CHECK_EQ(get_int(c, 20000), 5);
+    CHECK_EQ(get_int(c, -1), 6);
+    // 更新不改变大小，但标记为最近使用
+    k = 20000, v = 50;
+    CHECK_EQ(lru_put(c, &k, sizeof(k), &v), 0);
+    k = 7, v = 7;
+    lru_put(c, &k, sizeof(k), &v);
+    CHECK_EQ(get_int(c, -1), -1);
+    CHECK_EQ(get_int(c, 20000), 50);
+    lru_free(c);
+    lru_free(NULL);
+}
+
+typedef struct {
+    char keys[16][16];
+    size_t count;
+} Evicted;
+
+static void record_evicted(const void* key, size_t key_len, void* value, void* ctx) {
+    (void)value;
+    Evicted* e = (Evicted*)ctx;
+    memcpy(e->keys[e->count], key, key_len);
+    e->keys[e->count][key_len] = '\0';
+    e->count++;
+}
+
+static void test_strings(void) {
+    Evicted ev;
+    memset(&ev, 0, sizeof(ev));
+    LRUCache* c = make_cache(3, 8, sizeof(uint64_t), NULL, record_evicted, &ev);
+    const char* words[] = {"a", "bb", "ccc", "a", "dddd", "", "eeeee"};
+    for (uint64_t i = 0; i < 7; i++) {
+        lru_put(c, words[i], strlen(words[i]), &i);
+    }
+    // 超长的键
+    CHECK_EQ(lru_put(c, "123456789", 9, NULL), -1);
+    CHECK_EQ(ev.count, 3);
+    CHECK(strcmp(ev.keys[0], "bb") == 0);
+    CHECK(strcmp(ev.keys[1], "ccc") == 0);
+    CHECK(strcmp(ev.keys[2], "a") == 0);
+
+    // 遍历：最近使用在前
+    const char* expect[] = {"eeeee", "", "dddd"};
+    size_t iter = 0, n = 0, klen;
+    const void *key, *value;
+    while (lru_next(c, &iter, &key, &klen, &value)) {
+        CHECK(n < 3 && klen == strlen(expect[n]) && memcmp(key, expect[n], klen) == 0);
+        n++;
+    }
+    CHECK_EQ(n, 3);
+    CHECK_EQ(lru_next(c, &iter, &key, &klen, &value), 0);
+
+    // peek 不改变顺序；get_ref 可以原地修改
+    CHECK(lru_peek(c, "dddd", 4) != NULL);
+    uint64_t* ref = (uint64_t*)lru_get_ref(c, "", 0);
+    CHECK(ref != NULL && *ref == 5);
+    *ref = 55;
+    uint64_t out = 0;
+    CHECK_EQ(lru_get(c, "", 0, &out), 0);
+    CHECK_EQ(out, 55);
+    lru_put(c, "f", 1, NULL);
+    CHECK_EQ(ev.count, 4);
+    CHECK(strcmp(ev.keys[3], "dddd") == 0);
+    CHECK_EQ(lru_get(c, "f", 1, &out), 0);
+    CHECK_EQ(out, 0);
+
+    // lru_find 不改变顺序，lru_touch 补记使用；已删除的节点忽略
+    uint32_t node_f = UINT32_MAX, node_e = UINT32_MAX;
+    CHECK(lru_find(c, "f", 1, &node_f) != NULL);
+    CHECK(lru_find(c, "eeeee", 5, &node_e) != NULL);
+    CHECK(lru_find(c, "zz", 2, NULL) == NULL);
+    lru_touch(c, node_e);
+    lru_touch(c, node_f);
+    iter = 0;
+    CHECK(lru_next(c, &iter, &key, &klen, NULL) == 1 && klen == 1 && memcmp(key, "f", 1) == 0);
+    CHECK(lru_next(c, &iter, &key, &klen, NULL) == 1 && klen == 5 && memcmp(key, "eeeee", 5) == 0);
+    CHECK(lru_next(c, &iter, &key, &klen, NULL) == 1 && klen == 0);
+    lru_touch(c, 12345);
+
+    // 删除与清空
+    CHECK_EQ(lru_remove(c, "eeeee", 5, &out), 0);
+    lru_touch(c, node_e);
+    iter = 0;
+    CHECK(lru_next(c, &iter, &key, &klen, NULL) == 1 && klen == 1 && memcmp(key, "f", 1) == 0);
+    CHECK_EQ(out, 6);
+    CHECK_EQ(lru_remove(c, "eeeee", 5, NULL), -1);
+    CHECK_EQ(lru_size(c), 2);
+    lru_put(c, "g", 1, NULL);
+    CHECK_EQ(ev.count, 4);
+    lru_clear(c);
+    CHECK_EQ(lru_size(c), 0);
+    CHECK(lru_peek(c, "g", 1) == NULL);
+    iter = 0;
+    CHECK_EQ(lru_next(c, &iter, NULL, NULL, NULL), 0);
+    for (uint64_t i = 0; i < 3; i++) {
+        lru_put(c, &i, sizeof(i), &i);
+    }
+    CHECK_EQ(ev.count, 4);
+    CHECK_EQ(lru_size(c), 3);
+    lru_free(c);
+}
+
+/*
+ 参考实现：键为 0 ~ key_range - 1 的整数，按十进制字符串（变长）存入缓存
+ last[k] 为最近一次使用的时间，0 表示不在缓存中
+*/
+typedef struct {
+    uint64_t* last;
+    uint64_t* value;
+    uint64_t key_range;
+    size_t size;
+    uint64_t evicted;
+    size_t evictions;
+} Model;
+
+static void record_model_evicted(const void* key, size_t key_len, void* value, void* ctx) {
+    (void)value;
+    Model* m = (Model*)ctx;
+    char buf[32];
+    memcpy(buf, key, key_len);
+    buf[key_len] = '\0';
+    m->evicted = strtoull(buf, NULL, 10);
+    m->evictions++;
+}
+
+static void run_random(size_t capacity, uint64_t key_range, int ops, hash64_fn hash) {
+    Model m;
+    memset(&m, 0, sizeof(m));
+    m.last = (uint64_t*)calloc(key_range, sizeof(uint64_t));
+    m.value = (uint64_t*)calloc(key_range, sizeof(uint64_t));
+    m.key_range = key_range;
+    LRUCache* c = make_cache(capacity, 20, sizeof(uint64_t), hash, record_model_evicted, &m);
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+    size_t wrong = 0;
+    for (int t = 1; t <= ops; t++) {
+        uint64_t k = ut_rand(&rng) % key_range;
+        char key[32];
+        size_t len = (size_t)snprintf(key, sizeof(key), "%llu", (unsigned long long)k);
+        uint64_t op = ut_rand(&rng) % 8;
+        uint64_t out = 0;
+        if (op < 4) {
+            int rc = lru_get(c, key, len, &out);
+            wrong += rc != (m.last[k] != 0 ? 0 : -1);
+            if (m.last[k] != 0) {
+                wrong += out != m.value[k];
+                m.last[k] = (uint64_t)t;
+            }
+        } else if (op < 7) {
+            uint64_t v = ut_rand(&rng);
+            size_t before = m.evictions;
+            int rc = lru_put(c, key, len, &v);
+            wrong += rc != (m.last[k] == 0 ? 1 : 0);
+            if (m.last[k] == 0 && m.size == capacity) {
+                // 参考实现中最久未使用的键
+                uint64_t oldest = 0, oldest_t = UINT64_MAX;
+                for (uint64_t j = 0; j < key_range; j++) {
+                    if (m.last[j] != 0 && m.last[j] < oldest_t) {
+                        oldest_t = m.last[j];
+                        oldest = j;
+                    }
+                }
+                wrong += m.evictions != before + 1 || m.evicted != oldest;
+                m.last[oldest] = 0;
+                m.size--;
+            } else {
+                wrong += m.evictions != before;
+            }
+            m.size += m.last[k] == 0;
+            m.last[k] = (uint64_t)t;
+            m.value[k] = v;
+        } else {
+            int rc = lru_remove(c, key, len, &out);
+            wrong += rc != (m.last[k] != 0 ? 0 : -1);
+            if (m.last[k] != 0) {
+                wrong += out != m.value[k];
+                m.last[k] = 0;
+                m.size--;
+            }
+        }
+        wrong += lru_size(c) != m.size;
+    }
+    CHECK_EQ(wrong, 0);
+    lru_free(c);
+    free(m.last);
+    free(m.value);
+}
+
+static void test_random(void) {
+    run_random(50, 120, 200000, NULL);
+    run_random(1000, 3000, 200000, NULL);
+    run_random(1, 5, 10000, NULL);
+    // 全部冲突：所有键在同一组开始探测，删除多在满组中留下墓碑，触发原地重建
+    run_random(40, 100, 50000, ut_const_hash);
+}
+
+// CLOCK：命中置访问位，淘汰时跳过访问位为 1 的键（并清零）
+static void test_clock(void) {
+    Evicted ev;
+    memset(&ev, 0, sizeof(ev));
+    LRUCache* c = make_policy_cache(LRU_POLICY_CLOCK, 3, 8, sizeof(uint64_t), NULL, record_evicted, &ev);
+    CHECK_EQ(lru_policy(c), LRU_POLICY_CLOCK);
+    const char* words[] = {"a", "b", "c"};
+    for (uint64_t i = 0; i < 3; i++) {
+        lru_put(c, words[i], 1, &i);
+    }
+    uint64_t out = 9;
+    CHECK_EQ(lru_get(c, "a", 1, &out), 0);
+    CHECK_EQ(out, 0);
+    lru_put(c, "d", 1, NULL);      // a 有访问位，清零后跳过，淘汰 b
+    lru_put(c, "e", 1, NULL);      // 淘汰 c
+    lru_put(c, "f", 1, NULL);      // 指针回到 a，访问位已清零，淘汰 a
+    CHECK_EQ(ev.count, 3);
+    CHECK(strcmp(ev.keys[0], "b") == 0);
+    CHECK(strcmp(ev.keys[1], "c") == 0);
+    CHECK(strcmp(ev.keys[2], "a") == 0);
+
+    // 遍历按节点顺序：f 复用 a 的节点 0，d、e 在节点 1、2
+    const char* expect[] = {"f", "d", "e"};
+    size_t iter = 0, n = 0, klen;
+    const void* key;
+    while (lru_next(c, &iter, &key, &klen, NULL)) {
+        CHECK(n < 3 && klen == 1 && memcmp(key, expect[n], 1) == 0);
+        n++;
+    }
+    CHECK_EQ(n, 3);
+
+    // 删除后空出的节点先被使用，不淘汰
+    CHECK_EQ(lru_remove(c, "d", 1, NULL), 0);
+    CHECK_EQ(lru_put(c, "g", 1, NULL), 1);
+    CHECK_EQ(ev.count, 3);
+    iter = 0;
+    CHECK(lru_next(c, &iter, &key, &klen, NULL) == 1 && memcmp(key, "f", 1) == 0);
+    CHECK(lru_next(c, &iter, &key, &klen, NULL) == 1 && memcmp(key, "g", 1) == 0);
+
+    // touch 同样只置访问位：e、f 被跳过，淘汰 g
+    uint32_t node;
+    CHECK(lru_find(c, "e", 1, &node) != NULL);
+    lru_touch(c, node);
+    CHECK(lru_get_ref(c, "f", 1) != NULL);
+    lru_put(c, "h", 1, NULL);
+    CHECK_EQ(ev.count, 4);
+    CHECK(strcmp(ev.keys[3], "g") == 0);
+    lru_clear(c);
+    CHECK_EQ(lru_size(c), 0);
+    iter = 0;
+    CHECK_EQ(lru_next(c, &iter, NULL, NULL, NULL), 0);
+    lru_free(c);
+}
+
+/*
+ CLOCK 参考实现：节点 0 ~ capacity - 1，空闲节点按实现的空闲链表顺序（后进先出）使用
+ slot_key[i] 为节点 i 上的键（-1 表示空闲），key_slot[k] 为键 k 所在的节点（-1 表示不在缓存中）
+*/
+static void run_clock_random(size_t capacity, uint64_t key_range, int ops, hash64_fn hash) {
+    int64_t* slot_key = (int64_t*)malloc(capacity * sizeof(int64_t));
+    int64_t* key_slot = (int64_t*)malloc(key_range * sizeof(int64_t));
+    uint8_t* ref = (uint8_t*)calloc(capacity, 1);
+    uint64_t* value = (uint64_t*)calloc(key_range, sizeof(uint64_t));
+    size_t* free_stack = (size_t*)malloc(capacity * sizeof(size_t));
+    size_t free_top = capacity, hand = 0, size = 0;
+    for (size_t i = 0; i < capacity; i++) {
+        slot_key[i] = -1;
+        free_stack[i] = capacity - 1 - i;
+    }
+    for (uint64_t k = 0; k < key_range; k++) {
+        key_slot[k] = -1;
+    }
+    Model m;
+    memset(&m, 0, sizeof(m));
+    LRUCache* c = make_policy_cache(LRU_POLICY_CLOCK, capacity, 20, sizeof(uint64_t), hash, record_model_evicted, &m);
+    uint64_t rng = 0x2545f4914f6cdd1dULL;
+    size_t wrong = 0;
+    for (int t = 0; t < ops; t++) {
+        uint64_t k = ut_rand(&rng) % key_range;
+        char key[32];
+        size_t len = (size_t)snprintf(key, sizeof(key), "%llu", (unsigned long long)k);
+        uint64_t op = ut_rand(&rng) % 8;
+        uint64_t out = 0;
+        if (op < 4) {
+            int rc = lru_get(c, key, len, &out);
+            wrong += rc != (key_slot[k] >= 0 ? 0 : -1);
+            if (key_slot[k] >= 0) {
+                wrong += out != value[k];
+                ref[key_slot[k]] = 1;
+            }
+        } else if (op < 7) {
+            uint64_t v = ut_rand(&rng);
+            size_t before = m.evictions;
+            int rc = lru_put(c, key, len, &v);
+            wrong += rc != (key_slot[k] < 0 ? 1 : 0);
+            if (key_slot[k] >= 0) {
+                ref[key_slot[k]] = 1;
+            } else {
+                size_t i;
+                if (free_top > 0) {
+                    i = free_stack[--free_top];
+                    size++;
+                    wrong += m.evictions != before;
+                } else {
+                    while (ref[hand] != 0) {
+                        ref[hand] = 0;
+                        hand = (hand + 1) % capacity;
+                    }
+                    i = hand;
+                    hand = (hand + 1) % capacity;
+                    wrong += m.evictions != before + 1 || (int64_t)m.evicted != slot_key[i];
+                    key_slot[slot_key[i]] = -1;
+                }
+                slot_key[i] = (int64_t)k;
+                key_slot[k] = (int64_t)i;
+                ref[i] = 0;
+            }
+            value[k] = v;
+        } else {
+            int rc = lru_remove(c, key, len, &out);
+            wrong += rc != (key_slot[k] >= 0 ? 0 : -1);
+            if (key_slot[k] >= 0) {
+                wrong += out != value[k];
+                size_t i = (size_t)key_slot[k];
+                slot_key[i] = -1;
+                key_slot[k] = -1;
+                free_stack[free_top++] = i;
+                size--;
+            }
+        }
+        wrong += lru_size(c) != size;
+    }
+    CHECK_EQ(wrong, 0);
+    lru_free(c);
+    free(slot_key);
+    free(key_slot);
+    free(ref);
+    free(value);
+    free(free_stack);
+}
+
+static void test_clock_random(void) {
+    run_clock_random(50, 120, 200000, NULL);
+    run_clock_random(1000, 3000, 200000, NULL);
+    run_clock_random(1, 5, 10000, NULL);
+    run_clock_random(40, 100, 50000, ut_const_hash);
+}
+
+/*
+ 2Q / ARC / W-TinyLFU：淘汰哪个键由策略决定，参考实现只跟踪 "哪些键在缓存里"（淘汰回调里删除），
+ 检查查找结果、值、元素数、遍历与统计都与之一致
+*/
+
+typedef struct {
+    uint8_t* present;
+    size_t size;
+    size_t evictions;
+    size_t wrong;
+} Presence;
+
+static void record_presence_evicted(const void* key, size_t key_len, void* value, void* ctx) {
+    Presence* m = (Presence*)ctx;
+    uint64_t k;
+    memcpy(&k, key, sizeof(k));
+    m->wrong += key_len != sizeof(k) || memcmp(value, &k, sizeof(k)) != 0 || m->present[k] == 0;
+    m->present[k] = 0;
+    m->size--;
+    m->evictions++;
+}
+
+static void run_policy_random(LRUPolicy policy, size_t capacity, uint64_t key_range, int ops, hash64_fn hash) {
+    Presence m;
+    memset(&m, 0, sizeof(m));
+    m.present = (uint8_t*)calloc(key_range, 1);
+    LRUCache* c = make_policy_cache(policy, capacity, sizeof(uint64_t), sizeof(uint64_t), hash,
+                                    record_presence_evicted, &m);
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+    uint64_t gets = 0, hits = 0;
+    for (int t = 1; t <= ops; t++) {
+        // 一半的操作集中在 1/8 的键上，多队列策略的各个队列都有键进出
+        uint64_t r = ut_rand(&rng);
+        uint64_t k = (r & 1) ? r % (key_range / 8 + 1) : r % key_range;
+        uint64_t op = ut_rand(&rng) % 8;
+        uint64_t out = 0;
+        if (op < 4) {
+            int rc = lru_get(c, &k, sizeof(k), &out);
+            gets++;
+            hits += rc == 0;
+            m.wrong += rc != (m.present[k] ? 0 : -1) || (rc == 0 && out != k);
+        } else if (op < 7) {
+            size_t before = m.evictions, size = m.size;
+            int rc = lru_put(c, &k, sizeof(k), &k);
+            m.wrong += rc != (m.present[k] ? 0 : 1);
+            // 已满时插入新键恰好淘汰一个（W-TinyLFU 淘汰的可能是窗口挤出的候选者，但不会是新键）
+            m.wrong += m.evictions != before + (rc == 1 && size == capacity);
+            m.size += rc == 1;
+            m.present[k] = 1;
+            m.wrong += lru_peek(c, &k, sizeof(k)) == NULL;
+        } else {
+            int rc = lru_remove(c, &k, sizeof(k), &out);
+            m.wrong += rc != (m.present[k] ? 0 : -1) || (rc == 0 && out != k);
+            m.size -= m.present[k];
+            m.present[k] = 0;
+        }
+        m.wrong += lru_size(c) != m.size || m.size > capacity;
+    }
+    size_t iter = 0, n = 0;
+    const void* key;
+    while (lru_next(c, &iter, &key, NULL, NULL)) {
+        uint64_t k;
+        memcpy(&k, key, sizeof(k));
+        m.wrong += m.present[k] == 0;
+        n++;
+    }
+    CHECK_EQ(m.wrong, 0);
+    CHECK_EQ(n, m.size);
+    LRUStats st;
+    lru_get_stats(c, &st);
+    CHECK_EQ(st.hits, hits);
+    CHECK_EQ(st.misses, gets - hits);
+    CHECK_EQ(st.evictions, m.evictions);
+    lru_free(c);
+    free(m.present);
+}
+
+static void test_policy_random(void) {
+    for (int policy = LRU_POLICY_2Q; policy < LRU_POLICY_COUNT; policy++) {
+        run_policy_random((LRUPolicy)policy, 50, 120, 200000, NULL);
+        run_policy_random((LRUPolicy)policy, 1000, 3000, 200000, NULL);
+        run_policy_random((LRUPolicy)policy, 1, 5, 10000, NULL);
+        run_policy_random((LRUPolicy)policy, 2, 7, 10000, NULL);
+        run_policy_random((LRUPolicy)policy, 40, 100, 50000, ut_const_hash);
+    }
+}
+
+// 2Q：只出现一次的键留在 A1in，被挤出后在 A1out 中再次出现才进入 Am，之后的扫描挤不掉它
+static void test_2q(void) {
+    LRUCache* c = make_policy_cache(LRU_POLICY_2Q, 4, sizeof(int), sizeof(int), NULL, NULL, NULL);
+    for (int k = 1; k <= 5; k++) {
+        lru_put(c, &k, sizeof(k), &k);
+    }
+    // 1 被挤出到 A1out
+    int k = 1;
+    CHECK(lru_peek(c, &k, sizeof(k)) == NULL);
+    CHECK_EQ(lru_put(c, &k, sizeof(k), &k), 1);
+    for (k = 100; k < 150; k++) {
+        lru_put(c, &k, sizeof(k), &k);
+    }
+    CHECK_EQ(get_int(c, 1), 1);
+    // A1in 是 FIFO：命中不延长寿命
+    k = 200;
+    lru_put(c, &k, sizeof(k), &k);
+    CHECK_EQ(get_int(c, 200), 200);
+    for (k = 300; k < 304; k++) {
+        lru_put(c, &k, sizeof(k), &k);
+    }
+    CHECK_EQ(get_int(c, 200), -1);
+    CHECK_EQ(get_int(c, 1), 1);
+    lru_free(c);
+}
+
+// W-TinyLFU：频繁访问的键不会被一次性的新键挤出，被拒绝的候选者计入 rejections
+static void test_tinylfu(void) {
+    LRUCache* c = make_policy_cache(LRU_POLICY_WTINYLFU, 200, sizeof(int), sizeof(int), NULL, NULL, NULL);
+    for (int round = 0; round < 4; round++) {
+        for (int k = 0; k < 200; k++) {
+            if (get_int(c, k) != k) {
+                lru_put(c, &k, sizeof(k), &k);
+            }
+        }
+    }
+    for (int k = 1000; k < 3000; k++) {
+        lru_put(c, &k, sizeof(k), &k);
+    }
+    int kept = 0;
+    for (int k = 0; k < 200; k++) {
+        kept += lru_peek(c, &k, sizeof(k)) != NULL;
+    }
+    // 窗口（1%）里的热键会被扫描冲掉，主区的都留下
+    CHECK(kept >= 190);
+    LRUStats st;
+    lru_get_stats(c, &st);
+    CHECK(st.rejections >= 1950);
+    CHECK(st.rejections <= st.evictions);
+    lru_free(c);
+}
+
+// 热键随机访问 + 穿插的一次性扫描（短于 2Q 的 A1out，更长的扫描 2Q 也挡不住）：抗扫描的策略命中率高于 LRU；统计、命中率与清空
+static void test_scan_resistance(void) {
+    double ratio[LRU_POLICY_COUNT];
+    for (int policy = 0; policy < LRU_POLICY_COUNT; policy++) {
+        LRUCache* c = make_policy_cache((LRUPolicy)policy, 1000, sizeof(uint64_t), 0, NULL, NULL, NULL);
+        uint64_t rng = 7, scan = 1000000;
+        for (int round = 0; round < 50; round++) {
+            for (int i = 0; i < 2000; i++) {
+                uint64_t k = ut_rand(&rng) % 800;
+                if (lru_get(c, &k, sizeof(k), NULL) != 0) {
+                    lru_put(c, &k, sizeof(k), NULL);
+                }
+            }
+            for (int i = 0; i < 600; i++, scan++) {
+                if (lru_get(c, &scan, sizeof(scan), NULL) != 0) {
+                    lru_put(c, &scan, sizeof(scan), NULL);
+                }
+            }
+        }
+        ratio[policy] = lru_hit_ratio(c);
+        LRUStats st;
+        lru_get_stats(c, &st);
+        CHECK_EQ(st.hits + st.misses, 50u * 2600);
+        lru_clear(c);
+        CHECK_EQ(lru_size(c), 0);
+        lru_get_stats(c, &st);
+        CHECK_EQ(st.hits + st.misses, 50u * 2600);
+        lru_reset_stats(c);
+        CHECK(lru_hit_ratio(c) == 0.0);
+        lru_free(c);
+    }
+    for (int policy = LRU_POLICY_2Q; policy < LRU_POLICY_COUNT; policy++) {
+        CHECK(ratio[policy] > ratio[LRU_POLICY_LRU] + 0.05);
+    }
+    CHECK(strcmp(lru_policy_name(LRU_POLICY_ARC), "ARC") == 0);
+    CHECK(strcmp(lru_policy_name(LRU_POLICY_WTINYLFU), "W-TinyLFU") == 0);
+    CHECK(strcmp(lru_policy_name(LRU_POLICY_COUNT), "unknown") == 0);
+}
+
+// 创建之后，插入、淘汰、删除都不分配内存
+static void test_no_alloc(void) {
+#ifdef __GLIBC__
+    for (int policy = 0; policy < LRU_POLICY_COUNT; policy++) {
+        LRUCache* c = make_policy_cache((LRUPolicy)policy, 10000, 16, sizeof(uint64_t), NULL, NULL, NULL);
+        struct mallinfo2 before = mallinfo2();
+        uint64_t rng = 42;
+        for (int i = 0; i < 200000; i++) {
+            uint64_t k = ut_rand(&rng) % 30000;
+            if (i % 5 == 0) {
+                lru_remove(c, &k, sizeof(k), NULL);
+            } else {
+                lru_put(c, &k, sizeof(k), &k);
+            }
+        }
+        struct mallinfo2 after = mallinfo2();
+        CHECK_EQ(after.uordblks, before.uordblks);
+        CHECK_EQ(lru_size(c) <= 10000, 1);
+        CHECK(lru_memory(c) > 10000 * (16 + 16 + 8));
+        lru_free(c);
+    }
+#endif
+}
+
+int main(void) {
+    test_simple();
+    test_strings();
+    test_random();
+    test_clock();
+    test_clock_random();
+    test_policy_random();
+    test_2q();
+    test_tinylfu();
+    test_scan_resistance();
+    test_no_alloc();
+
+    return ut_report("lru_test");
+}
@@ -0,0 +1,193 @@
+#include "shardlru.h"
+#include "ut_check.h"
+#include "ut_util.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ 分片 LRU 测试：参数与分片数、单线程下的插入 / 查找 / 删除 / 清空、
+ 缓冲的命中在淘汰前被补记（1 个分片时与精确 LRU 一致）、各分片独立淘汰，
+ 以及多线程并发读写：值与键始终对应、元素数不超过容量
+*/
+
+static ShardLRU* make_cache(size_t capacity, size_t shards) {
+    ShardLRUConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.capacity = capacity;
+    cfg.shards = shards;
+    cfg.max_key_size = 16;
+    cfg.value_size = sizeof(uint64_t);
+    return shardlru_create(&cfg);
+}
+
+static void test_basic(void) {
+    ShardLRUConfig bad;
+    memset(&bad, 0, sizeof(bad));
+    CHECK(shardlru_create(NULL) == NULL);
+    CHECK(shardlru_create(&bad) == NULL);
+
+    ShardLRU* c = make_cache(1000, 0);
+    CHECK_EQ(shardlru_shard_count(c), SHARDLRU_DEFAULT_SHARDS);
+    CHECK(shardlru_capacity(c) >= 1000);
+    for (uint64_t i = 0; i < 500; i++) {
+        CHECK_EQ(shardlru_put(c, &i, sizeof(i), &i), 1);
+    }
+    uint64_t k = 7, v = 0;
+    CHECK_EQ(shardlru_put(c, &k, sizeof(k), &k), 0);
+    CHECK_EQ(shardlru_size(c), 500);
+    size_t wrong = 0;
+    for (uint64_t i = 0; i < 500; i++) {
+        wrong += shardlru_get(c, &i, sizeof(i), &v) != 0 || v != i;
+    }
+    CHECK_EQ(wrong, 0);
+    k = 1000;
+    CHECK_EQ(shardlru_get(c, &k, sizeof(k), &v), -1);
+    CHECK_EQ(shardlru_put(c, "0123456789abcdefg", 17, NULL), -1);
+    k = 3;
+    CHECK_EQ(shardlru_remove(c, &k, sizeof(k), &v), 0);
+    CHECK_EQ(v, 3);
+    CHECK_EQ(shardlru_remove(c, &k, sizeof(k), NULL), -1);
+    CHECK_EQ(shardlru_get(c, &k, sizeof(k), NULL), -1);
+    CHECK_EQ(shardlru_size(c), 499);
+    shardlru_clear(c);
+    CHECK_EQ(shardlru_size(c), 0);
+    k = 4;
+    CHECK_EQ(shardlru_get(c, &k, sizeof(k), NULL), -1);
+    shardlru_free(c);
+    shardlru_free(NULL);
+
+    // 分片数不超过容量
+    c = make_cache(3, 64);
+    CHECK_EQ(shardlru_shard_count(c), 2);
+    CHECK_EQ(shardlru_capacity(c), 4);
+    shardlru_free(c);
+}
+
+// 1 个分片：缓冲的命中在 put 淘汰前补记，结果与精确 LRU 一致
+static void test_buffered_hits(void) {
+    ShardLRU* c = make_cache(100, 1);
+    CHECK_EQ(shardlru_shard_count(c), 1);
+    for (uint64_t i = 0; i < 100; i++) {
+        shardlru_put(c, &i, sizeof(i), &i);
+    }
+    // 命中最早插入的 10 个键（少于一轮缓冲，不会在 get 中补记）
+    for (uint64_t i = 0; i < 10; i++) {
+        CHECK_EQ(shardlru_get(c, &i, sizeof(i), NULL), 0);
+    }
+    for (uint64_t i = 100; i < 190; i++) {
+        shardlru_put(c, &i, sizeof(i), &i);
+    }
+    size_t wrong = 0;
+    for (uint64_t i = 0; i < 10; i++) {
+        wrong += shardlru_get(c, &i, sizeof(i), NULL) != 0;
+    }
+    for (uint64_t i = 10; i < 100; i++) {
+        wrong += shardlru_get(c, &i, sizeof(i), NULL) != -1;
+    }
+    CHECK_EQ(wrong, 0);
+
+    // 超过一轮的命中：get 自己补记，之后仍按最近使用的顺序淘汰
+    for (int round = 0; round < 3; round++) {
+        for (uint64_t i = 0; i < 50; i++) {
+            shardlru_get(c, &i, sizeof(i), NULL);
+        }
+    }
+    for (uint64_t i = 200; i < 250; i++) {
+        shardlru_put(c, &i, sizeof(i), &i);
+    }
+    wrong = 0;
+    for (uint64_t i = 0; i < 10; i++) {
+        wrong += shardlru_get(c, &i, sizeof(i), NULL) != 0;
+    }
+    CHECK_EQ(wrong, 0);
+    shardlru_free(c);
+}
+
+// 每个分片独立淘汰：总元素数不超过各分片容量之和，每个分片都被填满
+static void test_shard_eviction(void) {
+    ShardLRU* c = make_cache(1024, 8);
+    for (uint64_t i = 0; i < 100000; i++) {
+        shardlru_put(c, &i, sizeof(i), &i);
+    }
+    CHECK_EQ(shardlru_size(c), shardlru_capacity(c));
+    // 最近插入的键都在
+    size_t missing = 0;
+    for (uint64_t i = 100000 - 64; i < 100000; i++) {
+        missing += shardlru_get(c, &i, sizeof(i), NULL) != 0;
+    }
+    CHECK_EQ(missing, 0);
+    shardlru_free(c);
+}
+
+typedef struct {
+    ShardLRU* cache;
+    uint64_t seed;
+    size_t wrong;
+} Worker;
+
+#define VALUE_OF(k) ((k) * 0x9e3779b97f4a7c15ULL)
+
+static void* worker_main(void* arg) {
+    Worker* w = (Worker*)arg;
+    uint64_t rng = w->seed;
+    for (int i = 0; i < 200000; i++) {
+        uint64_t k = ut_rand(&rng) % 5000;
+        uint64_t op = ut_rand(&rng) % 10;
+        if (op < 7) {
+            uint64_t v = 0;
+            if (shardlru_get(w->cache, &k, sizeof(k), &v) == 0 && v != VALUE_OF(k)) {
+                w->wrong++;
+            }
+        } else if (op < 9) {
+            uint64_t v = VALUE_OF(k);
+            shardlru_put(w->cache, &k, sizeof(k), &v);
+        } else {
+            uint64_t v = 0;
+            if (shardlru_remove(w->cache, &k, sizeof(k), &v) == 0 && v != VALUE_OF(k)) {
+                w->wrong++;
+            }
+        }
+    }
+    return NULL;
+}
+
+static void test_concurrent(void) {
+    for (size_t shards = 1; shards <= 16; shards *= 16) {
+        ShardLRU* c = make_cache(2000, shards);
+        enum { THREADS = 8 };
+        pthread_t tids[THREADS];
+        Worker workers[THREADS];
+        for (int i = 0; i < THREADS; i++) {
+            workers[i].cache = c;
+            workers[i].seed = 0x9e3779b97f4a7c15ULL * (uint64_t)(i + 1);
+            workers[i].wrong = 0;
+            pthread_create(&tids[i], NULL, worker_main, &workers[i]);
+        }
+        size_t wrong = 0;
+        for (int i = 0; i < THREADS; i++) {
+            pthread_join(tids[i], NULL);
+            wrong += workers[i].wrong;
+        }
+        CHECK_EQ(wrong, 0);
+        CHECK(shardlru_size(c) <= shardlru_capacity(c));
+        for (uint64_t k = 0; k < 5000; k++) {
+            uint64_t v = 0;
+            if (shardlru_get(c, &k, sizeof(k), &v) == 0 && v != VALUE_OF(k)) {
+                wrong++;
+            }
+        }
+        CHECK_EQ(wrong, 0);
+        shardlru_free(c);
+    }
+}
+
+int main(void) {
+    test_basic();
+    test_buffered_hits();
+    test_shard_eviction();
+    test_concurrent();
+
+    return ut_report("shardlru_test");
+}
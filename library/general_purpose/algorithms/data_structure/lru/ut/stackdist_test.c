@@ -0,0 +1,89 @@
+#include "lru.h"
+#include "stackdist.h"
+#include "ut_check.h"
+#include "ut_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ LRU 栈距离测试：小例子的距离、与 lru.h 的 LRU 策略逐个容量重放的命中次数一致（含多次压缩与扩容）
+*/
+
+static void test_small(void) {
+    StackDist* sd = stackdist_create(0);
+    CHECK(sd != NULL);
+    // a b c a b b d a
+    const uint64_t seq[] = {1, 2, 3, 1, 2, 2, 4, 1};
+    const size_t want[] = {STACKDIST_COLD, STACKDIST_COLD, STACKDIST_COLD, 2, 2, 0, STACKDIST_COLD, 2};
+    for (size_t i = 0; i < sizeof(seq) / sizeof(seq[0]); i++) {
+        size_t d;
+        CHECK_EQ(stackdist_access(sd, seq[i], &d), 0);
+        CHECK_EQ(d, want[i]);
+    }
+    CHECK_EQ(stackdist_accesses(sd), 8);
+    CHECK_EQ(stackdist_unique(sd), 4);
+    CHECK_EQ(stackdist_hits(sd, 0), 0);
+    CHECK_EQ(stackdist_hits(sd, 1), 1);
+    CHECK_EQ(stackdist_hits(sd, 2), 1);
+    CHECK_EQ(stackdist_hits(sd, 3), 4);
+    CHECK_EQ(stackdist_hits(sd, 1000), 4);
+    stackdist_free(sd);
+}
+
+// 用 lru.h 的 LRU 策略重放：get 未命中再 put
+static uint64_t lru_replay_hits(const uint64_t* keys, size_t n, size_t capacity) {
+    LRUConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.capacity = capacity;
+    cfg.max_key_size = sizeof(uint64_t);
+    LRUCache* c = lru_create(&cfg);
+    for (size_t i = 0; i < n; i++) {
+        if (lru_get(c, &keys[i], sizeof(uint64_t), NULL) != 0) {
+            lru_put(c, &keys[i], sizeof(uint64_t), NULL);
+        }
+    }
+    LRUStats st;
+    lru_get_stats(c, &st);
+    lru_free(c);
+    return st.hits;
+}
+
+static void run_against_lru(size_t n, uint64_t universe, int skewed) {
+    uint64_t* keys = (uint64_t*)malloc(n * sizeof(uint64_t));
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t r = ut_rand(&rng);
+        // 偏斜：一半访问落在 1/16 的键上
+        keys[i] = skewed && (r & 1) ? r % (universe / 16 + 1) : r % universe;
+    }
+    StackDist* sd = stackdist_create(0);
+    for (size_t i = 0; i < n; i++) {
+        CHECK_EQ(stackdist_access(sd, keys[i], NULL), 0);
+    }
+    const size_t caps[] = {1, 2, 10, 100, 1000, 5000, 20000};
+    uint64_t hits[sizeof(caps) / sizeof(caps[0])];
+    stackdist_curve(sd, caps, sizeof(caps) / sizeof(caps[0]), hits);
+    for (size_t i = 0; i < sizeof(caps) / sizeof(caps[0]); i++) {
+        CHECK_EQ(hits[i], lru_replay_hits(keys, n, caps[i]));
+        CHECK_EQ(hits[i], stackdist_hits(sd, caps[i]));
+    }
+    // 容量装得下全部键时只有冷启动未命中
+    CHECK_EQ(stackdist_hits(sd, stackdist_unique(sd)), n - stackdist_unique(sd));
+    stackdist_free(sd);
+    free(keys);
+}
+
+static void test_against_lru(void) {
+    // 初始 1024 个条目、2048 个位置：多次压缩，不同键数超过初始值时扩容
+    run_against_lru(200000, 300, 0);
+    run_against_lru(200000, 8000, 1);
+    run_against_lru(100000, 50000, 1);
+}
+
+int main(void) {
+    test_small();
+    test_against_lru();
+
+    return ut_report("stackdist_test");
+}
@@ -0,0 +1,29 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "error.h"
+#include <stddef.h>
+#include <stdio.h>
+
+// 批处理模式读取/输出缓冲区大小
+#define BATCH_READ_SIZE  (1 << 20)
+#define BATCH_WRITE_SIZE (1 << 20)
+
+// 批处理统计信息
+typedef struct {
+    size_t lines;       // 处理的行数
+    size_t errors;      // 出错的行数
+    // 以下字段仅在启用计数分配器（calc_enable_alloc_stats）时统计
+    size_t allocations;         // 所有行的分配次数之和
+    size_t alloc_bytes;         // 所有行申请的字节数之和
+    size_t max_line_allocations;// 单行最多的分配次数
+    size_t peak_bytes;          // 单行求值期间未释放字节数的最大峰值
+} BatchStats;
+
+// 函数声明
+int run_batch_file(const char* path, BatchStats* stats);
+int run_batch_fd(int fd, BatchStats* stats);
+int evaluate_line(const char* line, size_t length, double* result, CalcError* error);
+void print_batch_stats(FILE* out, const BatchStats* stats);
+
+#endif // BATCH_H
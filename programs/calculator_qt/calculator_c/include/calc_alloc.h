@@ -0,0 +1,53 @@
+#ifndef CALC_ALLOC_H
+#define CALC_ALLOC_H
+
+#include <stddef.h>
+
+// 可替换的内存分配接口
+// 计算器核心（词法分析、语法分析、求值）的所有动态内存都经由 CALC_MALLOC/CALC_REALLOC/CALC_FREE，
+// 既可以在编译时重定义这三个宏，也可以在运行时通过 calc_set_allocator 替换分配器
+typedef struct {
+    void* (*malloc_fn)(void* ctx, size_t size);
+    void* (*realloc_fn)(void* ctx, void* ptr, size_t size);
+    void (*free_fn)(void* ctx, void* ptr);
+    void* ctx;
+} CalcAllocator;
+
+// 分配统计信息
+typedef struct {
+    size_t allocations;     // malloc 与 realloc 的调用次数
+    size_t frees;           // free 的调用次数
+    size_t bytes;           // 累计申请的字节数
+    size_t current_bytes;   // 当前未释放的字节数
+    size_t peak_bytes;      // 统计区间内未释放字节数的峰值
+} CalcAllocStats;
+
+// 替换分配器，传入NULL恢复为标准库分配器
+// 已分配的内存必须由分配它的分配器释放，因此只能在没有未释放内存时切换
+void calc_set_allocator(const CalcAllocator* allocator);
+const CalcAllocator* calc_get_allocator(void);
+
+void* calc_malloc(size_t size);
+void* calc_realloc(void* ptr, size_t size);
+void calc_free(void* ptr);
+
+#ifndef CALC_MALLOC
+#define CALC_MALLOC(size) calc_malloc(size)
+#endif
+#ifndef CALC_REALLOC
+#define CALC_REALLOC(ptr, size) calc_realloc((ptr), (size))
+#endif
+#ifndef CALC_FREE
+#define CALC_FREE(ptr) calc_free(ptr)
+#endif
+
+// 启用计数分配器：在当前分配器之上为每块内存记录大小，统计次数、字节与峰值
+// 与 calc_set_allocator 一样，必须在计算器分配任何内存之前调用
+void calc_enable_alloc_stats(void);
+int calc_alloc_stats_enabled(void);
+const CalcAllocStats* calc_get_alloc_stats(void);
+
+// 开始新的统计区间：清零次数与字节，峰值从当前未释放字节数重新计起
+void calc_reset_alloc_stats(void);
+
+#endif // CALC_ALLOC_H
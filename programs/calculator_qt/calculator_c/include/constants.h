@@ -1,15 +1,18 @@
 #ifndef CONSTANTS_H
 #define CONSTANTS_H
 
+#include <stddef.h>
+
 #define MAX_CONSTANTS 10
 
 // 常量结构
 typedef struct {
-    char name[10];
+    const char* name;
     double value;
 } Constant;
 
 // 函数声明
+int lookup_constant(const char* name, size_t length);
 int is_constant(const char* name);
 double get_constant_value(const char* name);
 int get_constants_count();
@@ -1,6 +1,8 @@
 #ifndef FUNCTIONS_H
 #define FUNCTIONS_H
 
+#include <stddef.h>
+
 #define MAX_FUNCTIONS 20
 
 // 函数指针类型定义
@@ -8,13 +10,16 @@ typedef double (*FunctionPtr)(double*, int);
 
 // 函数结构
 typedef struct {
-    char name[10];
+    const char* name;
     FunctionPtr func;
     int min_args;
     int max_args;
 } Function;
 
 // 函数声明
+int lookup_function(const char* name, size_t length);
+Function* get_function_at(int index);
+double evaluate_function_at(int index, double* args, int arg_count);
 int is_function(const char* name);
 FunctionPtr get_function(const char* name);
 int get_function_arg_count(const char* name);
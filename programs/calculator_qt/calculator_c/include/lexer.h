@@ -2,6 +2,8 @@
 #define LEXER_H
 
 #include "error.h"
+#include <stddef.h>
+#include <stdint.h>
 
 // Token类型枚举
 typedef enum {
@@ -16,23 +18,29 @@ typedef enum {
 } TokenType;
 
 // Token结构
+// 标识符不再拷贝到定长缓冲区中：函数/常量记录其符号ID（函数表/常量表下标），
+// 原始文本通过 start/length 引用源表达式，因此标识符长度不受限制
 typedef struct {
-    TokenType type;
     double value;       // 当type为TOKEN_NUMBER时使用
-    char name[32];      // 当type为TOKEN_FUNCTION或TOKEN_CONSTANT时使用
+    size_t start;       // token在源表达式中的起始偏移
+    TokenType type;
+    int symbol;         // 当type为TOKEN_FUNCTION或TOKEN_CONSTANT时使用
+    uint32_t length;    // token在源表达式中的长度
     char op;            // 当type为TOKEN_OPERATOR时使用
 } Token;
 
 // 词法分析器结构
 typedef struct {
     const char* expression;
-    int pos;
+    size_t length;      // 表达式长度（不要求以'\0'结尾）
+    size_t pos;
     Token current_token;
     CalcError error;
 } Lexer;
 
 // 函数声明
 void init_lexer(Lexer* lexer, const char* expression);
+void init_lexer_n(Lexer* lexer, const char* expression, size_t length);
 Token get_next_token(Lexer* lexer);
 void consume_token(Lexer* lexer);
 int is_operator(char c);
@@ -14,7 +14,7 @@ typedef enum {
     NODE_CONSTANT
 } NodeType;
 
-// AST节点结构
+// AST节点结构（64位平台上为32字节，两个节点恰好占满一条缓存行）
 typedef struct ASTNode {
     NodeType type;
     union {
@@ -29,30 +29,37 @@ typedef struct ASTNode {
             struct ASTNode* operand;
         } unary_op;  // 当type为NODE_UNARY_OP时使用
         struct {
-            char name[32];
-            struct ASTNode** args;
+            int symbol;   // 函数的符号ID
             int arg_count;
+            struct ASTNode** args;
         } function_call;  // 当type为NODE_FUNCTION_CALL时使用
-        char constant_name[32];  // 当type为NODE_CONSTANT时使用
+        int constant;  // 当type为NODE_CONSTANT时使用，常量的符号ID
     } data;
 } ASTNode;
 
+// 括号与函数调用的最大嵌套层数
+// 每层嵌套在解析时占用 parse_factor/parse_expression/parse_term 三个栈帧，求值与释放时也按层递归，
+// 超过这个深度的表达式报语法错误，而不是在超长的输入行上耗尽调用栈
+#define PARSER_MAX_DEPTH 1000
+
 // 解析器结构
 typedef struct {
     Lexer lexer;
     CalcError error;
+    int depth;      // 当前括号与函数调用的嵌套层数
 } Parser;
 
 // 函数声明
 void init_parser(Parser* parser, const char* expression);
+void init_parser_n(Parser* parser, const char* expression, size_t length);
 ASTNode* parse_expression(Parser* parser);
 ASTNode* parse_term(Parser* parser);
 ASTNode* parse_factor(Parser* parser);
 ASTNode* create_number_node(double value);
 ASTNode* create_binary_op_node(char op, ASTNode* left, ASTNode* right);
 ASTNode* create_unary_op_node(char op, ASTNode* operand);
-ASTNode* create_function_call_node(const char* name, ASTNode** args, int arg_count);
-ASTNode* create_constant_node(const char* name);
+ASTNode* create_function_call_node(int symbol, ASTNode** args, int arg_count);
+ASTNode* create_constant_node(int symbol);
 void free_ast(ASTNode* node);
 int get_operator_precedence(char op);
 
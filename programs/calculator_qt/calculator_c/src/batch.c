@@ -0,0 +1,312 @@
+#define _GNU_SOURCE
+#include "batch.h"
+#include "calc_alloc.h"
+#include "parser.h"
+#include "calculator.h"
+#include "error.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 输出缓冲区：所有结果先写入一块大缓冲区，写满后一次 write() 输出
+typedef struct {
+    int fd;
+    char* buffer;
+    size_t length;
+    int failed;
+} BatchWriter;
+
+static void writer_flush(BatchWriter* writer) {
+    size_t offset = 0;
+
+    while (offset < writer->length && !writer->failed) {
+        ssize_t written = write(writer->fd, writer->buffer + offset,
+                                writer->length - offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            writer->failed = 1;
+            break;
+        }
+        offset += (size_t)written;
+    }
+    writer->length = 0;
+}
+
+// 保证缓冲区至少还有 size 字节空间
+static void writer_reserve(BatchWriter* writer, size_t size) {
+    if (BATCH_WRITE_SIZE - writer->length < size) {
+        writer_flush(writer);
+    }
+}
+
+static void writer_append(BatchWriter* writer, const char* data, size_t size) {
+    while (size > 0) {
+        writer_reserve(writer, 1);
+        size_t chunk = BATCH_WRITE_SIZE - writer->length;
+        if (chunk > size) {
+            chunk = size;
+        }
+        memcpy(writer->buffer + writer->length, data, chunk);
+        writer->length += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+// 输出格式（每个输入行对应一个输出行）：
+//   成功: <结果>\n          结果使用 %.17g，可无损还原为 double
+//   失败: error\t<信息>\n
+//   空行: \n
+static void write_result(BatchWriter* writer, double result) {
+    writer_reserve(writer, 32);
+    int n = snprintf(writer->buffer + writer->length, 32, "%.17g\n", result);
+    if (n > 0) {
+        writer->length += (size_t)n;
+    }
+}
+
+static void write_error(BatchWriter* writer, const char* message) {
+    writer_append(writer, "error\t", 6);
+    writer_append(writer, message, strlen(message));
+    writer_append(writer, "\n", 1);
+}
+
+int evaluate_line(const char* line, size_t length, double* result, CalcError* error) {
+    if (line == NULL || result == NULL || error == NULL) {
+        return -1;
+    }
+
+    Parser parser;
+    init_parser_n(&parser, line, length);
+
+    ASTNode* ast = parse_expression(&parser);
+    if (ast == NULL) {
+        if (parser.error.message[0] != '\0') {
+            *error = parser.error;
+        } else {
+            init_error(error, SYNTAX_ERROR, "表达式解析失败");
+        }
+        return -1;
+    }
+
+    if (parser.lexer.current_token.type != TOKEN_END) {
+        free_ast(ast);
+        init_error(error, SYNTAX_ERROR, "表达式解析完成后仍有未处理的字符");
+        return -1;
+    }
+
+    Calculator calc;
+    init_calculator(&calc);
+    *result = evaluate(&calc, ast);
+    free_ast(ast);
+
+    if (calc.error.message[0] != '\0') {
+        *error = calc.error;
+        return -1;
+    }
+    return 0;
+}
+
+// 处理一行输入（不含换行符），行内容直接引用输入缓冲区，不做拷贝
+static void process_line(BatchWriter* writer, const char* line, size_t length,
+                         BatchStats* stats) {
+    // 兼容 CRLF 换行
+    if (length > 0 && line[length - 1] == '\r') {
+        length--;
+    }
+
+    stats->lines++;
+
+    size_t start = 0;
+    while (start < length && is_whitespace(line[start])) {
+        start++;
+    }
+    if (start == length) {
+        writer_append(writer, "\n", 1);
+        return;
+    }
+
+    double result;
+    CalcError error;
+    int alloc_stats = calc_alloc_stats_enabled();
+    if (alloc_stats) {
+        calc_reset_alloc_stats();
+    }
+    if (evaluate_line(line + start, length - start, &result, &error) == 0) {
+        write_result(writer, result);
+    } else {
+        stats->errors++;
+        write_error(writer, error.message);
+    }
+    if (alloc_stats) {
+        const CalcAllocStats* line_stats = calc_get_alloc_stats();
+        stats->allocations += line_stats->allocations;
+        stats->alloc_bytes += line_stats->bytes;
+        if (line_stats->allocations > stats->max_line_allocations) {
+            stats->max_line_allocations = line_stats->allocations;
+        }
+        if (line_stats->peak_bytes > stats->peak_bytes) {
+            stats->peak_bytes = line_stats->peak_bytes;
+        }
+    }
+}
+
+// 切分 [data, data + size) 中的完整行，返回已消费的字节数
+// at_eof 为真时最后一段不带换行的内容也作为一行处理
+static size_t process_lines(BatchWriter* writer, const char* data, size_t size,
+                            int at_eof, BatchStats* stats) {
+    size_t offset = 0;
+
+    while (offset < size) {
+        const char* newline = memchr(data + offset, '\n', size - offset);
+        if (newline == NULL) {
+            if (at_eof) {
+                process_line(writer, data + offset, size - offset, stats);
+                offset = size;
+            }
+            break;
+        }
+
+        size_t length = (size_t)(newline - (data + offset));
+        process_line(writer, data + offset, length, stats);
+        offset += length + 1;
+    }
+
+    return offset;
+}
+
+// 普通文件：整体映射到内存，按行切分后直接求值
+static int run_batch_mapped(BatchWriter* writer, int fd, size_t size,
+                            BatchStats* stats) {
+    if (size == 0) {
+        return 0;
+    }
+
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        return -1;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    process_lines(writer, (const char*)data, size, 1, stats);
+
+    munmap(data, size);
+    return 0;
+}
+
+// 管道/终端：大块 read() 读入缓冲区，未读完的行移到缓冲区开头
+// 单行超过缓冲区时按两倍扩容（与 custom_getline 相同的策略）
+static int run_batch_stream(BatchWriter* writer, int fd, BatchStats* stats) {
+    size_t capacity = BATCH_READ_SIZE;
+    size_t length = 0;
+    char* buffer = (char*)malloc(capacity);
+    if (buffer == NULL) {
+        return -1;
+    }
+
+    int status = 0;
+    while (1) {
+        if (length == capacity) {
+            size_t new_capacity = capacity * 2;
+            char* new_buffer = (char*)realloc(buffer, new_capacity);
+            if (new_buffer == NULL) {
+                status = -1;
+                break;
+            }
+            buffer = new_buffer;
+            capacity = new_capacity;
+        }
+
+        ssize_t n = read(fd, buffer + length, capacity - length);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            status = -1;
+            break;
+        }
+        if (n == 0) {
+            process_lines(writer, buffer, length, 1, stats);
+            break;
+        }
+
+        // 只扫描新读入的数据中是否出现换行，避免对超长行重复扫描
+        size_t scanned = length;
+        length += (size_t)n;
+        if (memchr(buffer + scanned, '\n', length - scanned) == NULL) {
+            continue;
+        }
+
+        size_t consumed = process_lines(writer, buffer, length, 0, stats);
+        memmove(buffer, buffer + consumed, length - consumed);
+        length -= consumed;
+    }
+
+    free(buffer);
+    return status;
+}
+
+int run_batch_fd(int fd, BatchStats* stats) {
+    BatchStats local_stats = {0};
+    if (stats == NULL) {
+        stats = &local_stats;
+    }
+
+    BatchWriter writer = {STDOUT_FILENO, NULL, 0, 0};
+    writer.buffer = (char*)malloc(BATCH_WRITE_SIZE);
+    if (writer.buffer == NULL) {
+        return -1;
+    }
+
+    struct stat st;
+    int status;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        status = run_batch_mapped(&writer, fd, (size_t)st.st_size, stats);
+    } else {
+        status = run_batch_stream(&writer, fd, stats);
+    }
+
+    writer_flush(&writer);
+    free(writer.buffer);
+
+    if (writer.failed) {
+        return -1;
+    }
+    return status;
+}
+
+int run_batch_file(const char* path, BatchStats* stats) {
+    if (path == NULL || strcmp(path, "-") == 0) {
+        return run_batch_fd(STDIN_FILENO, stats);
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    int status = run_batch_fd(fd, stats);
+    close(fd);
+    return status;
+}
+
+void print_batch_stats(FILE* out, const BatchStats* stats) {
+    size_t evaluated = stats->lines;
+
+    fprintf(out, "行数: %zu, 错误: %zu\n", stats->lines, stats->errors);
+    if (!calc_alloc_stats_enabled()) {
+        return;
+    }
+    fprintf(out, "分配次数: %zu (平均每行 %.2f, 单行最多 %zu)\n", stats->allocations,
+            evaluated ? (double)stats->allocations / evaluated : 0.0,
+            stats->max_line_allocations);
+    fprintf(out, "分配字节: %zu (平均每行 %.1f), 单行峰值: %zu 字节\n", stats->alloc_bytes,
+            evaluated ? (double)stats->alloc_bytes / evaluated : 0.0, stats->peak_bytes);
+}
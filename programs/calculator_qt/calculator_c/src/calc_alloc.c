@@ -0,0 +1,136 @@
+#include "calc_alloc.h"
+#include <stddef.h>
+#include <stdlib.h>
+
+static void* default_malloc(void* ctx, size_t size) {
+    (void)ctx;
+    return malloc(size);
+}
+
+static void* default_realloc(void* ctx, void* ptr, size_t size) {
+    (void)ctx;
+    return realloc(ptr, size);
+}
+
+static void default_free(void* ctx, void* ptr) {
+    (void)ctx;
+    free(ptr);
+}
+
+static const CalcAllocator default_allocator = {
+    default_malloc, default_realloc, default_free, NULL
+};
+
+static CalcAllocator current_allocator = {
+    default_malloc, default_realloc, default_free, NULL
+};
+
+// 计数分配器包装的底层分配器
+static CalcAllocator counted_allocator;
+static CalcAllocStats alloc_stats;
+static int stats_enabled = 0;
+
+// 每块内存前的大小记录，按 max_align_t 对齐以保持返回地址的对齐
+typedef union {
+    size_t size;
+    max_align_t align;
+} AllocHeader;
+
+static void record_alloc(size_t size) {
+    alloc_stats.allocations++;
+    alloc_stats.bytes += size;
+    alloc_stats.current_bytes += size;
+    if (alloc_stats.current_bytes > alloc_stats.peak_bytes) {
+        alloc_stats.peak_bytes = alloc_stats.current_bytes;
+    }
+}
+
+static void* counting_malloc(void* ctx, size_t size) {
+    (void)ctx;
+    AllocHeader* header = (AllocHeader*)counted_allocator.malloc_fn(
+        counted_allocator.ctx, sizeof(AllocHeader) + size);
+    if (header == NULL) {
+        return NULL;
+    }
+    header->size = size;
+    record_alloc(size);
+    return header + 1;
+}
+
+static void* counting_realloc(void* ctx, void* ptr, size_t size) {
+    (void)ctx;
+    if (ptr == NULL) {
+        return counting_malloc(ctx, size);
+    }
+    AllocHeader* header = (AllocHeader*)ptr - 1;
+    size_t old_size = header->size;
+    header = (AllocHeader*)counted_allocator.realloc_fn(
+        counted_allocator.ctx, header, sizeof(AllocHeader) + size);
+    if (header == NULL) {
+        return NULL;
+    }
+    header->size = size;
+    alloc_stats.current_bytes -= old_size;
+    record_alloc(size);
+    return header + 1;
+}
+
+static void counting_free(void* ctx, void* ptr) {
+    (void)ctx;
+    if (ptr == NULL) {
+        return;
+    }
+    AllocHeader* header = (AllocHeader*)ptr - 1;
+    alloc_stats.frees++;
+    alloc_stats.current_bytes -= header->size;
+    counted_allocator.free_fn(counted_allocator.ctx, header);
+}
+
+void calc_set_allocator(const CalcAllocator* allocator) {
+    current_allocator = allocator != NULL ? *allocator : default_allocator;
+    stats_enabled = 0;
+}
+
+const CalcAllocator* calc_get_allocator(void) {
+    return &current_allocator;
+}
+
+void* calc_malloc(size_t size) {
+    return current_allocator.malloc_fn(current_allocator.ctx, size);
+}
+
+void* calc_realloc(void* ptr, size_t size) {
+    return current_allocator.realloc_fn(current_allocator.ctx, ptr, size);
+}
+
+void calc_free(void* ptr) {
+    current_allocator.free_fn(current_allocator.ctx, ptr);
+}
+
+void calc_enable_alloc_stats(void) {
+    if (stats_enabled) {
+        return;
+    }
+    counted_allocator = current_allocator;
+    current_allocator.malloc_fn = counting_malloc;
+    current_allocator.realloc_fn = counting_realloc;
+    current_allocator.free_fn = counting_free;
+    current_allocator.ctx = NULL;
+    alloc_stats = (CalcAllocStats){0, 0, 0, 0, 0};
+    stats_enabled = 1;
+}
+
+int calc_alloc_stats_enabled(void) {
+    return stats_enabled;
+}
+
+const CalcAllocStats* calc_get_alloc_stats(void) {
+    return &alloc_stats;
+}
+
+void calc_reset_alloc_stats(void) {
+    alloc_stats.allocations = 0;
+    alloc_stats.frees = 0;
+    alloc_stats.bytes = 0;
+    alloc_stats.peak_bytes = alloc_stats.current_bytes;
+}
@@ -1,4 +1,5 @@
 #include "calculator.h"
+#include "calc_alloc.h"
 #include "functions.h"
 #include "constants.h"
 #include <stdio.h>
@@ -15,6 +16,65 @@ void init_calculator(Calculator* calc) {
     calc->error.message[0] = '\0';
 }
 
+// 二元运算左链的初始栈容量，覆盖绝大多数交互式表达式
+#define CHAIN_STACK_SIZE 32
+
+// 沿左子树迭代求值二元运算链
+// 左结合的长表达式（如 1+1+...+1）会生成与项数等深的左链，递归求值在
+// 数 MB 的单个表达式上会耗尽调用栈，这里改用显式栈保存链上的节点
+static double evaluate_binary_chain(Calculator* calc, ASTNode* node) {
+    ASTNode* local_stack[CHAIN_STACK_SIZE];
+    ASTNode** stack = local_stack;
+    size_t capacity = CHAIN_STACK_SIZE;
+    size_t depth = 0;
+    
+    while (node != NULL && node->type == NODE_BINARY_OP) {
+        if (depth == capacity) {
+            size_t new_capacity = capacity * 2;
+            ASTNode** new_stack;
+            if (stack == local_stack) {
+                new_stack = (ASTNode**)CALC_MALLOC(new_capacity * sizeof(ASTNode*));
+                if (new_stack != NULL) {
+                    memcpy(new_stack, local_stack, sizeof(local_stack));
+                }
+            } else {
+                new_stack = (ASTNode**)CALC_REALLOC(stack, new_capacity * sizeof(ASTNode*));
+            }
+            if (new_stack == NULL) {
+                if (stack != local_stack) {
+                    CALC_FREE(stack);
+                }
+                init_error(&calc->error, EVALUATION_ERROR, "内存分配失败");
+                return 0.0;
+            }
+            stack = new_stack;
+            capacity = new_capacity;
+        }
+        stack[depth++] = node;
+        node = node->data.binary_op.left;
+    }
+    
+    // 先求最左端的操作数，再自底向上依次结合右操作数
+    double result = evaluate(calc, node);
+    while (depth > 0 && calc->error.message[0] == '\0') {
+        ASTNode* op_node = stack[--depth];
+        double right = evaluate(calc, op_node->data.binary_op.right);
+        if (calc->error.message[0] != '\0') {
+            break;
+        }
+        result = apply_operator(calc, op_node->data.binary_op.op, result, right);
+    }
+    
+    if (stack != local_stack) {
+        CALC_FREE(stack);
+    }
+    
+    if (calc->error.message[0] != '\0') {
+        return 0.0;
+    }
+    return result;
+}
+
 double evaluate(Calculator* calc, ASTNode* node) {
     if (calc == NULL || node == NULL) {
         if (calc != NULL) {
@@ -28,26 +88,16 @@ double evaluate(Calculator* calc, ASTNode* node) {
             return node->data.value;
             
         case NODE_CONSTANT: {
-            if (!is_constant(node->data.constant_name)) {
+            Constant* constant = get_constant_at(node->data.constant);
+            if (constant == NULL) {
                 init_error(&calc->error, EVALUATION_ERROR, "未知常量");
                 return 0.0;
             }
-            return get_constant_value(node->data.constant_name);
+            return constant->value;
         }
             
-        case NODE_BINARY_OP: {
-            double left = evaluate(calc, node->data.binary_op.left);
-            if (calc->error.message[0] != '\0') {
-                return 0.0;
-            }
-            
-            double right = evaluate(calc, node->data.binary_op.right);
-            if (calc->error.message[0] != '\0') {
-                return 0.0;
-            }
-            
-            return apply_operator(calc, node->data.binary_op.op, left, right);
-        }
+        case NODE_BINARY_OP:
+            return evaluate_binary_chain(calc, node);
             
         case NODE_UNARY_OP: {
             double operand = evaluate(calc, node->data.unary_op.operand);
@@ -59,7 +109,12 @@ double evaluate(Calculator* calc, ASTNode* node) {
         }
             
         case NODE_FUNCTION_CALL: {
-            double* args = (double*)malloc(node->data.function_call.arg_count * sizeof(double));
+            if (get_function_at(node->data.function_call.symbol) == NULL) {
+                init_error(&calc->error, EVALUATION_ERROR, "未知函数");
+                return 0.0;
+            }
+            
+            double* args = (double*)CALC_MALLOC(node->data.function_call.arg_count * sizeof(double));
             if (args == NULL) {
                 init_error(&calc->error, EVALUATION_ERROR, "内存分配失败");
                 return 0.0;
@@ -68,13 +123,13 @@ double evaluate(Calculator* calc, ASTNode* node) {
             for (int i = 0; i < node->data.function_call.arg_count; i++) {
                 args[i] = evaluate(calc, node->data.function_call.args[i]);
                 if (calc->error.message[0] != '\0') {
-                    free(args);
+                    CALC_FREE(args);
                     return 0.0;
                 }
             }
             
-            double result = apply_function(calc, node->data.function_call.name, args, node->data.function_call.arg_count);
-            free(args);
+            double result = evaluate_function_at(node->data.function_call.symbol, args, node->data.function_call.arg_count);
+            CALC_FREE(args);
             return result;
         }
             
@@ -11,6 +11,23 @@ static Constant constants[] = {
 // 常量数量
 static int constants_count = sizeof(constants) / sizeof(Constant);
 
+// 按名称查找常量，返回其在常量表中的下标（即符号ID），未找到返回-1
+// 名称由 (指针, 长度) 给出，可以直接引用源文本而无需拷贝
+int lookup_constant(const char* name, size_t length) {
+    if (name == NULL) {
+        return -1;
+    }
+    
+    for (int i = 0; i < constants_count; i++) {
+        if (strncmp(constants[i].name, name, length) == 0 &&
+            constants[i].name[length] == '\0') {
+            return i;
+        }
+    }
+    
+    return -1;
+}
+
 int is_constant(const char* name) {
     if (name == NULL) {
         return 0;
@@ -19,6 +19,46 @@ static Function functions[] = {
 // 函数数量
 static int functions_count = sizeof(functions) / sizeof(Function);
 
+// 按名称查找函数，返回其在函数表中的下标（即符号ID），未找到返回-1
+// 名称由 (指针, 长度) 给出，可以直接引用源文本而无需拷贝
+int lookup_function(const char* name, size_t length) {
+    if (name == NULL) {
+        return -1;
+    }
+    
+    for (int i = 0; i < functions_count; i++) {
+        if (strncmp(functions[i].name, name, length) == 0 &&
+            functions[i].name[length] == '\0') {
+            return i;
+        }
+    }
+    
+    return -1;
+}
+
+Function* get_function_at(int index) {
+    if (index < 0 || index >= functions_count) {
+        return NULL;
+    }
+    
+    return &functions[index];
+}
+
+// 按符号ID调用函数，省去按名称的查找
+double evaluate_function_at(int index, double* args, int arg_count) {
+    Function* function = get_function_at(index);
+    if (function == NULL || args == NULL) {
+        return 0.0;
+    }
+    
+    // 检查参数数量
+    if (arg_count < function->min_args || arg_count > function->max_args) {
+        return 0.0;
+    }
+    
+    return function->func(args, arg_count);
+}
+
 int is_function(const char* name) {
     if (name == NULL) {
         return 0;
@@ -1,4 +1,5 @@
 #include "lexer.h"
+#include "calc_alloc.h"
 #include "constants.h"
 #include "functions.h"
 #include <stdio.h>
@@ -11,7 +12,17 @@ void init_lexer(Lexer* lexer, const char* expression) {
         return;
     }
     
+    init_lexer_n(lexer, expression, strlen(expression));
+}
+
+void init_lexer_n(Lexer* lexer, const char* expression, size_t length) {
+    if (lexer == NULL || expression == NULL) {
+        return;
+    }
+    
+    // 按长度界定表达式，调用方可以直接传入大缓冲区中的一行而无需拷贝
     lexer->expression = expression;
+    lexer->length = length;
     lexer->pos = 0;
     lexer->current_token.type = TOKEN_END;
     lexer->error.type = CALC_ERROR;
@@ -26,7 +37,7 @@ void skip_whitespace(Lexer* lexer) {
         return;
     }
     
-    while (lexer->expression[lexer->pos] != '\0' && 
+    while (lexer->pos < lexer->length && 
            is_whitespace(lexer->expression[lexer->pos])) {
         lexer->pos++;
     }
@@ -40,112 +51,127 @@ int is_operator(char c) {
     return c == '+' || c == '-' || c == '*' || c == '/' || c == '^';
 }
 
+// 构造一个引用源表达式 [start, end) 的token
+static Token make_token(TokenType type, size_t start, size_t end) {
+    Token token;
+    token.value = 0.0;
+    token.start = start;
+    token.type = type;
+    token.symbol = -1;
+    token.length = (uint32_t)(end - start);
+    token.op = 0;
+    return token;
+}
+
 Token get_next_token(Lexer* lexer) {
     if (lexer == NULL || lexer->expression == NULL) {
-        Token error_token = {TOKEN_ERROR, 0.0, "", 0};
-        return error_token;
+        return make_token(TOKEN_ERROR, 0, 0);
     }
     
     skip_whitespace(lexer);
     
     // 检查是否到达表达式末尾
-    if (lexer->expression[lexer->pos] == '\0') {
-        Token end_token = {TOKEN_END, 0.0, "", 0};
-        return end_token;
+    if (lexer->pos >= lexer->length) {
+        return make_token(TOKEN_END, lexer->pos, lexer->pos);
     }
     
     char ch = lexer->expression[lexer->pos];
     
     // 处理数字
     if (isdigit(ch) || ch == '.') {
-        int start = lexer->pos;
-        while (lexer->expression[lexer->pos] != '\0' && 
+        size_t start = lexer->pos;
+        while (lexer->pos < lexer->length && 
                (isdigit(lexer->expression[lexer->pos]) || 
                 lexer->expression[lexer->pos] == '.')) {
             lexer->pos++;
         }
         
-        // 创建临时字符串来存储数字
-        int len = lexer->pos - start;
-        char* num_str = (char*)malloc(len + 1);
-        if (num_str == NULL) {
-            Token error_token = {TOKEN_ERROR, 0.0, "", 0};
-            return error_token;
+        // token长度用32位记录，超长的数字字面量视为错误而不是截断
+        size_t len = lexer->pos - start;
+        if (len > UINT32_MAX) {
+            return make_token(TOKEN_ERROR, start, start);
+        }
+        
+        // 创建临时字符串来存储数字，常见的短数字直接使用栈上缓冲区
+        char num_buf[64];
+        char* num_str = num_buf;
+        if (len >= sizeof(num_buf)) {
+            num_str = (char*)CALC_MALLOC(len + 1);
+            if (num_str == NULL) {
+                return make_token(TOKEN_ERROR, start, lexer->pos);
+            }
         }
         
-        strncpy(num_str, &lexer->expression[start], len);
+        memcpy(num_str, &lexer->expression[start], len);
         num_str[len] = '\0';
         
         double value = atof(num_str);
-        free(num_str);
+        if (num_str != num_buf) {
+            CALC_FREE(num_str);
+        }
         
-        Token number_token = {TOKEN_NUMBER, value, "", 0};
+        Token number_token = make_token(TOKEN_NUMBER, start, lexer->pos);
+        number_token.value = value;
         return number_token;
     }
     
     // 处理标识符（函数名或常量）
+    // 标识符直接在源文本上按 (指针, 长度) 查表得到符号ID，不拷贝也不截断
     if (isalpha(ch)) {
-        int start = lexer->pos;
-        while (lexer->expression[lexer->pos] != '\0' && 
+        size_t start = lexer->pos;
+        while (lexer->pos < lexer->length && 
                isalnum(lexer->expression[lexer->pos])) {
             lexer->pos++;
         }
         
-        // 创建临时字符串来存储标识符
-        int len = lexer->pos - start;
-        if (len >= 32) {
-            len = 31; // 防止缓冲区溢出
+        const char* name = &lexer->expression[start];
+        size_t len = lexer->pos - start;
+        if (len > UINT32_MAX) {
+            return make_token(TOKEN_ERROR, start, start);
         }
         
-        char name[32];
-        strncpy(name, &lexer->expression[start], len);
-        name[len] = '\0';
-        
         // 检查是否为常量
-        if (is_constant(name)) {
-            Token constant_token = {TOKEN_CONSTANT, 0.0, "", 0};
-            constant_token.type = TOKEN_CONSTANT;
-            strcpy(constant_token.name, name);
+        int symbol = lookup_constant(name, len);
+        if (symbol >= 0) {
+            Token constant_token = make_token(TOKEN_CONSTANT, start, lexer->pos);
+            constant_token.symbol = symbol;
             return constant_token;
         }
         
         // 检查是否为函数
-        if (is_function(name)) {
-            Token function_token = {TOKEN_FUNCTION, 0.0, "", 0};
-            function_token.type = TOKEN_FUNCTION;
-            strcpy(function_token.name, name);
+        symbol = lookup_function(name, len);
+        if (symbol >= 0) {
+            Token function_token = make_token(TOKEN_FUNCTION, start, lexer->pos);
+            function_token.symbol = symbol;
             return function_token;
         }
         
         // 未知标识符
-        Token error_token = {TOKEN_ERROR, 0.0, "", 0};
-        return error_token;
+        return make_token(TOKEN_ERROR, start, lexer->pos);
     }
     
     // 处理操作符
     if (is_operator(ch)) {
         lexer->pos++;
-        Token operator_token = {TOKEN_OPERATOR, 0.0, "", ch};
+        Token operator_token = make_token(TOKEN_OPERATOR, lexer->pos - 1, lexer->pos);
+        operator_token.op = ch;
         return operator_token;
     }
     
     // 处理括号
     if (ch == '(') {
         lexer->pos++;
-        Token lparen_token = {TOKEN_LPAREN, 0.0, "", 0};
-        return lparen_token;
+        return make_token(TOKEN_LPAREN, lexer->pos - 1, lexer->pos);
     }
     
     if (ch == ')') {
         lexer->pos++;
-        Token rparen_token = {TOKEN_RPAREN, 0.0, "", 0};
-        return rparen_token;
+        return make_token(TOKEN_RPAREN, lexer->pos - 1, lexer->pos);
     }
     
     // 未知字符
     lexer->pos++;
-    Token error_token = {TOKEN_ERROR, 0.0, "", 0};
-    return error_token;
+    return make_token(TOKEN_ERROR, lexer->pos - 1, lexer->pos);
 }
 
 void consume_token(Lexer* lexer) {
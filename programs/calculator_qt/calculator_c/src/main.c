@@ -2,11 +2,70 @@
 #include "parser.h"
 #include "calculator.h"
 #include "error.h"
+#include "batch.h"
+#include "calc_alloc.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-int main() {
+static void show_usage(const char* program) {
+    fprintf(stderr, "用法: %s [--stats] [--batch [文件]]\n", program);
+    fprintf(stderr, "  无参数            交互模式\n");
+    fprintf(stderr, "  -b, --batch [文件] 批处理模式，逐行求值文件（缺省或 '-' 为标准输入）\n");
+    fprintf(stderr, "                    输出每行一个结果，出错时输出 'error<TAB>信息'\n");
+    fprintf(stderr, "  -s, --stats       统计内存分配：交互模式下每个表达式显示解析与求值的分配，\n");
+    fprintf(stderr, "                    批处理模式结束时向标准错误输出汇总\n");
+}
+
+// 显示一个阶段的分配统计，并开始下一个统计区间
+static void show_alloc_stats(const char* phase) {
+    const CalcAllocStats* stats = calc_get_alloc_stats();
+    printf("  [%s] 分配 %zu 次, %zu 字节, 峰值 %zu 字节\n", phase, stats->allocations,
+           stats->bytes, stats->peak_bytes);
+    calc_reset_alloc_stats();
+}
+
+int main(int argc, char* argv[]) {
+    int batch = 0;
+    int show_stats = 0;
+    const char* path = NULL;
+    
+    // 选项可以任意顺序出现，第一个非选项参数（或单独的 '-'）是批处理的文件
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--stats") == 0) {
+            show_stats = 1;
+        } else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--batch") == 0) {
+            batch = 1;
+        } else if (path == NULL && (argv[i][0] != '-' || strcmp(argv[i], "-") == 0)) {
+            path = argv[i];
+        } else {
+            show_usage(argv[0]);
+            return 2;
+        }
+    }
+    // 文件只在批处理模式下有意义
+    if (path != NULL && !batch) {
+        show_usage(argv[0]);
+        return 2;
+    }
+    
+    // 计数分配器必须在计算器分配任何内存之前启用
+    if (show_stats) {
+        calc_enable_alloc_stats();
+    }
+    
+    if (batch) {
+        BatchStats stats = {0};
+        if (run_batch_file(path, &stats) != 0) {
+            perror(path != NULL ? path : "stdin");
+            return 1;
+        }
+        if (show_stats) {
+            print_batch_stats(stderr, &stats);
+        }
+        return 0;
+    }
+    
     show_welcome();
     
     char input[256];
@@ -31,6 +90,10 @@ int main() {
             continue;
         }
         
+        if (show_stats) {
+            calc_reset_alloc_stats();
+        }
+        
         // 初始化解析器
         Parser parser;
         init_parser(&parser, input);
@@ -40,7 +103,7 @@ int main() {
         
         // 检查解析是否成功
         if (ast == NULL) {
-            show_error("表达式解析失败");
+            show_error(parser.error.message[0] != '\0' ? parser.error.message : "表达式解析失败");
             continue;
         }
         
@@ -53,12 +116,19 @@ int main() {
             continue;
         }
         
+        if (show_stats) {
+            show_alloc_stats("解析");
+        }
+        
         // 初始化计算器
         Calculator calc;
         init_calculator(&calc);
         
         // 计算结果
         double result = evaluate(&calc, ast);
+        if (show_stats) {
+            show_alloc_stats("求值");
+        }
         
         // 释放AST内存
         free_ast(ast);
@@ -1,4 +1,5 @@
 #include "parser.h"
+#include "calc_alloc.h"
 #include "constants.h"
 #include "functions.h"
 #include <stdio.h>
@@ -10,9 +11,28 @@ void init_parser(Parser* parser, const char* expression) {
         return;
     }
     
-    init_lexer(&parser->lexer, expression);
+    init_parser_n(parser, expression, strlen(expression));
+}
+
+void init_parser_n(Parser* parser, const char* expression, size_t length) {
+    if (parser == NULL || expression == NULL) {
+        return;
+    }
+    
+    init_lexer_n(&parser->lexer, expression, length);
     parser->error.type = CALC_ERROR;
     parser->error.message[0] = '\0';
+    parser->depth = 0;
+}
+
+// 进入一层括号或函数调用，超过 PARSER_MAX_DEPTH 时记录错误并返回 -1
+static int enter_nesting(Parser* parser) {
+    if (parser->depth >= PARSER_MAX_DEPTH) {
+        init_error(&parser->error, SYNTAX_ERROR, "括号或函数调用嵌套过深");
+        return -1;
+    }
+    parser->depth++;
+    return 0;
 }
 
 ASTNode* parse_expression(Parser* parser) {
@@ -99,19 +119,21 @@ ASTNode* parse_factor(Parser* parser) {
     // 处理常量
     if (token.type == TOKEN_CONSTANT) {
         consume_token(&parser->lexer);
-        return create_constant_node(token.name);
+        return create_constant_node(token.symbol);
     }
     
     // 处理函数调用
     if (token.type == TOKEN_FUNCTION) {
-        char func_name[32];
-        strcpy(func_name, token.name);
+        int func_symbol = token.symbol;
         consume_token(&parser->lexer); // 消费函数名
         
         if (parser->lexer.current_token.type != TOKEN_LPAREN) {
             // 设置错误信息
             return NULL;
         }
+        if (enter_nesting(parser) != 0) {
+            return NULL;
+        }
         consume_token(&parser->lexer); // 消费左括号
         
         // 解析参数列表
@@ -125,7 +147,7 @@ ASTNode* parse_factor(Parser* parser) {
             }
             
             // 分配参数数组
-            args = (ASTNode**)malloc(sizeof(ASTNode*));
+            args = (ASTNode**)CALC_MALLOC(sizeof(ASTNode*));
             if (args == NULL) {
                 free_ast(first_arg);
                 return NULL;
@@ -143,18 +165,18 @@ ASTNode* parse_factor(Parser* parser) {
                     for (int i = 0; i < arg_count; i++) {
                         free_ast(args[i]);
                     }
-                    free(args);
+                    CALC_FREE(args);
                     return NULL;
                 }
                 
                 // 重新分配参数数组
-                ASTNode** new_args = (ASTNode**)realloc(args, (arg_count + 1) * sizeof(ASTNode*));
+                ASTNode** new_args = (ASTNode**)CALC_REALLOC(args, (arg_count + 1) * sizeof(ASTNode*));
                 if (new_args == NULL) {
                     // 释放已分配的参数
                     for (int i = 0; i < arg_count; i++) {
                         free_ast(args[i]);
                     }
-                    free(args);
+                    CALC_FREE(args);
                     free_ast(arg);
                     return NULL;
                 }
@@ -171,29 +193,46 @@ ASTNode* parse_factor(Parser* parser) {
                 for (int i = 0; i < arg_count; i++) {
                     free_ast(args[i]);
                 }
-                free(args);
+                CALC_FREE(args);
             }
             return NULL;
         }
         consume_token(&parser->lexer); // 消费右括号
+        parser->depth--;
         
-        return create_function_call_node(func_name, args, arg_count);
+        return create_function_call_node(func_symbol, args, arg_count);
     }
     
     // 处理一元操作符
+    // 连续的正负号（如 ---x）在这里迭代合并为至多一个取负节点，
+    // 不再每个符号递归一层，否则几十万个连续负号就会耗尽调用栈
     if (token.type == TOKEN_OPERATOR && 
         (token.op == '+' || token.op == '-')) {
-        char op = token.op;
-        consume_token(&parser->lexer); // 消费操作符
+        int negate = 0;
+        while (parser->lexer.current_token.type == TOKEN_OPERATOR &&
+               (parser->lexer.current_token.op == '+' || parser->lexer.current_token.op == '-')) {
+            negate ^= parser->lexer.current_token.op == '-';
+            consume_token(&parser->lexer); // 消费操作符
+        }
         ASTNode* operand = parse_factor(parser);
         if (operand == NULL) {
             return NULL;
         }
-        return create_unary_op_node(op, operand);
+        if (!negate) {
+            return operand;
+        }
+        ASTNode* node = create_unary_op_node('-', operand);
+        if (node == NULL) {
+            free_ast(operand);
+        }
+        return node;
     }
     
     // 处理括号表达式
     if (token.type == TOKEN_LPAREN) {
+        if (enter_nesting(parser) != 0) {
+            return NULL;
+        }
         consume_token(&parser->lexer); // 消费左括号
         ASTNode* expr = parse_expression(parser);
         if (expr == NULL) {
@@ -205,6 +244,7 @@ ASTNode* parse_factor(Parser* parser) {
             return NULL;
         }
         consume_token(&parser->lexer); // 消费右括号
+        parser->depth--;
         return expr;
     }
     
@@ -212,7 +252,7 @@ ASTNode* parse_factor(Parser* parser) {
 }
 
 ASTNode* create_number_node(double value) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
+    ASTNode* node = (ASTNode*)CALC_MALLOC(sizeof(ASTNode));
     if (node == NULL) {
         return NULL;
     }
@@ -223,7 +263,7 @@ ASTNode* create_number_node(double value) {
 }
 
 ASTNode* create_binary_op_node(char op, ASTNode* left, ASTNode* right) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
+    ASTNode* node = (ASTNode*)CALC_MALLOC(sizeof(ASTNode));
     if (node == NULL) {
         return NULL;
     }
@@ -236,7 +276,7 @@ ASTNode* create_binary_op_node(char op, ASTNode* left, ASTNode* right) {
 }
 
 ASTNode* create_unary_op_node(char op, ASTNode* operand) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
+    ASTNode* node = (ASTNode*)CALC_MALLOC(sizeof(ASTNode));
     if (node == NULL) {
         return NULL;
     }
@@ -247,57 +287,58 @@ ASTNode* create_unary_op_node(char op, ASTNode* operand) {
     return node;
 }
 
-ASTNode* create_function_call_node(const char* name, ASTNode** args, int arg_count) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
+ASTNode* create_function_call_node(int symbol, ASTNode** args, int arg_count) {
+    ASTNode* node = (ASTNode*)CALC_MALLOC(sizeof(ASTNode));
     if (node == NULL) {
         return NULL;
     }
     
     node->type = NODE_FUNCTION_CALL;
-    strncpy(node->data.function_call.name, name, sizeof(node->data.function_call.name) - 1);
-    node->data.function_call.name[sizeof(node->data.function_call.name) - 1] = '\0';
+    node->data.function_call.symbol = symbol;
     node->data.function_call.args = args;
     node->data.function_call.arg_count = arg_count;
     return node;
 }
 
-ASTNode* create_constant_node(const char* name) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
+ASTNode* create_constant_node(int symbol) {
+    ASTNode* node = (ASTNode*)CALC_MALLOC(sizeof(ASTNode));
     if (node == NULL) {
         return NULL;
     }
     
     node->type = NODE_CONSTANT;
-    strncpy(node->data.constant_name, name, sizeof(node->data.constant_name) - 1);
-    node->data.constant_name[sizeof(node->data.constant_name) - 1] = '\0';
+    node->data.constant = symbol;
     return node;
 }
 
 void free_ast(ASTNode* node) {
-    if (node == NULL) {
-        return;
-    }
-    
-    switch (node->type) {
-        case NODE_BINARY_OP:
-            free_ast(node->data.binary_op.left);
-            free_ast(node->data.binary_op.right);
-            break;
-        case NODE_UNARY_OP:
-            free_ast(node->data.unary_op.operand);
-            break;
-        case NODE_FUNCTION_CALL:
-            for (int i = 0; i < node->data.function_call.arg_count; i++) {
-                free_ast(node->data.function_call.args[i]);
-            }
-            free(node->data.function_call.args);
-            break;
-        default:
-            // 其他节点类型不需要特殊处理
-            break;
+    // 左结合的长表达式（如 1+1+...+1）会生成很深的左链，
+    // 沿左子树迭代释放，避免超长表达式导致栈溢出
+    while (node != NULL) {
+        ASTNode* next = NULL;
+        
+        switch (node->type) {
+            case NODE_BINARY_OP:
+                free_ast(node->data.binary_op.right);
+                next = node->data.binary_op.left;
+                break;
+            case NODE_UNARY_OP:
+                next = node->data.unary_op.operand;
+                break;
+            case NODE_FUNCTION_CALL:
+                for (int i = 0; i < node->data.function_call.arg_count; i++) {
+                    free_ast(node->data.function_call.args[i]);
+                }
+                CALC_FREE(node->data.function_call.args);
+                break;
+            default:
+                // 其他节点类型不需要特殊处理
+                break;
+        }
+        
+        CALC_FREE(node);
+        node = next;
     }
-    
-    free(node);
 }
 
 int get_operator_precedence(char op) {
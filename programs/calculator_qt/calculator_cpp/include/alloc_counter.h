@@ -0,0 +1,25 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstddef>
+
+// 分配统计信息
+struct AllocStats {
+    size_t allocations = 0;   // operator new 调用次数
+    size_t frees = 0;         // operator delete 调用次数
+    size_t bytes = 0;         // 累计申请的字节数
+    size_t currentBytes = 0;  // 当前未释放的字节数
+    size_t peakBytes = 0;     // 统计区间内未释放字节数的峰值
+};
+
+// operator new 计数替换
+// src/alloc_counter.cpp 替换了全局的 operator new/delete，只有显式链接
+// calculator_cpp_alloc 对象库的程序才会计数；计算器为单线程程序，计数器不加锁
+class AllocCounter {
+public:
+    static const AllocStats& stats();
+    // 开始新的统计区间：清零次数与字节，峰值从当前未释放字节数重新计起
+    static void reset();
+};
+
+#endif // ALLOC_COUNTER_H
@@ -56,13 +56,14 @@ class Parser {
 public:
     Parser(const std::string& expression);
     std::shared_ptr<ASTNode> parse();
+    // 仅做词法分析，返回全部token（以END结尾），与parse()共用同一输入，二者只能调用其一
+    std::vector<Token> tokenize();
 
 private:
     std::string expression;
     size_t pos;
     Token currentToken;
     
-    std::vector<Token> tokenize();
     Token getNextToken();
     void consumeToken();
     
@@ -0,0 +1,96 @@
+#include "alloc_counter.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+AllocStats counters;
+
+// 每块内存前的大小记录，按 max_align_t 对齐以保持返回地址的对齐
+union AllocHeader {
+    size_t size;
+    std::max_align_t align;
+};
+
+void* countedAlloc(size_t size) {
+    AllocHeader* header = static_cast<AllocHeader*>(std::malloc(sizeof(AllocHeader) + size));
+    if (header == nullptr) {
+        return nullptr;
+    }
+    header->size = size;
+    counters.allocations++;
+    counters.bytes += size;
+    counters.currentBytes += size;
+    if (counters.currentBytes > counters.peakBytes) {
+        counters.peakBytes = counters.currentBytes;
+    }
+    return header + 1;
+}
+
+void countedFree(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    AllocHeader* header = static_cast<AllocHeader*>(ptr) - 1;
+    counters.frees++;
+    counters.currentBytes -= header->size;
+    std::free(header);
+}
+
+} // namespace
+
+const AllocStats& AllocCounter::stats() {
+    return counters;
+}
+
+void AllocCounter::reset() {
+    counters.allocations = 0;
+    counters.frees = 0;
+    counters.bytes = 0;
+    counters.peakBytes = counters.currentBytes;
+}
+
+// 数组、nothrow 与带大小的版本在标准库中默认转发到以下函数，这里仍显式替换以免依赖实现细节
+void* operator new(size_t size) {
+    void* ptr = countedAlloc(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    countedFree(ptr);
+}
@@ -2,10 +2,31 @@
 #include "parser.h"
 #include "calculator.h"
 #include "error.h"
+#include "alloc_counter.h"
 #include <iostream>
 #include <string>
 
-int main() {
+// 显示一个阶段的分配统计，并开始下一个统计区间
+static void showAllocStats(const char* phase) {
+    const AllocStats& stats = AllocCounter::stats();
+    std::cout << "  [" << phase << "] 分配 " << stats.allocations << " 次, " << stats.bytes
+              << " 字节, 峰值 " << stats.peakBytes << " 字节\n";
+    AllocCounter::reset();
+}
+
+int main(int argc, char* argv[]) {
+    bool showStats = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-s" || arg == "--stats") {
+            showStats = true;
+        } else {
+            std::cerr << "用法: " << argv[0] << " [--stats]\n"
+                      << "  -s, --stats  每个表达式显示解析与求值的内存分配统计\n";
+            return 2;
+        }
+    }
+
     UI::showWelcome();
     
     while (true) {
@@ -28,14 +49,24 @@ int main() {
             continue;
         }
         
+        if (showStats) {
+            AllocCounter::reset();
+        }
+        
         try {
             // 解析表达式
             Parser parser(input);
             std::shared_ptr<ASTNode> ast = parser.parse();
+            if (showStats) {
+                showAllocStats("解析");
+            }
             
             // 计算结果
             Calculator calc;
             double result = calc.evaluate(ast);
+            if (showStats) {
+                showAllocStats("求值");
+            }
             
             // 显示结果
             UI::showResult(result);
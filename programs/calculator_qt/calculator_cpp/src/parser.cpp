@@ -17,6 +17,16 @@ std::shared_ptr<ASTNode> Parser::parse() {
     return result;
 }
 
+std::vector<Token> Parser::tokenize() {
+    std::vector<Token> tokens;
+    while (currentToken.type != END) {
+        tokens.push_back(currentToken);
+        consumeToken();
+    }
+    tokens.push_back(currentToken);
+    return tokens;
+}
+
 void Parser::skipWhitespace() {
     while (pos < expression.length() && std::isspace(expression[pos])) {
         pos++;
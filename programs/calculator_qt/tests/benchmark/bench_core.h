@@ -0,0 +1,50 @@
+#ifndef BENCH_CORE_H
+#define BENCH_CORE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 求值状态
+#define BENCH_OK    0
+#define BENCH_ERROR 1
+#define BENCH_DOMAIN 2  // 函数定义域错误（C 版本返回0，C++ 版本抛出 std::invalid_argument）
+
+// 一次操作的分配统计
+typedef struct {
+    unsigned long long allocations;
+    unsigned long long bytes;
+    unsigned long long peak_bytes;   // 相对区间开始时的峰值增量
+} BenchAlloc;
+
+// 计算器核心的统一测量接口
+// C 与 C++ 两个版本的头文件同名且类型冲突（Parser/ASTNode/Calculator），
+// 无法在同一个翻译单元中包含，因此各自在独立的源文件中实现本接口，
+// 基准测试主程序只通过函数指针调用
+typedef struct {
+    const char* name;
+    // 仅词法分析，返回token数量（不含结束标记），出错返回-1
+    long (*lex)(const char* expr, size_t length);
+    // 解析并释放AST，成功返回BENCH_OK
+    int (*parse)(const char* expr, size_t length);
+    // 解析一次并保留AST，供求值阶段反复使用，失败返回NULL
+    void* (*prepare)(const char* expr, size_t length);
+    // 对prepare得到的AST求值
+    int (*eval)(void* prepared, double* result);
+    void (*release)(void* prepared);
+    // 开始一个分配统计区间；C 版本在首次调用时启用计数分配器，
+    // 因此首次调用前不能持有该核心分配的内存
+    void (*alloc_begin)(void);
+    void (*alloc_end)(BenchAlloc* alloc);
+} BenchCore;
+
+extern const BenchCore bench_core_c;
+extern const BenchCore bench_core_cpp;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_CORE_H
@@ -0,0 +1,72 @@
+#include "bench_core.h"
+#include "calc_alloc.h"
+#include "calculator.h"
+#include "lexer.h"
+#include "parser.h"
+
+static long c_lex(const char* expr, size_t length) {
+    Lexer lexer;
+    long count = 0;
+
+    init_lexer_n(&lexer, expr, length);
+    while (lexer.current_token.type != TOKEN_END) {
+        if (lexer.current_token.type == TOKEN_ERROR) {
+            return -1;
+        }
+        count++;
+        consume_token(&lexer);
+    }
+    return count;
+}
+
+static void* c_prepare(const char* expr, size_t length) {
+    Parser parser;
+    init_parser_n(&parser, expr, length);
+
+    ASTNode* ast = parse_expression(&parser);
+    if (ast != NULL && parser.lexer.current_token.type != TOKEN_END) {
+        free_ast(ast);
+        return NULL;
+    }
+    return ast;
+}
+
+static int c_parse(const char* expr, size_t length) {
+    ASTNode* ast = (ASTNode*)c_prepare(expr, length);
+    if (ast == NULL) {
+        return BENCH_ERROR;
+    }
+    free_ast(ast);
+    return BENCH_OK;
+}
+
+static int c_eval(void* prepared, double* result) {
+    Calculator calc;
+    init_calculator(&calc);
+
+    *result = evaluate(&calc, (ASTNode*)prepared);
+    return calc.error.message[0] == '\0' ? BENCH_OK : BENCH_ERROR;
+}
+
+static void c_release(void* prepared) {
+    free_ast((ASTNode*)prepared);
+}
+
+static size_t alloc_base_bytes = 0;
+
+static void c_alloc_begin(void) {
+    calc_enable_alloc_stats();
+    calc_reset_alloc_stats();
+    alloc_base_bytes = calc_get_alloc_stats()->current_bytes;
+}
+
+static void c_alloc_end(BenchAlloc* alloc) {
+    const CalcAllocStats* stats = calc_get_alloc_stats();
+    alloc->allocations = stats->allocations;
+    alloc->bytes = stats->bytes;
+    alloc->peak_bytes = stats->peak_bytes - alloc_base_bytes;
+}
+
+const BenchCore bench_core_c = {
+    "c", c_lex, c_parse, c_prepare, c_eval, c_release, c_alloc_begin, c_alloc_end,
+};
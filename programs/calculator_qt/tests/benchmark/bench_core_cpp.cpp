@@ -0,0 +1,75 @@
+#include "bench_core.h"
+#include "alloc_counter.h"
+#include "calculator.h"
+#include "error.h"
+#include "parser.h"
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// C++ 版本的 Parser 以 std::string 接收表达式，构造字符串的拷贝计入测量结果
+long cppLex(const char* expr, size_t length) {
+    try {
+        Parser parser(std::string(expr, length));
+        return static_cast<long>(parser.tokenize().size()) - 1;
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+void* cppPrepare(const char* expr, size_t length) {
+    try {
+        Parser parser(std::string(expr, length));
+        return new std::shared_ptr<ASTNode>(parser.parse());
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+int cppParse(const char* expr, size_t length) {
+    try {
+        Parser parser(std::string(expr, length));
+        std::shared_ptr<ASTNode> ast = parser.parse();
+        return BENCH_OK;
+    } catch (const std::exception&) {
+        return BENCH_ERROR;
+    }
+}
+
+int cppEval(void* prepared, double* result) {
+    try {
+        Calculator calc;
+        *result = calc.evaluate(*static_cast<std::shared_ptr<ASTNode>*>(prepared));
+        return BENCH_OK;
+    } catch (const std::invalid_argument&) {
+        return BENCH_DOMAIN;
+    } catch (const std::exception&) {
+        return BENCH_ERROR;
+    }
+}
+
+void cppRelease(void* prepared) {
+    delete static_cast<std::shared_ptr<ASTNode>*>(prepared);
+}
+
+size_t allocBaseBytes = 0;
+
+void cppAllocBegin() {
+    AllocCounter::reset();
+    allocBaseBytes = AllocCounter::stats().currentBytes;
+}
+
+void cppAllocEnd(BenchAlloc* alloc) {
+    const AllocStats& stats = AllocCounter::stats();
+    alloc->allocations = stats.allocations;
+    alloc->bytes = stats.bytes;
+    alloc->peak_bytes = stats.peakBytes - allocBaseBytes;
+}
+
+} // namespace
+
+extern "C" const BenchCore bench_core_cpp = {
+    "cpp", cppLex, cppParse, cppPrepare, cppEval, cppRelease, cppAllocBegin, cppAllocEnd,
+};
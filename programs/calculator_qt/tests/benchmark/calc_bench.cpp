@@ -0,0 +1,326 @@
+// 科学计算器进程内基准测试
+// 直接链接 C 与 C++ 两个计算器核心，分别测量词法分析、语法分析、求值三个阶段，
+// 不包含进程启动、终端输出与欢迎信息，每项给出多次采样的 ns/op 分布，
+// 以及单次操作的分配次数、字节数与峰值（在计时之外单独运行一次统计）
+#include "bench_core.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct BenchCase {
+    std::string name;
+    std::string kind;   // "size": 平铺的长表达式, "depth": 括号嵌套深度
+    int param;          // 项数或嵌套深度
+    std::string expr;
+};
+
+struct Summary {
+    bool valid = false;
+    size_t samples = 0;
+    unsigned long long opsPerSample = 0;
+    double min = 0, mean = 0, p50 = 0, p90 = 0, p99 = 0;
+};
+
+struct CoreResult {
+    long tokens = -1;
+    bool ok = false;
+    double value = 0;
+    Summary lex, parse, eval;
+    BenchAlloc lexAlloc{}, parseAlloc{}, evalAlloc{};
+};
+
+struct Options {
+    size_t samples = 25;
+    double minSampleNs = 200000.0;  // 每个样本至少持续200微秒，以摊薄计时开销
+    std::string jsonPath;
+    bool quick = false;
+    double maxAllocsPerToken = -1;  // 解析与求值的分配次数/token 上限，负数表示不检查
+};
+
+using Clock = std::chrono::steady_clock;
+
+// 平铺表达式：N 项交替使用数字、函数调用与常量
+std::string makeSizeExpr(int terms) {
+    static const char* operands[] = {"3.25", "sin(0.5)", "2", "sqrt(16)", "pi", "1.5"};
+    static const char* ops[] = {" + ", " * ", " - ", " / "};
+    std::string expr;
+    for (int i = 0; i < terms; i++) {
+        if (i > 0) {
+            expr += ops[i % 4];
+        }
+        expr += operands[i % 6];
+    }
+    return expr;
+}
+
+// 嵌套表达式：((((1 + 1.5) * 1.5) - 1.5) ...)，语法分析递归深度等于嵌套层数
+std::string makeDepthExpr(int depth) {
+    static const char ops[] = {'+', '*', '-', '/'};
+    std::string expr = "1";
+    for (int i = 0; i < depth; i++) {
+        expr = "(" + expr + " " + ops[i % 4] + " 1.5)";
+    }
+    return expr;
+}
+
+std::vector<BenchCase> buildCorpus(bool quick) {
+    std::vector<BenchCase> corpus;
+    std::vector<int> sizes = {1, 10, 100, 1000, 10000};
+    std::vector<int> depths = {1, 4, 16, 64, 256};
+    if (quick) {
+        sizes = {1, 100};
+        depths = {16};
+    }
+    for (int n : sizes) {
+        corpus.push_back({"size_" + std::to_string(n), "size", n, makeSizeExpr(n)});
+    }
+    for (int d : depths) {
+        corpus.push_back({"depth_" + std::to_string(d), "depth", d, makeDepthExpr(d)});
+    }
+    return corpus;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    double rank = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(rank);
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    double frac = rank - lo;
+    return sorted[lo] * (1.0 - frac) + sorted[hi] * frac;
+}
+
+// 先倍增单个样本的重复次数直到耗时超过下限，再采集多个样本
+template <typename Fn>
+Summary measure(Fn&& op, const Options& options) {
+    Summary summary;
+    unsigned long long reps = 1;
+    while (true) {
+        auto start = Clock::now();
+        for (unsigned long long i = 0; i < reps; i++) {
+            op();
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        if (ns >= options.minSampleNs || reps >= (1ULL << 30)) {
+            break;
+        }
+        reps *= 2;
+    }
+
+    std::vector<double> perOp;
+    perOp.reserve(options.samples);
+    for (size_t s = 0; s < options.samples; s++) {
+        auto start = Clock::now();
+        for (unsigned long long i = 0; i < reps; i++) {
+            op();
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        perOp.push_back(ns / reps);
+    }
+
+    std::sort(perOp.begin(), perOp.end());
+    double sum = 0;
+    for (double v : perOp) {
+        sum += v;
+    }
+    summary.valid = true;
+    summary.samples = perOp.size();
+    summary.opsPerSample = reps;
+    summary.min = perOp.front();
+    summary.mean = sum / perOp.size();
+    summary.p50 = percentile(perOp, 0.50);
+    summary.p90 = percentile(perOp, 0.90);
+    summary.p99 = percentile(perOp, 0.99);
+    return summary;
+}
+
+CoreResult runCore(const BenchCore& core, const BenchCase& bc, const Options& options) {
+    CoreResult result;
+    const char* expr = bc.expr.data();
+    size_t length = bc.expr.size();
+
+    core.alloc_begin();
+    result.tokens = core.lex(expr, length);
+    core.alloc_end(&result.lexAlloc);
+    if (result.tokens < 0) {
+        return result;
+    }
+    core.alloc_begin();
+    core.parse(expr, length);
+    core.alloc_end(&result.parseAlloc);
+    result.lex = measure([&] { core.lex(expr, length); }, options);
+    result.parse = measure([&] { core.parse(expr, length); }, options);
+
+    void* ast = core.prepare(expr, length);
+    if (ast == nullptr) {
+        return result;
+    }
+    core.alloc_begin();
+    result.ok = core.eval(ast, &result.value) == BENCH_OK;
+    core.alloc_end(&result.evalAlloc);
+    if (result.ok) {
+        double sink = 0;
+        result.eval = measure([&] { core.eval(ast, &sink); }, options);
+    }
+    core.release(ast);
+    return result;
+}
+
+void printRow(const char* core, const char* phase, const Summary& s, long tokens,
+              const BenchAlloc& alloc) {
+    if (!s.valid) {
+        std::printf("  %-4s %-6s %12s\n", core, phase, "-");
+        return;
+    }
+    std::printf("  %-4s %-6s %12.1f %12.1f %12.1f %10.2f %8llu %10llu %10llu\n", core, phase,
+                s.p50, s.p90, s.p99, tokens > 0 ? s.p50 / tokens : 0.0, alloc.allocations,
+                alloc.bytes, alloc.peak_bytes);
+}
+
+void writeSummary(std::ostream& out, const Summary& s) {
+    if (!s.valid) {
+        out << "null";
+        return;
+    }
+    out << "{\"samples\": " << s.samples << ", \"ops_per_sample\": " << s.opsPerSample
+        << ", \"ns_per_op\": {\"min\": " << s.min << ", \"mean\": " << s.mean
+        << ", \"p50\": " << s.p50 << ", \"p90\": " << s.p90 << ", \"p99\": " << s.p99
+        << "}}";
+}
+
+void writeAlloc(std::ostream& out, const BenchAlloc& a) {
+    out << "{\"count\": " << a.allocations << ", \"bytes\": " << a.bytes
+        << ", \"peak_bytes\": " << a.peak_bytes << "}";
+}
+
+void writeCore(std::ostream& out, const CoreResult& r) {
+    out << "{\"tokens\": " << r.tokens << ", \"ok\": " << (r.ok ? "true" : "false");
+    if (r.ok && std::isfinite(r.value)) {
+        char value[32];
+        std::snprintf(value, sizeof(value), "%.17g", r.value);
+        out << ", \"value\": " << value;
+    }
+    out << ", \"lex\": ";
+    writeSummary(out, r.lex);
+    out << ", \"parse\": ";
+    writeSummary(out, r.parse);
+    out << ", \"eval\": ";
+    writeSummary(out, r.eval);
+    out << ", \"alloc\": {\"lex\": ";
+    writeAlloc(out, r.lexAlloc);
+    out << ", \"parse\": ";
+    writeAlloc(out, r.parseAlloc);
+    out << ", \"eval\": ";
+    if (r.ok) {
+        writeAlloc(out, r.evalAlloc);
+    } else {
+        out << "null";
+    }
+    out << "}}";
+}
+
+void usage(const char* program) {
+    std::fprintf(stderr,
+                 "用法: %s [--json 文件] [--samples N] [--min-sample-us N] [--quick]\n"
+                 "       [--max-allocs-per-token X]  解析与求值的分配次数/token 超过X时返回1\n",
+                 program);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            options.jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            options.samples = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--min-sample-us") == 0 && i + 1 < argc) {
+            options.minSampleNs = std::atof(argv[++i]) * 1000.0;
+        } else if (std::strcmp(argv[i], "--max-allocs-per-token") == 0 && i + 1 < argc) {
+            options.maxAllocsPerToken = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--quick") == 0) {
+            options.quick = true;
+            options.samples = 5;
+            options.minSampleNs = 20000.0;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    const BenchCore* cores[] = {&bench_core_c, &bench_core_cpp};
+    std::vector<BenchCase> corpus = buildCorpus(options.quick);
+    std::vector<std::vector<CoreResult>> results;
+    int gateFailures = 0;
+
+    // C 版本在首次调用时启用计数分配器，必须先于任何测量
+    for (const BenchCore* core : cores) {
+        core->alloc_begin();
+    }
+
+    std::printf("%-6s %-6s %12s %12s %12s %10s %8s %10s %10s\n", "core", "phase", "p50 ns/op",
+                "p90 ns/op", "p99 ns/op", "ns/token", "allocs", "bytes", "peak B");
+    for (const BenchCase& bc : corpus) {
+        std::printf("%s (%zu bytes)\n", bc.name.c_str(), bc.expr.size());
+        std::vector<CoreResult> row;
+        for (const BenchCore* core : cores) {
+            CoreResult r = runCore(*core, bc, options);
+            printRow(core->name, "lex", r.lex, r.tokens, r.lexAlloc);
+            printRow(core->name, "parse", r.parse, r.tokens, r.parseAlloc);
+            printRow(core->name, "eval", r.eval, r.tokens, r.evalAlloc);
+            if (options.maxAllocsPerToken >= 0 && r.tokens > 0) {
+                double perToken =
+                    static_cast<double>(r.parseAlloc.allocations + r.evalAlloc.allocations) /
+                    r.tokens;
+                if (perToken > options.maxAllocsPerToken) {
+                    std::printf("  超出分配上限: %s 每token %.2f 次 > %.2f\n", core->name,
+                                perToken, options.maxAllocsPerToken);
+                    gateFailures++;
+                }
+            }
+            row.push_back(r);
+        }
+        // 两个版本对同一表达式的结果应当一致
+        if (row[0].ok != row[1].ok ||
+            (row[0].ok && row[0].value != row[1].value &&
+             !(std::isnan(row[0].value) && std::isnan(row[1].value)))) {
+            std::printf("  警告: C 与 C++ 结果不一致\n");
+        }
+        results.push_back(row);
+    }
+
+    if (!options.jsonPath.empty()) {
+        std::ofstream out(options.jsonPath);
+        if (!out) {
+            std::fprintf(stderr, "无法写入 %s\n", options.jsonPath.c_str());
+            return 1;
+        }
+        out.precision(6);
+        out << std::fixed;
+        out << "{\n  \"benchmark\": \"calculator\",\n  \"unit\": \"ns\",\n  \"cases\": [\n";
+        for (size_t i = 0; i < corpus.size(); i++) {
+            const BenchCase& bc = corpus[i];
+            out << "    {\"name\": \"" << bc.name << "\", \"kind\": \"" << bc.kind
+                << "\", \"param\": " << bc.param << ", \"bytes\": " << bc.expr.size();
+            for (size_t c = 0; c < results[i].size(); c++) {
+                out << ",\n     \"" << cores[c]->name << "\": ";
+                writeCore(out, results[i][c]);
+            }
+            out << "}" << (i + 1 < corpus.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+        std::printf("结果已写入 %s\n", options.jsonPath.c_str());
+    }
+    return gateFailures > 0 ? 1 : 0;
+}
@@ -0,0 +1,448 @@
+// 科学计算器规模压力测试与差分测试
+// 规模测试：用随机表达式生成器从 10 到 10^7 个token 逐级放大输入，
+// 每个（核心, 规模）组合在独立子进程中运行，记录解析/求值耗时、吞吐量与峰值RSS，
+// 单token耗时随规模明显上升即提示超线性行为（逐字节realloc、深递归等）。
+// 差分测试：生成大量小表达式，比较 C 与 C++ 两个核心的结果。
+#include "bench_core.h"
+#include "expr_gen.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    uint64_t seed = 42;
+    size_t minTokens = 10;
+    size_t maxTokens = 10000000;
+    std::string profile = "flat";
+    std::string csvPath;
+    unsigned timeoutSec = 60;
+    size_t diffCount = 0;
+    size_t diffMaxTokens = 200;
+    bool scaling = true;
+};
+
+// 子进程通过管道回传的测量结果
+struct ChildReport {
+    int status;             // BENCH_OK / BENCH_ERROR / BENCH_DOMAIN，-1 表示生成失败，-2 表示解析失败
+    size_t tokens;
+    size_t bytes;
+    int depth;
+    double parseNs;
+    double evalNs;
+    long baselineRssKb;     // 生成表达式后、解析前的峰值RSS
+};
+
+struct Row {
+    const char* core;
+    size_t target;
+    ChildReport report;
+    std::string outcome;
+    long peakRssKb;
+};
+
+double elapsedNs(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// 规模测试的表达式形态
+//   flat:   浅嵌套的长链，主要考察线性扫描与左深树的遍历
+//   nested: 允许深度嵌套，考察递归下降的栈深度
+//   deep:   单链的括号/函数嵌套加上成串的一元正负号，规模大时嵌套层数超过 C 版本解析器的上限，
+//           考察超深输入是报错还是耗尽调用栈
+bool profileConfig(const std::string& profile, uint64_t seed, ExprGenConfig* config) {
+    expr_gen_default_config(config);
+    config->seed = seed;
+    // 规模测试关注解析与遍历开销，错误会让求值提前结束，因此去掉除法
+    // （长表达式中子表达式恰好抵消为0的概率很高）与有定义域限制的函数；
+    // 除零与定义域错误路径由差分测试覆盖
+    config->function_mask = EXPR_FUNC_TOTAL;
+    config->op_weights[EXPR_OP_DIV] = 0;
+    config->zero_literals = 0;
+    if (profile == "flat") {
+        config->max_depth = 3;
+        config->nest_prob = 0.05;
+    } else if (profile == "nested") {
+        config->max_depth = 10000;
+        config->width = 2;
+        config->nest_prob = 0.45;
+        config->func_prob = 0.10;
+        config->spine_prob = 0.5;
+    } else if (profile == "deep") {
+        // 生成器本身也按嵌套层数递归，深度上限取几倍于解析器上限即可
+        config->max_depth = 5000;
+        config->width = 1;
+        config->nest_prob = 0.7;
+        config->func_prob = 0.2;
+        config->unary_prob = 0.5;
+        config->unary_max_run = 8;
+        config->spine_prob = 1.0;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+[[noreturn]] void runChild(const BenchCore& core, const ExprGenConfig& config, size_t target, int fd) {
+    ChildReport report{};
+    ExprGen gen;
+    ExprBuffer expr;
+
+    expr_gen_init(&gen, &config);
+    expr_buffer_init(&expr);
+    if (expr_gen_generate(&gen, target, &expr) != 0) {
+        report.status = -1;
+    } else {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        report.baselineRssKb = usage.ru_maxrss;
+        report.tokens = expr.tokens;
+        report.bytes = expr.length;
+        report.depth = expr.depth;
+
+        auto start = Clock::now();
+        void* ast = core.prepare(expr.data, expr.length);
+        report.parseNs = elapsedNs(start);
+        if (ast == nullptr) {
+            report.status = -2;
+        } else {
+            double value = 0;
+            start = Clock::now();
+            report.status = core.eval(ast, &value);
+            report.evalNs = elapsedNs(start);
+            core.release(ast);
+        }
+    }
+    ssize_t written = write(fd, &report, sizeof(report));
+    _exit(written == static_cast<ssize_t>(sizeof(report)) ? 0 : 1);
+}
+
+Row runOne(const BenchCore& core, const ExprGenConfig& config, size_t target, unsigned timeoutSec) {
+    Row row{core.name, target, {}, "ok", 0};
+    int fds[2];
+    if (pipe(fds) != 0) {
+        row.outcome = "pipe失败";
+        return row;
+    }
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        alarm(timeoutSec);
+        runChild(core, config, target, fds[1]);
+    }
+    close(fds[1]);
+
+    bool received = false;
+    if (pid > 0) {
+        received = read(fds[0], &row.report, sizeof(row.report)) ==
+                   static_cast<ssize_t>(sizeof(row.report));
+    }
+    close(fds[0]);
+    if (pid < 0) {
+        row.outcome = "fork失败";
+        return row;
+    }
+
+    int status = 0;
+    struct rusage usage;
+    wait4(pid, &status, 0, &usage);
+    row.peakRssKb = usage.ru_maxrss;
+
+    if (WIFSIGNALED(status)) {
+        int sig = WTERMSIG(status);
+        row.outcome = sig == SIGALRM ? "超时" : std::string("崩溃:") + strsignal(sig);
+    } else if (!received) {
+        row.outcome = "无结果";
+    } else if (row.report.status == -1) {
+        row.outcome = "生成失败";
+    } else if (row.report.status == -2) {
+        row.outcome = "解析错误";
+    } else if (row.report.status == BENCH_ERROR) {
+        row.outcome = "求值错误";
+    } else if (row.report.status == BENCH_DOMAIN) {
+        row.outcome = "定义域错误";
+    }
+    return row;
+}
+
+// 10, 30, 100, 300, ... 直到 maxTokens
+std::vector<size_t> sizeSteps(size_t minTokens, size_t maxTokens) {
+    std::vector<size_t> steps;
+    for (size_t decade = 1; decade <= maxTokens; decade *= 10) {
+        for (size_t mult : {1, 3}) {
+            size_t n = decade * mult;
+            if (n >= minTokens && n <= maxTokens) {
+                steps.push_back(n);
+            }
+        }
+        if (decade > maxTokens / 10) {
+            break;
+        }
+    }
+    return steps;
+}
+
+int runScaling(const Options& options) {
+    ExprGenConfig config;
+    if (!profileConfig(options.profile, options.seed, &config)) {
+        std::fprintf(stderr, "未知的表达式形态: %s\n", options.profile.c_str());
+        return 2;
+    }
+
+    FILE* csv = nullptr;
+    if (!options.csvPath.empty()) {
+        csv = std::fopen(options.csvPath.c_str(), "w");
+        if (csv == nullptr) {
+            std::fprintf(stderr, "无法写入 %s\n", options.csvPath.c_str());
+            return 1;
+        }
+        std::fprintf(csv, "core,profile,target,tokens,bytes,depth,outcome,parse_ns,eval_ns,"
+                          "ns_per_token,tokens_per_sec,baseline_rss_kb,peak_rss_kb\n");
+    }
+
+    const BenchCore* cores[] = {&bench_core_c, &bench_core_cpp};
+    std::printf("形态: %s  种子: %llu\n", options.profile.c_str(),
+                static_cast<unsigned long long>(options.seed));
+    std::printf("%-4s %10s %10s %6s %12s %12s %10s %12s %10s %10s  %s\n", "core", "tokens",
+                "bytes", "depth", "parse ms", "eval ms", "ns/token", "Mtokens/s", "RSS MB",
+                "增量 MB", "结果");
+
+    int failures = 0;
+    for (const BenchCore* core : cores) {
+        double baselineNsPerToken = 0;
+        bool stopped = false;
+        for (size_t target : sizeSteps(options.minTokens, options.maxTokens)) {
+            if (stopped) {
+                break;
+            }
+            Row row = runOne(*core, config, target, options.timeoutSec);
+            const ChildReport& r = row.report;
+            double totalNs = r.parseNs + r.evalNs;
+            double nsPerToken = r.tokens ? totalNs / r.tokens : 0;
+            double throughput = totalNs > 0 ? r.tokens / totalNs * 1e3 : 0;
+            // 解析错误是预期的报错（deep 形态会触及 PARSER_MAX_DEPTH），算作正常结束；
+            // 只有崩溃、超时与生成失败才计入失败（退出码3）。解析在中途停止，不参与单token耗时的比较
+            bool parseError = row.outcome == "解析错误";
+            bool completed = row.outcome == "ok" || row.outcome == "求值错误" ||
+                             row.outcome == "定义域错误" || parseError;
+            bool measured = completed && !parseError;
+
+            std::printf("%-4s %10zu %10zu %6d %12.3f %12.3f %10.1f %12.2f %10.1f %10.1f  %s",
+                        row.core, r.tokens ? r.tokens : target, r.bytes, r.depth, r.parseNs / 1e6, r.evalNs / 1e6,
+                        nsPerToken, throughput, row.peakRssKb / 1024.0,
+                        (row.peakRssKb - r.baselineRssKb) / 1024.0, row.outcome.c_str());
+            // 以 1000 token 附近的单token耗时为基准，明显上升说明存在超线性开销
+            if (measured && r.tokens >= 1000 && baselineNsPerToken == 0) {
+                baselineNsPerToken = nsPerToken;
+            } else if (measured && baselineNsPerToken > 0 && nsPerToken > 3 * baselineNsPerToken) {
+                std::printf("  <- 超线性: %.1fx", nsPerToken / baselineNsPerToken);
+            }
+            std::printf("\n");
+
+            if (csv != nullptr) {
+                std::fprintf(csv, "%s,%s,%zu,%zu,%zu,%d,%s,%.0f,%.0f,%.3f,%.0f,%ld,%ld\n",
+                             row.core, options.profile.c_str(), target, r.tokens, r.bytes,
+                             r.depth, row.outcome.c_str(), r.parseNs, r.evalNs, nsPerToken,
+                             throughput * 1e6, r.baselineRssKb, row.peakRssKb);
+            }
+            // 崩溃或超时后更大的规模只会重复同样的结果
+            if (!completed) {
+                failures++;
+                stopped = true;
+            }
+        }
+    }
+    if (csv != nullptr) {
+        std::fclose(csv);
+        std::printf("CSV 已写入 %s\n", options.csvPath.c_str());
+    }
+    return failures > 0 ? 3 : 0;
+}
+
+bool sameValue(double a, double b) {
+    if (std::isnan(a) || std::isnan(b)) {
+        return std::isnan(a) && std::isnan(b);
+    }
+    if (a == b) {
+        return true;
+    }
+    return std::fabs(a - b) <= 1e-12 * std::max(std::fabs(a), std::fabs(b));
+}
+
+int evalCore(const BenchCore& core, const char* expr, size_t length, double* value) {
+    void* ast = core.prepare(expr, length);
+    if (ast == nullptr) {
+        return -1;
+    }
+    int status = core.eval(ast, value);
+    core.release(ast);
+    return status;
+}
+
+// 有定义域限制的函数的固定用例：定义域外的调用构成整个表达式，C 版本的结果恰为0，
+// 已知差异可以精确判定；随机表达式中出错的调用可能嵌在更大的表达式里，无法据此判定
+const char* const kDomainCases[] = {
+    "sqrt(-1)", "sqrt(-0.5)", "ln(0)", "ln(-e)", "log(0)", "log(-100)",
+    "sqrt(2)", "ln(e)", "log(1000)", "sqrt(pi) * ln(2) - log(0.5)",
+};
+
+struct DiffCounts {
+    size_t agree = 0;
+    size_t bothError = 0;
+    size_t domain = 0;
+    size_t mismatches = 0;
+};
+
+// 比较两个版本的结果并计数，不一致时返回 false
+bool compareCores(const char* expr, size_t length, DiffCounts* counts, int* cStatus, double* cValue,
+                  int* cppStatus, double* cppValue) {
+    *cValue = 0;
+    *cppValue = 0;
+    *cStatus = evalCore(bench_core_c, expr, length, cValue);
+    *cppStatus = evalCore(bench_core_cpp, expr, length, cppValue);
+
+    if (*cStatus == BENCH_OK && *cppStatus == BENCH_OK && sameValue(*cValue, *cppValue)) {
+        counts->agree++;
+    } else if (*cStatus == BENCH_ERROR && *cppStatus == BENCH_ERROR) {
+        counts->bothError++;
+    } else if (*cppStatus == BENCH_DOMAIN && *cStatus == BENCH_OK && *cValue == 0) {
+        // 已知差异：C 版本对 log/ln/sqrt 的定义域错误返回0而不报错，其他组合仍算不一致
+        counts->domain++;
+    } else {
+        counts->mismatches++;
+        return false;
+    }
+    return true;
+}
+
+// 差分测试：每个表达式使用由基准种子派生的独立种子和随机配置，便于单独复现
+int runDiff(const Options& options) {
+    ExprGenConfig base;
+    expr_gen_default_config(&base);
+    base.seed = options.seed;
+    ExprGen seeder;
+    expr_gen_init(&seeder, &base);
+
+    DiffCounts counts;
+    int cStatus, cppStatus;
+    double cValue, cppValue;
+
+    for (const char* text : kDomainCases) {
+        if (!compareCores(text, std::strlen(text), &counts, &cStatus, &cValue, &cppStatus, &cppValue)) {
+            std::printf("不一致 (定义域用例)\n  表达式: %s\n  C: status=%d value=%.17g\n"
+                        "  C++: status=%d value=%.17g\n",
+                        text, cStatus, cValue, cppStatus, cppValue);
+        }
+    }
+
+    ExprBuffer expr;
+    expr_buffer_init(&expr);
+    for (size_t i = 0; i < options.diffCount; i++) {
+        ExprGenConfig config;
+        expr_gen_default_config(&config);
+        config.seed = expr_gen_next(&seeder);
+        config.max_depth = 1 + static_cast<int>(expr_gen_next(&seeder) % 12);
+        config.width = 1 + static_cast<int>(expr_gen_next(&seeder) % 8);
+        config.spaces = static_cast<int>(expr_gen_next(&seeder) & 1);
+        config.literal_formats = 1 + static_cast<unsigned>(expr_gen_next(&seeder) % EXPR_LIT_ALL);
+        config.function_mask = EXPR_FUNC_TOTAL;
+        size_t target = 1 + expr_gen_next(&seeder) % options.diffMaxTokens;
+
+        ExprGen gen;
+        expr_gen_init(&gen, &config);
+        if (expr_gen_generate(&gen, target, &expr) != 0) {
+            std::fprintf(stderr, "内存不足\n");
+            expr_buffer_free(&expr);
+            return 1;
+        }
+
+        size_t before = counts.mismatches;
+        if (!compareCores(expr.data, expr.length, &counts, &cStatus, &cValue, &cppStatus, &cppValue) &&
+            before < 10) {
+            std::printf("不一致 #%zu (seed=%llu, max_depth=%d, width=%d, tokens=%zu)\n"
+                        "  表达式: %.200s%s\n  C: status=%d value=%.17g\n"
+                        "  C++: status=%d value=%.17g\n",
+                        i, static_cast<unsigned long long>(config.seed), config.max_depth,
+                        config.width, expr.tokens, expr.data,
+                        expr.length > 200 ? "..." : "", cStatus, cValue, cppStatus,
+                        cppValue);
+        }
+    }
+    expr_buffer_free(&expr);
+
+    std::printf("差分测试: %zu 个表达式 + %zu 个定义域用例, 一致 %zu, 均报错 %zu, 定义域差异(已知) %zu, "
+                "不一致 %zu\n",
+                options.diffCount, sizeof(kDomainCases) / sizeof(kDomainCases[0]), counts.agree,
+                counts.bothError, counts.domain, counts.mismatches);
+    return counts.mismatches > 0 ? 1 : 0;
+}
+
+void usage(const char* program) {
+    std::fprintf(stderr,
+                 "用法: %s [选项]\n"
+                 "  --seed N            随机种子 (默认42)\n"
+                 "  --profile flat|nested|deep  表达式形态 (默认flat)\n"
+                 "  --min-tokens N      最小规模 (默认10)\n"
+                 "  --max-tokens N      最大规模 (默认10000000)\n"
+                 "  --timeout 秒        单个子进程的超时 (默认60)\n"
+                 "  --csv 文件          写出CSV结果，供绘图脚本使用\n"
+                 "  --diff N            运行N个表达式的 C/C++ 差分测试\n"
+                 "  --diff-max-tokens N 差分测试单个表达式的最大token数 (默认200)\n"
+                 "  --diff-only         只运行差分测试\n",
+                 program);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--seed" && hasValue) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--profile" && hasValue) {
+            options.profile = argv[++i];
+        } else if (arg == "--min-tokens" && hasValue) {
+            options.minTokens = static_cast<size_t>(std::atof(argv[++i]));
+        } else if (arg == "--max-tokens" && hasValue) {
+            options.maxTokens = static_cast<size_t>(std::atof(argv[++i]));
+        } else if (arg == "--timeout" && hasValue) {
+            options.timeoutSec = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (arg == "--csv" && hasValue) {
+            options.csvPath = argv[++i];
+        } else if (arg == "--diff" && hasValue) {
+            options.diffCount = static_cast<size_t>(std::atof(argv[++i]));
+        } else if (arg == "--diff-max-tokens" && hasValue) {
+            options.diffMaxTokens = std::max<size_t>(1, static_cast<size_t>(std::atof(argv[++i])));
+        } else if (arg == "--diff-only") {
+            options.scaling = false;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    int result = 0;
+    if (options.diffCount > 0) {
+        result = runDiff(options);
+    }
+    if (options.scaling) {
+        int scaling = runScaling(options);
+        result = result != 0 ? result : scaling;
+    }
+    return result;
+}
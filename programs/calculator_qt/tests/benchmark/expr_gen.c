@@ -0,0 +1,283 @@
+#include "expr_gen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const function_names[] = {
+    "sin", "cos", "tan", "log", "ln", "exp", "sqrt", "abs"
+};
+static const char* const constant_names[] = {"pi", "e"};
+static const char op_chars[EXPR_OP_COUNT] = {'+', '-', '*', '/', '^'};
+
+void expr_gen_default_config(ExprGenConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->seed = 1;
+    config->max_depth = 6;
+    config->width = 6;
+    config->nest_prob = 0.15;
+    config->func_prob = 0.15;
+    config->const_prob = 0.10;
+    config->unary_prob = 0.05;
+    config->op_weights[EXPR_OP_ADD] = 4;
+    config->op_weights[EXPR_OP_SUB] = 3;
+    config->op_weights[EXPR_OP_MUL] = 3;
+    config->op_weights[EXPR_OP_DIV] = 2;
+    config->op_weights[EXPR_OP_POW] = 1;
+    config->literal_formats = EXPR_LIT_ALL;
+    config->function_mask = EXPR_FUNC_ALL;
+    config->zero_literals = 1;
+    config->spaces = 1;
+}
+
+void expr_gen_init(ExprGen* gen, const ExprGenConfig* config) {
+    gen->config = *config;
+    gen->state = config->seed;
+    gen->op_total = 0;
+    for (int i = 0; i < EXPR_OP_COUNT; i++) {
+        gen->op_total += config->op_weights[i];
+    }
+    gen->function_count = 0;
+    for (unsigned i = 0; i < sizeof(function_names) / sizeof(function_names[0]); i++) {
+        if (config->function_mask == 0 || (config->function_mask & (1u << i))) {
+            gen->functions[gen->function_count++] = (unsigned char)i;
+        }
+    }
+}
+
+uint64_t expr_gen_next(ExprGen* gen) {
+    uint64_t z = (gen->state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// [0, 1) 区间的均匀分布
+static double next_unit(ExprGen* gen) {
+    return (double)(expr_gen_next(gen) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static unsigned next_below(ExprGen* gen, unsigned bound) {
+    return (unsigned)(expr_gen_next(gen) % bound);
+}
+
+void expr_buffer_init(ExprBuffer* buffer) {
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+void expr_buffer_free(ExprBuffer* buffer) {
+    free(buffer->data);
+    expr_buffer_init(buffer);
+}
+
+static int buffer_reserve(ExprBuffer* buffer, size_t extra) {
+    size_t needed = buffer->length + extra + 1;
+    if (needed <= buffer->capacity) {
+        return 0;
+    }
+    size_t capacity = buffer->capacity ? buffer->capacity : 256;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    char* data = (char*)realloc(buffer->data, capacity);
+    if (data == NULL) {
+        return -1;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+static int append(ExprBuffer* buffer, const char* text, size_t length) {
+    if (buffer_reserve(buffer, length) != 0) {
+        return -1;
+    }
+    memcpy(buffer->data + buffer->length, text, length);
+    buffer->length += length;
+    buffer->data[buffer->length] = '\0';
+    return 0;
+}
+
+static int append_str(ExprBuffer* buffer, const char* text) {
+    return append(buffer, text, strlen(text));
+}
+
+static int emit_literal(ExprGen* gen, ExprBuffer* out) {
+    char text[96];
+    int formats[5];
+    int count = 0;
+    unsigned mask = gen->config.literal_formats ? gen->config.literal_formats : EXPR_LIT_INT;
+
+    for (int bit = 0; bit < 5; bit++) {
+        if (mask & (1u << bit)) {
+            formats[count++] = 1 << bit;
+        }
+    }
+
+    if (gen->config.zero_literals && next_below(gen, 64) == 0) {
+        out->tokens++;
+        return append(out, "0", 1);
+    }
+
+    int len;
+    switch (formats[next_below(gen, (unsigned)count)]) {
+        case EXPR_LIT_DECIMAL:
+            len = snprintf(text, sizeof(text), "%u.%02u", 1 + next_below(gen, 99), next_below(gen, 100));
+            break;
+        case EXPR_LIT_LEADING_DOT:
+            len = snprintf(text, sizeof(text), ".%u", 1 + next_below(gen, 999));
+            break;
+        case EXPR_LIT_TRAILING_DOT:
+            len = snprintf(text, sizeof(text), "%u.", 1 + next_below(gen, 999));
+            break;
+        case EXPR_LIT_LONG:
+            text[0] = '0';
+            text[1] = '.';
+            len = 2 + 64 + (int)next_below(gen, 16);
+            for (int i = 2; i < len; i++) {
+                text[i] = (char)('0' + next_below(gen, 10));
+            }
+            text[len] = '\0';
+            break;
+        default:
+            len = snprintf(text, sizeof(text), "%u", 1 + next_below(gen, 999));
+            break;
+    }
+    out->tokens++;
+    return append(out, text, (size_t)len);
+}
+
+static int generate_chain(ExprGen* gen, ExprBuffer* out, size_t budget, int depth);
+
+// 生成一个操作数，remaining 为本层剩余的token预算
+static int emit_operand(ExprGen* gen, ExprBuffer* out, size_t remaining, int depth) {
+    const ExprGenConfig* config = &gen->config;
+
+    if (config->unary_prob > 0 && next_unit(gen) < config->unary_prob) {
+        if (config->unary_max_run > 1) {
+            // 连续符号不超过剩余预算的一半，其余预算留给操作数本身
+            size_t run = 1 + next_below(gen, config->unary_max_run);
+            if (run > remaining / 2 + 1) {
+                run = remaining / 2 + 1;
+            }
+            for (size_t i = 0; i < run; i++) {
+                if (append(out, next_below(gen, 4) == 0 ? "+" : "-", 1) != 0) {
+                    return -1;
+                }
+            }
+            out->tokens += run;
+        } else {
+            if (append(out, "-", 1) != 0) {
+                return -1;
+            }
+            out->tokens++;
+        }
+    }
+
+    double r = next_unit(gen);
+    int can_nest = depth < config->max_depth && remaining >= 4;
+    size_t width = config->width > 0 ? (size_t)config->width : 1;
+    // 子表达式预算：1..width 个操作数，每个操作数连同运算符约2个token
+    size_t sub_budget = 1 + next_below(gen, (unsigned)(2 * width));
+    if (remaining > 3 && config->spine_prob > 0 && next_unit(gen) < config->spine_prob) {
+        sub_budget = remaining - 3;
+    }
+    if (remaining > 3 && sub_budget > remaining - 3) {
+        sub_budget = remaining - 3;
+    }
+
+    if (can_nest && r < config->nest_prob) {
+        if (append(out, "(", 1) != 0 ||
+            generate_chain(gen, out, sub_budget, depth + 1) != 0 ||
+            append(out, ")", 1) != 0) {
+            return -1;
+        }
+        out->tokens += 2;
+        return 0;
+    }
+    r -= config->nest_prob;
+
+    if (can_nest && r < config->func_prob && gen->function_count > 0) {
+        const char* name = function_names[gen->functions[next_below(gen, gen->function_count)]];
+        if (append_str(out, name) != 0 || append(out, "(", 1) != 0 ||
+            generate_chain(gen, out, sub_budget, depth + 1) != 0 ||
+            append(out, ")", 1) != 0) {
+            return -1;
+        }
+        out->tokens += 3;
+        return 0;
+    }
+    r -= config->func_prob;
+
+    if (r < config->const_prob) {
+        out->tokens++;
+        return append_str(out, constant_names[next_below(gen, 2)]);
+    }
+    return emit_literal(gen, out);
+}
+
+static int emit_operator(ExprGen* gen, ExprBuffer* out, int* op) {
+    unsigned pick = gen->op_total ? next_below(gen, gen->op_total) : 0;
+    *op = EXPR_OP_ADD;
+    for (int i = 0; i < EXPR_OP_COUNT; i++) {
+        if (pick < gen->config.op_weights[i]) {
+            *op = i;
+            break;
+        }
+        pick -= gen->config.op_weights[i];
+    }
+
+    char text[3];
+    size_t len = 0;
+    if (gen->config.spaces) {
+        text[len++] = ' ';
+    }
+    text[len++] = op_chars[*op];
+    if (gen->config.spaces) {
+        text[len++] = ' ';
+    }
+    out->tokens++;
+    return append(out, text, len);
+}
+
+// 生成由二元运算符连接的操作数序列，直到消耗 budget 个token
+static int generate_chain(ExprGen* gen, ExprBuffer* out, size_t budget, int depth) {
+    size_t start = out->tokens;
+
+    if (depth > out->depth) {
+        out->depth = depth;
+    }
+    do {
+        size_t used = out->tokens - start;
+        if (used > 0) {
+            int op;
+            if (emit_operator(gen, out, &op) != 0) {
+                return -1;
+            }
+            // 指数限制为小整数，避免大部分结果溢出为inf
+            if (op == EXPR_OP_POW) {
+                char text[2] = {(char)('1' + next_below(gen, 3)), '\0'};
+                out->tokens++;
+                if (append(out, text, 1) != 0) {
+                    return -1;
+                }
+                continue;
+            }
+            used++;
+        }
+        if (emit_operand(gen, out, budget > used ? budget - used : 1, depth) != 0) {
+            return -1;
+        }
+    } while (out->tokens - start < budget);
+    return 0;
+}
+
+int expr_gen_generate(ExprGen* gen, size_t target_tokens, ExprBuffer* out) {
+    out->length = 0;
+    out->tokens = 0;
+    out->depth = 0;
+    if (buffer_reserve(out, target_tokens * 4) != 0) {
+        return -1;
+    }
+    out->data[0] = '\0';
+    return generate_chain(gen, out, target_tokens ? target_tokens : 1, 0);
+}
@@ -0,0 +1,89 @@
+#ifndef EXPR_GEN_H
+#define EXPR_GEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 数字字面量格式（可组合）
+#define EXPR_LIT_INT          0x01  // 42
+#define EXPR_LIT_DECIMAL      0x02  // 3.25
+#define EXPR_LIT_LEADING_DOT  0x04  // .5
+#define EXPR_LIT_TRAILING_DOT 0x08  // 5.
+#define EXPR_LIT_LONG         0x10  // 0.12345678901234567，超过词法分析器的栈缓冲区
+#define EXPR_LIT_ALL          0x1f
+
+// 函数选择掩码，位序与生成器内部的函数表一致
+#define EXPR_FUNC_SIN   0x01
+#define EXPR_FUNC_COS   0x02
+#define EXPR_FUNC_TAN   0x04
+#define EXPR_FUNC_LOG   0x08
+#define EXPR_FUNC_LN    0x10
+#define EXPR_FUNC_EXP   0x20
+#define EXPR_FUNC_SQRT  0x40
+#define EXPR_FUNC_ABS   0x80
+#define EXPR_FUNC_ALL   0xff
+// 定义域为全体实数的函数，不会产生定义域错误
+#define EXPR_FUNC_TOTAL (EXPR_FUNC_SIN | EXPR_FUNC_COS | EXPR_FUNC_TAN | EXPR_FUNC_EXP | EXPR_FUNC_ABS)
+
+// 二元运算符，顺序与 op_weights 对应
+enum { EXPR_OP_ADD, EXPR_OP_SUB, EXPR_OP_MUL, EXPR_OP_DIV, EXPR_OP_POW, EXPR_OP_COUNT };
+
+// 生成器配置，相同的配置与种子总是生成相同的表达式
+typedef struct {
+    uint64_t seed;
+    int max_depth;          // 括号与函数参数的最大嵌套深度
+    int width;              // 嵌套子表达式的最大项数
+    double nest_prob;       // 操作数为括号子表达式的概率
+    double func_prob;       // 操作数为函数调用的概率
+    double const_prob;      // 操作数为常量（pi/e）的概率
+    double unary_prob;      // 操作数前加一元负号的概率
+    unsigned unary_max_run; // 大于1时一元正负号连续出现 1..unary_max_run 个（如 -+--x），0 或 1 为单个负号
+    double spine_prob;      // 嵌套子表达式占用本层全部剩余预算的概率，用于生成深层嵌套
+    unsigned op_weights[EXPR_OP_COUNT];
+    unsigned literal_formats;
+    unsigned function_mask; // 可选用的函数，0 等同于 EXPR_FUNC_ALL
+    int zero_literals;      // 非0时偶尔生成字面量0，覆盖除零错误路径
+    int spaces;             // 非0时在二元运算符两侧加空格
+} ExprGenConfig;
+
+// 生成结果，data 以 '\0' 结尾，容量按倍增方式扩展
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+    size_t tokens;          // 生成的token数量（不含结束标记）
+    int depth;              // 实际达到的最大嵌套深度
+} ExprBuffer;
+
+typedef struct {
+    ExprGenConfig config;
+    uint64_t state;
+    unsigned op_total;
+    unsigned function_count;
+    unsigned char functions[8];
+} ExprGen;
+
+// 填充默认配置：中等嵌套、包含全部运算符与字面量格式
+void expr_gen_default_config(ExprGenConfig* config);
+
+void expr_gen_init(ExprGen* gen, const ExprGenConfig* config);
+
+// 生成约 target_tokens 个token的表达式（可能略多几个以闭合括号），
+// 成功返回0，内存不足返回-1
+int expr_gen_generate(ExprGen* gen, size_t target_tokens, ExprBuffer* out);
+
+// 伪随机数（splitmix64），供调用者派生子种子
+uint64_t expr_gen_next(ExprGen* gen);
+
+void expr_buffer_init(ExprBuffer* buffer);
+void expr_buffer_free(ExprBuffer* buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EXPR_GEN_H
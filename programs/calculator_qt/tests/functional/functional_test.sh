@@ -55,6 +55,34 @@ run_test() {
     fi
 }
 
+# 批处理模式测试函数（仅C语言版本支持 --batch）
+run_batch_test() {
+    local test_name="$1"
+    local input="$2"
+    local expected="$3"
+    
+    total_tests=$((total_tests + 1))
+    
+    exe_path=$(get_executable_path "c" "$SCRIPT_DIR")
+    if ! check_executable "c" "$SCRIPT_DIR"; then
+        failed_tests=$((failed_tests + 1))
+        return 1
+    fi
+    
+    # 批处理模式逐行输出结果，整体与期望输出比较
+    result=$(printf "$input" | timeout 5s $exe_path --batch 2>/dev/null)
+    
+    if [ "$result" == "$(printf "$expected")" ]; then
+        echo -e "${GREEN}测试 '$test_name' (c batch) 通过${NC}"
+        passed_tests=$((passed_tests + 1))
+        return 0
+    else
+        echo -e "${RED}测试 '$test_name' (c batch) 失败: 期望 '$expected', 得到 '$result'${NC}"
+        failed_tests=$((failed_tests + 1))
+        return 1
+    fi
+}
+
 # 构建项目函数
 build_project_wrapper() {
     local lang_version="$1"
@@ -107,6 +135,18 @@ run_test "三角函数组合" "sin(pi/2) + cos(0)" "2" "c"
 run_test "指数和对数" "exp(ln(5))" "5" "c"
 run_test "混合函数" "abs(-3) + sqrt(9) - 2^2" "2" "c"
 
+# 批处理模式测试
+run_batch_test "批处理多行" "2 + 3\n2 * 3\n" "5\n6"
+run_batch_test "批处理空行与CRLF" "1\r\n\n2\n" "1\n\n2"
+run_batch_test "批处理末行无换行" "7\n2^10" "7\n1024"
+run_batch_test "批处理错误行" "5 / 0\n(1\n" "error\t除零错误\nerror\t表达式解析失败"
+run_batch_test "批处理完整精度" "1/3\n" "0.33333333333333331"
+# 超深嵌套报错且不影响后续行，连续正负号迭代合并
+deep_parens=$(printf '(%.0s' $(seq 1001))1$(printf ')%.0s' $(seq 1001))
+many_minus=$(printf -- '-%.0s' $(seq 100000))2
+run_batch_test "批处理嵌套过深" "${deep_parens}\n1+1\n" "error\t括号或函数调用嵌套过深\n2"
+run_batch_test "批处理连续负号" "1\n${many_minus}\n--3\n+-+4\n" "1\n2\n3\n-4"
+
 # 测试C++版本
 echo ""
 echo "-------------------------------------------"
@@ -1,6 +1,8 @@
 #!/bin/bash
 
 # 性能测试脚本 - 测试C语言和C++版本的计算器性能
+# 使用进程内基准测试程序 calc_bench 直接调用两个计算器核心，
+# 分阶段（词法/语法/求值）给出 ns/op 分布，不再把进程启动与终端输出计入结果
 
 echo "==========================================="
 echo "科学计算器性能测试"
@@ -10,104 +12,38 @@ echo "==========================================="
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 source "$SCRIPT_DIR/../common/test_utils.sh"
 
-# 性能测试函数
-run_performance_test() {
-    local test_name="$1"
-    local input="$2"
-    local iterations="$3"
-    local lang_version="$4"
-    
-    # 根据语言版本选择可执行文件
-    if [ "$lang_version" = "c" ]; then
-        exe_path="../../calculator_c/build_cmake/scientific_calculator"
-    else
-        exe_path="../../calculator_cpp/build_cmake/scientific_calculator"
-    fi
-    
-    # 检查可执行文件是否存在
-    if [ ! -f "$exe_path" ]; then
-        echo -e "${RED}错误: 找不到可执行文件 $exe_path${NC}"
-        return 1
-    fi
-    
-    # 创建临时输入文件
-    temp_input="/tmp/calculator_test_input.txt"
-    for ((i=1; i<=iterations; i++)); do
-        echo "$input" >> "$temp_input"
-    done
-    echo "quit" >> "$temp_input"
-    
-    # 运行性能测试
-    echo "正在测试 '$test_name' ($lang_version) - $iterations 次迭代..."
-    
-    # 使用time命令测量执行时间
-    result=$( { time -p timeout 30s $exe_path < "$temp_input" > /dev/null; } 2>&1 )
-    
-    # 检查是否超时
-    if [ $? -eq 124 ]; then
-        echo -e "${RED}测试 '$test_name' ($lang_version) 失败: 超时${NC}"
-        rm -f "$temp_input"
+PROJECT_DIR="$SCRIPT_DIR/../.."
+BUILD_DIR="$PROJECT_DIR/build_cmake"
+BENCH_EXE="$BUILD_DIR/tests/benchmark/calc_bench"
+RESULT_JSON="${BENCH_JSON:-$BUILD_DIR/performance_results.json}"
+
+# 构建基准测试程序（Release 模式，避免调试构建影响计时）
+build_benchmark() {
+    log_info "正在构建基准测试程序..."
+    cmake -S "$PROJECT_DIR" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Release >/dev/null 2>&1 &&
+        cmake --build "$BUILD_DIR" --target calc_bench >/dev/null 2>&1
+    if [ $? -ne 0 ] || [ ! -x "$BENCH_EXE" ]; then
+        log_error "构建基准测试程序失败"
         return 1
     fi
-    
-    # 提取执行时间
-    real_time=$(echo "$result" | grep "real" | awk '{print $2}')
-    user_time=$(echo "$result" | grep "user" | awk '{print $2}')
-    sys_time=$(echo "$result" | grep "sys" | awk '{print $2}')
-    
-    echo "  实际时间: ${real_time}s"
-    echo "  用户时间: ${user_time}s"
-    echo "  系统时间: ${sys_time}s"
-    
-    # 清理临时文件
-    rm -f "$temp_input"
-    
+    log_success "构建基准测试程序成功"
     return 0
 }
 
-# 构建项目函数
-build_project_wrapper() {
-    local lang_version="$1"
-    build_project "$lang_version" "$SCRIPT_DIR"
-}
-
-# 测试C语言版本
-echo ""
-echo "-------------------------------------------"
-echo "性能测试 - C语言版本"
-echo "-------------------------------------------"
-
-# 构建C语言版本
-build_project_wrapper "c"
-
-# 基准测试
-run_performance_test "简单算术运算" "2 + 3 * 4" 100 "c"
-run_performance_test "科学函数计算" "sin(pi/2)" 100 "c"
-run_performance_test "复合表达式" "sqrt(2^2 + 3^2)" 100 "c"
-
-# 压力测试
-run_performance_test "深度嵌套表达式" "((((((2+3)*4)-5)/6)^2)+1)" 50 "c"
-run_performance_test "大量计算任务" "2 + 3 * 4" 1000 "c"
+build_benchmark || exit 1
 
-# 测试C++版本
 echo ""
 echo "-------------------------------------------"
-echo "性能测试 - C++语言版本"
+echo "分阶段基准测试 - C / C++"
 echo "-------------------------------------------"
 
-# 构建C++语言版本
-build_project_wrapper "cpp"
-
-# 基准测试
-run_performance_test "简单算术运算" "2 + 3 * 4" 100 "cpp"
-run_performance_test "科学函数计算" "sin(pi/2)" 100 "cpp"
-run_performance_test "复合表达式" "sqrt(2^2 + 3^2)" 100 "cpp"
-
-# 压力测试
-run_performance_test "深度嵌套表达式" "((((((2+3)*4)-5)/6)^2)+1)" 50 "cpp"
-run_performance_test "大量计算任务" "2 + 3 * 4" 1000 "cpp"
+# 额外参数（如 --quick、--samples N）原样传给 calc_bench
+if ! "$BENCH_EXE" --json "$RESULT_JSON" "$@"; then
+    log_error "基准测试运行失败"
+    exit 1
+fi
 
 echo ""
 echo "==========================================="
-echo "性能测试完成"
-echo "==========================================="
\ No newline at end of file
+echo "性能测试完成，JSON 结果: $RESULT_JSON"
+echo "==========================================="
@@ -0,0 +1,26 @@
+# 规模扩展测试绘图：吞吐量与峰值RSS随输入规模的变化（双对数坐标）
+# 用法: gnuplot -e "datadir='build_cmake'" scaling_plot.gp
+if (!exists("datadir")) datadir = "."
+
+set terminal pngcairo size 1200,500
+set output datadir."/scaling.png"
+set datafile separator ","
+set key top left
+set logscale xy
+set grid
+set xlabel "tokens"
+set multiplot layout 1,2
+
+set title "吞吐量"
+set ylabel "tokens/s"
+plot for [p in "flat nested deep"] for [c in "c cpp"] \
+     datadir."/scaling_".p.".csv" using ((strcol(1) eq c && strcol(7) eq "ok") ? $4 : 1/0):11 \
+     with linespoints title c." ".p
+
+set title "峰值RSS"
+set ylabel "KB"
+plot for [p in "flat nested deep"] for [c in "c cpp"] \
+     datadir."/scaling_".p.".csv" using ((strcol(1) eq c && strcol(7) eq "ok") ? $4 : 1/0):13 \
+     with linespoints title c." ".p
+
+unset multiplot
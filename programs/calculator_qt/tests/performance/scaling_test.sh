@@ -0,0 +1,75 @@
+#!/bin/bash
+
+# 规模扩展测试脚本 - 用随机表达式生成器驱动 C 与 C++ 两个计算器核心
+# 1. 差分测试：大量随机小表达式，比较两个版本的求值结果
+# 2. 规模测试：从 10 到 10^7 个token，记录吞吐量与峰值RSS，输出CSV并绘图
+#    deep 形态是单链的深层括号/函数嵌套加成串的正负号，检查超深输入报错而不是崩溃
+#
+# 环境变量:
+#   SCALING_SEED        随机种子（默认42）
+#   SCALING_MAX_TOKENS  最大规模（默认10000000）
+#   SCALING_DIFF_COUNT  差分测试的表达式数量（默认20000）
+
+echo "==========================================="
+echo "科学计算器规模扩展测试"
+echo "==========================================="
+
+# 导入共享测试工具函数库
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+source "$SCRIPT_DIR/../common/test_utils.sh"
+
+PROJECT_DIR="$SCRIPT_DIR/../.."
+BUILD_DIR="$PROJECT_DIR/build_cmake"
+STRESS_EXE="$BUILD_DIR/tests/benchmark/calc_stress"
+SEED="${SCALING_SEED:-42}"
+MAX_TOKENS="${SCALING_MAX_TOKENS:-10000000}"
+DIFF_COUNT="${SCALING_DIFF_COUNT:-20000}"
+
+log_info "正在构建规模测试程序..."
+if ! cmake -S "$PROJECT_DIR" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Release >/dev/null 2>&1 ||
+   ! cmake --build "$BUILD_DIR" --target calc_stress >/dev/null 2>&1; then
+    log_error "构建规模测试程序失败"
+    exit 1
+fi
+
+result=0
+
+echo ""
+echo "-------------------------------------------"
+echo "差分测试 - C / C++ (种子 $SEED)"
+echo "-------------------------------------------"
+if "$STRESS_EXE" --seed "$SEED" --diff "$DIFF_COUNT" --diff-only; then
+    log_success "C 与 C++ 结果一致"
+else
+    log_error "C 与 C++ 结果不一致，可用上面打印的 seed 复现"
+    result=1
+fi
+
+# 崩溃或超时（退出码3）是需要关注的测试结论而非脚本错误，单独提示；
+# deep 形态超过嵌套上限时的解析错误是预期结果，不计入退出码3
+for profile in flat nested deep; do
+    echo ""
+    echo "-------------------------------------------"
+    echo "规模测试 - $profile"
+    echo "-------------------------------------------"
+    csv="$BUILD_DIR/scaling_$profile.csv"
+    "$STRESS_EXE" --seed "$SEED" --profile "$profile" --max-tokens "$MAX_TOKENS" --csv "$csv"
+    case $? in
+        0) ;;
+        3) log_warning "$profile: 部分规模崩溃或超时，见上表" ;;
+        *) log_error "$profile: 规模测试运行失败"; result=1 ;;
+    esac
+done
+
+if command -v gnuplot >/dev/null 2>&1; then
+    gnuplot -e "datadir='$BUILD_DIR'" "$SCRIPT_DIR/scaling_plot.gp" &&
+        log_info "图表已写入 $BUILD_DIR/scaling.png"
+else
+    log_warning "未安装 gnuplot，跳过绘图（CSV 位于 $BUILD_DIR）"
+fi
+
+echo ""
+echo "==========================================="
+echo "规模扩展测试完成"
+echo "==========================================="
+exit $result
@@ -119,6 +119,10 @@ echo ""
 echo "正在进行长时间运行测试..."
 run_stress_test "长时间运行测试" "sqrt(2^2 + 3^2) * sin(pi/4)" 10000 "cpp"
 
+# 随机表达式的规模扩展与差分测试
+echo ""
+"$SCRIPT_DIR/scaling_test.sh"
+
 echo ""
 echo "==========================================="
 echo "压力测试完成"
@@ -0,0 +1,385 @@
+/*
+ 近似成员查询过滤器基准测试（由 uthash tests/bloom_perf.c 扩展而来）
+ 在 uthash 表中查找一批键，其中一定比例的键不在表中（miss 率 0% / 50% / 90%），比较查找前是否先查过滤器：
+   uthash            ：不加过滤器（即 bloom_perf.none）
+   uthash+HASH_BLOOM ：uthash 内置的布隆过滤器，每个键只置 1 位，位数在编译期固定（bloom_bench_hash_bloom，-DHASH_BLOOM=23）
+   +blocked bloom    ：查找前先查 filter.h 的分块布隆过滤器
+   +cuckoo           ：查找前先查布谷鸟过滤器
+ 表与过滤器共用一次 xxHash64：uthash 取低 32 位（HASH_FUNCTION），过滤器使用完整的 64 位
+ 另外单独测过滤器本身：加入与查询的耗时（分块布隆过滤器分标量 / AVX2）、每个键占用的位数、目标与实测的假阳性率
+
+ 键：--names FILE 读取 bloom_perf 使用的 test14.dat（每行一个名字），否则生成 --n 个 16 字符的随机小写字符串
+ 不在表中的键：名字的前两个字符加 1（与 bloom_perf 相同，偶尔会撞上另一个名字），随机字符串的首字符改为大写
+
+ 用法：bloom_bench [--n N] [--names FILE] [--fpr P] [--lookups N]
+*/
+#define _POSIX_C_SOURCE 199309L
+#include "filter.h"
+#include "hashalg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define HASH_FUNCTION(keyptr, keylen, hashv) ((hashv) = (unsigned)xxHash64((keyptr), (keylen), 0))
+#include "uthash.h"
+
+#define KEY_LEN 16
+
+static uint64_t g_rng = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t next_rand(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return g_rng;
+}
+
+static volatile size_t g_sink;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    const char* key;
+    UT_hash_handle hh;
+} Item;
+
+typedef struct {
+    const char* key;
+    size_t len;
+} Key;
+
+typedef struct {
+    size_t found;       // 在表中找到的查询数
+    size_t absent;      // 表中没有的查询数
+    size_t passed;      // 表中没有、但过滤器返回 "可能存在" 的查询数
+    double ns;          // 每次查找的耗时
+} Result;
+
+// 读取名字文件：每行一个名字，去掉行尾换行；miss 为前两个字符加 1 的版本
+static size_t load_names(const char* path, Key** hits, Key** misses) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        exit(1);
+    }
+    size_t n = 0, cap = 1024;
+    *hits = (Key*)malloc(cap * sizeof(Key));
+    *misses = (Key*)malloc(cap * sizeof(Key));
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        size_t len = strcspn(line, "\r\n");
+        if (len == 0) {
+            continue;
+        }
+        if (n == cap) {
+            cap *= 2;
+            *hits = (Key*)realloc(*hits, cap * sizeof(Key));
+            *misses = (Key*)realloc(*misses, cap * sizeof(Key));
+        }
+        char* hit = (char*)malloc(len);
+        char* miss = (char*)malloc(len);
+        memcpy(hit, line, len);
+        memcpy(miss, line, len);
+        miss[0]++;
+        if (len > 1) {
+            miss[1]++;
+        }
+        (*hits)[n].key = hit;
+        (*hits)[n].len = len;
+        (*misses)[n].key = miss;
+        (*misses)[n].len = len;
+        n++;
+    }
+    fclose(file);
+    return n;
+}
+
+static void make_keys(size_t n, Key** hits, Key** misses) {
+    char* pool = (char*)malloc(n * KEY_LEN * 2);
+    *hits = (Key*)malloc(n * sizeof(Key));
+    *misses = (Key*)malloc(n * sizeof(Key));
+    for (size_t i = 0; i < n; i++) {
+        char* hit = pool + i * KEY_LEN * 2;
+        char* miss = hit + KEY_LEN;
+        for (int c = 0; c < KEY_LEN; c++) {
+            hit[c] = (char)('a' + next_rand() % 26);
+        }
+        memcpy(miss, hit, KEY_LEN);
+        miss[0] = (char)(miss[0] - 'a' + 'A');
+        (*hits)[i].key = hit;
+        (*hits)[i].len = KEY_LEN;
+        (*misses)[i].key = miss;
+        (*misses)[i].len = KEY_LEN;
+    }
+}
+
+// 生成 nq 次查询：每次随机取一个键，按 miss_rate 的概率换成不在表中的版本
+static Key* make_queries(const Key* hits, const Key* misses, size_t n, size_t nq, double miss_rate) {
+    Key* q = (Key*)malloc(nq * sizeof(Key));
+    for (size_t i = 0; i < nq; i++) {
+        size_t k = (size_t)(next_rand() % n);
+        int miss = (double)(next_rand() >> 11) / 9007199254740992.0 < miss_rate;
+        q[i] = miss ? misses[k] : hits[k];
+    }
+    return q;
+}
+
+static Result lookup_plain(Item* head, const Key* q, size_t nq) {
+    Result r;
+    memset(&r, 0, sizeof(r));
+    double start = now_sec();
+    for (size_t i = 0; i < nq; i++) {
+        Item* it = NULL;
+        HASH_FIND(hh, head, q[i].key, q[i].len, it);
+        r.found += it != NULL;
+    }
+    r.ns = (now_sec() - start) * 1e9 / (double)nq;
+    r.absent = nq - r.found;
+#ifdef HASH_BLOOM
+    // 单独统计内置过滤器放过了多少个不在表中的键
+    for (size_t i = 0; i < nq; i++) {
+        Item* it = NULL;
+        unsigned hv;
+        HASH_VALUE(q[i].key, q[i].len, hv);
+        HASH_FIND_BYHASHVALUE(hh, head, q[i].key, q[i].len, hv, it);
+        r.passed += it == NULL && HASH_BLOOM_TEST(head->hh.tbl, hv);
+    }
+#else
+    r.passed = r.absent;
+#endif
+    return r;
+}
+
+#ifndef HASH_BLOOM
+static Result lookup_bloom(Item* head, const BloomFilter* f, const Key* q, size_t nq) {
+    Result r;
+    memset(&r, 0, sizeof(r));
+    size_t probes = 0;
+    double start = now_sec();
+    for (size_t i = 0; i < nq; i++) {
+        uint64_t h = xxHash64(q[i].key, q[i].len, 0);
+        if (!bloom_contains_hash(f, h)) {
+            continue;
+        }
+        probes++;
+        Item* it = NULL;
+        HASH_FIND_BYHASHVALUE(hh, head, q[i].key, q[i].len, (unsigned)h, it);
+        r.found += it != NULL;
+    }
+    r.ns = (now_sec() - start) * 1e9 / (double)nq;
+    r.absent = nq - r.found;
+    r.passed = probes - r.found;
+    return r;
+}
+
+static Result lookup_cuckoo(Item* head, const CuckooFilter* f, const Key* q, size_t nq) {
+    Result r;
+    memset(&r, 0, sizeof(r));
+    size_t probes = 0;
+    double start = now_sec();
+    for (size_t i = 0; i < nq; i++) {
+        uint64_t h = xxHash64(q[i].key, q[i].len, 0);
+        if (!cuckoo_filter_contains_hash(f, h)) {
+            continue;
+        }
+        probes++;
+        Item* it = NULL;
+        HASH_FIND_BYHASHVALUE(hh, head, q[i].key, q[i].len, (unsigned)h, it);
+        r.found += it != NULL;
+    }
+    r.ns = (now_sec() - start) * 1e9 / (double)nq;
+    r.absent = nq - r.found;
+    r.passed = probes - r.found;
+    return r;
+}
+#endif
+
+static void print_row(const char* name, double miss_rate, const Result* r, size_t filter_bytes, size_t n) {
+    printf("%-20s %5.0f%% %10.1f %10zu", name, miss_rate * 100, r->ns, r->found);
+    if (r->absent == 0 || filter_bytes == 0) {
+        printf(" %10s", "-");
+    } else {
+        printf(" %10.4f", (double)r->passed / (double)r->absent);
+    }
+    if (filter_bytes == 0) {
+        printf(" %10s\n", "-");
+    } else {
+        printf(" %10.1f\n", (double)filter_bytes * 8 / (double)n);
+    }
+}
+
+#ifndef HASH_BLOOM
+// 过滤器本身：用预先算好的哈希值测加入与查询（一半在集合中、一半不在），查询不在集合中的键统计假阳性率
+static void bench_filters(const Key* hits, const Key* misses, size_t n, double fpr, size_t nq) {
+    uint64_t* add = (uint64_t*)malloc(n * sizeof(uint64_t));
+    uint64_t* absent = (uint64_t*)malloc(n * sizeof(uint64_t));
+    uint64_t* query = (uint64_t*)malloc(nq * sizeof(uint64_t));
+    for (size_t i = 0; i < n; i++) {
+        add[i] = xxHash64(hits[i].key, hits[i].len, 0);
+        absent[i] = xxHash64(misses[i].key, misses[i].len, 0);
+    }
+    for (size_t i = 0; i < nq; i++) {
+        size_t k = (size_t)(next_rand() % n);
+        query[i] = (next_rand() & 1) ? add[k] : absent[k];
+    }
+
+    printf("\n%-22s %10s %10s %10s %10s %10s %10s\n", "filter", "add ns", "query ns", "bits/key", "target", "estimate",
+           "measured");
+    size_t acc = 0;
+    for (int scalar = 0; scalar < 2; scalar++) {
+        BloomFilter* f = bloom_create(n, fpr);
+        double start = now_sec();
+        for (size_t i = 0; i < n; i++) {
+            if (scalar) {
+                bloom_add_hash_scalar(f, add[i]);
+            } else {
+                bloom_add_hash(f, add[i]);
+            }
+        }
+        double add_ns = (now_sec() - start) * 1e9 / (double)n;
+        start = now_sec();
+        for (size_t i = 0; i < nq; i++) {
+            acc += scalar ? bloom_contains_hash_scalar(f, query[i]) : bloom_contains_hash(f, query[i]);
+        }
+        double query_ns = (now_sec() - start) * 1e9 / (double)nq;
+        size_t positives = 0;
+        for (size_t i = 0; i < n; i++) {
+            positives += (size_t)bloom_contains_hash(f, absent[i]);
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "blocked bloom k=%u%s", bloom_k(f), scalar ? " (s)" : "");
+        printf("%-22s %10.1f %10.1f %10.2f %10.4f %10.4f %10.4f\n", name, add_ns, query_ns,
+               (double)bloom_memory(f) * 8 / (double)n, fpr, bloom_fpr(bloom_blocks(f), bloom_k(f), n),
+               (double)positives / (double)n);
+        bloom_free(f);
+    }
+
+    CuckooFilter* c = cuckoo_filter_create(n, fpr);
+    double start = now_sec();
+    size_t failed = 0;
+    for (size_t i = 0; i < n; i++) {
+        failed += cuckoo_filter_add_hash(c, add[i]) != 0;
+    }
+    double add_ns = (now_sec() - start) * 1e9 / (double)n;
+    start = now_sec();
+    for (size_t i = 0; i < nq; i++) {
+        acc += (size_t)cuckoo_filter_contains_hash(c, query[i]);
+    }
+    double query_ns = (now_sec() - start) * 1e9 / (double)nq;
+    size_t positives = 0;
+    for (size_t i = 0; i < n; i++) {
+        positives += (size_t)cuckoo_filter_contains_hash(c, absent[i]);
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "cuckoo fp=%u", cuckoo_filter_fp_bits(c));
+    printf("%-22s %10.1f %10.1f %10.2f %10.4f %10s %10.4f\n", name, add_ns, query_ns,
+           (double)cuckoo_filter_memory(c) * 8 / (double)n, fpr, "-", (double)positives / (double)n);
+    if (failed != 0) {
+        printf("  cuckoo: %zu 个键加入失败\n", failed);
+    }
+    // 删除全部键的耗时
+    start = now_sec();
+    for (size_t i = 0; i < n; i++) {
+        cuckoo_filter_remove_hash(c, add[i]);
+    }
+    printf("  cuckoo remove: %.1f ns/key, 剩余 %zu 个指纹\n", (now_sec() - start) * 1e9 / (double)n,
+           cuckoo_filter_count(c));
+    cuckoo_filter_free(c);
+    g_sink += acc;
+    free(add);
+    free(absent);
+    free(query);
+}
+#endif
+
+int main(int argc, char* argv[]) {
+    size_t n = (size_t)1 << 20;
+    const char* names = NULL;
+    double fpr = 0.01;
+    size_t nq = 4000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            n = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--names") == 0 && i + 1 < argc) {
+            names = argv[++i];
+        } else if (strcmp(argv[i], "--fpr") == 0 && i + 1 < argc) {
+            fpr = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--lookups") == 0 && i + 1 < argc) {
+            nq = (size_t)strtoull(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "用法: %s [--n N] [--names FILE] [--fpr P] [--lookups N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Key* hits;
+    Key* misses;
+    if (names != NULL) {
+        n = load_names(names, &hits, &misses);
+    } else {
+        make_keys(n, &hits, &misses);
+    }
+    if (n == 0 || nq == 0 || !(fpr > 0 && fpr < 1)) {
+        fprintf(stderr, "键数、查询数应大于 0，fpr 应在 (0, 1) 之间\n");
+        return 2;
+    }
+
+    Item* items = (Item*)calloc(n, sizeof(Item));
+    Item* head = NULL;
+    for (size_t i = 0; i < n; i++) {
+        Item* it = NULL;
+        HASH_FIND(hh, head, hits[i].key, hits[i].len, it);
+        if (it == NULL) {
+            items[i].key = hits[i].key;
+            HASH_ADD_KEYPTR(hh, head, items[i].key, hits[i].len, &items[i]);
+        }
+    }
+#ifndef HASH_BLOOM
+    BloomFilter* bloom = bloom_create(n, fpr);
+    CuckooFilter* cuckoo = cuckoo_filter_create(n, fpr);
+    if (bloom == NULL || cuckoo == NULL) {
+        fprintf(stderr, "过滤器创建失败\n");
+        return 1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        uint64_t h = xxHash64(hits[i].key, hits[i].len, 0);
+        bloom_add_hash(bloom, h);
+        cuckoo_filter_add_hash(cuckoo, h);
+    }
+#endif
+
+    printf("%zu 个键（表中 %u 个），每种配置 %zu 次查找，目标假阳性率 %g\n", n, HASH_COUNT(head), nq, fpr);
+    printf("%-20s %6s %10s %10s %10s %10s\n", "table", "miss", "ns/lookup", "found", "fpr", "bits/key");
+    const double miss_rates[] = {0.0, 0.5, 0.9};
+    for (int m = 0; m < 3; m++) {
+        Key* q = make_queries(hits, misses, n, nq, miss_rates[m]);
+#ifdef HASH_BLOOM
+        Result r = lookup_plain(head, q, nq);
+        char name[32];
+        snprintf(name, sizeof(name), "uthash+HASH_BLOOM=%d", HASH_BLOOM);
+        print_row(name, miss_rates[m], &r, HASH_BLOOM_BYTELEN, n);
+#else
+        Result r = lookup_plain(head, q, nq);
+        print_row("uthash", miss_rates[m], &r, 0, n);
+        r = lookup_bloom(head, bloom, q, nq);
+        print_row("+blocked bloom", miss_rates[m], &r, bloom_memory(bloom), n);
+        r = lookup_cuckoo(head, cuckoo, q, nq);
+        print_row("+cuckoo", miss_rates[m], &r, cuckoo_filter_memory(cuckoo), n);
+#endif
+        free(q);
+    }
+
+#ifndef HASH_BLOOM
+    bloom_free(bloom);
+    cuckoo_filter_free(cuckoo);
+    bench_filters(hits, misses, n, fpr, nq);
+#endif
+    HASH_CLEAR(hh, head);
+    free(items);
+    return 0;
+}
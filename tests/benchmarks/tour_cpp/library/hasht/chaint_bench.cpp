@@ -0,0 +1,189 @@
+// 链地址法在构造的哈希碰撞下的表现：uthash、chaint（链表）、chaint（树化）
+// 三种表都使用 Java String.hashCode（s[0]*31^(n-1) + ... + s[n-1]）：
+//   collide：由 "Aa" / "BB" 拼成的 2^bits 个字符串，哈希值全部相同（针对 Java HashMap 的经典攻击）
+//   random ：同样长度的随机字符串，作为对照
+// 插入按 "先查找，不存在再加入" 的方式进行（处理外部输入的键时的常见写法），之后打乱顺序查找全部键、逐个删除
+// 用法：chaint_bench [--bits B]...
+#include "chaint.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static uint32_t javaHash(const void* key, size_t len) {
+    const unsigned char* p = static_cast<const unsigned char*>(key);
+    uint32_t h = 0;
+    for (size_t i = 0; i < len; i++) {
+        h = h * 31 + p[i];
+    }
+    return h;
+}
+
+#define HASH_FUNCTION(keyptr, keylen, hashv) ((hashv) = javaHash((keyptr), (keylen)))
+#include "uthash.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t g_rng = 0x243f6a8885a308d3ULL;
+
+uint64_t nextRand() {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return g_rng;
+}
+
+volatile uint64_t g_sink;
+
+uint32_t chainHash(const void* key, size_t len, uint32_t seed) {
+    (void)seed;
+    return javaHash(key, len);
+}
+
+struct Result {
+    double insert = 0, find = 0, erase = 0;    // ns/op
+    size_t depth = 0;                           // 最坏查找的比较次数
+};
+
+double nsPerOp(Clock::time_point start, size_t ops) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (double)ops;
+}
+
+struct UtItem {
+    const char* key;
+    UT_hash_handle hh;
+};
+
+Result benchUthash(const std::vector<std::string>& keys, const std::vector<size_t>& order) {
+    Result r;
+    size_t len = keys[0].size();
+    std::vector<UtItem> items(keys.size());
+    UtItem* head = nullptr;
+    auto start = Clock::now();
+    for (size_t i = 0; i < keys.size(); i++) {
+        UtItem* found = nullptr;
+        HASH_FIND(hh, head, keys[i].data(), len, found);
+        if (found == nullptr) {
+            items[i].key = keys[i].data();
+            HASH_ADD_KEYPTR(hh, head, items[i].key, len, &items[i]);
+        }
+    }
+    r.insert = nsPerOp(start, keys.size());
+    for (unsigned b = 0; b < head->hh.tbl->num_buckets; b++) {
+        r.depth = std::max(r.depth, (size_t)head->hh.tbl->buckets[b].count);
+    }
+
+    uint64_t acc = 0;
+    start = Clock::now();
+    for (size_t i : order) {
+        UtItem* found = nullptr;
+        HASH_FIND(hh, head, keys[i].data(), len, found);
+        acc += found != nullptr;
+    }
+    r.find = nsPerOp(start, order.size());
+    start = Clock::now();
+    for (size_t i : order) {
+        UtItem* found = nullptr;
+        HASH_FIND(hh, head, keys[i].data(), len, found);
+        HASH_DEL(head, found);
+    }
+    r.erase = nsPerOp(start, order.size());
+    g_sink += acc;
+    return r;
+}
+
+Result benchChaint(const std::vector<std::string>& keys, const std::vector<size_t>& order, int treeify) {
+    Result r;
+    size_t len = keys[0].size();
+    ChainTConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.hash = chainHash;
+    cfg.treeify = treeify;
+    ChainT* t = chaint_create(&cfg);
+    std::vector<ChainTNode> nodes(keys.size());
+    auto start = Clock::now();
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (chaint_find(t, keys[i].data(), len) == nullptr) {
+            chaint_add(t, &nodes[i], keys[i].data(), len);
+        }
+    }
+    r.insert = nsPerOp(start, keys.size());
+    r.depth = chaint_max_depth(t);
+
+    uint64_t acc = 0;
+    start = Clock::now();
+    for (size_t i : order) {
+        acc += chaint_find(t, keys[i].data(), len) != nullptr;
+    }
+    r.find = nsPerOp(start, order.size());
+    start = Clock::now();
+    for (size_t i : order) {
+        acc += chaint_remove(t, keys[i].data(), len) != nullptr;
+    }
+    r.erase = nsPerOp(start, order.size());
+    g_sink += acc;
+    chaint_free(t);
+    return r;
+}
+
+void printRow(const char* name, const char* workload, size_t n, const Result& r) {
+    printf("%-14s %-8s %8zu %12.1f %12.1f %12.1f %8zu\n", name, workload, n, r.insert, r.find, r.erase, r.depth);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<int> bitsList;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bits") == 0 && i + 1 < argc) {
+            bitsList.push_back(atoi(argv[++i]));
+        } else {
+            fprintf(stderr, "用法: %s [--bits B]...\n", argv[0]);
+            return 2;
+        }
+    }
+    if (bitsList.empty()) {
+        bitsList = {10, 12, 14};
+    }
+
+    printf("%-14s %-8s %8s %12s %12s %12s %8s\n", "table", "workload", "n", "insert", "find", "erase", "depth");
+    for (int bits : bitsList) {
+        if (bits < 1 || bits > 20) {
+            fprintf(stderr, "bits 应在 1 ~ 20 之间\n");
+            return 2;
+        }
+        size_t n = (size_t)1 << bits;
+        std::vector<std::string> collide(n), random(n);
+        for (size_t i = 0; i < n; i++) {
+            for (int b = 0; b < bits; b++) {
+                collide[i] += ((i >> b) & 1) ? "BB" : "Aa";
+                random[i] += (char)('a' + nextRand() % 26);
+                random[i] += (char)('a' + nextRand() % 26);
+            }
+        }
+        std::vector<size_t> order(n);
+        for (size_t i = 0; i < n; i++) {
+            order[i] = i;
+        }
+        for (size_t i = n; i > 1; i--) {
+            std::swap(order[i - 1], order[nextRand() % i]);
+        }
+
+        const struct {
+            const char* name;
+            const std::vector<std::string>* keys;
+        } workloads[] = {{"random", &random}, {"collide", &collide}};
+        for (const auto& w : workloads) {
+            printRow("uthash", w.name, n, benchUthash(*w.keys, order));
+            printRow("chaint list", w.name, n, benchChaint(*w.keys, order, 0));
+            printRow("chaint tree", w.name, n, benchChaint(*w.keys, order, 1));
+        }
+    }
+    return 0;
+}
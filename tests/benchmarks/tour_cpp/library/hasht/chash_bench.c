@@ -0,0 +1,277 @@
+/*
+ 一致性哈希基准测试
+ （1）lookup：Ketama 环、跳跃一致性哈希、Rendezvous 哈希与取模分片在不同节点数下的单次查找耗时（ns），
+      键的哈希值预先算好，只测分片本身
+ （2）movement：加入一个节点、删除一个中间节点（跳跃一致性哈希只能删除最后一个）时移动的键的比例，
+      与理想值 1/(n+1)、1/n 对比
+ （3）balance：各节点分到的键数的最大值 / 平均值，Ketama 环按每节点虚拟节点数分别统计
+
+ 用法：chash_bench [--keys N] [--csv]
+*/
+#define _POSIX_C_SOURCE 199309L
+#include "chash.h"
+#include "hashalg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef enum { SHARD_RING, SHARD_JUMP, SHARD_RENDEZVOUS, SHARD_MODULO } ShardKind;
+
+static const char* g_kind_names[] = { "ketama", "jump", "rendezvous", "modulo" };
+
+// 一组节点的某种分片方式；ring 只在 SHARD_RING 时使用，node_hashes 只在 SHARD_RENDEZVOUS 时使用
+typedef struct {
+    ShardKind kind;
+    int32_t n;
+    ChashRing* ring;
+    uint64_t* node_hashes;
+    int* ring_ids;          // ring 的节点编号 -> 节点序号（与其他方式一致，便于比较）
+} Shard;
+
+static uint64_t* g_hash64;
+static uint32_t* g_hash32;
+static int* g_before;
+static int* g_after;
+static size_t g_keys = 1000000;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void node_name(char* buf, size_t size, int i) {
+    snprintf(buf, size, "cache-%d.example.com:11211", i);
+}
+
+/*
+ node_ids[0..n) 为当前节点的序号（删除中间节点后序号不连续）；
+ jump/modulo 只看节点数，第 i 个桶对应 node_ids[i]
+*/
+static Shard shard_build(ShardKind kind, const int* node_ids, int32_t n, uint32_t vnodes) {
+    Shard s;
+    memset(&s, 0, sizeof(s));
+    s.kind = kind;
+    s.n = n;
+    char name[64];
+    if (kind == SHARD_RING) {
+        s.ring = chash_ring_create(vnodes);
+        s.ring_ids = (int*)malloc((size_t)n * sizeof(int));
+        for (int32_t i = 0; i < n; i++) {
+            node_name(name, sizeof(name), node_ids[i]);
+            int id = chash_ring_add(s.ring, name, 1);
+            s.ring_ids[id] = node_ids[i];
+        }
+    } else if (kind == SHARD_RENDEZVOUS) {
+        s.node_hashes = (uint64_t*)malloc((size_t)n * sizeof(uint64_t));
+        for (int32_t i = 0; i < n; i++) {
+            node_name(name, sizeof(name), node_ids[i]);
+            s.node_hashes[i] = xxHash64(name, strlen(name), 0);
+        }
+    }
+    return s;
+}
+
+static void shard_free(Shard* s) {
+    chash_ring_free(s->ring);
+    free(s->node_hashes);
+    free(s->ring_ids);
+}
+
+// 返回节点在 node_ids 中的位置
+static inline int shard_lookup(const Shard* s, size_t k) {
+    switch (s->kind) {
+    case SHARD_RING:       return chash_ring_lookup_hash(s->ring, g_hash32[k]);
+    case SHARD_JUMP:       return jump_consistent_hash(g_hash64[k], s->n);
+    case SHARD_RENDEZVOUS: return rendezvous_hash(g_hash64[k], s->node_hashes, s->n);
+    default:               return (int)(g_hash64[k] % (uint64_t)s->n);
+    }
+}
+
+static volatile long g_sink;
+
+static double bench_lookup(const Shard* s) {
+    size_t reps = 1;
+    for (;;) {
+        long acc = 0;
+        double start = now_sec();
+        for (size_t r = 0; r < reps; r++) {
+            for (size_t k = 0; k < g_keys; k++) {
+                acc += shard_lookup(s, k);
+            }
+        }
+        double elapsed = now_sec() - start;
+        g_sink += acc;
+        if (elapsed >= 0.2) {
+            return elapsed * 1e9 / (double)(reps * g_keys);
+        }
+        reps *= 2;
+    }
+}
+
+static void map_all(ShardKind kind, const int* ids, int32_t n, int* out) {
+    Shard s = shard_build(kind, ids, n, 0);
+    for (size_t k = 0; k < g_keys; k++) {
+        int r = shard_lookup(&s, k);
+        // ring 返回的是环内编号，其余返回 ids 中的位置，统一转换成节点序号
+        out[k] = kind == SHARD_RING ? s.ring_ids[r] : ids[r];
+    }
+    shard_free(&s);
+}
+
+static double moved_ratio(void) {
+    size_t moved = 0;
+    for (size_t k = 0; k < g_keys; k++) {
+        moved += g_before[k] != g_after[k];
+    }
+    return (double)moved / (double)g_keys;
+}
+
+int main(int argc, char* argv[]) {
+    int csv = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else if (strcmp(argv[i], "--keys") == 0 && i + 1 < argc) {
+            g_keys = (size_t)strtoull(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "用法: %s [--keys N] [--csv]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (g_keys == 0) {
+        g_keys = 1;
+    }
+
+    g_hash64 = (uint64_t*)malloc(g_keys * sizeof(uint64_t));
+    g_hash32 = (uint32_t*)malloc(g_keys * sizeof(uint32_t));
+    g_before = (int*)malloc(g_keys * sizeof(int));
+    g_after = (int*)malloc(g_keys * sizeof(int));
+    if (g_hash64 == NULL || g_hash32 == NULL || g_before == NULL || g_after == NULL) {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+    char key[32];
+    for (size_t k = 0; k < g_keys; k++) {
+        int len = snprintf(key, sizeof(key), "user:%zu", k);
+        g_hash64[k] = xxHash64(key, (size_t)len, 0);
+        g_hash32[k] = murmurHash3_32(key, (size_t)len, 0);
+    }
+
+    static const int32_t node_counts[] = { 10, 100, 1000 };
+    enum { NC = sizeof(node_counts) / sizeof(node_counts[0]), MAX_NODES = 1001 };
+    int ids[MAX_NODES];
+
+    // （1）查找耗时
+    if (csv) {
+        printf("test,kind,nodes,value\n");
+    } else {
+        printf("lookup（ns/次，%zu 个键，Ketama 每节点 %d 个虚拟节点）\n", g_keys, CHASH_DEFAULT_VNODES);
+        printf("%-12s %10s %10s %10s\n", "", "10", "100", "1000");
+    }
+    for (int kind = 0; kind < 4; kind++) {
+        if (!csv) {
+            printf("%-12s", g_kind_names[kind]);
+        }
+        for (int c = 0; c < NC; c++) {
+            int32_t n = node_counts[c];
+            for (int32_t i = 0; i < n; i++) {
+                ids[i] = i;
+            }
+            Shard s = shard_build((ShardKind)kind, ids, n, 0);
+            double ns = bench_lookup(&s);
+            shard_free(&s);
+            if (csv) {
+                printf("lookup,%s,%d,%.2f\n", g_kind_names[kind], n, ns);
+            } else {
+                printf(" %10.2f", ns);
+            }
+            fflush(stdout);
+        }
+        if (!csv) {
+            printf("\n");
+        }
+    }
+
+    // （2）节点增删时移动的键的比例
+    if (!csv) {
+        printf("\nmovement（移动的键 / 全部键）\n");
+        printf("%-12s %8s %14s %14s\n", "", "nodes", "join(+1)", "leave(-1)");
+    }
+    for (int kind = 0; kind < 4; kind++) {
+        for (int c = 0; c < 2; c++) {
+            int32_t n = node_counts[c];
+            for (int32_t i = 0; i <= n; i++) {
+                ids[i] = i;
+            }
+            map_all((ShardKind)kind, ids, n, g_before);
+            map_all((ShardKind)kind, ids, n + 1, g_after);
+            double join = moved_ratio();
+
+            // 删除中间的节点 n/2；jump 与 modulo 的桶只能是连续编号，删除的是最后一个
+            if (kind == SHARD_RING || kind == SHARD_RENDEZVOUS) {
+                memmove(&ids[n / 2], &ids[n / 2 + 1], (size_t)(n - n / 2) * sizeof(int));
+            }
+            map_all((ShardKind)kind, ids, n - 1, g_after);
+            double leave = moved_ratio();
+            if (csv) {
+                printf("join,%s,%d,%.4f\n", g_kind_names[kind], n, join);
+                printf("leave,%s,%d,%.4f\n", g_kind_names[kind], n, leave);
+            } else {
+                printf("%-12s %8d %14.4f %14.4f\n", g_kind_names[kind], n, join, leave);
+            }
+        }
+    }
+    if (!csv) {
+        printf("%-12s %8d %14.4f %14.4f\n", "ideal", 10, 1.0 / 11, 1.0 / 10);
+        printf("%-12s %8d %14.4f %14.4f\n", "ideal", 100, 1.0 / 101, 1.0 / 100);
+    }
+
+    // （3）负载均衡：100 个节点，最大负载 / 平均负载
+    static const uint32_t vnode_counts[] = { 1, 10, 40, 160, 640 };
+    if (!csv) {
+        printf("\nbalance（100 个节点，最大负载 / 平均负载）\n");
+    }
+    int32_t n = 100;
+    for (int32_t i = 0; i < n; i++) {
+        ids[i] = i;
+    }
+    size_t counts[100];
+    for (size_t v = 0; v < sizeof(vnode_counts) / sizeof(vnode_counts[0]) + 2; v++) {
+        char label[32];
+        memset(counts, 0, sizeof(counts));
+        if (v < sizeof(vnode_counts) / sizeof(vnode_counts[0])) {
+            Shard s = shard_build(SHARD_RING, ids, n, vnode_counts[v]);
+            for (size_t k = 0; k < g_keys; k++) {
+                counts[s.ring_ids[shard_lookup(&s, k)]]++;
+            }
+            shard_free(&s);
+            snprintf(label, sizeof(label), "ketama/%u", vnode_counts[v]);
+        } else {
+            ShardKind kind = v == sizeof(vnode_counts) / sizeof(vnode_counts[0]) ? SHARD_JUMP : SHARD_RENDEZVOUS;
+            Shard s = shard_build(kind, ids, n, 0);
+            for (size_t k = 0; k < g_keys; k++) {
+                counts[shard_lookup(&s, k)]++;
+            }
+            shard_free(&s);
+            snprintf(label, sizeof(label), "%s", g_kind_names[kind]);
+        }
+        size_t max = 0;
+        for (int32_t i = 0; i < n; i++) {
+            max = counts[i] > max ? counts[i] : max;
+        }
+        double ratio = (double)max * n / (double)g_keys;
+        if (csv) {
+            printf("balance,%s,%d,%.3f\n", label, n, ratio);
+        } else {
+            printf("%-14s %8.3f\n", label, ratio);
+        }
+    }
+
+    free(g_hash64);
+    free(g_hash32);
+    free(g_before);
+    free(g_after);
+    return 0;
+}
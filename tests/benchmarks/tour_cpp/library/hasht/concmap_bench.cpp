@@ -0,0 +1,260 @@
+// 并发哈希表吞吐测试：1 ~ 64 个线程，读比例 100% / 95% / 50%
+//   concmap      ：分段锁（64 段）+ 无锁读
+//   concmap 1seg ：只有 1 段（写者共用一把锁），读仍然无锁，用来区分 "分段" 与 "无锁读" 各自的作用
+//   hasht+rwlock ：hasht 外面套一把读写锁
+//   uthash+rwlock：uthash 外面套一把读写锁（uthash tests/threads 中的用法）
+// 预先插入 N 个键，键在 [0, 2N) 中均匀随机；写操作一半插入（已存在则更新）、一半删除，元素数大致不变
+// 每种配置总共执行 OPS 次操作，平均分给各线程，输出每秒百万次操作（Mops/s）
+// 用法：concmap_bench [--n N] [--ops OPS]
+#include "concmap.h"
+#include "hasht.h"
+#include "uthash.h"
+#include <pthread.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t nextRand(uint64_t& s) {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    return s;
+}
+
+std::atomic<uint64_t> g_sink{0};
+
+// 表的统一接口；每个线程先 attach 取得自己的上下文
+struct Map {
+    virtual ~Map() = default;
+    virtual void* attach() { return nullptr; }
+    virtual void detach(void* ctx) { (void)ctx; }
+    virtual bool get(void* ctx, uint64_t key, uint64_t* value) = 0;
+    virtual void put(void* ctx, uint64_t key, uint64_t value) = 0;
+    virtual void remove(void* ctx, uint64_t key) = 0;
+};
+
+struct ConcMapAdapter : Map {
+    ConcMap* m;
+    explicit ConcMapAdapter(size_t segments, size_t n) {
+        ConcMapConfig cfg;
+        memset(&cfg, 0, sizeof(cfg));
+        cfg.key_size = sizeof(uint64_t);
+        cfg.value_size = sizeof(uint64_t);
+        cfg.segments = segments;
+        cfg.initial_capacity = n;
+        m = concmap_create(&cfg);
+    }
+    ~ConcMapAdapter() override { concmap_free(m); }
+    void* attach() override { return concmap_attach(m); }
+    void detach(void* ctx) override { concmap_detach((ConcMapThread*)ctx); }
+    bool get(void* ctx, uint64_t key, uint64_t* value) override {
+        return concmap_get((ConcMapThread*)ctx, &key, value) == 0;
+    }
+    void put(void* ctx, uint64_t key, uint64_t value) override { concmap_put((ConcMapThread*)ctx, &key, &value); }
+    void remove(void* ctx, uint64_t key) override { concmap_remove((ConcMapThread*)ctx, &key, nullptr); }
+};
+
+struct HashtRwlock : Map {
+    HashT* t;
+    pthread_rwlock_t lock;
+    explicit HashtRwlock(size_t n) {
+        HashTConfig cfg;
+        memset(&cfg, 0, sizeof(cfg));
+        cfg.key_size = sizeof(uint64_t);
+        cfg.value_size = sizeof(uint64_t);
+        cfg.initial_capacity = n;
+        t = hasht_create(&cfg);
+        pthread_rwlock_init(&lock, nullptr);
+    }
+    ~HashtRwlock() override {
+        hasht_free(t);
+        pthread_rwlock_destroy(&lock);
+    }
+    bool get(void* ctx, uint64_t key, uint64_t* value) override {
+        (void)ctx;
+        pthread_rwlock_rdlock(&lock);
+        const void* v = hasht_get(t, &key);
+        if (v != nullptr) {
+            memcpy(value, v, sizeof(*value));
+        }
+        pthread_rwlock_unlock(&lock);
+        return v != nullptr;
+    }
+    void put(void* ctx, uint64_t key, uint64_t value) override {
+        (void)ctx;
+        pthread_rwlock_wrlock(&lock);
+        hasht_put(t, &key, &value);
+        pthread_rwlock_unlock(&lock);
+    }
+    void remove(void* ctx, uint64_t key) override {
+        (void)ctx;
+        pthread_rwlock_wrlock(&lock);
+        hasht_remove(t, &key, nullptr);
+        pthread_rwlock_unlock(&lock);
+    }
+};
+
+struct UtItem {
+    uint64_t key;
+    uint64_t value;
+    UT_hash_handle hh;
+};
+
+struct UthashRwlock : Map {
+    UtItem* head = nullptr;
+    pthread_rwlock_t lock;
+    UthashRwlock() { pthread_rwlock_init(&lock, nullptr); }
+    ~UthashRwlock() override {
+        UtItem* it;
+        UtItem* tmp;
+        HASH_ITER(hh, head, it, tmp) {
+            HASH_DEL(head, it);
+            free(it);
+        }
+        pthread_rwlock_destroy(&lock);
+    }
+    bool get(void* ctx, uint64_t key, uint64_t* value) override {
+        (void)ctx;
+        UtItem* it = nullptr;
+        pthread_rwlock_rdlock(&lock);
+        HASH_FIND(hh, head, &key, sizeof(key), it);
+        if (it != nullptr) {
+            *value = it->value;
+        }
+        pthread_rwlock_unlock(&lock);
+        return it != nullptr;
+    }
+    void put(void* ctx, uint64_t key, uint64_t value) override {
+        (void)ctx;
+        UtItem* it = nullptr;
+        pthread_rwlock_wrlock(&lock);
+        HASH_FIND(hh, head, &key, sizeof(key), it);
+        if (it != nullptr) {
+            it->value = value;
+        } else {
+            it = (UtItem*)malloc(sizeof(UtItem));
+            it->key = key;
+            it->value = value;
+            HASH_ADD(hh, head, key, sizeof(uint64_t), it);
+        }
+        pthread_rwlock_unlock(&lock);
+    }
+    void remove(void* ctx, uint64_t key) override {
+        (void)ctx;
+        UtItem* it = nullptr;
+        pthread_rwlock_wrlock(&lock);
+        HASH_FIND(hh, head, &key, sizeof(key), it);
+        if (it != nullptr) {
+            HASH_DEL(head, it);
+            free(it);
+        }
+        pthread_rwlock_unlock(&lock);
+    }
+};
+
+// 返回 Mops/s
+double run(Map& map, size_t n, int threads, int readPercent, size_t ops) {
+    void* ctx = map.attach();
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < n; i++) {
+        map.put(ctx, nextRand(rng) % (2 * n), i);
+    }
+    map.detach(ctx);
+
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    size_t perThread = ops / (size_t)threads;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            void* c = map.attach();
+            uint64_t s = 0x2545f4914f6cdd1dULL * (uint64_t)(t + 1);
+            uint64_t acc = 0;
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < perThread; i++) {
+                uint64_t r = nextRand(s);
+                uint64_t key = (r >> 8) % (2 * n);
+                int dice = (int)(r % 100);
+                if (dice < readPercent) {
+                    uint64_t v = 0;
+                    acc += map.get(c, key, &v) ? v : 0;
+                } else if (dice & 1) {
+                    map.put(c, key, r);
+                } else {
+                    map.remove(c, key);
+                }
+            }
+            g_sink += acc;
+            map.detach(c);
+        });
+    }
+    while (ready.load() < threads) {
+        std::this_thread::yield();
+    }
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& w : workers) {
+        w.join();
+    }
+    double sec = std::chrono::duration<double>(Clock::now() - start).count();
+    return (double)(perThread * (size_t)threads) / sec / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t n = 1 << 20;
+    size_t ops = 4000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            n = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            ops = strtoull(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [--n N] [--ops OPS]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (n == 0 || ops == 0) {
+        fprintf(stderr, "N 与 OPS 应大于 0\n");
+        return 2;
+    }
+
+    const int threadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+    const int readPercents[] = {100, 95, 50};
+    printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    printf("%-14s %5s", "table", "read%");
+    for (int t : threadCounts) {
+        printf(" %7dT", t);
+    }
+    printf("   (Mops/s)\n");
+    for (int readPercent : readPercents) {
+        for (int kind = 0; kind < 4; kind++) {
+            static const char* const names[] = {"concmap", "concmap 1seg", "hasht+rwlock", "uthash+rwlock"};
+            printf("%-14s %5d", names[kind], readPercent);
+            for (int t : threadCounts) {
+                Map* map = kind == 0   ? (Map*)new ConcMapAdapter(CONCMAP_DEFAULT_SEGMENTS, n)
+                           : kind == 1 ? (Map*)new ConcMapAdapter(1, n)
+                           : kind == 2 ? (Map*)new HashtRwlock(n)
+                                       : (Map*)new UthashRwlock();
+                printf(" %8.2f", run(*map, n, t, readPercent, ops));
+                fflush(stdout);
+                delete map;
+            }
+            printf("\n");
+        }
+    }
+    return 0;
+}
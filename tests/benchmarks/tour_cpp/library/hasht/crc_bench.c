@@ -0,0 +1,119 @@
+/*
+ CRC 吞吐基准测试
+ 各实现对 64B ~ 1MiB 的缓冲区求 CRC，报告 GB/s
+
+ 用法：crc_bench [--csv] [--min-ms N]
+*/
+#define _POSIX_C_SOURCE 199309L
+#include "crc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    const char* name;
+    uint32_t (*crc32_fn)(uint32_t crc, const void* data, size_t len);     // 二选一
+    uint64_t (*crc64_fn)(uint64_t crc, const void* data, size_t len);
+} CrcCase;
+
+static const CrcCase g_cases[] = {
+    { "crc32_ieee (slice8)", crc32_ieee_update, NULL },
+    { "crc32c slice8",       crc32c_update_sw,  NULL },
+    { "crc32c sse4.2",       crc32c_update_hw,  NULL },
+    { "crc64 slice8",        NULL,              crc64_update_sw },
+    { "crc64 pclmul",        NULL,              crc64_update_clmul },
+};
+#define CASE_COUNT (sizeof(g_cases) / sizeof(g_cases[0]))
+
+static const size_t g_sizes[] = { 64, 256, 1024, 4096, 16384, 65536, 1 << 20 };
+#define SIZE_COUNT (sizeof(g_sizes) / sizeof(g_sizes[0]))
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static volatile uint64_t g_sink;
+
+static double bench_case(const CrcCase* c, const unsigned char* buf, size_t len, double min_sec) {
+    size_t iters = 1;
+    for (;;) {
+        uint64_t acc = 0;
+        double start = now_sec();
+        for (size_t i = 0; i < iters; i++) {
+            // 上一次的结果作为下一次的初值，测到的是连续数据流的吞吐
+            if (c->crc32_fn != NULL) {
+                acc = c->crc32_fn((uint32_t)acc, buf, len);
+            } else {
+                acc = c->crc64_fn(acc, buf, len);
+            }
+        }
+        double elapsed = now_sec() - start;
+        g_sink += acc;
+        if (elapsed >= min_sec) {
+            return (double)(len * iters) / elapsed / 1e9;
+        }
+        iters *= 2;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int csv = 0;
+    double min_sec = 0.05;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+            min_sec = atof(argv[++i]) / 1000.0;
+        } else {
+            fprintf(stderr, "用法: %s [--csv] [--min-ms N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    size_t max_len = g_sizes[SIZE_COUNT - 1];
+    unsigned char* buf = (unsigned char*)malloc(max_len);
+    if (buf == NULL) {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+    uint64_t x = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < max_len; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        buf[i] = (unsigned char)x;
+    }
+
+    if (csv) {
+        printf("case,bytes,gb_per_s\n");
+    } else {
+        printf("SSE4.2: %s, PCLMULQDQ: %s\n", crc32c_hw_available() ? "可用" : "不可用",
+               crc64_clmul_available() ? "可用" : "不可用");
+        printf("%-20s", "GB/s");
+        for (size_t s = 0; s < SIZE_COUNT; s++) {
+            printf(" %8zu", g_sizes[s]);
+        }
+        printf("\n");
+    }
+    for (size_t c = 0; c < CASE_COUNT; c++) {
+        if (!csv) {
+            printf("%-20s", g_cases[c].name);
+        }
+        for (size_t s = 0; s < SIZE_COUNT; s++) {
+            double gbps = bench_case(&g_cases[c], buf, g_sizes[s], min_sec);
+            if (csv) {
+                printf("%s,%zu,%.3f\n", g_cases[c].name, g_sizes[s], gbps);
+            } else {
+                printf(" %8.2f", gbps);
+            }
+            fflush(stdout);
+        }
+        if (!csv) {
+            printf("\n");
+        }
+    }
+
+    free(buf);
+    return 0;
+}
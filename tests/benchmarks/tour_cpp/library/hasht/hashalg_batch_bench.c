@@ -0,0 +1,177 @@
+/*
+ 批量哈希基准测试
+ 同一组 N 个键（默认 4096 个，连续存放）分别用逐个调用与批量接口哈希，报告每秒哈希的键数（Mkeys/s）
+
+ 用法：hashalg_batch_bench [--csv] [--keys N] [--min-ms N]
+*/
+#define _POSIX_C_SOURCE 199309L
+#include "hashalg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    const unsigned char* base;
+    const void** keys;
+    size_t* lens;
+    size_t key_len;
+    size_t n;
+    uint32_t* out32;
+    uint64_t* out64;
+} BatchInput;
+
+typedef void (*batch_run_fn)(const BatchInput* in, uint32_t seed);
+
+static void run_murmur_loop(const BatchInput* in, uint32_t seed) {
+    for (size_t i = 0; i < in->n; i++) {
+        in->out32[i] = murmurHash3_32(in->keys[i], in->lens[i], seed);
+    }
+}
+
+static void run_murmur_batch(const BatchInput* in, uint32_t seed) {
+    murmurHash3_32_batch(in->keys, in->lens, in->n, seed, in->out32);
+}
+
+static void run_murmur_fixed_scalar(const BatchInput* in, uint32_t seed) {
+    murmurHash3_32_batch_fixed_scalar(in->base, in->key_len, in->key_len, in->n, seed, in->out32);
+}
+
+static void run_murmur_fixed(const BatchInput* in, uint32_t seed) {
+    murmurHash3_32_batch_fixed(in->base, in->key_len, in->key_len, in->n, seed, in->out32);
+}
+
+static void run_xxh64_loop(const BatchInput* in, uint32_t seed) {
+    for (size_t i = 0; i < in->n; i++) {
+        in->out64[i] = xxHash64(in->keys[i], in->lens[i], seed);
+    }
+}
+
+static void run_xxh64_batch(const BatchInput* in, uint32_t seed) {
+    xxHash64_batch(in->keys, in->lens, in->n, seed, in->out64);
+}
+
+typedef struct {
+    const char* name;
+    batch_run_fn run;
+} BatchCase;
+
+static const BatchCase g_cases[] = {
+    { "murmur3_32 loop",         run_murmur_loop },
+    { "murmur3_32 batch",        run_murmur_batch },
+    { "murmur3_32 fixed scalar", run_murmur_fixed_scalar },
+    { "murmur3_32 fixed",        run_murmur_fixed },
+    { "xxh64 loop",              run_xxh64_loop },
+    { "xxh64 batch",             run_xxh64_batch },
+};
+#define CASE_COUNT (sizeof(g_cases) / sizeof(g_cases[0]))
+
+static const size_t g_key_lens[] = { 8, 16, 32, 64 };
+#define LEN_COUNT (sizeof(g_key_lens) / sizeof(g_key_lens[0]))
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// 返回每秒哈希的键数
+static double bench_case(const BatchCase* c, const BatchInput* in, double min_sec) {
+    size_t rounds = 1;
+    for (;;) {
+        double start = now_sec();
+        for (size_t r = 0; r < rounds; r++) {
+            c->run(in, (uint32_t)r);
+        }
+        double elapsed = now_sec() - start;
+        if (elapsed >= min_sec) {
+            return (double)(rounds * in->n) / elapsed;
+        }
+        rounds *= 2;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int csv = 0;
+    size_t n = 4096;
+    double min_sec = 0.1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else if (strcmp(argv[i], "--keys") == 0 && i + 1 < argc) {
+            n = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+            min_sec = atof(argv[++i]) / 1000.0;
+        } else {
+            fprintf(stderr, "用法: %s [--csv] [--keys N] [--min-ms N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (n == 0) {
+        n = 1;
+    }
+
+    size_t max_len = g_key_lens[LEN_COUNT - 1];
+    unsigned char* data = (unsigned char*)malloc(n * max_len);
+    const void** keys = (const void**)malloc(n * sizeof(*keys));
+    size_t* lens = (size_t*)malloc(n * sizeof(*lens));
+    uint32_t* out32 = (uint32_t*)malloc(n * sizeof(*out32));
+    uint64_t* out64 = (uint64_t*)malloc(n * sizeof(*out64));
+    if (data == NULL || keys == NULL || lens == NULL || out32 == NULL || out64 == NULL) {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+    uint64_t x = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < n * max_len; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        data[i] = (unsigned char)x;
+    }
+
+    if (csv) {
+        printf("case,key_bytes,keys,mkeys_per_s\n");
+    } else {
+        printf("AVX2: %s, %zu 个键\n", hash_cpu_has_avx2() ? "可用" : "不可用", n);
+        printf("%-24s", "Mkeys/s");
+        for (size_t l = 0; l < LEN_COUNT; l++) {
+            printf(" %7zuB", g_key_lens[l]);
+        }
+        printf("\n");
+    }
+
+    double results[CASE_COUNT][LEN_COUNT];
+    for (size_t l = 0; l < LEN_COUNT; l++) {
+        // 键紧密排列，定长接口的 stride 等于键长
+        for (size_t i = 0; i < n; i++) {
+            keys[i] = data + i * g_key_lens[l];
+            lens[i] = g_key_lens[l];
+        }
+        BatchInput in = { data, keys, lens, g_key_lens[l], n, out32, out64 };
+        for (size_t c = 0; c < CASE_COUNT; c++) {
+            results[c][l] = bench_case(&g_cases[c], &in, min_sec);
+        }
+    }
+
+    for (size_t c = 0; c < CASE_COUNT; c++) {
+        if (!csv) {
+            printf("%-24s", g_cases[c].name);
+        }
+        for (size_t l = 0; l < LEN_COUNT; l++) {
+            if (csv) {
+                printf("%s,%zu,%zu,%.3f\n", g_cases[c].name, g_key_lens[l], n, results[c][l] / 1e6);
+            } else {
+                printf(" %8.1f", results[c][l] / 1e6);
+            }
+        }
+        if (!csv) {
+            printf("\n");
+        }
+    }
+
+    free(data);
+    free(keys);
+    free(lens);
+    free(out32);
+    free(out64);
+    return 0;
+}
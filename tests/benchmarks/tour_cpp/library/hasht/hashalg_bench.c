@@ -0,0 +1,173 @@
+/*
+ 哈希函数吞吐基准测试
+ 对每个算法、每个键长度反复哈希同一块缓冲区，报告 GB/s 与单次哈希耗时（ns）
+ 每次调用的种子不同，避免编译器把循环不变的调用提到循环外
+
+ 用法：hashalg_bench [--csv] [--min-ms N] [--alg 名字]...
+*/
+#define _POSIX_C_SOURCE 199309L
+#include "hashalg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    const char* name;
+    hash32_fn hash32;           // 二选一
+    hash64_fn hash64;
+} BenchAlg;
+
+static uint64_t xxh64_scalar_fn(const void* key, size_t len, uint64_t seed) {
+    return xxHash64_scalar(key, len, seed);
+}
+
+static uint64_t xxh64_avx2_fn(const void* key, size_t len, uint64_t seed) {
+    return xxHash64_avx2(key, len, seed);
+}
+
+static const BenchAlg g_algs[] = {
+    { "times33",     NULL,           times33Hash64 },
+    { "murmur3_32",  murmurHash3_32, NULL },
+    { "murmur64a",   NULL,           murmurHash64A },
+    { "murmur3_128", NULL,           murmurHash3_x64_64 },
+    { "sax",         NULL,           saxHash64 },
+    { "fnv1a",       NULL,           fnvHash64 },
+    { "oat",         NULL,           oatHash64 },
+    { "jenkins",     jenHash,        NULL },
+    { "jenkins64",   NULL,           jenHash64 },
+    { "xxh64",       NULL,           xxh64_scalar_fn },
+    { "xxh64_avx2",  NULL,           xxh64_avx2_fn },
+};
+#define ALG_COUNT (sizeof(g_algs) / sizeof(g_algs[0]))
+
+static const size_t g_sizes[] = { 4, 8, 16, 32, 64, 256, 1024, 4096, 65536, 1 << 20 };
+#define SIZE_COUNT (sizeof(g_sizes) / sizeof(g_sizes[0]))
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// 结果汇总到全局变量，防止调用被优化掉
+static volatile uint64_t g_sink;
+
+// 以倍增的迭代次数运行，直到耗时超过 min_sec，返回每次哈希的秒数
+static double bench_one(const BenchAlg* alg, const unsigned char* buf, size_t len, double min_sec) {
+    size_t iters = 16;
+    for (;;) {
+        uint64_t acc = 0;
+        double start = now_sec();
+        if (alg->hash32 != NULL) {
+            for (size_t i = 0; i < iters; i++) {
+                acc += alg->hash32(buf, len, (uint32_t)i);
+            }
+        } else {
+            for (size_t i = 0; i < iters; i++) {
+                acc += alg->hash64(buf, len, i);
+            }
+        }
+        double elapsed = now_sec() - start;
+        g_sink += acc;
+        if (elapsed >= min_sec) {
+            return elapsed / (double)iters;
+        }
+        iters *= 2;
+    }
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "用法: %s [--csv] [--min-ms N] [--alg 名字]...\n", prog);
+    fprintf(stderr, "算法:");
+    for (size_t i = 0; i < ALG_COUNT; i++) {
+        fprintf(stderr, " %s", g_algs[i].name);
+    }
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char* argv[]) {
+    int csv = 0;
+    double min_sec = 0.05;
+    int selected[ALG_COUNT];
+    int any_selected = 0;
+    memset(selected, 0, sizeof(selected));
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+            min_sec = atof(argv[++i]) / 1000.0;
+        } else if (strcmp(argv[i], "--alg") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            size_t a = 0;
+            while (a < ALG_COUNT && strcmp(g_algs[a].name, name) != 0) {
+                a++;
+            }
+            if (a == ALG_COUNT) {
+                usage(argv[0]);
+                return 2;
+            }
+            selected[a] = 1;
+            any_selected = 1;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    size_t max_len = g_sizes[SIZE_COUNT - 1];
+    // 多分配 1 字节并从奇数地址开始，测到的是未对齐读取的性能
+    unsigned char* storage = (unsigned char*)malloc(max_len + 1);
+    if (storage == NULL) {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+    unsigned char* buf = storage + 1;
+    uint64_t x = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < max_len; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        buf[i] = (unsigned char)x;
+    }
+
+    if (csv) {
+        printf("alg,bytes,ns_per_hash,gb_per_s\n");
+    } else {
+        printf("AVX2: %s\n", hash_cpu_has_avx2() ? "可用" : "不可用");
+        printf("%-12s", "bytes");
+        for (size_t s = 0; s < SIZE_COUNT; s++) {
+            printf(" %9zu", g_sizes[s]);
+        }
+        printf("\n");
+    }
+
+    for (size_t a = 0; a < ALG_COUNT; a++) {
+        if (any_selected && !selected[a]) {
+            continue;
+        }
+        if (!csv) {
+            printf("%-12s", g_algs[a].name);
+        }
+        for (size_t s = 0; s < SIZE_COUNT; s++) {
+            double sec = bench_one(&g_algs[a], buf, g_sizes[s], min_sec);
+            double gbps = (double)g_sizes[s] / sec / 1e9;
+            if (csv) {
+                printf("%s,%zu,%.3f,%.3f\n", g_algs[a].name, g_sizes[s], sec * 1e9, gbps);
+            } else {
+                // 小于 1KiB 的键关心单次延迟（ns），大键关心吞吐（GB/s）
+                if (g_sizes[s] < 1024) {
+                    printf(" %7.1fns", sec * 1e9);
+                } else {
+                    printf(" %5.2fGB/s", gbps);
+                }
+            }
+            fflush(stdout);
+        }
+        if (!csv) {
+            printf("\n");
+        }
+    }
+
+    free(storage);
+    return 0;
+}
@@ -0,0 +1,647 @@
+/*
+ 哈希质量与吞吐测试（SMHasher 的精简版）
+ hashalg.c 注释里 "低碰撞率"、"分布均匀" 之类的说法，在这里用数据验证，为每个哈希表挑选合适的哈希函数
+
+ 测试项：
+ - speed      ：1B ~ 1MiB 键长下的吞吐（字节/周期）
+ - latency    ：短键（1~32B）的延迟（周期/次），下一次的键依赖上一次的结果，测到的是依赖链的延迟而不是吞吐
+ - avalanche  ：翻转输入的任意一位，输出每一位翻转的概率应为 50%，报告最差的偏差 |2p - 1|
+ - bic        ：位独立性（Bit Independence Criterion），翻转一个输入位时任意两个输出位的翻转应互不相关，报告最大相关系数 |r|
+ - dist       ：整数、UUID、URL 三类键按低位 / 高位分桶，卡方检验的 z 分数（理想哈希约为标准正态分布）
+ - collision  ：同一组键的碰撞数，与理想随机哈希的期望 n(n-1)/2^(bits+1) 比较
+
+ 周期使用 x86 的 TSC 计数（恒定频率，不随睿频变化），其他平台退化为纳秒
+ 结果中带 "!" 的项超过了阈值：avalanche / bic 为 max(1%, 5 倍抽样标准差)，dist 为 |z| > 5，
+ collision 为超出期望 4 倍泊松标准差以上
+
+ 用法：hashalg_quality [--test 名字]... [--alg 名字]... [--bits 32|64] [--keys N] [--reps N] [--csv]
+*/
+#define _POSIX_C_SOURCE 199309L
+#include "hashalg.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLE_UNIT "cycle"
+static inline uint64_t read_cycles(void) {
+    return __rdtsc();
+}
+#else
+#define CYCLE_UNIT "ns"
+static inline uint64_t read_cycles(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+enum {
+    TEST_SPEED     = 1 << 0,
+    TEST_LATENCY   = 1 << 1,
+    TEST_AVALANCHE = 1 << 2,
+    TEST_BIC       = 1 << 3,
+    TEST_DIST      = 1 << 4,
+    TEST_COLLISION = 1 << 5,
+};
+
+static const struct { const char* name; int bit; } g_tests[] = {
+    { "speed", TEST_SPEED },
+    { "latency", TEST_LATENCY },
+    { "avalanche", TEST_AVALANCHE },
+    { "bic", TEST_BIC },
+    { "dist", TEST_DIST },
+    { "collision", TEST_COLLISION },
+};
+#define TEST_COUNT (sizeof(g_tests) / sizeof(g_tests[0]))
+
+typedef struct {
+    int bits;                   // 32：测试 hash32，64：测试 hash64
+    size_t keys;                // dist / collision 每组键的个数
+    size_t reps;                // avalanche / bic 的抽样次数
+    int csv;
+} QualityConfig;
+
+static QualityConfig g_cfg = { 64, 1 << 20, 50000, 0 };
+
+/* ---------- 公共工具 ---------- */
+
+static uint64_t g_rng = 0x9e3779b97f4a7c15ULL;
+
+// splitmix64：生成随机键
+static uint64_t next_rand(void) {
+    uint64_t z = (g_rng += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static void fill_random(unsigned char* buf, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (unsigned char)next_rand();
+    }
+}
+
+// 按 --bits 选择 32 或 64 位输出，统一返回 uint64_t
+static inline uint64_t hash_key(const HashAlgInfo* alg, const void* key, size_t len, uint64_t seed) {
+    if (g_cfg.bits == 32) {
+        return alg->hash32(key, len, (uint32_t)seed);
+    }
+    return alg->hash64(key, len, seed);
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static volatile uint64_t g_sink;
+
+// 输出一个结果：表格模式下打印一格，CSV 模式下打印一行
+static void report(const char* test, const char* alg, const char* param, double value, int flagged,
+                   const char* fmt) {
+    if (g_cfg.csv) {
+        printf("%s,%s,%s,%.6g,%d\n", test, alg, param, value, flagged);
+    } else {
+        printf(" ");
+        printf(fmt, value);
+        printf("%s", flagged ? "!" : " ");
+    }
+}
+
+static void print_header(const char* title, const char* unit, const char* const* cols, size_t ncols) {
+    if (g_cfg.csv) {
+        return;
+    }
+    printf("\n== %s (%s) ==\n%-10s", title, unit, "alg");
+    for (size_t i = 0; i < ncols; i++) {
+        printf(" %10s", cols[i]);
+    }
+    printf("\n");
+}
+
+static void row_begin(const HashAlgInfo* alg) {
+    if (!g_cfg.csv) {
+        printf("%-10s", alg->name);
+    }
+}
+
+static void row_end(void) {
+    if (!g_cfg.csv) {
+        printf("\n");
+    }
+    fflush(stdout);
+}
+
+/* ---------- speed / latency ---------- */
+
+static const size_t g_speed_sizes[] = { 1, 4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1 << 20 };
+#define SPEED_SIZES (sizeof(g_speed_sizes) / sizeof(g_speed_sizes[0]))
+
+static void test_speed(const HashAlgInfo* alg, const unsigned char* buf) {
+    row_begin(alg);
+    for (size_t s = 0; s < SPEED_SIZES; s++) {
+        size_t len = g_speed_sizes[s];
+        size_t iters = 1;
+        double best = 0;
+        // 迭代次数倍增到至少 20ms，取 3 轮中最好的一轮
+        for (;;) {
+            double start = now_sec();
+            uint64_t c0 = read_cycles();
+            uint64_t acc = 0;
+            for (size_t i = 0; i < iters; i++) {
+                acc += alg->hash64(buf, len, i);
+            }
+            uint64_t c1 = read_cycles();
+            g_sink += acc;
+            if (now_sec() - start >= 0.02) {
+                for (int round = 0; round < 3; round++) {
+                    c0 = read_cycles();
+                    for (size_t i = 0; i < iters; i++) {
+                        acc += alg->hash64(buf, len, i);
+                    }
+                    c1 = read_cycles();
+                    double bpc = (double)(len * iters) / (double)(c1 - c0);
+                    best = bpc > best ? bpc : best;
+                }
+                g_sink += acc;
+                break;
+            }
+            iters *= 2;
+        }
+        char param[32];
+        snprintf(param, sizeof(param), "%zu", len);
+        report("speed", alg->name, param, best, 0, "%10.3f");
+    }
+    row_end();
+}
+
+static const size_t g_latency_sizes[] = { 1, 2, 4, 8, 12, 16, 24, 32 };
+#define LATENCY_SIZES (sizeof(g_latency_sizes) / sizeof(g_latency_sizes[0]))
+
+static void test_latency(const HashAlgInfo* alg) {
+    row_begin(alg);
+    for (size_t s = 0; s < LATENCY_SIZES; s++) {
+        size_t len = g_latency_sizes[s];
+        unsigned char key[32];
+        fill_random(key, sizeof(key));
+        const size_t iters = 200000;
+        double best = 1e30;
+        for (int round = 0; round < 5; round++) {
+            uint64_t h = 0;
+            uint64_t c0 = read_cycles();
+            for (size_t i = 0; i < iters; i++) {
+                // 把上一次的结果混入键的第一个字节：下一次哈希必须等上一次完成
+                key[0] ^= (unsigned char)h;
+                h = alg->hash64(key, len, 0);
+            }
+            uint64_t c1 = read_cycles();
+            g_sink += h;
+            double per = (double)(c1 - c0) / (double)iters;
+            best = per < best ? per : best;
+        }
+        char param[32];
+        snprintf(param, sizeof(param), "%zu", len);
+        report("latency", alg->name, param, best, 0, "%10.1f");
+    }
+    row_end();
+}
+
+/* ---------- avalanche / bic ---------- */
+
+static const size_t g_aval_sizes[] = { 4, 8, 16, 32 };
+#define AVAL_SIZES (sizeof(g_aval_sizes) / sizeof(g_aval_sizes[0]))
+
+static int bias_flagged(double bias, size_t reps) {
+    double limit = 5.0 / sqrt((double)reps);
+    return bias > (limit > 0.01 ? limit : 0.01);
+}
+
+static void test_avalanche(const HashAlgInfo* alg) {
+    const int out_bits = g_cfg.bits;
+    uint32_t* flips = (uint32_t*)malloc(sizeof(uint32_t) * 32 * 8 * 64);
+    row_begin(alg);
+    for (size_t s = 0; s < AVAL_SIZES; s++) {
+        size_t len = g_aval_sizes[s];
+        size_t in_bits = len * 8;
+        unsigned char key[32];
+        memset(flips, 0, sizeof(uint32_t) * in_bits * out_bits);
+        for (size_t r = 0; r < g_cfg.reps; r++) {
+            fill_random(key, len);
+            uint64_t h = hash_key(alg, key, len, 0);
+            for (size_t i = 0; i < in_bits; i++) {
+                key[i / 8] ^= (unsigned char)(1u << (i % 8));
+                uint64_t d = h ^ hash_key(alg, key, len, 0);
+                key[i / 8] ^= (unsigned char)(1u << (i % 8));
+                uint32_t* row = flips + i * out_bits;
+                while (d != 0) {
+                    row[__builtin_ctzll(d)]++;
+                    d &= d - 1;
+                }
+            }
+        }
+        double worst = 0;
+        for (size_t c = 0; c < in_bits * (size_t)out_bits; c++) {
+            double bias = fabs(2.0 * flips[c] / (double)g_cfg.reps - 1.0);
+            worst = bias > worst ? bias : worst;
+        }
+        char param[32];
+        snprintf(param, sizeof(param), "%zuB", len);
+        report("avalanche", alg->name, param, worst * 100.0, bias_flagged(worst, g_cfg.reps), "%9.2f%%");
+    }
+    row_end();
+    free(flips);
+}
+
+// 对 8 字节键的每个输入位，把 reps 次的输出差分按输出位转置成位图，两两求与后 popcount 得到同时翻转的次数
+static void test_bic(const HashAlgInfo* alg) {
+    const int out_bits = g_cfg.bits;
+    const size_t len = 8;
+    const size_t words = (g_cfg.reps + 63) / 64;
+    uint64_t* cols = (uint64_t*)malloc(sizeof(uint64_t) * words * out_bits);
+    unsigned char* keys = (unsigned char*)malloc(g_cfg.reps * len);
+    uint64_t* base = (uint64_t*)malloc(sizeof(uint64_t) * g_cfg.reps);
+    fill_random(keys, g_cfg.reps * len);
+    for (size_t r = 0; r < g_cfg.reps; r++) {
+        base[r] = hash_key(alg, keys + r * len, len, 0);
+    }
+
+    double worst = 0;
+    for (size_t i = 0; i < len * 8; i++) {
+        memset(cols, 0, sizeof(uint64_t) * words * out_bits);
+        for (size_t r = 0; r < g_cfg.reps; r++) {
+            unsigned char* key = keys + r * len;
+            key[i / 8] ^= (unsigned char)(1u << (i % 8));
+            uint64_t d = base[r] ^ hash_key(alg, key, len, 0);
+            key[i / 8] ^= (unsigned char)(1u << (i % 8));
+            while (d != 0) {
+                int j = __builtin_ctzll(d);
+                cols[j * words + r / 64] |= 1ULL << (r % 64);
+                d &= d - 1;
+            }
+        }
+        double p[64];
+        for (int j = 0; j < out_bits; j++) {
+            size_t cnt = 0;
+            for (size_t w = 0; w < words; w++) {
+                cnt += (size_t)__builtin_popcountll(cols[j * words + w]);
+            }
+            p[j] = (double)cnt / (double)g_cfg.reps;
+        }
+        for (int j = 0; j < out_bits; j++) {
+            for (int k = j + 1; k < out_bits; k++) {
+                size_t both = 0;
+                for (size_t w = 0; w < words; w++) {
+                    both += (size_t)__builtin_popcountll(cols[j * words + w] & cols[k * words + w]);
+                }
+                double var = p[j] * (1 - p[j]) * p[k] * (1 - p[k]);
+                // 某个输出位从不（或总是）翻转时，相关系数没有意义，按完全相关计
+                double r = var > 0 ? fabs((double)both / (double)g_cfg.reps - p[j] * p[k]) / sqrt(var) : 1.0;
+                worst = r > worst ? r : worst;
+            }
+        }
+    }
+
+    row_begin(alg);
+    report("bic", alg->name, "8B", worst * 100.0, bias_flagged(worst, g_cfg.reps), "%9.2f%%");
+    row_end();
+    free(cols);
+    free(keys);
+    free(base);
+}
+
+/* ---------- 键集合：整数、UUID、URL ---------- */
+
+typedef struct {
+    const char* name;
+    char* data;
+    size_t* off;
+    size_t* len;
+    size_t n;
+} KeySet;
+
+static void keyset_alloc(KeySet* ks, const char* name, size_t n, size_t bytes) {
+    ks->name = name;
+    ks->data = (char*)malloc(bytes);
+    ks->off = (size_t*)malloc(sizeof(size_t) * n);
+    ks->len = (size_t*)malloc(sizeof(size_t) * n);
+    ks->n = n;
+    if (ks->data == NULL || ks->off == NULL || ks->len == NULL) {
+        fprintf(stderr, "内存不足\n");
+        exit(1);
+    }
+}
+
+static void keyset_free(KeySet* ks) {
+    free(ks->data);
+    free(ks->off);
+    free(ks->len);
+}
+
+// 连续整数 0..n-1，按 width 字节小端序存放
+static void keyset_ints(KeySet* ks, const char* name, size_t n, size_t width) {
+    keyset_alloc(ks, name, n, n * width);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t v = i;
+        for (size_t b = 0; b < width; b++) {
+            ks->data[i * width + b] = (char)(v >> (8 * b));
+        }
+        ks->off[i] = i * width;
+        ks->len[i] = width;
+    }
+}
+
+// 随机 UUID v4 文本（36 字节，小写十六进制）
+static void keyset_uuids(KeySet* ks, size_t n) {
+    static const char hex[] = "0123456789abcdef";
+    keyset_alloc(ks, "uuid", n, n * 36);
+    for (size_t i = 0; i < n; i++) {
+        char* p = ks->data + i * 36;
+        uint64_t hi = next_rand();
+        uint64_t lo = next_rand();
+        hi = (hi & ~0xf000ULL) | 0x4000ULL;                         // 版本 4
+        lo = (lo & ~(3ULL << 62)) | (2ULL << 62);                   // 变体 10xx
+        int pos = 0;
+        for (int nib = 0; nib < 32; nib++) {
+            if (nib == 8 || nib == 12 || nib == 16 || nib == 20) {
+                p[pos++] = '-';
+            }
+            uint64_t src = nib < 16 ? hi : lo;
+            p[pos++] = hex[(src >> (60 - 4 * (nib % 16))) & 0xf];
+        }
+        ks->off[i] = i * 36;
+        ks->len[i] = 36;
+    }
+}
+
+// 结构相似的 URL：公共前缀很长，差异集中在中间或末尾的数字上
+static void keyset_urls(KeySet* ks, size_t n) {
+    keyset_alloc(ks, "url", n, n * 96);
+    size_t pos = 0;
+    for (size_t i = 0; i < n; i++) {
+        char* p = ks->data + pos;
+        int w;
+        switch (i % 4) {
+            case 0:
+                w = snprintf(p, 96, "https://www.example.com/catalog/item/%zu", i / 4);
+                break;
+            case 1:
+                w = snprintf(p, 96, "https://www.example.com/user/%zu/profile", i / 4);
+                break;
+            case 2:
+                w = snprintf(p, 96, "https://search.example.com/search?q=term%zu&page=%zu", i / 40, i / 4 % 10);
+                break;
+            default:
+                w = snprintf(p, 96, "https://static.example.com/img/%08zx.png", i / 4);
+                break;
+        }
+        ks->off[i] = pos;
+        ks->len[i] = (size_t)w;
+        pos += (size_t)w;
+    }
+}
+
+static void hash_keyset(const HashAlgInfo* alg, const KeySet* ks, uint64_t* out) {
+    for (size_t i = 0; i < ks->n; i++) {
+        out[i] = hash_key(alg, ks->data + ks->off[i], ks->len[i], 0);
+    }
+}
+
+/* ---------- dist / collision ---------- */
+
+// 卡方检验的 z 分数：(chi2 - df) / sqrt(2 df)
+static double chi_square_z(const uint64_t* hashes, size_t n, int bucket_bits, int shift) {
+    size_t buckets = (size_t)1 << bucket_bits;
+    uint32_t* counts = (uint32_t*)calloc(buckets, sizeof(uint32_t));
+    uint64_t mask = buckets - 1;
+    for (size_t i = 0; i < n; i++) {
+        counts[(hashes[i] >> shift) & mask]++;
+    }
+    double expect = (double)n / (double)buckets;
+    double chi2 = 0;
+    for (size_t b = 0; b < buckets; b++) {
+        double d = counts[b] - expect;
+        chi2 += d * d / expect;
+    }
+    free(counts);
+    double df = (double)(buckets - 1);
+    return (chi2 - df) / sqrt(2 * df);
+}
+
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static size_t count_collisions(uint64_t* hashes, size_t n) {
+    qsort(hashes, n, sizeof(uint64_t), cmp_u64);
+    size_t c = 0;
+    for (size_t i = 1; i < n; i++) {
+        c += hashes[i] == hashes[i - 1];
+    }
+    return c;
+}
+
+static void test_dist(const HashAlgInfo* alg, const KeySet* sets, size_t nsets, uint64_t* hashes) {
+    row_begin(alg);
+    for (size_t s = 0; s < nsets; s++) {
+        hash_keyset(alg, &sets[s], hashes);
+        // 平均每个桶 8 个键
+        int bucket_bits = 1;
+        while (((size_t)1 << (bucket_bits + 3)) < sets[s].n && bucket_bits < 24) {
+            bucket_bits++;
+        }
+        double zlo = chi_square_z(hashes, sets[s].n, bucket_bits, 0);
+        double zhi = chi_square_z(hashes, sets[s].n, bucket_bits, g_cfg.bits - bucket_bits);
+        char param[64];
+        snprintf(param, sizeof(param), "%s/low", sets[s].name);
+        report("dist", alg->name, param, zlo, fabs(zlo) > 5, "%10.1f");
+        snprintf(param, sizeof(param), "%s/high", sets[s].name);
+        report("dist", alg->name, param, zhi, fabs(zhi) > 5, "%10.1f");
+    }
+    row_end();
+}
+
+static void test_collision(const HashAlgInfo* alg, const KeySet* sets, size_t nsets, uint64_t* hashes) {
+    row_begin(alg);
+    for (size_t s = 0; s < nsets; s++) {
+        size_t n = sets[s].n;
+        hash_keyset(alg, &sets[s], hashes);
+        size_t c = count_collisions(hashes, n);
+        double expect = (double)n * (double)(n - 1) / 2.0 / ldexp(1.0, g_cfg.bits);
+        int flagged = (double)c > expect + 4 * sqrt(expect) + 2;
+        report("collision", alg->name, sets[s].name, (double)c, flagged, "%10.0f");
+    }
+    row_end();
+}
+
+/* ---------- main ---------- */
+
+static void usage(const char* prog) {
+    fprintf(stderr, "用法: %s [--test 名字]... [--alg 名字]... [--bits 32|64] [--keys N] [--reps N] [--csv]\n", prog);
+    fprintf(stderr, "测试:");
+    for (size_t i = 0; i < TEST_COUNT; i++) {
+        fprintf(stderr, " %s", g_tests[i].name);
+    }
+    fprintf(stderr, "\n算法:");
+    for (int a = 0; a < HASH_ALG_COUNT; a++) {
+        fprintf(stderr, " %s", hash_alg_get((HashAlg)a)->name);
+    }
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char* argv[]) {
+    int tests = 0;
+    int selected[HASH_ALG_COUNT];
+    int any_alg = 0;
+    memset(selected, 0, sizeof(selected));
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--test") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            size_t t = 0;
+            while (t < TEST_COUNT && strcmp(g_tests[t].name, name) != 0) {
+                t++;
+            }
+            if (t == TEST_COUNT) {
+                usage(argv[0]);
+                return 2;
+            }
+            tests |= g_tests[t].bit;
+        } else if (strcmp(argv[i], "--alg") == 0 && i + 1 < argc) {
+            const HashAlgInfo* info = hash_alg_find(argv[++i]);
+            if (info == NULL) {
+                usage(argv[0]);
+                return 2;
+            }
+            selected[info->alg] = 1;
+            any_alg = 1;
+        } else if (strcmp(argv[i], "--bits") == 0 && i + 1 < argc) {
+            g_cfg.bits = atoi(argv[++i]);
+            if (g_cfg.bits != 32 && g_cfg.bits != 64) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--keys") == 0 && i + 1 < argc) {
+            g_cfg.keys = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            g_cfg.reps = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            g_cfg.csv = 1;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (tests == 0) {
+        tests = TEST_SPEED | TEST_LATENCY | TEST_AVALANCHE | TEST_BIC | TEST_DIST | TEST_COLLISION;
+    }
+    if (g_cfg.keys < 16) {
+        g_cfg.keys = 16;
+    }
+    if (g_cfg.reps < 64) {
+        g_cfg.reps = 64;
+    }
+
+    const HashAlgInfo* algs[HASH_ALG_COUNT];
+    int nalgs = 0;
+    for (int a = 0; a < HASH_ALG_COUNT; a++) {
+        if (!any_alg || selected[a]) {
+            algs[nalgs++] = hash_alg_get((HashAlg)a);
+        }
+    }
+
+    if (g_cfg.csv) {
+        printf("test,alg,param,value,flagged\n");
+    } else {
+        printf("输出宽度 %d 位，dist/collision 每组 %zu 个键，avalanche/bic 抽样 %zu 次\n",
+               g_cfg.bits, g_cfg.keys, g_cfg.reps);
+    }
+
+    if (tests & TEST_SPEED) {
+        size_t max_len = g_speed_sizes[SPEED_SIZES - 1];
+        unsigned char* buf = (unsigned char*)malloc(max_len);
+        fill_random(buf, max_len);
+        const char* cols[SPEED_SIZES];
+        char names[SPEED_SIZES][16];
+        for (size_t s = 0; s < SPEED_SIZES; s++) {
+            snprintf(names[s], sizeof(names[s]), "%zuB", g_speed_sizes[s]);
+            cols[s] = names[s];
+        }
+        print_header("speed", "bytes/" CYCLE_UNIT ", 64 位版本", cols, SPEED_SIZES);
+        for (int a = 0; a < nalgs; a++) {
+            test_speed(algs[a], buf);
+        }
+        free(buf);
+    }
+
+    if (tests & TEST_LATENCY) {
+        const char* cols[LATENCY_SIZES];
+        char names[LATENCY_SIZES][16];
+        for (size_t s = 0; s < LATENCY_SIZES; s++) {
+            snprintf(names[s], sizeof(names[s]), "%zuB", g_latency_sizes[s]);
+            cols[s] = names[s];
+        }
+        print_header("latency", CYCLE_UNIT "/hash, 64 位版本", cols, LATENCY_SIZES);
+        for (int a = 0; a < nalgs; a++) {
+            test_latency(algs[a]);
+        }
+    }
+
+    if (tests & TEST_AVALANCHE) {
+        const char* cols[AVAL_SIZES] = { "4B", "8B", "16B", "32B" };
+        print_header("avalanche", "最差偏差 |2p-1|", cols, AVAL_SIZES);
+        for (int a = 0; a < nalgs; a++) {
+            test_avalanche(algs[a]);
+        }
+    }
+
+    if (tests & TEST_BIC) {
+        const char* cols[1] = { "8B" };
+        print_header("bic", "最大相关系数 |r|", cols, 1);
+        for (int a = 0; a < nalgs; a++) {
+            test_bic(algs[a]);
+        }
+    }
+
+    if (tests & (TEST_DIST | TEST_COLLISION)) {
+        KeySet sets[5];
+        keyset_ints(&sets[0], "int32", g_cfg.keys, 4);
+        keyset_ints(&sets[1], "int64", g_cfg.keys, 8);
+        keyset_uuids(&sets[2], g_cfg.keys);
+        keyset_urls(&sets[3], g_cfg.keys);
+        const size_t nsets = 4;
+        uint64_t* hashes = (uint64_t*)malloc(sizeof(uint64_t) * g_cfg.keys);
+
+        if (tests & TEST_DIST) {
+            const char* cols[8] = { "int32/lo", "int32/hi", "int64/lo", "int64/hi",
+                                    "uuid/lo", "uuid/hi", "url/lo", "url/hi" };
+            print_header("dist", "卡方 z 分数", cols, 8);
+            for (int a = 0; a < nalgs; a++) {
+                test_dist(algs[a], sets, nsets, hashes);
+            }
+        }
+        if (tests & TEST_COLLISION) {
+            double expect = (double)g_cfg.keys * (double)(g_cfg.keys - 1) / 2.0 / ldexp(1.0, g_cfg.bits);
+            char unit[64];
+            snprintf(unit, sizeof(unit), "碰撞数，理想期望 %.3g", expect);
+            const char* cols[4] = { "int32", "int64", "uuid", "url" };
+            print_header("collision", unit, cols, 4);
+            for (int a = 0; a < nalgs; a++) {
+                test_collision(algs[a], sets, nsets, hashes);
+            }
+        }
+
+        free(hashes);
+        for (size_t s = 0; s < nsets; s++) {
+            keyset_free(&sets[s]);
+        }
+    }
+
+    return 0;
+}
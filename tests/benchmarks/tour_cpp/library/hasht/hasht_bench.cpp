@@ -0,0 +1,298 @@
+// 哈希表基准测试：hasht（开放寻址 + SSE2 分组探测）、robinhood（开放寻址 + Robin Hood）、uthash（链地址法）、std::unordered_map
+// 键为随机 64 位整数、值为 64 位整数，每个规模分别测量：
+// 逐个插入（不预留容量，包含扩容）、命中查找（打乱顺序）、未命中查找、逐个删除，输出 ns/op 与每个元素占用的字节数
+// robinhood 另测一行预留容量（按元素数精确分配）的结果，并输出探测长度的平均值、p99 与最大值
+// 用法：hasht_bench [--n N]... [--load F]
+#include "hasht.h"
+#include "robinhood.h"
+#include "uthash.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    double insert = 0, hit = 0, miss = 0, erase = 0;    // ns/op
+    double bytesPerEntry = 0;
+};
+
+uint64_t g_rng = 0x9e3779b97f4a7c15ULL;
+
+uint64_t nextRand() {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return g_rng;
+}
+
+double nsPerOp(Clock::time_point start, size_t ops) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (double)ops;
+}
+
+volatile uint64_t g_sink;
+
+// 统计 std::unordered_map 分配的字节数（节点 + 桶数组）
+size_t g_stdBytes = 0;
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+    T* allocate(size_t n) {
+        g_stdBytes += n * sizeof(T);
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) {
+        g_stdBytes -= n * sizeof(T);
+        ::operator delete(p);
+    }
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+Result benchHasht(const std::vector<uint64_t>& keys, const std::vector<uint64_t>& order,
+                  const std::vector<uint64_t>& misses, double maxLoad) {
+    Result r;
+    HashTConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.key_size = sizeof(uint64_t);
+    cfg.value_size = sizeof(uint64_t);
+    cfg.max_load = maxLoad;
+    HashT* t = hasht_create(&cfg);
+
+    auto start = Clock::now();
+    for (uint64_t k : keys) {
+        hasht_put(t, &k, &k);
+    }
+    r.insert = nsPerOp(start, keys.size());
+    r.bytesPerEntry = (double)hasht_memory(t) / (double)keys.size();
+
+    uint64_t acc = 0;
+    start = Clock::now();
+    for (uint64_t k : order) {
+        acc += *static_cast<uint64_t*>(hasht_get(t, &k));
+    }
+    r.hit = nsPerOp(start, order.size());
+    start = Clock::now();
+    for (uint64_t k : misses) {
+        acc += hasht_get(t, &k) != nullptr;
+    }
+    r.miss = nsPerOp(start, misses.size());
+    start = Clock::now();
+    for (uint64_t k : order) {
+        acc += hasht_remove(t, &k, nullptr);
+    }
+    r.erase = nsPerOp(start, order.size());
+    g_sink += acc;
+    hasht_free(t);
+    return r;
+}
+
+struct ProbeStats {
+    double mean = 0;
+    size_t p99 = 0, max = 0;
+};
+
+ProbeStats g_probe;
+
+Result benchRobin(const std::vector<uint64_t>& keys, const std::vector<uint64_t>& order,
+                  const std::vector<uint64_t>& misses, double maxLoad, bool reserve) {
+    Result r;
+    RobinHoodConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.key_size = sizeof(uint64_t);
+    cfg.value_size = sizeof(uint64_t);
+    cfg.max_load = maxLoad;
+    RobinHood* t = robinhood_create(&cfg);
+    if (reserve) {
+        robinhood_reserve(t, keys.size());
+    }
+
+    auto start = Clock::now();
+    for (uint64_t k : keys) {
+        robinhood_put(t, &k, &k);
+    }
+    r.insert = nsPerOp(start, keys.size());
+    r.bytesPerEntry = (double)robinhood_memory(t) / (double)keys.size();
+
+    std::vector<size_t> hist(ROBINHOOD_MAX_PROBE + 1);
+    g_probe = ProbeStats();
+    g_probe.max = robinhood_probe_histogram(t, hist.data(), hist.size());
+    size_t seen = 0;
+    for (size_t i = 0; i < hist.size(); i++) {
+        g_probe.mean += (double)(hist[i] * i) / (double)keys.size();
+        if (seen < keys.size() * 99 / 100) {
+            g_probe.p99 = i;
+        }
+        seen += hist[i];
+    }
+
+    uint64_t acc = 0;
+    start = Clock::now();
+    for (uint64_t k : order) {
+        acc += *static_cast<uint64_t*>(robinhood_get(t, &k));
+    }
+    r.hit = nsPerOp(start, order.size());
+    start = Clock::now();
+    for (uint64_t k : misses) {
+        acc += robinhood_get(t, &k) != nullptr;
+    }
+    r.miss = nsPerOp(start, misses.size());
+    start = Clock::now();
+    for (uint64_t k : order) {
+        acc += robinhood_remove(t, &k, nullptr);
+    }
+    r.erase = nsPerOp(start, order.size());
+    g_sink += acc;
+    robinhood_free(t);
+    return r;
+}
+
+struct UtItem {
+    uint64_t key;
+    uint64_t value;
+    UT_hash_handle hh;
+};
+
+Result benchUthash(const std::vector<uint64_t>& keys, const std::vector<uint64_t>& order,
+                   const std::vector<uint64_t>& misses) {
+    Result r;
+    UtItem* head = nullptr;
+    // 元素预先分配，只测表本身的操作
+    std::vector<UtItem> items(keys.size());
+    auto start = Clock::now();
+    for (size_t i = 0; i < keys.size(); i++) {
+        items[i].key = keys[i];
+        items[i].value = keys[i];
+        HASH_ADD(hh, head, key, sizeof(uint64_t), &items[i]);
+    }
+    r.insert = nsPerOp(start, keys.size());
+    r.bytesPerEntry = (double)(keys.size() * sizeof(UtItem) + HASH_OVERHEAD(hh, head) -
+                               keys.size() * sizeof(UT_hash_handle)) / (double)keys.size();
+
+    uint64_t acc = 0;
+    start = Clock::now();
+    for (uint64_t k : order) {
+        UtItem* it = nullptr;
+        HASH_FIND(hh, head, &k, sizeof(uint64_t), it);
+        acc += it->value;
+    }
+    r.hit = nsPerOp(start, order.size());
+    start = Clock::now();
+    for (uint64_t k : misses) {
+        UtItem* it = nullptr;
+        HASH_FIND(hh, head, &k, sizeof(uint64_t), it);
+        acc += it != nullptr;
+    }
+    r.miss = nsPerOp(start, misses.size());
+    start = Clock::now();
+    for (uint64_t k : order) {
+        UtItem* it = nullptr;
+        HASH_FIND(hh, head, &k, sizeof(uint64_t), it);
+        HASH_DEL(head, it);
+    }
+    r.erase = nsPerOp(start, order.size());
+    g_sink += acc;
+    HASH_CLEAR(hh, head);
+    return r;
+}
+
+Result benchStd(const std::vector<uint64_t>& keys, const std::vector<uint64_t>& order,
+                const std::vector<uint64_t>& misses) {
+    using Map = std::unordered_map<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                                   CountingAllocator<std::pair<const uint64_t, uint64_t>>>;
+    Result r;
+    g_stdBytes = 0;
+    {
+        Map m;
+        auto start = Clock::now();
+        for (uint64_t k : keys) {
+            m[k] = k;
+        }
+        r.insert = nsPerOp(start, keys.size());
+        r.bytesPerEntry = (double)g_stdBytes / (double)keys.size();
+
+        uint64_t acc = 0;
+        start = Clock::now();
+        for (uint64_t k : order) {
+            acc += m.find(k)->second;
+        }
+        r.hit = nsPerOp(start, order.size());
+        start = Clock::now();
+        for (uint64_t k : misses) {
+            acc += m.find(k) != m.end();
+        }
+        r.miss = nsPerOp(start, misses.size());
+        start = Clock::now();
+        for (uint64_t k : order) {
+            acc += m.erase(k);
+        }
+        r.erase = nsPerOp(start, order.size());
+        g_sink += acc;
+    }
+    return r;
+}
+
+void printRow(const char* name, size_t n, const Result& r) {
+    printf("%-18s %10zu %10.1f %10.1f %10.1f %10.1f %12.1f\n", name, n, r.insert, r.hit, r.miss, r.erase,
+           r.bytesPerEntry);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes;
+    double maxLoad = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            sizes.push_back((size_t)strtoull(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) {
+            maxLoad = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "用法: %s [--n N]... [--load F]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (sizes.empty()) {
+        sizes = {1000, 100000, 1000000, 4000000};
+    }
+
+    printf("%-18s %10s %10s %10s %10s %10s %12s\n", "table", "n", "insert", "hit", "miss", "erase", "bytes/entry");
+    for (size_t n : sizes) {
+        std::vector<uint64_t> keys(n), misses(n);
+        for (size_t i = 0; i < n; i++) {
+            keys[i] = nextRand() | 1;           // 命中的键为奇数
+            misses[i] = nextRand() & ~1ULL;     // 未命中的键为偶数
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        std::vector<uint64_t> order(keys);
+        for (size_t i = order.size(); i > 1; i--) {
+            std::swap(order[i - 1], order[nextRand() % i]);
+        }
+        for (size_t i = keys.size(); i > 1; i--) {
+            std::swap(keys[i - 1], keys[nextRand() % i]);
+        }
+
+        printRow("hasht", keys.size(), benchHasht(keys, order, misses, maxLoad));
+        printRow("robinhood", keys.size(), benchRobin(keys, order, misses, maxLoad, false));
+        printRow("robinhood reserve", keys.size(), benchRobin(keys, order, misses, maxLoad, true));
+        printf("  robinhood 探测长度：平均 %.2f，p99 %zu，最大 %zu\n", g_probe.mean, g_probe.p99, g_probe.max);
+        printRow("uthash", keys.size(), benchUthash(keys, order, misses));
+        printRow("std::unordered", keys.size(), benchStd(keys, order, misses));
+    }
+    return 0;
+}
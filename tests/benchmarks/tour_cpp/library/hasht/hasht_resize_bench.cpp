@@ -0,0 +1,191 @@
+// 扩容停顿测试：逐个插入 N 个随机 64 位键，记录每次插入的耗时，对比一次性扩容与渐进式扩容
+// 每次插入之后再查找若干个已插入的键，查找同样计时（迁移期间查找要检查新旧两个数组）
+// 输出插入延迟的分布（按数量级分桶）、p99 / p99.9 / 最大值，以及查找的平均与最大延迟
+// 用法：hasht_resize_bench [--n N] [--reads R]
+#include "hasht.h"
+#include "uthash.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t g_rng = 0x2545f4914f6cdd1dULL;
+
+uint64_t nextRand() {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return g_rng;
+}
+
+volatile uint64_t g_sink;
+
+// 延迟分桶上界（ns）：< 100ns、< 1us、< 10us、< 100us、< 1ms、< 10ms、>= 10ms
+constexpr int kBuckets = 7;
+const char* const kBucketNames[kBuckets] = {"<100ns", "<1us", "<10us", "<100us", "<1ms", "<10ms", ">=10ms"};
+
+int bucketOf(double ns) {
+    int b = 0;
+    for (double limit = 100; b < kBuckets - 1 && ns >= limit; limit *= 10) {
+        b++;
+    }
+    return b;
+}
+
+struct Stats {
+    uint64_t hist[kBuckets] = {};
+    double p99 = 0, p999 = 0, maxInsert = 0;
+    double avgRead = 0, maxRead = 0;
+    double totalMs = 0;
+};
+
+// 表的统一接口：插入、查找
+struct Table {
+    virtual ~Table() = default;
+    virtual void insert(uint64_t key) = 0;
+    virtual uint64_t find(uint64_t key) = 0;
+};
+
+struct HashtTable : Table {
+    HashT* t;
+    explicit HashtTable(size_t step) {
+        HashTConfig cfg;
+        memset(&cfg, 0, sizeof(cfg));
+        cfg.key_size = sizeof(uint64_t);
+        cfg.value_size = sizeof(uint64_t);
+        cfg.incremental_step = step;
+        t = hasht_create(&cfg);
+    }
+    ~HashtTable() override { hasht_free(t); }
+    void insert(uint64_t key) override { hasht_put(t, &key, &key); }
+    uint64_t find(uint64_t key) override { return *static_cast<uint64_t*>(hasht_get(t, &key)); }
+};
+
+struct UtItem {
+    uint64_t key;
+    uint64_t value;
+    UT_hash_handle hh;
+};
+
+// uthash：桶链过长时 HASH_EXPAND_BUCKETS 一次性把桶数加倍并重新挂链
+struct UthashTable : Table {
+    UtItem* head = nullptr;
+    std::vector<UtItem> items;
+    size_t used = 0;
+    explicit UthashTable(size_t n) : items(n) {}
+    ~UthashTable() override { HASH_CLEAR(hh, head); }
+    void insert(uint64_t key) override {
+        UtItem* it = &items[used++];
+        it->key = key;
+        it->value = key;
+        HASH_ADD(hh, head, key, sizeof(uint64_t), it);
+    }
+    uint64_t find(uint64_t key) override {
+        UtItem* it = nullptr;
+        HASH_FIND(hh, head, &key, sizeof(uint64_t), it);
+        return it->value;
+    }
+};
+
+Stats run(Table& table, const std::vector<uint64_t>& keys, int reads) {
+    Stats s;
+    std::vector<float> lat(keys.size());
+    double readSum = 0;
+    uint64_t acc = 0;
+    auto begin = Clock::now();
+    for (size_t i = 0; i < keys.size(); i++) {
+        auto t0 = Clock::now();
+        table.insert(keys[i]);
+        auto t1 = Clock::now();
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        lat[i] = (float)ns;
+        s.hist[bucketOf(ns)]++;
+        s.maxInsert = std::max(s.maxInsert, ns);
+        for (int r = 0; r < reads; r++) {
+            uint64_t k = keys[nextRand() % (i + 1)];
+            auto r0 = Clock::now();
+            acc += table.find(k);
+            double rns = std::chrono::duration<double, std::nano>(Clock::now() - r0).count();
+            readSum += rns;
+            s.maxRead = std::max(s.maxRead, rns);
+        }
+    }
+    s.totalMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    g_sink += acc;
+    s.avgRead = reads > 0 ? readSum / ((double)keys.size() * reads) : 0;
+
+    size_t i99 = lat.size() * 99 / 100;
+    size_t i999 = lat.size() * 999 / 1000;
+    std::nth_element(lat.begin(), lat.begin() + i99, lat.end());
+    s.p99 = lat[i99];
+    std::nth_element(lat.begin() + i99, lat.begin() + i999, lat.end());
+    s.p999 = lat[i999];
+    return s;
+}
+
+void printRow(const char* name, const Stats& s) {
+    printf("%-18s", name);
+    for (uint64_t c : s.hist) {
+        printf(" %9llu", (unsigned long long)c);
+    }
+    printf(" %8.0f %8.0f %10.0f %8.1f %8.0f %9.0f\n", s.p99, s.p999, s.maxInsert, s.avgRead, s.maxRead, s.totalMs);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t n = 4000000;
+    int reads = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            n = (size_t)strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--reads") == 0 && i + 1 < argc) {
+            reads = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "用法: %s [--n N] [--reads R]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (n == 0 || reads < 0) {
+        fprintf(stderr, "n 必须大于 0，reads 不能为负\n");
+        return 2;
+    }
+
+    std::vector<uint64_t> keys(n);
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = nextRand();
+    }
+
+    printf("插入 %zu 个键，每次插入后查找 %d 次；插入延迟分布（次数）与分位数（ns）\n", n, reads);
+    printf("%-18s", "table");
+    for (const char* b : kBucketNames) {
+        printf(" %9s", b);
+    }
+    printf(" %8s %8s %10s %8s %8s %9s\n", "p99", "p99.9", "max", "read", "readmax", "total_ms");
+
+    struct Config {
+        const char* name;
+        size_t step;
+    };
+    const Config configs[] = {
+        {"hasht stop-world", 0},
+        {"hasht incr step=1", 1},
+        {"hasht incr step=8", 8},
+    };
+    for (const Config& c : configs) {
+        HashtTable t(c.step);
+        printRow(c.name, run(t, keys, reads));
+    }
+    {
+        UthashTable t(n);
+        printRow("uthash", run(t, keys, reads));
+    }
+    return 0;
+}
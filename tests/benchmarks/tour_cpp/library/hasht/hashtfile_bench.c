@@ -0,0 +1,248 @@
+/*
+ 只读哈希表文件（hashtfile）的启动与查找测试
+ 先生成 "键\t值" 的文本文件（每行一个键值对），然后比较两种启动方式：
+   （1）每次启动从文本重建：逐行解析，插入 hasht（键、值为定长 24 字节）
+   （2）预先构建 hashtfile（一次性的构建耗时也列出），启动时 mmap 打开
+ 打开后的首批查找分两种情况：页缓存中已有文件（刚写完或其他进程在用），
+ 以及用 posix_fadvise(DONTNEED) 把文件逐出页缓存后（冷启动，页面按需从磁盘读入）
+ 最后比较 hasht 与 hashtfile 的随机查找吞吐，以及进程的匿名内存与文件映射内存
+
+ 用法：hashtfile_bench [--n N] [--dir DIR]
+*/
+#define _GNU_SOURCE
+#include "hasht.h"
+#include "hashtfile.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FIELD 24
+
+static uint64_t g_rng = 0x243f6a8885a308d3ULL;
+
+static uint64_t next_rand(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return g_rng;
+}
+
+static volatile size_t g_sink;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int format_key(char* buf, uint64_t i) {
+    return snprintf(buf, FIELD, "user:%012llu", (unsigned long long)(i * 2654435761ULL % 1000000000000ULL));
+}
+
+static void write_text(const char* path, size_t n) {
+    FILE* fp = fopen(path, "w");
+    if (fp == NULL) {
+        perror(path);
+        exit(1);
+    }
+    for (size_t i = 0; i < n; i++) {
+        char key[FIELD];
+        format_key(key, i);
+        fprintf(fp, "%s\t%016llx\n", key, (unsigned long long)next_rand());
+    }
+    fclose(fp);
+}
+
+// 解析一行 "键\t值"，成功返回 1
+static int parse_line(char* line, char** key, size_t* key_len, char** value, size_t* value_len) {
+    char* tab = strchr(line, '\t');
+    if (tab == NULL) {
+        return 0;
+    }
+    *key = line;
+    *key_len = (size_t)(tab - line);
+    *value = tab + 1;
+    *value_len = strcspn(tab + 1, "\n");
+    return *key_len < FIELD && *value_len < FIELD;
+}
+
+static HashT* load_hasht(const char* path) {
+    HashTConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.key_size = FIELD;
+    cfg.value_size = FIELD;
+    HashT* t = hasht_create(&cfg);
+    FILE* fp = fopen(path, "r");
+    char line[128];
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char *k, *v;
+        size_t kl, vl;
+        if (!parse_line(line, &k, &kl, &v, &vl)) {
+            continue;
+        }
+        char key[FIELD] = {0};
+        char value[FIELD] = {0};
+        memcpy(key, k, kl);
+        memcpy(value, v, vl);
+        hasht_put(t, key, value);
+    }
+    fclose(fp);
+    return t;
+}
+
+static HashTFileBuilder* load_builder(const char* path) {
+    HashTFileBuilder* b = hashtfile_builder_create(0, 0);
+    FILE* fp = fopen(path, "r");
+    char line[128];
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char *k, *v;
+        size_t kl, vl;
+        if (parse_line(line, &k, &kl, &v, &vl)) {
+            hashtfile_builder_add(b, k, kl, v, vl);
+        }
+    }
+    fclose(fp);
+    return b;
+}
+
+static void evict_page_cache(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+// 打开文件并完成前 first 次查找的耗时
+static double open_and_probe(const char* path, const uint64_t* ids, size_t first, HashTFile** out) {
+    double start = now_sec();
+    HashTFile* f = hashtfile_open(path);
+    if (f == NULL) {
+        fprintf(stderr, "打开 %s 失败\n", path);
+        exit(1);
+    }
+    size_t hits = 0;
+    for (size_t i = 0; i < first; i++) {
+        char key[FIELD];
+        int len = format_key(key, ids[i]);
+        hits += hashtfile_get(f, key, (size_t)len, NULL) != NULL;
+    }
+    double t = now_sec() - start;
+    g_sink += hits;
+    *out = f;
+    return t;
+}
+
+static void print_rss(const char* label) {
+    FILE* fp = fopen("/proc/self/status", "r");
+    if (fp == NULL) {
+        return;
+    }
+    char line[256];
+    printf("%s:", label);
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (strncmp(line, "RssAnon:", 8) == 0 || strncmp(line, "RssFile:", 8) == 0) {
+            line[strcspn(line, "\n")] = '\0';
+            printf("  %s", line);
+        }
+    }
+    printf("\n");
+    fclose(fp);
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = 4000000;
+    const char* dir = "/tmp";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            n = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc) {
+            dir = argv[++i];
+        } else {
+            fprintf(stderr, "用法: %s [--n N] [--dir DIR]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (n == 0) {
+        fprintf(stderr, "n 应大于 0\n");
+        return 2;
+    }
+    char text[512], table[512];
+    snprintf(text, sizeof(text), "%s/hashtfile_bench_%d.txt", dir, (int)getpid());
+    snprintf(table, sizeof(table), "%s/hashtfile_bench_%d.tbl", dir, (int)getpid());
+    write_text(text, n);
+
+    const size_t first = 1000, lookups = 2000000;
+    uint64_t* ids = (uint64_t*)malloc(lookups * sizeof(uint64_t));
+    for (size_t i = 0; i < lookups; i++) {
+        ids[i] = next_rand() % n;
+    }
+
+    printf("%zu 个键值对\n", n);
+    double start = now_sec();
+    HashT* t = load_hasht(text);
+    printf("从文本重建 hasht：%.1f ms\n", (now_sec() - start) * 1e3);
+
+    start = now_sec();
+    HashTFileBuilder* b = load_builder(text);
+    double parse = now_sec() - start;
+    start = now_sec();
+    if (hashtfile_builder_write(b, table) != 0) {
+        perror("hashtfile_builder_write");
+        return 1;
+    }
+    printf("构建 hashtfile（一次性）：%.1f ms，其中写文件 %.1f ms\n", (parse + now_sec() - start) * 1e3,
+           (now_sec() - start) * 1e3);
+    hashtfile_builder_free(b);
+
+    HashTFile* f;
+    double warm = open_and_probe(table, ids, first, &f);
+    printf("打开 + 前 1000 次查找（页缓存中）：%.3f ms，文件 %.1f MiB\n", warm * 1e3,
+           (double)hashtfile_bytes(f) / (1 << 20));
+    hashtfile_close(f);
+    evict_page_cache(table);
+    double cold = open_and_probe(table, ids, first, &f);
+    printf("打开 + 前 1000 次查找（逐出页缓存后）：%.3f ms\n", cold * 1e3);
+    hashtfile_close(f);
+
+    // 随机查找吞吐：都在内存中（hashtfile 先整体预读）
+    f = hashtfile_open(table);
+    hashtfile_prefetch(f);
+    size_t hits = 0;
+    for (size_t i = 0; i < lookups; i++) {
+        char key[FIELD];
+        int len = format_key(key, ids[i]);
+        hits += hashtfile_get(f, key, (size_t)len, NULL) != NULL;
+    }
+    start = now_sec();
+    for (size_t i = 0; i < lookups; i++) {
+        char key[FIELD];
+        int len = format_key(key, ids[i]);
+        hits += hashtfile_get(f, key, (size_t)len, NULL) != NULL;
+    }
+    double file_ns = (now_sec() - start) * 1e9 / (double)lookups;
+    start = now_sec();
+    for (size_t i = 0; i < lookups; i++) {
+        char key[FIELD] = {0};
+        format_key(key, ids[i]);
+        hits += hasht_get(t, key) != NULL;
+    }
+    double table_ns = (now_sec() - start) * 1e9 / (double)lookups;
+    printf("随机查找（命中，含格式化键）：hashtfile %.1f ns，hasht %.1f ns\n", file_ns, table_ns);
+    if (hits != 3 * lookups) {
+        printf("  查找结果不一致：%zu / %zu\n", hits, 3 * lookups);
+    }
+    print_rss("hasht 与 hashtfile 同时在内存中");
+    hasht_free(t);
+    print_rss("释放 hasht 后");
+
+    hashtfile_close(f);
+    free(ids);
+    unlink(text);
+    unlink(table);
+    return 0;
+}
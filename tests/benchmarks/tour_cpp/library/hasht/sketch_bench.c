@@ -0,0 +1,252 @@
+/*
+ SimHash / MinHash 近似去重基准测试
+ 合成语料：从随机生成的词表中均匀抽词组成文档，其中一部分文档有一个近似副本（替换其中一定比例的词）
+ （1）构建：分词 + 3 词 shingle、SimHash（标量 / AVX2）、OPH MinHash、k 次置换 MinHash 的每文档耗时
+ （2）签名比较：前 512 个文档的签名（在缓存中）两两比较，标量与 AVX2 的每秒比较次数
+ （3）查找相似对：LSH banding 与两两比较的耗时（两两比较实测前 2000 个文档，按 n(n-1)/2 外推），
+      近似副本的召回率，以及近似副本与随机文档对的 SimHash 距离
+
+ 用法：sketch_bench [--docs N] [--words N] [--dup-rate R] [--edit-rate R] [--k K] [--threshold T]
+*/
+#define _POSIX_C_SOURCE 199309L
+#include "hashalg.h"
+#include "sketch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define VOCAB 20000
+#define SHINGLE 3
+
+static uint64_t g_rng = 0x2545f4914f6cdd1dULL;
+
+static uint64_t next_rand(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return g_rng;
+}
+
+static volatile size_t g_sink;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    char* text;
+    size_t len;
+} Doc;
+
+static char g_vocab[VOCAB][12];
+
+static void make_vocab(void) {
+    for (int i = 0; i < VOCAB; i++) {
+        int len = 3 + (int)(next_rand() % 8);
+        for (int c = 0; c < len; c++) {
+            g_vocab[i][c] = (char)('a' + next_rand() % 26);
+        }
+        g_vocab[i][len] = '\0';
+    }
+}
+
+static Doc make_doc(const uint32_t* words, size_t nwords) {
+    Doc d;
+    d.text = (char*)malloc(nwords * 12);
+    d.len = 0;
+    for (size_t i = 0; i < nwords; i++) {
+        size_t wl = strlen(g_vocab[words[i]]);
+        memcpy(d.text + d.len, g_vocab[words[i]], wl);
+        d.len += wl;
+        d.text[d.len++] = ' ';
+    }
+    return d;
+}
+
+int main(int argc, char* argv[]) {
+    size_t ndocs = 20000;
+    size_t nwords = 300;
+    double dup_rate = 0.1;
+    double edit_rate = 0.05;
+    uint32_t k = 128;
+    double threshold = 0.5;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--docs") == 0 && i + 1 < argc) {
+            ndocs = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--words") == 0 && i + 1 < argc) {
+            nwords = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--dup-rate") == 0 && i + 1 < argc) {
+            dup_rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--edit-rate") == 0 && i + 1 < argc) {
+            edit_rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--k") == 0 && i + 1 < argc) {
+            k = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "用法: %s [--docs N] [--words N] [--dup-rate R] [--edit-rate R] [--k K] [--threshold T]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (ndocs < 2 || nwords < SHINGLE || k == 0 || k > MINHASH_MAX_K) {
+        fprintf(stderr, "参数无效\n");
+        return 2;
+    }
+
+    // 语料：前 ndups 个文档各有一个近似副本，放在文档 ndocs - ndups + i
+    size_t ndups = (size_t)((double)ndocs * dup_rate / (1.0 + dup_rate));
+    size_t nbase = ndocs - ndups;
+    make_vocab();
+    Doc* docs = (Doc*)malloc(ndocs * sizeof(Doc));
+    uint32_t** words = (uint32_t**)malloc(nbase * sizeof(uint32_t*));
+    uint32_t* tmp = (uint32_t*)malloc(nwords * sizeof(uint32_t));
+    for (size_t d = 0; d < nbase; d++) {
+        words[d] = (uint32_t*)malloc(nwords * sizeof(uint32_t));
+        for (size_t w = 0; w < nwords; w++) {
+            words[d][w] = (uint32_t)(next_rand() % VOCAB);
+        }
+        docs[d] = make_doc(words[d], nwords);
+    }
+    for (size_t i = 0; i < ndups; i++) {
+        for (size_t w = 0; w < nwords; w++) {
+            int edit = (double)(next_rand() % 1000000) < edit_rate * 1000000.0;
+            tmp[w] = edit ? (uint32_t)(next_rand() % VOCAB) : words[i][w];
+        }
+        docs[nbase + i] = make_doc(tmp, nwords);
+    }
+    size_t total_bytes = 0;
+    for (size_t d = 0; d < ndocs; d++) {
+        total_bytes += docs[d].len;
+    }
+    printf("语料：%zu 个文档（%zu 对近似副本，替换 %.0f%% 的词），每文档 %zu 词，共 %.1f MB；%d 词 shingle，签名 %u 个值\n",
+           ndocs, ndups, edit_rate * 100, nwords, (double)total_bytes / 1e6, SHINGLE, k);
+
+    // （1）构建
+    uint64_t* shingles = (uint64_t*)malloc(nwords * sizeof(uint64_t));
+    uint64_t* fps = (uint64_t*)malloc(ndocs * sizeof(uint64_t));
+    uint32_t* sigs = (uint32_t*)malloc(ndocs * k * sizeof(uint32_t));
+    uint32_t* kperm = (uint32_t*)malloc(k * sizeof(uint32_t));
+    double t_shingle = 0, t_simhash = 0, t_simhash_scalar = 0, t_oph = 0, t_kperm = 0;
+    size_t kperm_docs = ndocs < 2000 ? ndocs : 2000;   // k 次置换很慢，只测一部分文档
+    for (size_t d = 0; d < ndocs; d++) {
+        double t0 = now_sec();
+        size_t n = sketch_word_shingles(docs[d].text, docs[d].len, SHINGLE, shingles, nwords);
+        double t1 = now_sec();
+        fps[d] = simhash64(shingles, NULL, n);
+        double t2 = now_sec();
+        minhash_oph(shingles, n, k, sigs + d * k);
+        double t3 = now_sec();
+        g_sink += simhash64_scalar(shingles, NULL, n);
+        double t4 = now_sec();
+        t_shingle += t1 - t0;
+        t_simhash += t2 - t1;
+        t_oph += t3 - t2;
+        t_simhash_scalar += t4 - t3;
+        if (d < kperm_docs) {
+            minhash_kperm(shingles, n, k, kperm);
+            t_kperm += now_sec() - t4;
+        }
+    }
+    printf("\n构建（us/文档）\n");
+    printf("  分词 + shingle      %8.2f\n", t_shingle * 1e6 / (double)ndocs);
+    printf("  SimHash 标量        %8.2f\n", t_simhash_scalar * 1e6 / (double)ndocs);
+    printf("  SimHash AVX2        %8.2f\n", t_simhash * 1e6 / (double)ndocs);
+    printf("  MinHash OPH         %8.2f\n", t_oph * 1e6 / (double)ndocs);
+    printf("  MinHash k 次置换    %8.2f\n", t_kperm * 1e6 / (double)kperm_docs);
+
+    // （2）签名比较：前 hot 个文档两两比较，签名都在缓存中
+    size_t hot = ndocs < 512 ? ndocs : 512;
+    printf("\n签名比较（百万次/秒）\n");
+    for (int impl = 0; impl < 2; impl++) {
+        size_t reps = 1;
+        for (;;) {
+            size_t acc = 0;
+            double t0 = now_sec();
+            for (size_t r = 0; r < reps; r++) {
+                for (size_t i = 0; i < hot; i++) {
+                    for (size_t j = i + 1; j < hot; j++) {
+                        const uint32_t* a = sigs + i * k;
+                        const uint32_t* b = sigs + j * k;
+                        acc += impl == 0 ? minhash_match_count_scalar(a, b, k) : minhash_match_count_avx2(a, b, k);
+                    }
+                }
+            }
+            double elapsed = now_sec() - t0;
+            g_sink += acc;
+            if (elapsed >= 0.2) {
+                double cmps = (double)reps * (double)(hot * (hot - 1) / 2);
+                printf("  %-6s %8.2f\n", impl == 0 ? "标量" : "AVX2", cmps / elapsed * 1e-6);
+                break;
+            }
+            reps *= 2;
+        }
+    }
+
+    // 两两比较：实测前 sample 个文档的全部文档对，按文档对数外推到全部文档
+    size_t sample = ndocs < 2000 ? ndocs : 2000;
+    double t_brute = now_sec();
+    size_t brute_hits = 0;
+    for (size_t i = 0; i < sample; i++) {
+        for (size_t j = i + 1; j < sample; j++) {
+            brute_hits += minhash_match_count(sigs + i * k, sigs + j * k, k) >= threshold * k;
+        }
+    }
+    t_brute = now_sec() - t_brute;
+    g_sink += brute_hits;
+    double all_pairs = (double)ndocs * (double)(ndocs - 1) / 2.0;
+    double brute = t_brute * all_pairs / ((double)sample * (double)(sample - 1) / 2.0);
+
+    // （3）查找相似对
+    uint32_t bands = 0, rows = 0;
+    lsh_choose_bands(k, threshold, &bands, &rows);
+    SketchPair* pairs = NULL;
+    size_t npairs = 0;
+    double t0 = now_sec();
+    if (lsh_candidates(sigs, ndocs, k, bands, rows, &pairs, &npairs) != 0) {
+        fprintf(stderr, "lsh_candidates 失败\n");
+        return 1;
+    }
+    double t_lsh = now_sec() - t0;
+    size_t found = 0, verified = 0;
+    for (size_t i = 0; i < npairs; i++) {
+        const uint32_t* a = sigs + (size_t)pairs[i].a * k;
+        const uint32_t* b = sigs + (size_t)pairs[i].b * k;
+        verified += minhash_jaccard(a, b, k) >= threshold;
+        found += pairs[i].a < ndups && pairs[i].b == nbase + pairs[i].a;
+    }
+    size_t simhash_hits = 0;
+    double dup_dist = 0, rand_dist = 0;
+    for (size_t i = 0; i < ndups; i++) {
+        int d = simhash_distance(fps[i], fps[nbase + i]);
+        simhash_hits += d <= 3;
+        dup_dist += d;
+        rand_dist += simhash_distance(fps[i], fps[(i * 7919 + 1) % nbase]);
+    }
+    printf("\n查找相似对（阈值 %.2f，%u 段 x %u 行）\n", threshold, bands, rows);
+    printf("  LSH 候选            %zu 对，耗时 %.3f s，其中估计相似度 >= 阈值的 %zu 对\n", npairs, t_lsh, verified);
+    printf("  近似副本召回率      %.4f（%zu / %zu）\n", ndups ? (double)found / (double)ndups : 1.0, found, ndups);
+    printf("  两两比较（外推）    %.3f s，%.0f 对\n", brute, all_pairs);
+    printf("  SimHash 平均距离    近似副本 %.1f 位，随机文档对 %.1f 位；距离 <= 3 的近似副本占 %.4f\n",
+           ndups ? dup_dist / (double)ndups : 0.0, ndups ? rand_dist / (double)ndups : 0.0,
+           ndups ? (double)simhash_hits / (double)ndups : 1.0);
+
+    free(pairs);
+    free(kperm);
+    free(sigs);
+    free(fps);
+    free(shingles);
+    free(tmp);
+    for (size_t d = 0; d < nbase; d++) {
+        free(words[d]);
+    }
+    free(words);
+    for (size_t d = 0; d < ndocs; d++) {
+        free(docs[d].text);
+    }
+    free(docs);
+    return 0;
+}
@@ -0,0 +1,316 @@
+// LRU 缓存基准测试：lru（slab 节点 + 内嵌开放寻址索引）、uthash + 双向链表（每个节点 malloc）、std::unordered_map + std::list
+// 键、值都是 64 位整数，容量默认 10^6，测量：
+// 填满（插入 capacity 个不同的键）、命中查找（打乱顺序）、读穿透（get 未命中时 put，键在 capacity * ratio 个键中均匀分布，
+// 稳态下每次未命中都淘汰一个键），输出 ns/op、命中率与每个键占用的字节数
+// 用法：lru_bench [--capacity N] [--ratio R] [--ops N]
+#include "lru.h"
+#include "uthash.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    double fill = 0, hit = 0, mixed = 0;    // ns/op
+    double hitRate = 0;
+    double bytesPerEntry = 0;
+};
+
+uint64_t g_rng = 0x9e3779b97f4a7c15ULL;
+
+uint64_t nextRand() {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return g_rng;
+}
+
+double nsPerOp(Clock::time_point start, size_t ops) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (double)ops;
+}
+
+volatile uint64_t g_sink;
+
+// 键由编号打散得到，避免连续整数让各实现的哈希表现得过于理想
+inline uint64_t keyOf(uint64_t id) {
+    return id * 0x9e3779b97f4a7c15ULL + 0x632be59bd9b4e019ULL;
+}
+
+Result benchLru(size_t capacity, const std::vector<uint64_t>& order, const std::vector<uint64_t>& mixed) {
+    Result r;
+    LRUConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.capacity = capacity;
+    cfg.max_key_size = sizeof(uint64_t);
+    cfg.value_size = sizeof(uint64_t);
+    LRUCache* c = lru_create(&cfg);
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < capacity; i++) {
+        uint64_t k = keyOf(i);
+        lru_put(c, &k, sizeof(k), &k);
+    }
+    r.fill = nsPerOp(start, capacity);
+
+    uint64_t sum = 0;
+    start = Clock::now();
+    for (uint64_t id : order) {
+        uint64_t k = keyOf(id), v;
+        if (lru_get(c, &k, sizeof(k), &v) == 0) {
+            sum += v;
+        }
+    }
+    r.hit = nsPerOp(start, order.size());
+
+    size_t hits = 0;
+    start = Clock::now();
+    for (uint64_t id : mixed) {
+        uint64_t k = keyOf(id), v;
+        if (lru_get(c, &k, sizeof(k), &v) == 0) {
+            hits++;
+            sum += v;
+        } else {
+            lru_put(c, &k, sizeof(k), &k);
+        }
+    }
+    r.mixed = nsPerOp(start, mixed.size());
+    r.hitRate = (double)hits / (double)mixed.size();
+    r.bytesPerEntry = (double)lru_memory(c) / (double)capacity;
+    g_sink += sum;
+    lru_free(c);
+    return r;
+}
+
+// uthash 做索引，节点自带前后指针组成 LRU 链表，每个节点单独 malloc / free
+struct UtNode {
+    uint64_t key;
+    uint64_t value;
+    UtNode* prev;
+    UtNode* next;
+    UT_hash_handle hh;
+};
+
+struct UtLru {
+    UtNode* table = nullptr;
+    UtNode* head = nullptr;     // 最近使用
+    UtNode* tail = nullptr;     // 最久未使用
+    size_t size = 0;
+    size_t capacity = 0;
+
+    void unlink(UtNode* n) {
+        (n->prev != nullptr ? n->prev->next : head) = n->next;
+        (n->next != nullptr ? n->next->prev : tail) = n->prev;
+    }
+    void pushFront(UtNode* n) {
+        n->prev = nullptr;
+        n->next = head;
+        (head != nullptr ? head->prev : tail) = n;
+        head = n;
+    }
+    UtNode* get(uint64_t key) {
+        UtNode* n;
+        HASH_FIND(hh, table, &key, sizeof(key), n);
+        if (n != nullptr && n != head) {
+            unlink(n);
+            pushFront(n);
+        }
+        return n;
+    }
+    void put(uint64_t key, uint64_t value) {
+        UtNode* n = get(key);
+        if (n != nullptr) {
+            n->value = value;
+            return;
+        }
+        if (size == capacity) {
+            UtNode* old = tail;
+            unlink(old);
+            HASH_DELETE(hh, table, old);
+            free(old);
+            size--;
+        }
+        n = (UtNode*)malloc(sizeof(UtNode));
+        n->key = key;
+        n->value = value;
+        HASH_ADD(hh, table, key, sizeof(n->key), n);
+        pushFront(n);
+        size++;
+    }
+    void clear() {
+        UtNode *n, *tmp;
+        HASH_ITER(hh, table, n, tmp) {
+            HASH_DELETE(hh, table, n);
+            free(n);
+        }
+        head = tail = nullptr;
+        size = 0;
+    }
+};
+
+Result benchUthash(size_t capacity, const std::vector<uint64_t>& order, const std::vector<uint64_t>& mixed) {
+    Result r;
+    UtLru c;
+    c.capacity = capacity;
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < capacity; i++) {
+        uint64_t k = keyOf(i);
+        c.put(k, k);
+    }
+    r.fill = nsPerOp(start, capacity);
+
+    uint64_t sum = 0;
+    start = Clock::now();
+    for (uint64_t id : order) {
+        UtNode* n = c.get(keyOf(id));
+        if (n != nullptr) {
+            sum += n->value;
+        }
+    }
+    r.hit = nsPerOp(start, order.size());
+
+    size_t hits = 0;
+    start = Clock::now();
+    for (uint64_t id : mixed) {
+        uint64_t k = keyOf(id);
+        UtNode* n = c.get(k);
+        if (n != nullptr) {
+            hits++;
+            sum += n->value;
+        } else {
+            c.put(k, k);
+        }
+    }
+    r.mixed = nsPerOp(start, mixed.size());
+    r.hitRate = (double)hits / (double)mixed.size();
+    // 节点（malloc 头部按 16 字节计）+ 桶数组
+    size_t node = (sizeof(UtNode) + 8 + 15) / 16 * 16;
+    r.bytesPerEntry = (double)(c.size * node + HASH_OVERHEAD(hh, c.table) - c.size * sizeof(UT_hash_handle)) /
+                      (double)capacity;
+    g_sink += sum;
+    c.clear();
+    return r;
+}
+
+Result benchStd(size_t capacity, const std::vector<uint64_t>& order, const std::vector<uint64_t>& mixed) {
+    Result r;
+    using List = std::list<std::pair<uint64_t, uint64_t>>;
+    List list;
+    std::unordered_map<uint64_t, List::iterator> index;
+    index.reserve(capacity);
+    auto get = [&](uint64_t k) -> uint64_t* {
+        auto it = index.find(k);
+        if (it == index.end()) {
+            return nullptr;
+        }
+        list.splice(list.begin(), list, it->second);
+        return &it->second->second;
+    };
+    auto put = [&](uint64_t k, uint64_t v) {
+        if (uint64_t* p = get(k)) {
+            *p = v;
+            return;
+        }
+        if (index.size() == capacity) {
+            index.erase(list.back().first);
+            list.pop_back();
+        }
+        list.emplace_front(k, v);
+        index.emplace(k, list.begin());
+    };
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < capacity; i++) {
+        uint64_t k = keyOf(i);
+        put(k, k);
+    }
+    r.fill = nsPerOp(start, capacity);
+
+    uint64_t sum = 0;
+    start = Clock::now();
+    for (uint64_t id : order) {
+        if (uint64_t* p = get(keyOf(id))) {
+            sum += *p;
+        }
+    }
+    r.hit = nsPerOp(start, order.size());
+
+    size_t hits = 0;
+    start = Clock::now();
+    for (uint64_t id : mixed) {
+        uint64_t k = keyOf(id);
+        if (uint64_t* p = get(k)) {
+            hits++;
+            sum += *p;
+        } else {
+            put(k, k);
+        }
+    }
+    r.mixed = nsPerOp(start, mixed.size());
+    r.hitRate = (double)hits / (double)mixed.size();
+    // 链表节点（两个指针 + 键值）与哈希表节点（next 指针 + 键 + 迭代器）各按 malloc 的 32 字节计，另加桶数组
+    r.bytesPerEntry = (double)(index.size() * 64 + index.bucket_count() * sizeof(void*)) / (double)capacity;
+    g_sink += sum;
+    return r;
+}
+
+void printRow(const char* name, const Result& r) {
+    printf("%-10s %10.1f %10.1f %12.1f %8.1f%% %10.1f\n", name, r.fill, r.hit, r.mixed, r.hitRate * 100,
+           r.bytesPerEntry);
+}
+
+}   // namespace
+
+int main(int argc, char* argv[]) {
+    size_t capacity = 1000000;
+    double ratio = 1.25;
+    size_t ops = 10000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--capacity") == 0 && i + 1 < argc) {
+            capacity = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--ratio") == 0 && i + 1 < argc) {
+            ratio = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            ops = strtoull(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [--capacity N] [--ratio R] [--ops N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (capacity == 0 || ratio < 1.0 || ops == 0) {
+        fprintf(stderr, "capacity、ops 应大于 0，ratio 不小于 1\n");
+        return 2;
+    }
+
+    // 命中查找：已有的键打乱顺序
+    std::vector<uint64_t> order(capacity);
+    for (size_t i = 0; i < capacity; i++) {
+        order[i] = i;
+    }
+    for (size_t i = capacity - 1; i > 0; i--) {
+        std::swap(order[i], order[nextRand() % (i + 1)]);
+    }
+    // 读穿透：键在 capacity * ratio 个键中均匀分布，稳态命中率约为 1 / ratio
+    uint64_t range = (uint64_t)((double)capacity * ratio);
+    std::vector<uint64_t> mixed(ops);
+    for (size_t i = 0; i < ops; i++) {
+        mixed[i] = nextRand() % range;
+    }
+
+    printf("容量 %zu，读穿透的键空间 %llu（%.2f 倍容量），%zu 次操作\n", capacity, (unsigned long long)range, ratio,
+           ops);
+    printf("%-10s %10s %10s %12s %9s %10s\n", "impl", "fill ns", "hit ns", "get/put ns", "hit", "B/entry");
+    printRow("lru", benchLru(capacity, order, mixed));
+    printRow("uthash", benchUthash(capacity, order, mixed));
+    printRow("std", benchStd(capacity, order, mixed));
+    return 0;
+}
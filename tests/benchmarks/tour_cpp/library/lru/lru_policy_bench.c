@@ -0,0 +1,242 @@
+/*
+ 淘汰策略对比：同一条访问序列（trace）分别重放到 LRU、CLOCK、2Q、ARC、W-TinyLFU 策略的 lru 缓存上，
+ 每次访问先 get，未命中再 put（读穿透），输出各容量下的命中率（lru_hit_ratio）与每秒百万次访问（Mops/s）
+ 内置三种合成 trace（键为 64 位整数）：
+   （1）zipf 0.99：少数热点键占大部分访问
+   （2）zipf 0.7 ：分布较平
+   （3）zipf 0.99 + 扫描：每 100 万次访问中插入一段 10 万个从未出现过的键的顺序扫描
+ 也可以用 --trace 读入文本 trace（每行一个键，按字符串处理）
+
+ 用法：lru_policy_bench [--keys N] [--len N] [--trace FILE]
+*/
+#include "lru.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t g_rng = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t next_rand(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return g_rng;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// 访问序列：定长键（8 字节整数）或变长键（文本 trace，offsets[i] ~ offsets[i + 1]）
+typedef struct {
+    const char* name;
+    size_t len;
+    size_t universe;            // 不同键的个数（用来按比例选容量）
+    uint64_t* ids;              // 定长键
+    char* text;                 // 变长键
+    size_t* offsets;
+} Trace;
+
+// 按累积分布反查生成 zipf 分布的键编号，编号再打散，避免热点键连续
+static void fill_zipf(uint64_t* ids, size_t len, size_t keys, double alpha) {
+    double* cdf = (double*)malloc(keys * sizeof(double));
+    double sum = 0;
+    for (size_t i = 0; i < keys; i++) {
+        sum += 1.0 / pow((double)(i + 1), alpha);
+        cdf[i] = sum;
+    }
+    for (size_t i = 0; i < len; i++) {
+        double u = (double)(next_rand() >> 11) * 0x1.0p-53 * sum;
+        size_t lo = 0, hi = keys - 1;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (cdf[mid] < u) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        ids[i] = lo * 0x9e3779b97f4a7c15ULL;
+    }
+    free(cdf);
+}
+
+static Trace make_zipf(const char* name, size_t keys, size_t len, double alpha, int scans) {
+    Trace t;
+    memset(&t, 0, sizeof(t));
+    t.name = name;
+    t.len = len;
+    t.universe = keys;
+    t.ids = (uint64_t*)malloc(len * sizeof(uint64_t));
+    fill_zipf(t.ids, len, keys, alpha);
+    if (scans) {
+        // 每 100 万次访问的开头替换成 10 万个新键的顺序扫描
+        uint64_t next = keys;
+        for (size_t start = 0; start < len; start += 1000000) {
+            for (size_t i = start; i < start + 100000 && i < len; i++) {
+                t.ids[i] = (next++) * 0x9e3779b97f4a7c15ULL;
+            }
+        }
+        t.universe = (size_t)next;
+    }
+    return t;
+}
+
+static int load_text(const char* path, Trace* t) {
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL) {
+        perror(path);
+        return -1;
+    }
+    memset(t, 0, sizeof(*t));
+    t->name = path;
+    size_t cap_text = 1 << 20, cap_off = 1 << 16, used = 0;
+    t->text = (char*)malloc(cap_text);
+    t->offsets = (size_t*)malloc(cap_off * sizeof(size_t));
+    t->offsets[0] = 0;
+    char line[4096];
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        size_t n = strcspn(line, "\r\n");
+        if (n == 0 || n > 255) {
+            continue;
+        }
+        if (used + n > cap_text) {
+            cap_text = (used + n) * 2;
+            t->text = (char*)realloc(t->text, cap_text);
+        }
+        if (t->len + 2 > cap_off) {
+            cap_off *= 2;
+            t->offsets = (size_t*)realloc(t->offsets, cap_off * sizeof(size_t));
+        }
+        memcpy(t->text + used, line, n);
+        used += n;
+        t->offsets[++t->len] = used;
+    }
+    fclose(fp);
+    // 统计不同键的个数
+    LRUConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.capacity = t->len != 0 ? t->len : 1;
+    cfg.max_key_size = 255;
+    LRUCache* c = lru_create(&cfg);
+    for (size_t i = 0; i < t->len; i++) {
+        t->universe += lru_put(c, t->text + t->offsets[i], t->offsets[i + 1] - t->offsets[i], NULL) == 1;
+    }
+    lru_free(c);
+    return t->len != 0 ? 0 : -1;
+}
+
+// 重放一次，返回命中率，*mops 为吞吐
+static double replay(const Trace* t, LRUPolicy policy, size_t capacity, double* mops) {
+    LRUConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.capacity = capacity;
+    cfg.max_key_size = t->ids != NULL ? sizeof(uint64_t) : 255;
+    cfg.value_size = sizeof(uint64_t);
+    cfg.policy = policy;
+    LRUCache* c = lru_create(&cfg);
+    double start = now_sec();
+    for (size_t i = 0; i < t->len; i++) {
+        const void* key;
+        size_t len;
+        if (t->ids != NULL) {
+            key = &t->ids[i];
+            len = sizeof(uint64_t);
+        } else {
+            key = t->text + t->offsets[i];
+            len = t->offsets[i + 1] - t->offsets[i];
+        }
+        if (lru_get(c, key, len, NULL) != 0) {
+            lru_put(c, key, len, &i);
+        }
+    }
+    *mops = (double)t->len / (now_sec() - start) / 1e6;
+    double hit = lru_hit_ratio(c);
+    lru_free(c);
+    return hit;
+}
+
+static void run_trace(const Trace* t) {
+    // 最后一档容量装得下全部键，除了首次访问都命中，比较的是命中路径本身的开销
+    static const double fractions[] = {0.001, 0.01, 0.05, 0.1, 0.2, 1.0};
+    enum { NF = sizeof(fractions) / sizeof(fractions[0]) };
+    double hit[NF][LRU_POLICY_COUNT], mops[NF][LRU_POLICY_COUNT];
+    size_t caps[NF];
+    for (size_t f = 0; f < NF; f++) {
+        caps[f] = (size_t)((double)t->universe * fractions[f]);
+        for (int p = 0; p < LRU_POLICY_COUNT && caps[f] != 0; p++) {
+            hit[f][p] = replay(t, (LRUPolicy)p, caps[f], &mops[f][p]);
+        }
+    }
+    printf("%s：%zu 次访问，%zu 个不同的键\n", t->name, t->len, t->universe);
+    for (int table = 0; table < 2; table++) {
+        printf("  %-10s", table == 0 ? "hit%" : "Mops");
+        for (int p = 0; p < LRU_POLICY_COUNT; p++) {
+            printf(" %10s", lru_policy_name((LRUPolicy)p));
+        }
+        printf("\n");
+        for (size_t f = 0; f < NF; f++) {
+            if (caps[f] == 0) {
+                continue;
+            }
+            printf("  %-10zu", caps[f]);
+            for (int p = 0; p < LRU_POLICY_COUNT; p++) {
+                printf(" %10.2f", table == 0 ? hit[f][p] * 100 : mops[f][p]);
+            }
+            printf("\n");
+        }
+    }
+}
+
+static void free_trace(Trace* t) {
+    free(t->ids);
+    free(t->text);
+    free(t->offsets);
+}
+
+int main(int argc, char* argv[]) {
+    size_t keys = 1000000;
+    size_t len = 10000000;
+    const char* path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--keys") == 0 && i + 1 < argc) {
+            keys = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--len") == 0 && i + 1 < argc) {
+            len = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else {
+            fprintf(stderr, "用法: %s [--keys N] [--len N] [--trace FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (keys == 0 || len == 0) {
+        fprintf(stderr, "keys、len 应大于 0\n");
+        return 2;
+    }
+
+    if (path != NULL) {
+        Trace t;
+        if (load_text(path, &t) != 0) {
+            fprintf(stderr, "读取 %s 失败或为空\n", path);
+            return 1;
+        }
+        run_trace(&t);
+        free_trace(&t);
+        return 0;
+    }
+    Trace traces[3] = {
+        make_zipf("zipf 0.99", keys, len, 0.99, 0),
+        make_zipf("zipf 0.7", keys, len, 0.7, 0),
+        make_zipf("zipf 0.99 + 扫描", keys, len, 0.99, 1),
+    };
+    for (int i = 0; i < 3; i++) {
+        run_trace(&traces[i]);
+        free_trace(&traces[i]);
+    }
+    return 0;
+}
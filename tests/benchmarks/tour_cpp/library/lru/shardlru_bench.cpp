@@ -0,0 +1,234 @@
+// 并发 LRU 缓存吞吐测试：1 ~ 64 个线程，读比例 100% / 95%
+//   shardlru      ：分片（64 片）+ 读锁查找 + 命中缓冲后批量更新顺序
+//   shardlru 1片  ：只有 1 个分片，用来区分 "分片" 与 "命中缓冲" 各自的作用
+//   lru+mutex     ：lru.h 外面套一把互斥锁，每次命中都在锁内调整顺序
+//   foo_cache     ：uthash tests/lru_cache/cache.c 原样编译进来，每次查找都取写锁并删除再插入条目
+// 预先插入容量 N 个键，键为十进制字符串、在 [0, 1.25N) 中均匀随机（命中率约 80%）；
+// 写操作为插入（已存在则更新，已满则淘汰），每种配置总共执行 OPS 次操作，平均分给各线程，输出每秒百万次操作（Mops/s）
+// 用法：shardlru_bench [--n N] [--ops OPS]
+#include "lru.h"
+#include "shardlru.h"
+#include <pthread.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "cache.h"
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t nextRand(uint64_t& s) {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    return s;
+}
+
+std::atomic<uint64_t> g_sink{0};
+
+// foo_cache 只保存键的指针，键与值在测试期间一直有效
+constexpr size_t KEY_SIZE = 24;
+std::vector<char> g_keys;
+
+char* keyAt(uint64_t i) {
+    return &g_keys[i * KEY_SIZE];
+}
+
+struct Cache {
+    virtual ~Cache() = default;
+    virtual bool get(uint64_t id, uint64_t* value) = 0;
+    virtual void put(uint64_t id, uint64_t value) = 0;
+};
+
+struct ShardAdapter : Cache {
+    ShardLRU* c;
+    ShardAdapter(size_t capacity, size_t shards) {
+        ShardLRUConfig cfg;
+        memset(&cfg, 0, sizeof(cfg));
+        cfg.capacity = capacity;
+        cfg.shards = shards;
+        cfg.max_key_size = KEY_SIZE;
+        cfg.value_size = sizeof(uint64_t);
+        c = shardlru_create(&cfg);
+    }
+    ~ShardAdapter() override { shardlru_free(c); }
+    bool get(uint64_t id, uint64_t* value) override {
+        const char* k = keyAt(id);
+        return shardlru_get(c, k, strlen(k), value) == 0;
+    }
+    void put(uint64_t id, uint64_t value) override {
+        const char* k = keyAt(id);
+        shardlru_put(c, k, strlen(k), &value);
+    }
+};
+
+struct LruMutex : Cache {
+    LRUCache* c;
+    pthread_mutex_t lock;
+    explicit LruMutex(size_t capacity) {
+        LRUConfig cfg;
+        memset(&cfg, 0, sizeof(cfg));
+        cfg.capacity = capacity;
+        cfg.max_key_size = KEY_SIZE;
+        cfg.value_size = sizeof(uint64_t);
+        c = lru_create(&cfg);
+        pthread_mutex_init(&lock, nullptr);
+    }
+    ~LruMutex() override {
+        lru_free(c);
+        pthread_mutex_destroy(&lock);
+    }
+    bool get(uint64_t id, uint64_t* value) override {
+        const char* k = keyAt(id);
+        size_t len = strlen(k);
+        pthread_mutex_lock(&lock);
+        int ret = lru_get(c, k, len, value);
+        pthread_mutex_unlock(&lock);
+        return ret == 0;
+    }
+    void put(uint64_t id, uint64_t value) override {
+        const char* k = keyAt(id);
+        size_t len = strlen(k);
+        pthread_mutex_lock(&lock);
+        lru_put(c, k, len, &value);
+        pthread_mutex_unlock(&lock);
+    }
+};
+
+void noFree(void* element) {
+    (void)element;
+}
+
+// foo_cache 的值是指针，这里指向 g_values 中对应的元素；insert 不检查键是否已存在，先查找，未命中再插入
+std::vector<uint64_t> g_values;
+
+struct FooCache : Cache {
+    foo_cache* c = nullptr;
+    explicit FooCache(size_t capacity) {
+        // 元素数达到 max_entries 时淘汰，最多保存 max_entries - 1 个
+        foo_cache_create(&c, capacity + 1, noFree);
+    }
+    ~FooCache() override { foo_cache_delete(c, 1); }
+    bool get(uint64_t id, uint64_t* value) override {
+        uint64_t* v = nullptr;
+        foo_cache_lookup(c, keyAt(id), &v);
+        if (v != nullptr) {
+            *value = *v;
+        }
+        return v != nullptr;
+    }
+    void put(uint64_t id, uint64_t value) override {
+        uint64_t* v = nullptr;
+        foo_cache_lookup(c, keyAt(id), &v);
+        if (v == nullptr) {
+            g_values[id] = value;
+            foo_cache_insert(c, keyAt(id), &g_values[id]);
+        }
+    }
+};
+
+// 返回 Mops/s
+double run(Cache& cache, size_t n, uint64_t range, int threads, int readPercent, size_t ops) {
+    for (size_t i = 0; i < n; i++) {
+        cache.put(i, i);
+    }
+
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    size_t perThread = ops / (size_t)threads;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            uint64_t s = 0x2545f4914f6cdd1dULL * (uint64_t)(t + 1);
+            uint64_t acc = 0;
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < perThread; i++) {
+                uint64_t r = nextRand(s);
+                uint64_t id = (r >> 8) % range;
+                if ((int)(r % 100) < readPercent) {
+                    uint64_t v = 0;
+                    acc += cache.get(id, &v) ? v : 0;
+                } else {
+                    cache.put(id, id);
+                }
+            }
+            g_sink += acc;
+        });
+    }
+    while (ready.load() < threads) {
+        std::this_thread::yield();
+    }
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& w : workers) {
+        w.join();
+    }
+    double sec = std::chrono::duration<double>(Clock::now() - start).count();
+    return (double)(perThread * (size_t)threads) / sec / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t n = 1 << 18;
+    size_t ops = 2000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--n") == 0 && i + 1 < argc) {
+            n = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            ops = strtoull(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [--n N] [--ops OPS]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (n == 0 || ops == 0) {
+        fprintf(stderr, "N 与 OPS 应大于 0\n");
+        return 2;
+    }
+    uint64_t range = n + n / 4;
+    g_keys.resize(range * KEY_SIZE);
+    g_values.resize(range);
+    for (uint64_t i = 0; i < range; i++) {
+        snprintf(keyAt(i), KEY_SIZE, "%llu", (unsigned long long)(i * 2654435761ULL % 1000000007ULL));
+    }
+
+    const int threadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+    const int readPercents[] = {100, 95};
+    printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    printf("%-14s %5s", "cache", "read%");
+    for (int t : threadCounts) {
+        printf(" %7dT", t);
+    }
+    printf("   (Mops/s)\n");
+    for (int readPercent : readPercents) {
+        for (int kind = 0; kind < 4; kind++) {
+            static const char* const names[] = {"shardlru", "shardlru 1", "lru+mutex", "foo_cache"};
+            printf("%-14s %5d", names[kind], readPercent);
+            for (int t : threadCounts) {
+                Cache* cache = kind == 0   ? (Cache*)new ShardAdapter(n, SHARDLRU_DEFAULT_SHARDS)
+                               : kind == 1 ? (Cache*)new ShardAdapter(n, 1)
+                               : kind == 2 ? (Cache*)new LruMutex(n)
+                                           : (Cache*)new FooCache(n);
+                printf(" %8.2f", run(*cache, n, range, t, readPercent, ops));
+                fflush(stdout);
+                delete cache;
+            }
+            printf("\n");
+        }
+    }
+    return 0;
+}